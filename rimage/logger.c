@@ -0,0 +1,384 @@
+/*
+ * Compact DMA trace decoder.
+ *
+ * Copyright (c) 2018, Intel Corporation.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ */
+
+/*
+ * Reads the compact trace stream copied by the DSP trace DMA, or with -m
+ * the full log entries of the mailbox trace window, and prints every event
+ * as text, using the log dictionary written by rimage -p.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <inttypes.h>
+
+#include "file_format.h"
+#include <uapi/logging.h>
+
+#define ARRAY_SIZE(x) (sizeof(x) / sizeof(x[0]))
+
+/* static log entry as declared by _DECLARE_LOG_ENTRY() in sof/trace.h */
+struct ldc_entry_header {
+	uint32_t level;
+	uint32_t component_id;
+	uint32_t params_num;
+	uint32_t line_idx;
+	uint32_t file_name_len;
+};
+
+struct ldc {
+	struct snd_sof_logs_header header;
+	uint8_t *data;
+};
+
+struct stream {
+	FILE *fd;
+	uint64_t timestamp;
+	uint32_t entry_base;
+	int burst;
+	int mailbox;	/* full entries until a flushed burst */
+};
+
+static const char * const class_names[] = {
+	"", "irq", "ipc", "pipe", "host", "dai", "dma", "ssp", "comp",
+	"wait", "lock", "mem", "mixer", "buffer", "volume", "switch", "mux",
+	"src", "tone", "eq-fir", "eq-iir", "sa", "dmic", "power", "idc",
+	"cpu",
+};
+
+static void usage(char *name)
+{
+	fprintf(stdout,
+		"%s:\t -l ldc_file -i trace_file [-o out_file] [-m]\n", name);
+	fprintf(stdout, "\t\t -m trace_file is the mailbox trace window\n");
+	exit(0);
+}
+
+static int ldc_read(struct ldc *ldc, const char *file)
+{
+	FILE *fd;
+	int ret = 0;
+
+	fd = fopen(file, "r");
+	if (!fd) {
+		fprintf(stderr, "error: unable to open %s %d\n", file, errno);
+		return -errno;
+	}
+
+	if (fread(&ldc->header, sizeof(ldc->header), 1, fd) != 1 ||
+	    memcmp(ldc->header.sig, SND_SOF_LOGS_SIG,
+		   SND_SOF_LOGS_SIG_SIZE)) {
+		fprintf(stderr, "error: %s is not a log dictionary\n", file);
+		ret = -EINVAL;
+		goto out;
+	}
+
+	ldc->data = calloc(1, ldc->header.data_length);
+	if (!ldc->data) {
+		ret = -ENOMEM;
+		goto out;
+	}
+
+	fseek(fd, ldc->header.data_offset, SEEK_SET);
+	if (fread(ldc->data, 1, ldc->header.data_length, fd) !=
+	    ldc->header.data_length) {
+		fprintf(stderr, "error: can't read log entries %d\n", -errno);
+		ret = -EINVAL;
+	}
+
+out:
+	fclose(fd);
+	return ret;
+}
+
+static int read_varint(FILE *fd, uint64_t *value)
+{
+	int shift;
+	int c;
+
+	*value = 0;
+	for (shift = 0; shift < 64; shift += 7) {
+		c = fgetc(fd);
+		if (c == EOF)
+			return -EIO;
+
+		*value |= (uint64_t)(c & 0x7f) << shift;
+		if (!(c & 0x80))
+			return 0;
+	}
+
+	return -EINVAL;
+}
+
+/* dictionary entry of a log entry address, NULL if there is none */
+static struct ldc_entry_header *ldc_entry(struct ldc *ldc, uint32_t entry)
+{
+	uint32_t offset = entry - ldc->header.base_address;
+
+	if (offset + sizeof(struct ldc_entry_header) >
+	    ldc->header.data_length)
+		return NULL;
+
+	return (struct ldc_entry_header *)(ldc->data + offset);
+}
+
+static void print_event(struct ldc *ldc, FILE *out, struct stream *s,
+			int core, uint32_t entry, uint32_t *params, int count)
+{
+	struct ldc_entry_header *e = ldc_entry(ldc, entry);
+	const char *file_name;
+	const char *text;
+	uint32_t class;
+
+	if (!e) {
+		fprintf(out, "[%" PRIu64 "] c%d unknown entry 0x%x\n",
+			s->timestamp, core, entry);
+		return;
+	}
+
+	/* file name and text are char arrays padded to 32 bit words */
+	file_name = (const char *)(e + 1);
+	text = file_name + ((e->file_name_len + 3) & ~3) + sizeof(uint32_t);
+
+	class = e->component_id >> 24;
+	fprintf(out, "[%" PRIu64 "] c%d %-8s %s:%u ", s->timestamp, core,
+		class < ARRAY_SIZE(class_names) ? class_names[class] : "?",
+		file_name, e->line_idx);
+	fprintf(out, text, params[0], params[1], params[2], params[3]);
+	fprintf(out, "\n");
+
+	if (count != e->params_num)
+		fprintf(out, "warning: %d params, dictionary has %u\n",
+			count, e->params_num);
+}
+
+static int read_burst(struct stream *s)
+{
+	struct log_compact_burst burst;
+
+	/* the tag was already consumed */
+	if (fread(&burst.version, sizeof(burst) - 1, 1, s->fd) != 1)
+		return -EIO;
+
+	if (burst.version != LOG_COMPACT_VERSION) {
+		fprintf(stderr, "error: compact trace version %u, not %u\n",
+			burst.version, LOG_COMPACT_VERSION);
+		return -EINVAL;
+	}
+
+	s->timestamp = burst.timestamp;
+	s->entry_base = burst.entry_base;
+	s->burst = 1;
+
+	return 0;
+}
+
+static int read_event(struct ldc *ldc, FILE *out, struct stream *s, int tag)
+{
+	uint32_t params[4] = {0};
+	uint64_t delta;
+	uint64_t value;
+	uint64_t param;
+	int count = LOG_COMPACT_TAG_PARAMS(tag);
+	int ret;
+	int i;
+
+	if (count > ARRAY_SIZE(params))
+		return -EINVAL;
+
+	ret = read_varint(s->fd, &delta);
+	if (ret < 0)
+		return ret;
+
+	/* zigzag signed delta */
+	s->timestamp += (delta >> 1) ^ -(delta & 1);
+
+	ret = read_varint(s->fd, &value);
+	if (ret < 0)
+		return ret;
+
+	for (i = 0; i < count; i++) {
+		ret = read_varint(s->fd, &param);
+		if (ret < 0)
+			return ret;
+		params[i] = param;
+	}
+
+	/* events before the first burst have no time and entry base */
+	if (s->burst)
+		print_event(ldc, out, s, LOG_COMPACT_TAG_CORE(tag),
+			    s->entry_base + value, params, count);
+
+	return 0;
+}
+
+/* full mailbox entry, the magic byte was already consumed */
+static int read_entry(struct ldc *ldc, FILE *out, struct stream *s)
+{
+	struct log_entry_header header;
+	struct ldc_entry_header *e;
+	uint32_t params[4] = {0};
+	uint32_t entry;
+	uint32_t count = 0;
+
+	if (fread((uint8_t *)&header + 1, sizeof(header) - 1, 1, s->fd) != 1 ||
+	    fread(&entry, sizeof(entry), 1, s->fd) != 1)
+		return -EIO;
+
+	/* the entry does not hold its params count, the dictionary does */
+	e = ldc_entry(ldc, entry);
+	if (e)
+		count = e->params_num;
+	if (count > ARRAY_SIZE(params))
+		return -EINVAL;
+
+	if (count && fread(params, sizeof(params[0]), count, s->fd) != count)
+		return -EIO;
+
+	s->timestamp = header.timestamp;
+	print_event(ldc, out, s, header.core_id, entry, params, count);
+
+	return 0;
+}
+
+/*
+ * The mailbox window holds word aligned full entries, and empty or
+ * overwritten words that are skipped. A trace flush on panic copies
+ * compact bursts after the last entry, which are decoded to the end.
+ */
+static int read_mailbox(struct ldc *ldc, FILE *out, struct stream *s,
+			int tag)
+{
+	uint8_t skip[sizeof(uint32_t) - 1];
+
+	switch (tag) {
+	case LOG_ENTRY_MAGIC:
+		return read_entry(ldc, out, s);
+	case LOG_COMPACT_BURST:
+		s->mailbox = 0;
+		return read_burst(s);
+	default:
+		if (fread(skip, sizeof(skip), 1, s->fd) != 1)
+			return -EIO;
+		return 0;
+	}
+}
+
+static int decode(struct ldc *ldc, FILE *out, struct stream *s)
+{
+	int tag;
+	int ret;
+
+	while ((tag = fgetc(s->fd)) != EOF) {
+		if (s->mailbox) {
+			ret = read_mailbox(ldc, out, s, tag);
+			if (ret < 0)
+				return ret;
+			continue;
+		}
+
+		switch (tag) {
+		case LOG_COMPACT_PAD:
+			break;
+		case LOG_COMPACT_BURST:
+			ret = read_burst(s);
+			if (ret < 0)
+				return ret;
+			break;
+		default:
+			ret = read_event(ldc, out, s, tag);
+			if (ret < 0)
+				return ret;
+			break;
+		}
+	}
+
+	return 0;
+}
+
+int main(int argc, char *argv[])
+{
+	struct ldc ldc;
+	struct stream s;
+	const char *ldc_file = NULL;
+	const char *in_file = NULL;
+	const char *out_file = NULL;
+	FILE *out = stdout;
+	int opt, ret;
+
+	memset(&ldc, 0, sizeof(ldc));
+	memset(&s, 0, sizeof(s));
+
+	while ((opt = getopt(argc, argv, "hl:i:o:m")) != -1) {
+		switch (opt) {
+		case 'l':
+			ldc_file = optarg;
+			break;
+		case 'i':
+			in_file = optarg;
+			break;
+		case 'o':
+			out_file = optarg;
+			break;
+		case 'm':
+			s.mailbox = 1;
+			break;
+		case 'h':
+		default:
+			usage(argv[0]);
+			break;
+		}
+	}
+
+	if (!ldc_file || !in_file)
+		usage(argv[0]);
+
+	ret = ldc_read(&ldc, ldc_file);
+	if (ret < 0)
+		return ret;
+
+	s.fd = fopen(in_file, "r");
+	if (!s.fd) {
+		fprintf(stderr, "error: unable to open %s %d\n", in_file,
+			errno);
+		ret = -errno;
+		goto out;
+	}
+
+	if (out_file) {
+		out = fopen(out_file, "w");
+		if (!out) {
+			fprintf(stderr, "error: unable to open %s %d\n",
+				out_file, errno);
+			ret = -errno;
+			goto out;
+		}
+	}
+
+	ret = decode(&ldc, out, &s);
+	if (ret < 0)
+		fprintf(stderr, "error: truncated trace stream\n");
+
+out:
+	if (out && out != stdout)
+		fclose(out);
+	if (s.fd)
+		fclose(s.fd);
+	free(ldc.data);
+	return ret;
+}
@@ -38,3 +38,29 @@ libraries="vol=libsof_volume.so,src=libsof_src.so"
 
 # run src testbench
 #./src/host/testbench -i $input_file -o $output_file -b $bits_in -t $topology_file -a $libraries -r $fs_in -R $fs_out -d
+
+# run volume testbench in a shell pipeline, wav on stdin gives wav on stdout
+#cat in.wav | ./src/host/testbench -i - -o - -b $bits_in -t $topology_file -a $libraries > out.wav
+
+# run volume testbench with timed control events, e.g. a line
+# "4800 2 volume 0x8000 0x8000" sets volume of comp 2 at input frame 4800
+#./src/host/testbench -i $input_file -o $output_file -b $bits_in -t $topology_file -a $libraries -c controls.txt
+
+# run volume testbench after 10000 pipeline open/close cycles and report
+# host heap fragmentation before and after the cycles
+#./src/host/testbench -i $input_file -o $output_file -b $bits_in -t $topology_file -a $libraries -s 10000
+
+# run volume testbench after 10000 stream open/close cycles on one topology
+# load, the pipeline arena and heap must not grow
+#./src/host/testbench -i $input_file -o $output_file -b $bits_in -t $topology_file -a $libraries -S 10000
+
+# run volume testbench reading the input in 16 frame blocks, a shorter period
+# than the pipeline period, as when a 0.33 ms DAI feeds a 1 ms pipeline
+#./src/host/testbench -i $input_file -o $output_file -b $bits_in -t $topology_file -a $libraries -p 16
+
+# run volume testbench on emulated DSP core 1 and report the IDC round trips
+#./src/host/testbench -i $input_file -o $output_file -b $bits_in -t $topology_file -a $libraries -C 1
+
+# run volume testbench moving the pipeline to the next emulated DSP core every
+# 10 periods, the output must not change
+#./src/host/testbench -i $input_file -o $output_file -b $bits_in -t $topology_file -a $libraries -M 10
@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2018, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of the Intel Corporation nor the
+ *     names of its contributors may be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <arch/hifi_emu.h>
+
+struct hifi_emu_ops hifi_emu_ops;
+
+void *hifi_emu_cbegin;
+void *hifi_emu_cend;
+
+void hifi_emu_ops_reset(void)
+{
+	memset(&hifi_emu_ops, 0, sizeof(hifi_emu_ops));
+}
+
+uint64_t hifi_emu_ops_total(void)
+{
+	return hifi_emu_ops.load + hifi_emu_ops.store + hifi_emu_ops.mul +
+		hifi_emu_ops.alu;
+}
+
+/* Rough estimate assuming the compiler bundles the load/store and the
+ * multiply/ALU slot operations of the loop bodies perfectly, so the busier
+ * of the two slot groups sets the cycle count.
+ */
+uint64_t hifi_emu_cycles(void)
+{
+	uint64_t ldst = hifi_emu_ops.load + hifi_emu_ops.store;
+	uint64_t arith = hifi_emu_ops.mul + hifi_emu_ops.alu;
+
+	return ldst > arith ? ldst : arith;
+}
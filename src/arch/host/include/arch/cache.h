@@ -34,10 +34,49 @@
 #include <stdint.h>
 #include <stddef.h>
 
-static inline void dcache_writeback_region(void *addr, size_t size) {}
-static inline void dcache_invalidate_region(void *addr, size_t size) {}
+/* emulated line size, the maintenance stats count the lines touched */
+#define DCACHE_STATS_LINE	64
+
+/*
+ * Bytes of the lines host code asked to write back or invalidate. The
+ * stats are defined by host/cpu.c, programs not linking it don't count.
+ */
+struct dcache_stats {
+	uint64_t writeback;
+	uint64_t invalidate;
+};
+
+extern struct dcache_stats dcache_stats __attribute__((weak));
+
+static inline void dcache_stats_add(uint64_t *bytes, void *addr, size_t size)
+{
+	uintptr_t start = (uintptr_t)addr & ~(DCACHE_STATS_LINE - 1);
+	uintptr_t end = ((uintptr_t)addr + size + DCACHE_STATS_LINE - 1) &
+		~(DCACHE_STATS_LINE - 1);
+
+	if (size)
+		__atomic_fetch_add(bytes, end - start, __ATOMIC_RELAXED);
+}
+
+static inline void dcache_writeback_region(void *addr, size_t size)
+{
+	if (&dcache_stats)
+		dcache_stats_add(&dcache_stats.writeback, addr, size);
+}
+
+static inline void dcache_invalidate_region(void *addr, size_t size)
+{
+	if (&dcache_stats)
+		dcache_stats_add(&dcache_stats.invalidate, addr, size);
+}
+
 static inline void icache_invalidate_region(void *addr, size_t size) {}
+
 static inline void dcache_writeback_invalidate_region(void *addr,
-	size_t size) {}
+	size_t size)
+{
+	dcache_writeback_region(addr, size);
+	dcache_invalidate_region(addr, size);
+}
 
 #endif
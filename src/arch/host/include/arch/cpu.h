@@ -32,22 +32,36 @@
 #ifndef __INCLUDE_ARCH_CPU__
 #define __INCLUDE_ARCH_CPU__
 
+#include <platform/platcfg.h>
+
+/*
+ * Host builds run every enabled core on a thread of its own, the emulation
+ * is in the testbench, see src/host/cpu.c.
+ */
+extern __thread int emu_cpu_id;
+
+void emu_cpu_enable_core(int id);
+void emu_cpu_disable_core(int id);
+int emu_cpu_is_core_enabled(int id);
+
 static inline void arch_cpu_enable_core(int id)
 {
+	emu_cpu_enable_core(id);
 }
 
 static inline void arch_cpu_disable_core(int id)
 {
+	emu_cpu_disable_core(id);
 }
 
 static inline int arch_cpu_is_core_enabled(int id)
 {
-	return 0;
+	return emu_cpu_is_core_enabled(id);
 }
 
 static inline int arch_cpu_get_id(void)
 {
-	return 0;
+	return emu_cpu_id;
 }
 
 static inline void cpu_write_threadptr(int threadptr)
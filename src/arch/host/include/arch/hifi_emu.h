@@ -0,0 +1,492 @@
+/*
+ * Copyright (c) 2018, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of the Intel Corporation nor the
+ *     names of its contributors may be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Host emulation of the HiFi2 EP and HiFi3 intrinsics used by the audio
+ * processing kernels.
+ *
+ * Vector registers are kept in 64 bit integers. For 32x2 types H is the
+ * upper and L the lower word, for 16x4 types lane 3 is the upper halfword.
+ * As on the DSP, 64 bit loads place the sample at the lower address to
+ * H (or lane 3). 24 bit values are kept left aligned in 32 bits and the
+ * HiFi2 EP 56 bit Q registers are kept as Q17.47 in 64 bits.
+ *
+ * Every emulated intrinsic is counted to its instruction class so that
+ * a rough cycle estimate can be derived for a kernel call.
+ */
+
+#ifndef __INCLUDE_ARCH_HIFI_EMU__
+#define __INCLUDE_ARCH_HIFI_EMU__
+
+#include <stdint.h>
+
+typedef int16_t ae_int16;
+typedef int32_t ae_int32;
+typedef int32_t ae_f32;
+typedef int32_t ae_f24;
+typedef int32_t ae_p24f;
+typedef int32_t ae_p16x2s;
+typedef int32_t ae_q32s;
+typedef int64_t ae_int64;
+typedef int64_t ae_f64;
+typedef int64_t ae_int32x2;
+typedef int64_t ae_f32x2;
+typedef int64_t ae_f24x2;
+typedef int64_t ae_int16x4;
+typedef int64_t ae_f16x4;
+typedef int64_t ae_p24x2f;
+typedef int64_t ae_q56s;
+typedef int64_t ae_valign;
+
+/* issued intrinsics per instruction class */
+struct hifi_emu_ops {
+	uint64_t load;
+	uint64_t store;
+	uint64_t mul;
+	uint64_t alu;
+};
+
+extern struct hifi_emu_ops hifi_emu_ops;
+
+/* circular addressing registers CBEGIN0 and CEND0 */
+extern void *hifi_emu_cbegin;
+extern void *hifi_emu_cend;
+
+void hifi_emu_ops_reset(void);
+uint64_t hifi_emu_ops_total(void);
+uint64_t hifi_emu_cycles(void);
+
+/* Pointer arguments updated by the intrinsics are often written with a
+ * cast, e.g. (ae_int32 *)fir->rwp. HIFI_EMU_LV() drops such a cast so
+ * the pointer can be assigned to.
+ */
+#define HIFI_EMU_CAT_(a, b) a ## b
+#define HIFI_EMU_CAT(a, b) HIFI_EMU_CAT_(a, b)
+#define HIFI_EMU_STRIP(...) HIFI_EMU_
+#define HIFI_EMU_NO_HIFI_EMU_
+#define HIFI_EMU_NO_HIFI_EMU_STRIP
+#define HIFI_EMU_LV(p) HIFI_EMU_CAT(HIFI_EMU_NO_, HIFI_EMU_STRIP p)
+
+#define HIFI_EMU_XP(p, inc) \
+	(HIFI_EMU_LV(p) = hifi_emu_lin(HIFI_EMU_LV(p), (int)(inc)))
+#define HIFI_EMU_XC(p, inc) \
+	(HIFI_EMU_LV(p) = hifi_emu_circ(HIFI_EMU_LV(p), (int)(inc)))
+
+/* register lane helpers */
+
+static inline int32_t hifi_emu_h(int64_t v)
+{
+	return (int32_t)((uint64_t)v >> 32);
+}
+
+static inline int32_t hifi_emu_l(int64_t v)
+{
+	return (int32_t)v;
+}
+
+static inline int16_t hifi_emu_lane16(int64_t v, int lane)
+{
+	return (int16_t)((uint64_t)v >> (16 * lane));
+}
+
+static inline int64_t hifi_emu_pack(int32_t h, int32_t l)
+{
+	return (int64_t)(((uint64_t)(uint32_t)h << 32) | (uint32_t)l);
+}
+
+static inline int64_t hifi_emu_pack16(int16_t v)
+{
+	uint64_t u = (uint16_t)v;
+
+	return (int64_t)(u << 48 | u << 32 | u << 16 | u);
+}
+
+static inline int32_t hifi_emu_f24(int32_t v)
+{
+	return v & ~0xff;
+}
+
+static inline int32_t hifi_emu_sat32(int64_t v)
+{
+	if (v > INT32_MAX)
+		return INT32_MAX;
+	if (v < INT32_MIN)
+		return INT32_MIN;
+	return (int32_t)v;
+}
+
+/* saturating left shift to a bits wide signed value */
+static inline int64_t hifi_emu_sls(int64_t v, int s, int bits)
+{
+	const int64_t max = (int64_t)(((uint64_t)1 << (bits - 1)) - 1);
+	const int64_t min = -max - 1;
+
+	if (s >= bits)
+		return v > 0 ? max : (v < 0 ? min : 0);
+	if (v > max >> s)
+		return max;
+	if (v < min >> s)
+		return min;
+	return (int64_t)((uint64_t)v << s);
+}
+
+/* arithmetic shift right, negative amount shifts left */
+static inline int64_t hifi_emu_sra64(int64_t v, int s)
+{
+	return s >= 0 ? v >> s : (int64_t)((uint64_t)v << -s);
+}
+
+/* symmetric rounding of Q17.47 to Q1.31 */
+static inline int32_t hifi_emu_round48(int64_t v)
+{
+	const int64_t rnd = 1 << 15;
+
+	return hifi_emu_sat32(v < 0 ? -((-v + rnd) >> 16) : (v + rnd) >> 16);
+}
+
+/* address updates */
+
+static inline void *hifi_emu_lin(void *p, int inc)
+{
+	return (char *)p + inc;
+}
+
+static inline void *hifi_emu_circ(void *p, int inc)
+{
+	char *begin = hifi_emu_cbegin;
+	char *end = hifi_emu_cend;
+	char *next = (char *)p + inc;
+
+	if (inc >= 0) {
+		if (next >= end)
+			next -= end - begin;
+	} else if (next < begin) {
+		next += end - begin;
+	}
+
+	return next;
+}
+
+/* loads and stores */
+
+static inline int64_t hifi_emu_l32(const void *p)
+{
+	int32_t v = *(const int32_t *)p;
+
+	hifi_emu_ops.load++;
+	return hifi_emu_pack(v, v);
+}
+
+static inline int64_t hifi_emu_l32f24(const void *p)
+{
+	int32_t v = hifi_emu_f24(*(const int32_t *)p);
+
+	hifi_emu_ops.load++;
+	return hifi_emu_pack(v, v);
+}
+
+static inline int64_t hifi_emu_l32x2(const void *p)
+{
+	const int32_t *w = p;
+
+	hifi_emu_ops.load++;
+	return hifi_emu_pack(w[0], w[1]);
+}
+
+static inline int64_t hifi_emu_l32x2f24(const void *p)
+{
+	const int32_t *w = p;
+
+	hifi_emu_ops.load++;
+	return hifi_emu_pack(hifi_emu_f24(w[0]), hifi_emu_f24(w[1]));
+}
+
+static inline int64_t hifi_emu_l16(const void *p)
+{
+	hifi_emu_ops.load++;
+	return hifi_emu_pack16(*(const int16_t *)p);
+}
+
+static inline int64_t hifi_emu_l16x4(const void *p)
+{
+	const uint16_t *h = p;
+
+	hifi_emu_ops.load++;
+	return (int64_t)((uint64_t)h[0] << 48 | (uint64_t)h[1] << 32 |
+			 (uint64_t)h[2] << 16 | h[3]);
+}
+
+static inline int64_t hifi_emu_l16x2f(const void *p)
+{
+	const int16_t *h = p;
+
+	hifi_emu_ops.load++;
+	return hifi_emu_pack(h[0] * 65536, h[1] * 65536);
+}
+
+static inline int64_t hifi_emu_lq32f(const void *p)
+{
+	hifi_emu_ops.load++;
+	return (int64_t)*(const int32_t *)p * 65536;
+}
+
+static inline void hifi_emu_s32(void *p, int32_t v)
+{
+	hifi_emu_ops.store++;
+	*(int32_t *)p = v;
+}
+
+static inline void hifi_emu_s16(void *p, int16_t v)
+{
+	hifi_emu_ops.store++;
+	*(int16_t *)p = v;
+}
+
+static inline int64_t hifi_emu_la_prime(const void *p)
+{
+	hifi_emu_ops.load++;
+	return 0;
+}
+
+/* multiplies, all products are fractional and accumulate in Q17.47 */
+
+static inline int64_t hifi_emu_mac32x16(int64_t acc, int32_t d0, int32_t d1,
+					int16_t c0, int16_t c1)
+{
+	return acc + (((int64_t)d0 * c0 + (int64_t)d1 * c1) << 1);
+}
+
+static inline int64_t hifi_emu_mac24(int64_t acc, int64_t d, int64_t c)
+{
+	hifi_emu_ops.mul++;
+	return acc + (((int64_t)(hifi_emu_h(d) >> 8) * (hifi_emu_h(c) >> 8) +
+		       (int64_t)(hifi_emu_l(d) >> 8) * (hifi_emu_l(c) >> 8))
+		      << 1);
+}
+
+static inline int32_t hifi_emu_mulrs(int32_t a, int32_t b, int s)
+{
+	return hifi_emu_sat32(((int64_t)a * b + ((int64_t)1 << (s - 1)))
+			      >> s);
+}
+
+/* lane wise ALU operations */
+
+static inline int32_t hifi_emu_sraa32rs(int32_t v, int s)
+{
+	if (s <= 0)
+		return (int32_t)hifi_emu_sls(v, -s, 32);
+	return hifi_emu_sat32(((int64_t)v + ((int64_t)1 << (s - 1))) >> s);
+}
+
+static inline int32_t hifi_emu_slaa32(int32_t v, int s)
+{
+	return s >= 0 ? (int32_t)((uint32_t)v << s) : v >> -s;
+}
+
+static inline int32_t hifi_emu_srla32(int32_t v, int s)
+{
+	return s >= 0 ? (int32_t)((uint32_t)v >> s) :
+		(int32_t)((uint32_t)v << -s);
+}
+
+static inline int64_t hifi_emu_zero(void)
+{
+	hifi_emu_ops.alu++;
+	return 0;
+}
+
+static inline int64_t hifi_emu_sel(int32_t h, int32_t l)
+{
+	hifi_emu_ops.alu++;
+	return hifi_emu_pack(h, l);
+}
+
+static inline int64_t hifi_emu_alu32(int64_t v,
+				     int32_t (*op)(int32_t v, int s), int s)
+{
+	hifi_emu_ops.alu++;
+	return hifi_emu_pack(op(hifi_emu_h(v), s), op(hifi_emu_l(v), s));
+}
+
+static inline int64_t hifi_emu_alu64(int64_t v)
+{
+	hifi_emu_ops.alu++;
+	return v;
+}
+
+/*
+ * HiFi3 intrinsics
+ */
+
+#define AE_ZERO16()		hifi_emu_zero()
+#define AE_ZERO24()		hifi_emu_zero()
+#define AE_ZERO32()		hifi_emu_zero()
+#define AE_ZERO64()		hifi_emu_zero()
+#define AE_ZEROQ56()		hifi_emu_zero()
+
+#define AE_SETCBEGIN0(p)	(hifi_emu_cbegin = (void *)(p))
+#define AE_SETCEND0(p)		(hifi_emu_cend = (void *)(p))
+
+#define AE_L16_XP(d, p, inc) \
+	do { (d) = hifi_emu_l16(p); HIFI_EMU_XP(p, inc); } while (0)
+#define AE_L32_XP(d, p, inc) \
+	do { (d) = hifi_emu_l32(p); HIFI_EMU_XP(p, inc); } while (0)
+#define AE_L32_XC(d, p, inc) \
+	do { (d) = hifi_emu_l32(p); HIFI_EMU_XC(p, inc); } while (0)
+#define AE_L32F24_XC(d, p, inc) \
+	do { (d) = hifi_emu_l32f24(p); HIFI_EMU_XC(p, inc); } while (0)
+#define AE_L32X2_XC(d, p, inc) \
+	do { (d) = hifi_emu_l32x2(p); HIFI_EMU_XC(p, inc); } while (0)
+#define AE_L32X2F24_XC(d, p, inc) \
+	do { (d) = hifi_emu_l32x2f24(p); HIFI_EMU_XC(p, inc); } while (0)
+#define AE_L32X2F24_IP(d, p, inc) \
+	do { (d) = hifi_emu_l32x2f24(p); HIFI_EMU_XP(p, inc); } while (0)
+
+/* Unaligned loads only need the stream to be primed, on host any
+ * alignment is fine so the alignment register carries no data.
+ */
+#define AE_LA64_PP(p)		hifi_emu_la_prime(p)
+#define AE_LA16X4_IP(d, u, p) \
+	do { \
+		(void)&(u); \
+		(d) = hifi_emu_l16x4(p); \
+		HIFI_EMU_XP(p, sizeof(ae_int16x4)); \
+	} while (0)
+
+#define AE_S16_0_XP(d, p, inc) \
+	do { \
+		hifi_emu_s16(p, hifi_emu_lane16(d, 0)); \
+		HIFI_EMU_XP(p, inc); \
+	} while (0)
+#define AE_S32_L_I(d, p, off) \
+	hifi_emu_s32((char *)(p) + (off), hifi_emu_l(d))
+#define AE_S32_L_XP(d, p, inc) \
+	do { hifi_emu_s32(p, hifi_emu_l(d)); HIFI_EMU_XP(p, inc); } while (0)
+#define AE_S32_L_XC(d, p, inc) \
+	do { hifi_emu_s32(p, hifi_emu_l(d)); HIFI_EMU_XC(p, inc); } while (0)
+
+#define AE_SEL32_HH(a, b)	hifi_emu_sel(hifi_emu_h(a), hifi_emu_h(b))
+#define AE_SEL32_LL(a, b)	hifi_emu_sel(hifi_emu_l(a), hifi_emu_l(b))
+#define AE_SELP24_HH(a, b)	hifi_emu_sel(hifi_emu_h(a), hifi_emu_h(b))
+#define AE_SELP24_LL(a, b)	hifi_emu_sel(hifi_emu_l(a), hifi_emu_l(b))
+#define AE_SELP24_LH(a, b)	hifi_emu_sel(hifi_emu_l(a), hifi_emu_h(b))
+
+#define AE_MOVF16X4_FROMF32X2(d)	((ae_f16x4)(d))
+
+#define AE_SLAA32(d, s)		hifi_emu_alu32(d, hifi_emu_slaa32, s)
+#define AE_SLAI32(d, s)		hifi_emu_alu32(d, hifi_emu_slaa32, s)
+#define AE_SRAI32(d, s)		hifi_emu_alu32(d, hifi_emu_slaa32, -(s))
+#define AE_SRLA32(d, s)		hifi_emu_alu32(d, hifi_emu_srla32, s)
+#define AE_SRAA32RS(d, s)	hifi_emu_alu32(d, hifi_emu_sraa32rs, s)
+
+#define AE_SRAA64(d, s)		hifi_emu_alu64(hifi_emu_sra64(d, s))
+#define AE_SLAA64S(d, s) \
+	hifi_emu_alu64((s) >= 0 ? hifi_emu_sls(d, s, 64) : (d) >> -(s))
+#define AE_ROUND32F48SSYM(d) \
+	hifi_emu_sel(hifi_emu_round48(d), hifi_emu_round48(d))
+
+#define AE_MULAAFD32X16_H3_L2(q, d, c) \
+	do { \
+		hifi_emu_ops.mul++; \
+		(q) = hifi_emu_mac32x16(q, hifi_emu_h(d), hifi_emu_l(d), \
+					hifi_emu_lane16(c, 3), \
+					hifi_emu_lane16(c, 2)); \
+	} while (0)
+#define AE_MULAAFD32X16_H1_L0(q, d, c) \
+	do { \
+		hifi_emu_ops.mul++; \
+		(q) = hifi_emu_mac32x16(q, hifi_emu_h(d), hifi_emu_l(d), \
+					hifi_emu_lane16(c, 1), \
+					hifi_emu_lane16(c, 0)); \
+	} while (0)
+
+/* q0 += d0.h * c[hi] + d0.l * c[lo], q1 += d0.l * c[hi] + d1.h * c[lo] */
+#define HIFI_EMU_FIR(q0, q1, d0, d1, c, hi, lo) \
+	do { \
+		hifi_emu_ops.mul++; \
+		(q0) = hifi_emu_mac32x16(q0, hifi_emu_h(d0), hifi_emu_l(d0), \
+					 hifi_emu_lane16(c, hi), \
+					 hifi_emu_lane16(c, lo)); \
+		(q1) = hifi_emu_mac32x16(q1, hifi_emu_l(d0), hifi_emu_h(d1), \
+					 hifi_emu_lane16(c, hi), \
+					 hifi_emu_lane16(c, lo)); \
+	} while (0)
+#define AE_MULAFD32X16X2_FIR_HH(q0, q1, d0, d1, c) \
+	HIFI_EMU_FIR(q0, q1, d0, d1, c, 3, 2)
+#define AE_MULAFD32X16X2_FIR_HL(q0, q1, d0, d1, c) \
+	HIFI_EMU_FIR(q0, q1, d0, d1, c, 1, 0)
+
+#define AE_MULAAFP24S_HH_LL(q, d, c)	((q) = hifi_emu_mac24(q, d, c))
+#define AE_MULAAFD24_HH_LL(q, d, c)	((q) = hifi_emu_mac24(q, d, c))
+
+#define AE_MULFP32X16X2RS_L(d, c) \
+	(hifi_emu_ops.mul++, \
+	 hifi_emu_pack(hifi_emu_mulrs(hifi_emu_h(d), hifi_emu_lane16(c, 1), \
+				      15), \
+		       hifi_emu_mulrs(hifi_emu_l(d), hifi_emu_lane16(c, 0), \
+				      15)))
+#define AE_MULFP32X2RS(a, b) \
+	(hifi_emu_ops.mul++, \
+	 hifi_emu_pack(hifi_emu_mulrs(hifi_emu_h(a), hifi_emu_h(b), 31), \
+		       hifi_emu_mulrs(hifi_emu_l(a), hifi_emu_l(b), 31)))
+
+/*
+ * HiFi2 EP intrinsics
+ */
+
+#define AE_LP24F_C(d, p, inc) \
+	do { (d) = hifi_emu_l32f24(p); HIFI_EMU_XC(p, inc); } while (0)
+#define AE_LP24X2F_C(d, p, inc) \
+	do { (d) = hifi_emu_l32x2f24(p); HIFI_EMU_XC(p, inc); } while (0)
+#define AE_LP24X2F_I(p, off) \
+	hifi_emu_l32x2f24((const char *)(p) + (off))
+#define AE_LP16X2F_I(p, off) \
+	hifi_emu_l16x2f((const char *)(p) + (off))
+
+#define AE_LQ32F_I(p, off)	hifi_emu_lq32f((const char *)(p) + (off))
+#define AE_LQ32F_C(q, p, inc) \
+	do { (q) = hifi_emu_lq32f(p); HIFI_EMU_XC(p, inc); } while (0)
+#define AE_SQ32F_I(q, p, off) \
+	hifi_emu_s32((char *)(p) + (off), (int32_t)((q) >> 16))
+#define AE_SQ32F_C(q, p, inc) \
+	do { \
+		hifi_emu_s32(p, (int32_t)((q) >> 16)); \
+		HIFI_EMU_XC(p, inc); \
+	} while (0)
+
+#define AE_CVTQ48A32S(v)	hifi_emu_alu64((int64_t)(v) * 65536)
+#define AE_ROUNDSQ32SYM(q) \
+	hifi_emu_alu64((int64_t)hifi_emu_round48(q) * 65536)
+#define AE_SRAAQ56(q, s)	hifi_emu_alu64(hifi_emu_sra64(q, s))
+#define AE_SRAIQ56(q, s)	hifi_emu_alu64((q) >> (s))
+#define AE_SLLIQ56(q, s)	hifi_emu_alu64(hifi_emu_sra64(q, -(s)))
+#define AE_SLLASQ56S(q, s) \
+	hifi_emu_alu64((s) >= 0 ? hifi_emu_sls(q, s, 56) : (q) >> -(s))
+
+#endif
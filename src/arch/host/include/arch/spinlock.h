@@ -36,11 +36,35 @@
 #include <errno.h>
 #include <pthread.h>
 
+/* cores are emulated with threads, so host locks really spin */
 typedef struct {
+	volatile uint32_t lock;
+#if DEBUG_LOCKS
+	uint32_t user;
+#endif
 } spinlock_t;
 
-static inline void arch_spinlock_init(spinlock_t *lock) {}
-static inline void arch_spin_lock(spinlock_t *lock) {}
-static inline void arch_spin_unlock(spinlock_t *lock) {}
+static inline void arch_spinlock_init(spinlock_t *lock)
+{
+	lock->lock = 0;
+}
+
+static inline void arch_spin_lock(spinlock_t *lock)
+{
+	while (__sync_lock_test_and_set(&lock->lock, 1))
+		;
+}
+
+static inline int arch_try_lock(spinlock_t *lock)
+{
+	if (__sync_lock_test_and_set(&lock->lock, 1))
+		return 0; /* lock failed */
+	return 1; /* lock acquired */
+}
+
+static inline void arch_spin_unlock(spinlock_t *lock)
+{
+	__sync_lock_release(&lock->lock);
+}
 
 #endif
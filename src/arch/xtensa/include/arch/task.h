@@ -41,6 +41,7 @@
 #include <sof/schedule.h>
 #include <sof/interrupt.h>
 #include <platform/platform.h>
+#include <platform/timer.h>
 #include <sof/debug.h>
 #include <sof/alloc.h>
 
@@ -82,7 +83,7 @@ static inline uint32_t task_get_irq(struct task *task)
 	case TASK_PRI_MED + 1 ... TASK_PRI_LOW:
 		irq = PLATFORM_IRQ_TASK_LOW;
 		break;
-	case TASK_PRI_HIGH ... TASK_PRI_MED - 1:
+	case TASK_PRI_LL ... TASK_PRI_MED - 1:
 		irq = PLATFORM_IRQ_TASK_HIGH;
 		break;
 	case TASK_PRI_MED:
@@ -109,7 +110,7 @@ static inline void task_set_data(struct task *task)
 		irq_task = *task_irq_low_get();
 		dst = &irq_task->list;
 		break;
-	case TASK_PRI_HIGH ... TASK_PRI_MED - 1:
+	case TASK_PRI_LL ... TASK_PRI_MED - 1:
 		irq_task = *task_irq_high_get();
 		dst = &irq_task->list;
 		break;
@@ -121,7 +122,13 @@ static inline void task_set_data(struct task *task)
 	}
 
 	spin_lock_irq(&irq_task->lock, flags);
-	list_item_append(&task->irq_list, dst);
+
+	/* low latency tasks run first on their IRQ level */
+	if (task->priority == TASK_PRI_LL)
+		list_item_prepend(&task->irq_list, dst);
+	else
+		list_item_append(&task->irq_list, dst);
+
 	spin_unlock_irq(&irq_task->lock, flags);
 }
 
@@ -135,6 +142,7 @@ static void _irq_task(void *arg)
 	struct list_item *tlist;
 	struct list_item *clist;
 	struct task *task;
+	uint64_t start;
 	uint32_t flags;
 
 	spin_lock_irq(&irq_task->lock, flags);
@@ -148,8 +156,12 @@ static void _irq_task(void *arg)
 
 		spin_unlock_irq(&irq_task->lock, flags);
 
-		if (task->func && task->state == TASK_STATE_RUNNING)
+		if (task->func && task->state == TASK_STATE_RUNNING) {
+			start = platform_timer_get(platform_timer);
 			task->func(task->data);
+			schedule_task_rtime(task,
+				platform_timer_get(platform_timer) - start);
+		}
 
 		schedule_task_complete(task);
 		spin_lock_irq(&irq_task->lock, flags);
@@ -45,10 +45,6 @@
 #include <sof/idc.h>
 #include <sof/ipc.h>
 #include <sof/lock.h>
-#include <sof/notifier.h>
-
-extern struct ipc *_ipc;
-extern void cpu_power_down_core(void);
 
 /**
  * \brief Returns IDC data.
@@ -166,106 +162,6 @@ static inline int arch_idc_send_msg(struct idc_msg *msg, uint32_t mode)
 	return ret;
 }
 
-/**
- * \brief Executes IDC pipeline trigger message.
- * \param[in] cmd Trigger command.
- * \return Error code.
- */
-static inline int idc_pipeline_trigger(uint32_t cmd)
-{
-	struct sof_ipc_stream *data = _ipc->comp_data;
-	struct ipc_comp_dev *pcm_dev;
-	int ret;
-
-	/* invalidate stream data */
-	dcache_invalidate_region(data, sizeof(*data));
-
-	/* check whether component exists */
-	pcm_dev = ipc_get_comp(_ipc, data->comp_id);
-	if (!pcm_dev)
-		return -ENODEV;
-
-	/* check whether we are executing from the right core */
-	if (arch_cpu_get_id() != pcm_dev->cd->pipeline->ipc_pipe.core)
-		return -EINVAL;
-
-	/* invalidate pipeline on start */
-	if (cmd == COMP_TRIGGER_START)
-		pipeline_cache(pcm_dev->cd->pipeline,
-			       pcm_dev->cd, COMP_CACHE_INVALIDATE);
-
-	/* trigger pipeline */
-	ret = pipeline_trigger(pcm_dev->cd->pipeline, pcm_dev->cd, cmd);
-
-	/* writeback pipeline on stop */
-	if (cmd == COMP_TRIGGER_STOP)
-		pipeline_cache(pcm_dev->cd->pipeline,
-			       pcm_dev->cd, COMP_CACHE_WRITEBACK_INV);
-
-	return ret;
-}
-
-/**
- * \brief Executes IDC component command message.
- * \param[in] cmd Component command.
- * \return Error code.
- */
-static inline int idc_component_command(uint32_t cmd)
-{
-	struct sof_ipc_ctrl_data *data = _ipc->comp_data;
-	struct ipc_comp_dev *comp_dev;
-	int ret;
-
-	/* invalidate control data */
-	dcache_invalidate_region(data, sizeof(*data));
-	dcache_invalidate_region(data + 1,
-				 data->rhdr.hdr.size - sizeof(*data));
-
-	/* check whether component exists */
-	comp_dev = ipc_get_comp(_ipc, data->comp_id);
-	if (!comp_dev)
-		return -ENODEV;
-
-	/* check whether we are executing from the right core */
-	if (arch_cpu_get_id() != comp_dev->cd->pipeline->ipc_pipe.core)
-		return -EINVAL;
-
-	/* execute component command */
-	ret = comp_cmd(comp_dev->cd, cmd, data);
-
-	/* writeback control data */
-	dcache_writeback_region(data, data->rhdr.hdr.size);
-
-	return ret;
-}
-
-/**
- * \brief Executes IDC message based on type.
- * \param[in,out] msg Pointer to IDC message.
- */
-static inline void idc_cmd(struct idc_msg *msg)
-{
-	uint32_t type = iTS(msg->header);
-
-	switch (type) {
-	case iTS(IDC_MSG_POWER_DOWN):
-		cpu_power_down_core();
-		break;
-	case iTS(IDC_MSG_PPL_TRIGGER):
-		idc_pipeline_trigger(msg->extension);
-		break;
-	case iTS(IDC_MSG_COMP_CMD):
-		idc_component_command(msg->extension);
-		break;
-	case iTS(IDC_MSG_NOTIFY):
-		notifier_notify();
-		break;
-	default:
-		trace_idc_error("eTc");
-		trace_error_value(msg->header);
-	}
-}
-
 /**
  * \brief Handles received IDC message.
  * \param[in,out] data Pointer to IDC data.
@@ -60,7 +60,7 @@ struct comp_buffer *buffer_new(struct sof_ipc_buffer *desc)
 	}
 
 	/* allocate new buffer */
-	buffer = rzalloc(RZONE_RUNTIME, SOF_MEM_CAPS_RAM, sizeof(*buffer));
+	buffer = rzalloc_slab(RZONE_RUNTIME, SLAB_BUFFER, sizeof(*buffer));
 	if (buffer == NULL) {
 		trace_buffer_error("ebN");
 		return NULL;
@@ -85,6 +85,10 @@ struct comp_buffer *buffer_new(struct sof_ipc_buffer *desc)
 
 	buffer_zero(buffer);
 
+	/* can be freed before it is connected */
+	list_init(&buffer->source_list);
+	list_init(&buffer->sink_list);
+
 	spinlock_init(&buffer->lock);
 
 	return buffer;
@@ -95,6 +99,10 @@ void buffer_free(struct comp_buffer *buffer)
 {
 	trace_buffer("BFr");
 
+	/* the components' buffer lists change */
+	mm_pm_dirty_list(&buffer->source_list);
+	mm_pm_dirty_list(&buffer->sink_list);
+
 	list_item_del(&buffer->source_list);
 	list_item_del(&buffer->sink_list);
 	rfree(buffer->addr);
@@ -113,15 +121,16 @@ void comp_update_buffer_produce(struct comp_buffer *buffer, uint32_t bytes)
 	 * 2. source(non-DMA) --> buffer --> sink(DMA): write back to memory.
 	 * 3. source(DMA) --> buffer --> sink(DMA): do nothing.
 	 * 4. source(non-DMA) --> buffer --> sink(non-DMA): do nothing.
+	 * The region is only recorded here, buffer_sync() runs the cache
+	 * operation once for all the data produced in the period.
 	 */
-	if (buffer->source->is_dma_connected &&
-	    !buffer->sink->is_dma_connected)
-		/* need invalidate cache for sink component to use */
-		dcache_invalidate_region(buffer->w_ptr, bytes);
-	else if (!buffer->source->is_dma_connected &&
-		 buffer->sink->is_dma_connected)
-		/* need write back to memory for sink component to use */
-		dcache_writeback_region(buffer->w_ptr, bytes);
+	if (buffer->source->is_dma_connected !=
+	    buffer->sink->is_dma_connected) {
+		if (!buffer->sync_bytes)
+			buffer->sync_ptr = buffer->w_ptr;
+		buffer->sync_bytes = MIN(buffer->sync_bytes + bytes,
+					 buffer->size);
+	}
 
 	buffer->w_ptr += bytes;
 
@@ -171,10 +180,6 @@ void comp_update_buffer_consume(struct comp_buffer *buffer, uint32_t bytes)
 	/* calculate free bytes */
 	buffer->free = buffer->size - buffer->avail;
 
-	if (buffer->sink->is_dma_connected &&
-	    !buffer->source->is_dma_connected)
-		dcache_writeback_region(buffer->r_ptr, bytes);
-
 	spin_unlock_irq(&buffer->lock, flags);
 
 	tracev_buffer("con");
@@ -182,3 +187,52 @@ void comp_update_buffer_consume(struct comp_buffer *buffer, uint32_t bytes)
 	tracev_value((buffer->ipc_buffer.comp.id << 16) | buffer->size);
 	tracev_value((buffer->r_ptr - buffer->addr) << 16 | (buffer->w_ptr - buffer->addr));
 }
+
+/* run the cache operation on the region, split where it wraps */
+static void buffer_cache_region(struct comp_buffer *buffer,
+				cache_command cache_cmd, void *ptr,
+				uint32_t bytes)
+{
+	uint32_t head = MIN(bytes, buffer->end_addr - ptr);
+
+	cache_cmd(ptr, head);
+	if (bytes > head)
+		cache_cmd(buffer->addr, bytes - head);
+}
+
+void buffer_sync(struct comp_buffer *buffer)
+{
+	uint32_t flags;
+
+	spin_lock_irq(&buffer->lock, flags);
+
+	if (!buffer->sync_bytes)
+		goto out;
+
+	/* DMA wrote the data for the sink or the sink DMA will read it */
+	if (buffer->source->is_dma_connected)
+		buffer_cache_region(buffer, &dcache_invalidate_region,
+				    buffer->sync_ptr, buffer->sync_bytes);
+	else
+		buffer_cache_region(buffer, &dcache_writeback_region,
+				    buffer->sync_ptr, buffer->sync_bytes);
+
+	buffer->sync_bytes = 0;
+
+out:
+	spin_unlock_irq(&buffer->lock, flags);
+}
+
+void buffer_cache(struct comp_buffer *buffer, int cmd)
+{
+	cache_command cache_cmd = comp_get_cache_command(cmd);
+
+	if (!cache_cmd)
+		return;
+
+	/* the other core reads the pointers, then the data not consumed */
+	cache_cmd(buffer, sizeof(*buffer));
+	if (buffer->avail)
+		buffer_cache_region(buffer, cache_cmd, buffer->r_ptr,
+				    buffer->avail);
+}
@@ -68,9 +68,6 @@ struct dai_data {
 	int xrun;		/* true if we are doing xrun recovery */
 	int pointer_init;	/* true if buffer pointer was initialized */
 
-	uint32_t dai_pos_blks;	/* position in bytes (nearest block) */
-
-	volatile uint64_t *dai_pos; /* host can read back this value without IPC */
 	uint64_t wallclock;	/* wall clock at stream start */
 };
 
@@ -78,7 +75,6 @@ static void dai_buffer_process(struct comp_dev *dev)
 {
 	struct dai_data *dd = comp_get_drvdata(dev);
 	struct comp_buffer *dma_buffer;
-	void *buffer_ptr;
 
 	if (dev->params.direction == SOF_IPC_STREAM_PLAYBACK) {
 		dma_buffer = list_first_item(&dev->bsource_list,
@@ -87,8 +83,6 @@ static void dai_buffer_process(struct comp_dev *dev)
 		/* recalc available buffer space */
 		comp_update_buffer_consume(dma_buffer, dd->period_bytes);
 
-		buffer_ptr = dma_buffer->r_ptr;
-
 		/* make sure there is available bytes for next period */
 		if (dma_buffer->avail < dd->period_bytes) {
 			trace_dai_error("xru");
@@ -101,8 +95,6 @@ static void dai_buffer_process(struct comp_dev *dev)
 		/* recalc available buffer space */
 		comp_update_buffer_produce(dma_buffer, dd->period_bytes);
 
-		buffer_ptr = dma_buffer->w_ptr;
-
 		/* make sure there is free bytes for next period */
 		if (dma_buffer->free < dd->period_bytes) {
 			trace_dai_error("xro");
@@ -110,13 +102,10 @@ static void dai_buffer_process(struct comp_dev *dev)
 		}
 	}
 
-	/* update host position (in bytes offset) for drivers */
+	/* update host position (in bytes offset) for drivers, the host
+	 * component publishes it in the stream position slot
+	 */
 	dev->position += dd->period_bytes;
-	if (dd->dai_pos) {
-		dd->dai_pos_blks += dd->period_bytes;
-		*dd->dai_pos = dd->dai_pos_blks +
-			buffer_ptr - dma_buffer->addr;
-	}
 }
 
 /* this is called by DMA driver every time descriptor has completed */
@@ -170,7 +159,7 @@ static struct comp_dev *dai_new(struct sof_ipc_comp *comp)
 
 	trace_dai("new");
 
-	dev = rzalloc(RZONE_RUNTIME, SOF_MEM_CAPS_RAM,
+	dev = rzalloc_slab(RZONE_RUNTIME, SLAB_COMP_DEV,
 		COMP_SIZE(struct sof_ipc_comp_dai));
 	if (dev == NULL)
 		return NULL;
@@ -218,8 +207,6 @@ static struct comp_dev *dai_new(struct sof_ipc_comp *comp)
 	}
 
 	dma_sg_init(&dd->config.elem_array);
-	dd->dai_pos = NULL;
-	dd->dai_pos_blks = 0;
 	dd->xrun = 0;
 	dd->pointer_init = 0;
 
@@ -254,6 +241,7 @@ static int dai_playback_params(struct comp_dev *dev)
 	struct comp_buffer *dma_buffer;
 	int err;
 	uint32_t buffer_size;
+	uint32_t periods;
 
 	/* set up DMA configuration */
 	config->direction = DMA_DIR_MEM_TO_DEV;
@@ -267,13 +255,15 @@ static int dai_playback_params(struct comp_dev *dev)
 	dma_buffer = list_first_item(&dev->bsource_list,
 		struct comp_buffer, sink_list);
 	source_config = COMP_GET_CONFIG(dma_buffer->source);
-	buffer_size = source_config->periods_sink * dd->period_bytes;
+	periods = pipeline_dma_periods(dev->pipeline,
+				       source_config->periods_sink);
+	buffer_size = periods * dd->period_bytes;
 
 	/* resize the buffer if space is available to align with period size */
 	err = buffer_set_size(dma_buffer, buffer_size);
 	if (err < 0) {
 		trace_dai_error("ep1");
-		trace_error_value(source_config->periods_sink);
+		trace_error_value(periods);
 		trace_error_value(dd->period_bytes);
 		trace_error_value(buffer_size);
 		trace_error_value(dma_buffer->alloc_size);
@@ -283,8 +273,7 @@ static int dai_playback_params(struct comp_dev *dev)
 	if (!config->elem_array.elems) {
 		err = dma_sg_alloc(&config->elem_array, RZONE_RUNTIME,
 				   config->direction,
-				   source_config->periods_sink,
-				   dd->period_bytes,
+				   periods, dd->period_bytes,
 				   (uintptr_t)(dma_buffer->r_ptr),
 				   dai_fifo(dd->dai, SOF_IPC_STREAM_PLAYBACK));
 		if (err < 0) {
@@ -304,6 +293,7 @@ static int dai_capture_params(struct comp_dev *dev)
 	struct comp_buffer *dma_buffer;
 	int err;
 	uint32_t buffer_size;
+	uint32_t periods;
 
 	/* set up DMA configuration */
 	config->direction = DMA_DIR_DEV_TO_MEM;
@@ -317,13 +307,15 @@ static int dai_capture_params(struct comp_dev *dev)
 	dma_buffer = list_first_item(&dev->bsink_list,
 		struct comp_buffer, source_list);
 	sink_config = COMP_GET_CONFIG(dma_buffer->sink);
-	buffer_size = sink_config->periods_source * dd->period_bytes;
+	periods = pipeline_dma_periods(dev->pipeline,
+				       sink_config->periods_source);
+	buffer_size = periods * dd->period_bytes;
 
 	/* resize the buffer if space is available to align with period size */
 	err = buffer_set_size(dma_buffer, buffer_size);
 	if (err < 0) {
 		trace_dai_error("ec1");
-		trace_error_value(sink_config->periods_sink);
+		trace_error_value(periods);
 		trace_error_value(dd->period_bytes);
 		trace_error_value(buffer_size);
 		trace_error_value(dma_buffer->alloc_size);
@@ -333,8 +325,7 @@ static int dai_capture_params(struct comp_dev *dev)
 	if (!config->elem_array.elems) {
 		err = dma_sg_alloc(&config->elem_array, RZONE_RUNTIME,
 				   config->direction,
-				   sink_config->periods_source,
-				   dd->period_bytes,
+				   periods, dd->period_bytes,
 				   (uintptr_t)(dma_buffer->w_ptr),
 				   dai_fifo(dd->dai, SOF_IPC_STREAM_CAPTURE));
 		if (err < 0) {
@@ -463,10 +454,6 @@ static int dai_reset(struct comp_dev *dev)
 
 	dma_sg_free(&config->elem_array);
 
-	dd->dai_pos_blks = 0;
-	if (dd->dai_pos)
-		*dd->dai_pos = 0;
-	dd->dai_pos = NULL;
 	dd->wallclock = 0;
 	dev->position = 0;
 	dd->xrun = 0;
@@ -592,6 +579,13 @@ static int dai_comp_trigger(struct comp_dev *dev, int cmd)
 		ret = dma_stop(dd->dma, dd->chan);
 		dai_trigger(dd->dai, COMP_TRIGGER_STOP, dev->params.direction);
 		break;
+	case COMP_TRIGGER_MIGRATE_OUT:
+		/* the DAI keeps running, only its DMA period events move */
+		ret = dma_migrate_out(dd->dma, dd->chan);
+		break;
+	case COMP_TRIGGER_MIGRATE_IN:
+		ret = dma_migrate_in(dd->dma, dd->chan);
+		break;
 	default:
 		break;
 	}
@@ -740,7 +734,7 @@ static void dai_cache(struct comp_dev *dev, int cmd)
 	}
 }
 
-static struct comp_driver comp_dai = {
+struct comp_driver comp_dai = {
 	.type	= SOF_COMP_DAI,
 	.ops	= {
 		.new		= dai_new,
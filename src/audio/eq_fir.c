@@ -389,7 +389,7 @@ static struct comp_dev *eq_fir_new(struct sof_ipc_comp *comp)
 		return NULL;
 	}
 
-	dev = rzalloc(RZONE_RUNTIME, SOF_MEM_CAPS_RAM,
+	dev = rzalloc_slab(RZONE_RUNTIME, SLAB_COMP_DEV,
 		      COMP_SIZE(struct sof_ipc_comp_eq_fir));
 	if (!dev)
 		return NULL;
@@ -632,7 +632,10 @@ static int eq_fir_copy(struct comp_dev *dev)
 	struct comp_data *sd = comp_get_drvdata(dev);
 	struct comp_buffer *source;
 	struct comp_buffer *sink;
-	int res;
+	uint32_t frame_bytes;
+	uint32_t frames;
+	uint32_t copied;
+	uint32_t n;
 	int nch = dev->params.channels;
 	struct fir_state_32x16 *fir = sd->fir;
 
@@ -644,26 +647,27 @@ static int eq_fir_copy(struct comp_dev *dev)
 	sink = list_first_item(&dev->bsink_list, struct comp_buffer,
 			       source_list);
 
-	/* make sure source component buffer has enough data available and that
-	 * the sink component buffer has enough free bytes for copy. Also
-	 * check for XRUNs.
-	 */
-	res = comp_buffer_can_copy_bytes(source, sink, sd->period_bytes);
-	if (res) {
-		trace_eq_error("xrn");
-		return -EIO;	/* xrun */
-	}
-
-	if (dev->frames & 1)
-		sd->eq_fir_func(fir, source, sink, dev->frames, nch);
-	else
-		sd->eq_fir_func_even(fir, source, sink, dev->frames, nch);
+	/* copy whatever source data fits in the sink, in whole frames */
+	frame_bytes = dev->frame_bytes;
+	frames = comp_buffer_get_copy_frames(source, frame_bytes,
+					     sink, frame_bytes);
+
+	/* filter up to each buffer wrap */
+	for (copied = 0; copied < frames; copied += n) {
+		n = comp_buffer_get_contig_frames(source, frame_bytes,
+						  sink, frame_bytes,
+						  frames - copied);
+		if (n & 1)
+			sd->eq_fir_func(fir, source, sink, n, nch);
+		else
+			sd->eq_fir_func_even(fir, source, sink, n, nch);
 
-	/* calc new free and available */
-	comp_update_buffer_consume(source, sd->period_bytes);
-	comp_update_buffer_produce(sink, sd->period_bytes);
+		/* calc new free and available */
+		comp_update_buffer_consume(source, n * frame_bytes);
+		comp_update_buffer_produce(sink, n * frame_bytes);
+	}
 
-	return dev->frames;
+	return frames;
 }
 
 static int eq_fir_prepare(struct comp_dev *dev)
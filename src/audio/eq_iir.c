@@ -354,7 +354,7 @@ static struct comp_dev *eq_iir_new(struct sof_ipc_comp *comp)
 		return NULL;
 	}
 
-	dev = rzalloc(RZONE_RUNTIME, SOF_MEM_CAPS_RAM,
+	dev = rzalloc_slab(RZONE_RUNTIME, SLAB_COMP_DEV,
 		      COMP_SIZE(struct sof_ipc_comp_eq_iir));
 	if (!dev)
 		return NULL;
@@ -602,7 +602,10 @@ static int eq_iir_copy(struct comp_dev *dev)
 	struct comp_data *cd = comp_get_drvdata(dev);
 	struct comp_buffer *source;
 	struct comp_buffer *sink;
-	int res;
+	uint32_t frame_bytes;
+	uint32_t frames;
+	uint32_t copied;
+	uint32_t n;
 
 	tracev_comp("cpy");
 
@@ -612,23 +615,24 @@ static int eq_iir_copy(struct comp_dev *dev)
 	sink = list_first_item(&dev->bsink_list, struct comp_buffer,
 			       source_list);
 
-	/* make sure source component buffer has enough data available and that
-	 * the sink component buffer has enough free bytes for copy. Also
-	 * check for XRUNs.
-	 */
-	res = comp_buffer_can_copy_bytes(source, sink, cd->period_bytes);
-	if (res) {
-		trace_eq_error("xrn");
-		return -EIO;	/* xrun */
+	/* copy whatever source data fits in the sink, in whole frames */
+	frame_bytes = dev->frame_bytes;
+	frames = comp_buffer_get_copy_frames(source, frame_bytes,
+					     sink, frame_bytes);
+
+	/* filter up to each buffer wrap */
+	for (copied = 0; copied < frames; copied += n) {
+		n = comp_buffer_get_contig_frames(source, frame_bytes,
+						  sink, frame_bytes,
+						  frames - copied);
+		cd->eq_iir_func(dev, source, sink, n);
+
+		/* calc new free and available */
+		comp_update_buffer_consume(source, n * frame_bytes);
+		comp_update_buffer_produce(sink, n * frame_bytes);
 	}
 
-	cd->eq_iir_func(dev, source, sink, dev->frames);
-
-	/* calc new free and available */
-	comp_update_buffer_consume(source, cd->period_bytes);
-	comp_update_buffer_produce(sink, cd->period_bytes);
-
-	return dev->frames;
+	return frames;
 }
 
 static int eq_iir_prepare(struct comp_dev *dev)
@@ -64,6 +64,16 @@
 #else
 #error "No HIFIEP or HIFI3 found. Cannot build FIR module."
 #endif
+#elif defined OPS_HIFI3_EMU
+/* GCC with host emulation of HiFi3 intrinsics */
+#define FIR_GENERIC	0
+#define FIR_HIFIEP	0
+#define FIR_HIFI3	1
+#elif defined OPS_HIFI2EP_EMU
+/* GCC with host emulation of HiFi2 EP intrinsics */
+#define FIR_GENERIC	0
+#define FIR_HIFIEP	1
+#define FIR_HIFI3	0
 #else
 /* GCC */
 #define FIR_GENERIC	1
@@ -42,6 +42,7 @@
 #include <sof/dma.h>
 #include <sof/ipc.h>
 #include <sof/wait.h>
+#include <sof/math/numbers.h>
 #include <sof/audio/component.h>
 #include <sof/audio/pipeline.h>
 #include <platform/dma.h>
@@ -52,13 +53,18 @@
 #define tracev_host(__e)	tracev_event(TRACE_CLASS_HOST, __e)
 #define trace_host_error(__e)	trace_error(TRACE_CLASS_HOST, __e)
 
+/* max elements of the persistent descriptor ring, larger rings fall back
+ * to programming the DMA every period
+ */
+#define HOST_RING_ELEMS_MAX	256
+
 /**
  * \brief Host buffer info.
  */
 struct hc_buf {
 	struct dma_sg_elem_array elem_array; /**< array of SG elements */
 	uint32_t current;		/**< index of current element */
-	uint32_t current_end;
+	uintptr_t current_end;
 };
 
 /**
@@ -69,6 +75,12 @@ struct hc_buf {
  * multiple of host_period_bytes.
  *
  * host_size is the host buffer size (in bytes) specified in the IPC parameters.
+ *
+ * Without DMA gateway the transfers of a whole cycle through the host and
+ * local buffers are set up once in ring when they fit. The DMA then stops
+ * at the end of every period and is restarted by dma_copy() without
+ * being reprogrammed. Otherwise the single element in config is moved
+ * along and programmed every period.
  */
 struct host_data {
 	/* local DMA config */
@@ -96,6 +108,10 @@ struct host_data {
 	struct hc_buf *sink;
 	uint32_t split_remaining;
 	uint32_t next_inc;
+	struct dma_sg_elem_array ring;	/**< transfers of a cycle */
+	uint32_t ring_index;	/**< ring element being transferred */
+	uint32_t ring_bytes;	/**< bytes done in the current period */
+	uint32_t ring_started;	/**< channel was started on this ring */
 #endif
 
 	/* stream info */
@@ -116,6 +132,132 @@ static inline struct dma_sg_elem *next_buffer(struct hc_buf *hc)
 	return hc->elem_array.elems + hc->current;
 }
 
+/* move to the next ring element, the DMA stops at the end of a period */
+static void host_ring_next(struct host_data *hd, struct dma_sg_elem *next)
+{
+	hd->ring_bytes += hd->ring.elems[hd->ring_index].size;
+
+	if (++hd->ring_index == hd->ring.count)
+		hd->ring_index = 0;
+
+	/* split period, continue with the next element */
+	if (hd->ring_bytes < hd->period_bytes)
+		return;
+
+	hd->ring_bytes = 0;
+	next->size = DMA_RELOAD_END;
+
+	/* let any waiters know we have completed */
+	wait_completed(&hd->complete);
+}
+
+/*
+ * Walk the transfers of the given number of periods from the start of the
+ * source and sink buffers, splitting them at element boundaries like
+ * host_dma_cb() does, and return the number of transfers. The transfers
+ * are stored in elems unless it is NULL.
+ */
+static uint32_t host_ring_walk(struct host_data *hd, uint32_t periods,
+			       struct dma_sg_elem *elems)
+{
+	struct dma_sg_elem_array *source = &hd->source->elem_array;
+	struct dma_sg_elem_array *sink = &hd->sink->elem_array;
+	struct dma_sg_elem *src = source->elems;
+	struct dma_sg_elem *dest = sink->elems;
+	uintptr_t src_pos = src->src;
+	uintptr_t dest_pos = dest->dest;
+	uint32_t remaining;
+	uint32_t count = 0;
+	uint32_t size;
+	uint32_t i;
+
+	for (i = 0; i < periods; i++) {
+		for (remaining = hd->period_bytes; remaining;
+		     remaining -= size) {
+			size = MIN(remaining, src->src + src->size - src_pos);
+			size = MIN(size, dest->dest + dest->size - dest_pos);
+
+			if (elems) {
+				elems[count].src = src_pos;
+				elems[count].dest = dest_pos;
+				elems[count].size = size;
+			}
+			count++;
+
+			src_pos += size;
+			if (src_pos == src->src + src->size) {
+				if (++src == source->elems + source->count)
+					src = source->elems;
+				src_pos = src->src;
+			}
+
+			dest_pos += size;
+			if (dest_pos == dest->dest + dest->size) {
+				if (++dest == sink->elems + sink->count)
+					dest = sink->elems;
+				dest_pos = dest->dest;
+			}
+		}
+	}
+
+	return count;
+}
+
+/* build the transfers of a full cycle through host and local buffers */
+static int host_ring_create(struct comp_dev *dev)
+{
+	struct host_data *hd = comp_get_drvdata(dev);
+	uint32_t host_periods = hd->host_size / hd->period_bytes;
+	uint32_t periods;
+	uint32_t count;
+
+	/* both buffers are back at their start after this many periods */
+	periods = host_periods % hd->period_count ?
+		host_periods * hd->period_count : host_periods;
+
+	count = host_ring_walk(hd, periods, NULL);
+	if (count > HOST_RING_ELEMS_MAX) {
+		trace_host("rng");
+		trace_value(count);
+		return -E2BIG;
+	}
+
+	hd->ring.elems = rzalloc(RZONE_RUNTIME, SOF_MEM_CAPS_RAM,
+				 sizeof(struct dma_sg_elem) * count);
+	if (!hd->ring.elems)
+		return -ENOMEM;
+
+	hd->ring.count = host_ring_walk(hd, periods, hd->ring.elems);
+	hd->ring_index = 0;
+	hd->ring_bytes = 0;
+	hd->ring_started = 0;
+
+	return 0;
+}
+
+/* program the ring once, the channel is restarted from it every period */
+static int host_ring_set_config(struct comp_dev *dev)
+{
+	struct host_data *hd = comp_get_drvdata(dev);
+	struct dma_sg_config config = hd->config;
+	int err;
+
+	err = host_ring_create(dev);
+	if (err < 0)
+		return err;
+
+	config.cyclic = 1;
+	config.elem_array = hd->ring;
+
+	err = dma_set_config(hd->dma, hd->chan, &config);
+	if (err < 0) {
+		trace_host_error("eRc");
+		dma_sg_free(&hd->ring);
+	}
+
+	return err;
+}
+
 #endif
 
 /*
@@ -140,7 +282,12 @@ static void host_dma_cb(void *data, uint32_t type, struct dma_sg_elem *next)
 	uint32_t period_bytes = hd->period_bytes;
 #endif
 
-	local_elem = hd->config.elem_array.elems;
+#if !defined CONFIG_DMA_GW
+	if (hd->ring.count)
+		local_elem = hd->ring.elems + hd->ring_index;
+	else
+#endif
+		local_elem = hd->config.elem_array.elems;
 
 	tracev_host("irq");
 
@@ -162,23 +309,32 @@ static void host_dma_cb(void *data, uint32_t type, struct dma_sg_elem *next)
 	if (hd->local_pos >= hd->host_size)
 		hd->local_pos = 0;
 
+	/* timestamped position for the host, updates position first
+	 * by calling ops.position()
+	 */
+	pipeline_get_timestamp(dev->pipeline, dev, &hd->posn);
+
 	/* NO_IRQ mode if host_period_size == 0 */
-	if (dev->params.host_period_bytes != 0) {
+	if (dev->params.host_period_bytes != 0)
 		hd->report_pos += local_elem->size;
 
-		/* send IPC message to driver if needed */
-		if (hd->report_pos >= dev->params.host_period_bytes) {
-			hd->report_pos = 0;
-
-			/* send timestamped position to host
-			 * (updates position first, by calling ops.position())
-			 */
-			pipeline_get_timestamp(dev->pipeline, dev, &hd->posn);
-			ipc_stream_send_position(dev, &hd->posn);
-		}
+	/* the position slot is updated every period, the IPC message is
+	 * only sent every host period
+	 */
+	if (dev->params.host_period_bytes != 0 &&
+	    hd->report_pos >= dev->params.host_period_bytes) {
+		hd->report_pos = 0;
+		ipc_stream_send_position(dev, &hd->posn);
+	} else {
+		ipc_stream_publish_position(dev, &hd->posn);
 	}
 
 #if !defined CONFIG_DMA_GW
+	if (hd->ring.count) {
+		host_ring_next(hd, next);
+		return;
+	}
+
 	/* update src and dest positions and check for overflow */
 	local_elem->src += local_elem->size;
 	local_elem->dest += local_elem->size;
@@ -312,6 +468,12 @@ static int host_trigger(struct comp_dev *dev, int cmd)
 			}
 		}
 		break;
+	case COMP_TRIGGER_MIGRATE_OUT:
+		ret = dma_migrate_out(hd->dma, hd->chan);
+		break;
+	case COMP_TRIGGER_MIGRATE_IN:
+		ret = dma_migrate_in(hd->dma, hd->chan);
+		break;
 	default:
 		break;
 	}
@@ -333,7 +495,7 @@ static struct comp_dev *host_new(struct sof_ipc_comp *comp)
 
 	trace_host("new");
 
-	dev = rzalloc(RZONE_RUNTIME, SOF_MEM_CAPS_RAM,
+	dev = rzalloc_slab(RZONE_RUNTIME, SLAB_COMP_DEV,
 		COMP_SIZE(struct sof_ipc_comp_host));
 	if (dev == NULL)
 		return NULL;
@@ -369,6 +531,7 @@ static struct comp_dev *host_new(struct sof_ipc_comp *comp)
 #else
 	dma_sg_init(&hd->host.elem_array);
 	dma_sg_init(&hd->local.elem_array);
+	dma_sg_init(&hd->ring);
 
 	err = dma_sg_alloc(&hd->config.elem_array, RZONE_RUNTIME,
 			   dir, 1, 0, 0, 0);
@@ -397,6 +560,7 @@ static void host_free(struct comp_dev *dev)
 
 #if !defined CONFIG_DMA_GW
 	dma_channel_put(hd->dma, hd->chan);
+	dma_sg_free(&hd->ring);
 #endif
 	dma_put(hd->dma);
 
@@ -471,6 +635,10 @@ static int host_params(struct comp_dev *dev)
 		hd->period_count = cconfig->periods_source;
 	}
 
+	/* low latency pipelines buffer one period plus margin */
+	hd->period_count = pipeline_dma_periods(dev->pipeline,
+						hd->period_count);
+
 	/* validate period count */
 	if (hd->period_count == 0) {
 		trace_host_error("eS0");
@@ -531,6 +699,10 @@ static int host_params(struct comp_dev *dev)
 		dma_channel_put(hd->dma, hd->chan);
 		return err;
 	}
+#else
+	/* a failed ring falls back to programming every period */
+	dma_sg_free(&hd->ring);
+	host_ring_set_config(dev);
 #endif
 	/* set up callback */
 	dma_set_cb(hd->dma, hd->chan, DMA_IRQ_TYPE_LLIST,
@@ -554,6 +726,12 @@ static int host_prepare(struct comp_dev *dev)
 	hd->report_pos = 0;
 #if !defined CONFIG_DMA_GW
 	hd->split_remaining = 0;
+
+	/* transfers start again from the start of both buffers */
+	host_elements_reset(dev);
+	hd->ring_index = 0;
+	hd->ring_bytes = 0;
+	hd->ring_started = 0;
 #endif
 	hd->pointer_init = 0;
 	dev->position = 0;
@@ -575,6 +753,15 @@ static int host_pointer_reset(struct comp_dev *dev)
 
 static int host_stop(struct comp_dev *dev)
 {
+#if !defined CONFIG_DMA_GW
+	struct host_data *hd = comp_get_drvdata(dev);
+
+	/* rewind the channel to the first ring element */
+	if (hd->ring.count && hd->ring_started) {
+		hd->ring_started = 0;
+		return dma_stop(hd->dma, hd->chan);
+	}
+#endif
 	return 0;
 }
 
@@ -614,6 +801,9 @@ static int host_reset(struct comp_dev *dev)
 
 	/* free all local DMA elements */
 	dma_sg_free(&hd->local.elem_array);
+
+	/* free the descriptor ring */
+	dma_sg_free(&hd->ring);
 #endif
 
 #if defined CONFIG_DMA_GW
@@ -645,6 +835,7 @@ static int host_copy_int(struct comp_dev *dev, bool preload_run)
 {
 	struct host_data *hd = comp_get_drvdata(dev);
 	struct dma_sg_elem *local_elem;
+	uint32_t copy_bytes;
 	int ret;
 
 	tracev_host("cpy");
@@ -653,17 +844,24 @@ static int host_copy_int(struct comp_dev *dev, bool preload_run)
 		return 0;
 
 	local_elem = hd->config.elem_array.elems;
+	copy_bytes = local_elem->size;
+
+#if !defined CONFIG_DMA_GW
+	/* ring transfers always cover a whole period */
+	if (hd->ring.count)
+		copy_bytes = hd->period_bytes;
+#endif
 
 	/* enough free or avail to copy ? */
 	if (dev->params.direction == SOF_IPC_STREAM_PLAYBACK) {
-		if (hd->dma_buffer->free < local_elem->size) {
+		if (hd->dma_buffer->free < copy_bytes) {
 			/* buffer is enough avail, just return. */
 			trace_host("Bea");
 			return 0;
 		}
 	} else {
 
-		if (hd->dma_buffer->avail < local_elem->size) {
+		if (hd->dma_buffer->avail < copy_bytes) {
 			/* buffer is enough empty, just return. */
 			trace_host("Bee");
 			return 0;
@@ -681,11 +879,21 @@ static int host_copy_int(struct comp_dev *dev, bool preload_run)
 
 	/* note: update() moved to callback */
 #else
-	/* do DMA transfer */
-	ret = dma_set_config(hd->dma, hd->chan, &hd->config);
-	if (ret < 0)
-		goto out;
-	ret = dma_start(hd->dma, hd->chan);
+	if (hd->ring.count && hd->ring_started) {
+		/* restart the channel on the programmed ring */
+		ret = dma_copy(hd->dma, hd->chan, hd->period_bytes, 0);
+	} else {
+		/* program the next transfer unless the ring is used */
+		if (!hd->ring.count) {
+			ret = dma_set_config(hd->dma, hd->chan, &hd->config);
+			if (ret < 0)
+				goto out;
+		}
+
+		/* do DMA transfer */
+		ret = dma_start(hd->dma, hd->chan);
+		hd->ring_started = ret == 0;
+	}
 	if (ret < 0)
 		goto out;
 #endif
@@ -712,6 +920,7 @@ static void host_cache(struct comp_dev *dev, int cmd)
 
 #if !defined CONFIG_DMA_GW
 		dma_sg_cache_wb_inv(&hd->local.elem_array);
+		dma_sg_cache_wb_inv(&hd->ring);
 #endif
 
 		dcache_writeback_invalidate_region(hd->dma, sizeof(*hd->dma));
@@ -730,6 +939,7 @@ static void host_cache(struct comp_dev *dev, int cmd)
 
 #if !defined CONFIG_DMA_GW
 		dma_sg_cache_inv(&hd->local.elem_array);
+		dma_sg_cache_inv(&hd->ring);
 #endif
 
 		dma_sg_cache_inv(&hd->config.elem_array);
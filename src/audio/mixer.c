@@ -37,6 +37,7 @@
 #include <sof/alloc.h>
 #include <sof/audio/component.h>
 #include <sof/audio/format.h>
+#include <sof/math/numbers.h>
 
 #define trace_mixer(__e)	trace_event(TRACE_CLASS_MIXER, __e)
 #define tracev_mixer(__e)	tracev_event(TRACE_CLASS_MIXER, __e)
@@ -86,7 +87,7 @@ static struct comp_dev *mixer_new(struct sof_ipc_comp *comp)
 	struct mixer_data *md;
 
 	trace_mixer("new");
-	dev = rzalloc(RZONE_RUNTIME, SOF_MEM_CAPS_RAM,
+	dev = rzalloc_slab(RZONE_RUNTIME, SLAB_COMP_DEV,
 		COMP_SIZE(struct sof_ipc_comp_mixer));
 	if (dev == NULL)
 		return NULL;
@@ -208,7 +209,8 @@ static int mixer_trigger(struct comp_dev *dev, int cmd)
 }
 
 /*
- * Mix N source PCM streams to one sink PCM stream. Frames copied is constant.
+ * Mix N source PCM streams to one sink PCM stream. Frames copied is the
+ * minimum available in the sources and free in the sink.
  */
 static int mixer_copy(struct comp_dev *dev)
 {
@@ -219,7 +221,9 @@ static int mixer_copy(struct comp_dev *dev)
 	struct list_item *blist;
 	int32_t i = 0;
 	int32_t num_mix_sources = 0;
-	int res;
+	uint32_t frames;
+	uint32_t copied;
+	uint32_t n;
 
 	tracev_mixer("cpy");
 
@@ -242,36 +246,39 @@ static int mixer_copy(struct comp_dev *dev)
 	if (num_mix_sources == 0)
 		return 0;
 
-	/* make sure no sources have underruns */
-	for (i = 0; i < num_mix_sources; i++) {
-
-		/* make sure source component buffer has enough data available
-		 * and that the sink component buffer has enough free bytes
-		 * for copy. Also check for XRUNs */
-		res = comp_buffer_can_copy_bytes(sources[i], sink, md->period_bytes);
-		if (res < 0) {
-			trace_mixer_error("xru");
-			comp_underrun(dev, sources[i], sources[i]->avail,
-				md->period_bytes);
-		} else if (res > 0) {
-			trace_mixer_error("xro");
-			comp_overrun(dev, sources[i], sink->free,
-				md->period_bytes);
-		}
+	/* mix the frames all sources have available and the sink has room for,
+	 * a source with less than a period makes the mixer wait for it.
+	 */
+	frames = comp_buffer_get_copy_frames(sources[0], dev->frame_bytes,
+					     sink, dev->frame_bytes);
+	for (i = 1; i < num_mix_sources; i++)
+		frames = MIN(frames,
+			     comp_buffer_get_copy_frames(sources[i],
+							 dev->frame_bytes, sink,
+							 dev->frame_bytes));
+
+	/* mix streams up to each buffer wrap */
+	for (copied = 0; copied < frames; copied += n) {
+		n = frames - copied;
+		for (i = 0; i < num_mix_sources; i++)
+			n = comp_buffer_get_contig_frames(sources[i],
+							  dev->frame_bytes,
+							  sink,
+							  dev->frame_bytes, n);
+
+		md->mix_func(dev, sink, sources, num_mix_sources, n);
+
+		/* update source buffer pointers for overflow */
+		for (i = num_mix_sources - 1; i >= 0; i--)
+			comp_update_buffer_consume(sources[i],
+						   n * dev->frame_bytes);
+
+		/* calc new free and available */
+		comp_update_buffer_produce(sink, n * dev->frame_bytes);
 	}
 
-	/* mix streams */
-	md->mix_func(dev, sink, sources, i, dev->frames);
-
-	/* update source buffer pointers for overflow */
-	for (i = --num_mix_sources; i >= 0; i--)
-		comp_update_buffer_consume(sources[i], md->period_bytes);
-
-	/* calc new free and available */
-	comp_update_buffer_produce(sink, md->period_bytes);
-
 	/* number of frames sent downstream */
-	return dev->frames;
+	return frames;
 }
 
 static int mixer_reset(struct comp_dev *dev)
@@ -38,10 +38,12 @@
 #include <sof/stream.h>
 #include <sof/alloc.h>
 #include <sof/debug.h>
+#include <sof/clk.h>
 #include <sof/ipc.h>
 #include <sof/lock.h>
 #include <platform/timer.h>
 #include <platform/platform.h>
+#include <platform/clk.h>
 #include <sof/audio/component.h>
 #include <sof/audio/pipeline.h>
 #include <sof/cpu.h>
@@ -75,6 +77,7 @@ static void connect_upstream(struct pipeline *p, struct comp_dev *start,
 	/* complete component init */
 	current->pipeline = p;
 	current->frames = p->ipc_pipe.frames_per_sched;
+	mm_pm_dirty(current);
 
 	/* we are an endpoint if we have 0 source components */
 	if (list_is_empty(&current->bsource_list)) {
@@ -115,6 +118,7 @@ static void connect_downstream(struct pipeline *p, struct comp_dev *start,
 	/* complete component init */
 	current->pipeline = p;
 	current->frames = p->ipc_pipe.frames_per_sched;
+	mm_pm_dirty(current);
 
 	/* we are an endpoint if we have 0 sink components */
 	if (list_is_empty(&current->bsink_list)) {
@@ -146,6 +150,7 @@ static void disconnect_upstream(struct pipeline *p, struct comp_dev *start,
 
 	/* complete component init */
 	current->pipeline = NULL;
+	mm_pm_dirty(current);
 
 	/* now run this operation upstream */
 	list_for_item(clist, &current->bsource_list) {
@@ -162,6 +167,7 @@ static void disconnect_upstream(struct pipeline *p, struct comp_dev *start,
 
 	/* disconnect source from buffer */
 	spin_lock(&current->lock);
+	mm_pm_dirty_list(&current->bsource_list);
 	list_item_del_init(&current->bsource_list);
 	spin_unlock(&current->lock);
 }
@@ -175,6 +181,7 @@ static void disconnect_downstream(struct pipeline *p, struct comp_dev *start,
 
 	/* complete component init */
 	current->pipeline = NULL;
+	mm_pm_dirty(current);
 
 	/* now run this operation downstream */
 	list_for_item(clist, &current->bsink_list) {
@@ -191,6 +198,7 @@ static void disconnect_downstream(struct pipeline *p, struct comp_dev *start,
 
 	/* disconnect source from buffer */
 	spin_lock(&current->lock);
+	mm_pm_dirty_list(&current->bsink_list);
 	list_item_del_init(&current->bsink_list);
 	spin_unlock(&current->lock);
 }
@@ -212,6 +220,7 @@ static void pipeline_trigger_sched_comp(struct pipeline *p,
 	case COMP_TRIGGER_RELEASE:
 	case COMP_TRIGGER_START:
 		p->xrun_bytes = 0;
+		p->xrun_comp = NULL;
 
 		/* playback pipelines need scheduled now, capture pipelines are
 		 * scheduled once their initial DMA period is filled by the DAI
@@ -230,6 +239,62 @@ static void pipeline_trigger_sched_comp(struct pipeline *p,
 	default:
 		break;
 	}
+
+	/* streams are stopped before D3, so this also saves the xrun and
+	 * catch up state the pipeline task updated while running
+	 */
+	mm_pm_dirty(p);
+}
+
+/* DMA IRQ, scheduler and task switch passes of every period */
+#define PIPELINE_LL_PASSES	3
+
+/* cycles at the maximum core clock of the scheduler clock ticks */
+static uint64_t pipeline_ll_cycles(uint64_t ticks)
+{
+	return ticks * CLK_MAX_CPU_HZ / 1000 /
+		clock_ms_to_ticks(PLATFORM_SCHED_CLOCK, 1);
+}
+
+/* cycles of the period work with the scheduling overhead */
+static uint64_t pipeline_ll_work(struct sof_ipc_pipe_new *pipe_desc)
+{
+	return pipe_desc->mips +
+		pipeline_ll_cycles(PIPELINE_LL_PASSES * PLATFORM_SCHEDULE_COST);
+}
+
+int pipeline_ll_budget(struct sof_ipc_pipe_new *pipe_desc)
+{
+	uint64_t budget;
+
+	if (pipe_desc->frames_per_sched &&
+	    pipe_desc->frames_per_sched < PIPELINE_LL_FRAMES_MIN)
+		return -EINVAL;
+
+	/* cycles of the period the pipeline may use */
+	budget = (uint64_t)CLK_MAX_CPU_HZ / 1000000 * pipe_desc->deadline *
+		PIPELINE_LL_LOAD_MAX / 100;
+
+	if (pipeline_ll_work(pipe_desc) > budget)
+		return -EINVAL;
+
+	return 0;
+}
+
+/*
+ * The DMA works on one period while the next one is made. That one must be
+ * ready within the DMA IRQ margin and the period work, so the buffer holds
+ * the period in flight and the periods covering both.
+ */
+uint32_t pipeline_ll_periods(struct sof_ipc_pipe_new *pipe_desc)
+{
+	uint64_t cycles_per_us = CLK_MAX_CPU_HZ / 1000000;
+	uint64_t lead;
+
+	lead = PIPELINE_LL_MARGIN + (pipeline_ll_work(pipe_desc) +
+				     cycles_per_us - 1) / cycles_per_us;
+
+	return 1 + (lead + pipe_desc->deadline - 1) / pipe_desc->deadline;
 }
 
 /* create new pipeline - returns pipeline id or negative error */
@@ -237,11 +302,23 @@ struct pipeline *pipeline_new(struct sof_ipc_pipe_new *pipe_desc,
 	struct comp_dev *cd)
 {
 	struct pipeline *p;
+	int priority = pipe_desc->priority;
 
 	trace_pipe("new");
 
+	/* low latency pipelines must fit their overhead budget */
+	if (pipeline_is_ll(pipe_desc)) {
+		if (pipeline_ll_budget(pipe_desc) < 0) {
+			trace_pipe_error("eLL");
+			trace_error_value(pipe_desc->deadline);
+			trace_error_value(pipe_desc->mips);
+			return NULL;
+		}
+		priority = TASK_PRI_LL;
+	}
+
 	/* allocate new pipeline */
-	p = rzalloc(RZONE_RUNTIME, SOF_MEM_CAPS_RAM, sizeof(*p));
+	p = rzalloc_slab(RZONE_RUNTIME, SLAB_PIPELINE, sizeof(*p));
 	if (p == NULL) {
 		trace_pipe_error("ePN");
 		return NULL;
@@ -251,8 +328,7 @@ struct pipeline *pipeline_new(struct sof_ipc_pipe_new *pipe_desc,
 	p->sched_comp = cd;
 	p->status = COMP_STATE_INIT;
 	schedule_task_init(&p->pipe_task, pipeline_task, p);
-	schedule_task_config(&p->pipe_task, pipe_desc->priority,
-		pipe_desc->core);
+	schedule_task_config(&p->pipe_task, priority, pipe_desc->core);
 	list_init(&p->comp_list);
 	list_init(&p->buffer_list);
 	spinlock_init(&p->lock);
@@ -264,6 +340,8 @@ struct pipeline *pipeline_new(struct sof_ipc_pipe_new *pipe_desc,
 /* pipelines must be inactive */
 int pipeline_free(struct pipeline *p)
 {
+	int pipeline_id = p->ipc_pipe.pipeline_id;
+
 	trace_pipe("fre");
 
 	/* make sure we are not in use */
@@ -279,8 +357,9 @@ int pipeline_free(struct pipeline *p)
 	disconnect_downstream(p, p->sched_comp, p->sched_comp);
 	disconnect_upstream(p, p->sched_comp, p->sched_comp);
 
-	/* now free the pipeline */
+	/* now free the pipeline and its arena */
 	rfree(p);
+	arena_release(pipeline_id);
 
 	return 0;
 }
@@ -302,6 +381,7 @@ int pipeline_complete(struct pipeline *p)
 	connect_downstream(p, p->sched_comp, p->sched_comp);
 	connect_upstream(p, p->sched_comp, p->sched_comp);
 	p->status = COMP_STATE_READY;
+	mm_pm_dirty(p);
 	return 0;
 }
 
@@ -315,6 +395,7 @@ int pipeline_comp_connect(struct pipeline *p, struct comp_dev *source_comp,
 	spin_lock(&source_comp->lock);
 	list_item_prepend(&sink_buffer->source_list, &source_comp->bsink_list);
 	sink_buffer->source = source_comp;
+	mm_pm_dirty_list(&sink_buffer->source_list);
 	spin_unlock(&source_comp->lock);
 
 	/* connect the components */
@@ -336,6 +417,7 @@ int pipeline_buffer_connect(struct pipeline *p,
 	spin_lock(&sink_comp->lock);
 	list_item_prepend(&source_buffer->sink_list, &sink_comp->bsource_list);
 	source_buffer->sink = sink_comp;
+	mm_pm_dirty_list(&source_buffer->sink_list);
 	spin_unlock(&sink_comp->lock);
 
 	/* connect the components */
@@ -398,6 +480,8 @@ static int component_op_downstream(struct op_data *op_data,
 		return -EINVAL;
 	}
 
+	comp_pm_dirty(current);
+
 	/* don't walk the graph any further if this component fails */
 	if (err < 0) {
 		trace_pipe_error("eOp");
@@ -480,6 +564,8 @@ static int component_op_upstream(struct op_data *op_data,
 		return -EINVAL;
 	}
 
+	comp_pm_dirty(current);
+
 	/* don't walk the graph any further if this component fails */
 	if (err < 0) {
 		trace_pipe_error("eOp");
@@ -519,6 +605,15 @@ static int component_prepare_buffers_upstream(struct comp_dev *start,
 	/* component copy/process to downstream */
 	if (current != start && buffer != NULL) {
 
+		/* sizes are final once all components are prepared */
+		if (comp_buffer_check_frames(buffer,
+					     buffer->source->frame_bytes) < 0) {
+			trace_pipe_error("eBF");
+			trace_error_value(buffer->size);
+			trace_error_value(buffer->source->frame_bytes);
+			return -EINVAL;
+		}
+
 		buffer_reset_pos(buffer);
 
 		/* stop going downstream if we reach an end point in this pipeline */
@@ -559,6 +654,15 @@ static int component_prepare_buffers_downstream(struct comp_dev *start,
 	/* component copy/process to downstream */
 	if (current != start && buffer != NULL) {
 
+		/* sizes are final once all components are prepared */
+		if (comp_buffer_check_frames(buffer,
+					     buffer->source->frame_bytes) < 0) {
+			trace_pipe_error("eBF");
+			trace_error_value(buffer->size);
+			trace_error_value(buffer->source->frame_bytes);
+			return -EINVAL;
+		}
+
 		buffer_reset_pos(buffer);
 
 		/* stop going downstream if we reach an end point in this pipeline */
@@ -610,17 +714,21 @@ int pipeline_prepare(struct pipeline *p, struct comp_dev *dev)
 			goto out;
 
 		/* set up reader and writer positions */
-		component_prepare_buffers_downstream(dev, dev, NULL);
+		ret = component_prepare_buffers_downstream(dev, dev, NULL);
 	} else {
 		ret = component_op_upstream(&op_data, dev, dev, NULL);
 		if (ret < 0)
 			goto out;
 
 		/* set up reader and writer positions */
-		component_prepare_buffers_upstream(dev, dev, NULL);
+		ret = component_prepare_buffers_upstream(dev, dev, NULL);
 	}
 
+	if (ret < 0)
+		goto out;
+
 	p->status = COMP_STATE_PREPARE;
+	mm_pm_dirty(p);
 out:
 	spin_unlock_irq(&p->lock, flags);
 	return ret;
@@ -630,7 +738,6 @@ static void component_cache_downstream(int cmd, struct comp_dev *start,
 				       struct comp_dev *current,
 				       struct comp_dev *previous)
 {
-	cache_command cache_cmd = comp_get_cache_command(cmd);
 	struct list_item *clist;
 	struct comp_buffer *buffer;
 
@@ -644,8 +751,7 @@ static void component_cache_downstream(int cmd, struct comp_dev *start,
 	list_for_item(clist, &current->bsink_list) {
 		buffer = container_of(clist, struct comp_buffer, source_list);
 
-		if (cache_cmd)
-			cache_cmd(buffer, sizeof(*buffer));
+		buffer_cache(buffer, cmd);
 
 		/* don't go downstream if this component is not connected */
 		if (!buffer->connected)
@@ -659,7 +765,6 @@ static void component_cache_upstream(int cmd, struct comp_dev *start,
 				     struct comp_dev *current,
 				     struct comp_dev *previous)
 {
-	cache_command cache_cmd = comp_get_cache_command(cmd);
 	struct list_item *clist;
 	struct comp_buffer *buffer;
 
@@ -673,8 +778,7 @@ static void component_cache_upstream(int cmd, struct comp_dev *start,
 	list_for_item(clist, &current->bsource_list) {
 		buffer = container_of(clist, struct comp_buffer, sink_list);
 
-		if (cache_cmd)
-			cache_cmd(buffer, sizeof(*buffer));
+		buffer_cache(buffer, cmd);
 
 		/* don't go upstream if this component is not connected */
 		if (!buffer->connected)
@@ -780,6 +884,143 @@ int pipeline_trigger(struct pipeline *p, struct comp_dev *host, int cmd)
 	return ret;
 }
 
+/*
+ * Pipeline migration. The owning core hands the pipeline over between two
+ * periods: it moves the DMA period events of its host and DAI components
+ * off this core and changes the pipeline task core, then the new core takes
+ * the DMA period events. The DMA keeps running, so a period event raised
+ * meanwhile is taken by the new core and the stream does not stop. The
+ * master core drives both halves over IDC.
+ */
+
+/* a period is in progress from its DMA event until the task completes */
+static inline int pipeline_in_period(struct pipeline *p)
+{
+	return p->pipe_task.state == TASK_STATE_QUEUED ||
+		p->pipe_task.state == TASK_STATE_RUNNING ||
+		p->pipe_task.state == TASK_STATE_PREEMPTED;
+}
+
+/* hand pipeline over to core between two periods on its own core */
+int pipeline_migrate_out(struct pipeline *p, int core)
+{
+	uint32_t flags;
+	int ret;
+
+	trace_pipe("mgO");
+
+	/* only the owning core takes the pipeline DMA events */
+	if (p->ipc_pipe.core != cpu_get_id())
+		return -EINVAL;
+
+	/* no DMA event may start a period until the events have moved */
+	flags = interrupt_global_disable();
+
+	/* a period in progress completes on this core */
+	if (pipeline_in_period(p)) {
+		ret = -EBUSY;
+		goto out;
+	}
+
+	ret = pipeline_trigger(p, p->source_comp, COMP_TRIGGER_MIGRATE_OUT);
+	if (ret < 0) {
+		trace_pipe_error("mg0");
+		trace_error_value(ret);
+
+		/* keep the events of the components already moved out */
+		pipeline_trigger(p, p->source_comp, COMP_TRIGGER_MIGRATE_IN);
+		goto out;
+	}
+
+	p->ipc_pipe.core = core;
+	schedule_task_config(&p->pipe_task, p->pipe_task.priority, core);
+
+	/* the new core reads the pipeline from memory */
+	pipeline_cache(p, p->source_comp, COMP_CACHE_WRITEBACK_INV);
+
+out:
+	interrupt_global_enable(flags);
+	return ret;
+}
+
+/* take over a pipeline handed to this core and its DMA events */
+int pipeline_migrate_in(struct pipeline *p)
+{
+	int ret;
+
+	trace_pipe("mgI");
+
+	dcache_invalidate_region(p, sizeof(*p));
+	pipeline_cache(p, p->source_comp, COMP_CACHE_INVALIDATE);
+
+	if (p->ipc_pipe.core != cpu_get_id())
+		return -EINVAL;
+
+	p->migrations++;
+
+	ret = pipeline_trigger(p, p->source_comp, COMP_TRIGGER_MIGRATE_IN);
+	if (ret < 0) {
+		trace_pipe_error("mg1");
+		trace_error_value(ret);
+	}
+
+	return ret;
+}
+
+static int pipeline_migrate_on_core(struct pipeline *p, uint32_t type,
+				    int on_core, int core)
+{
+	struct idc_msg migrate = { type,
+		IDC_MSG_PPL_MIGRATE_EXT(p->ipc_pipe.comp_id, core), on_core };
+
+	if (on_core != cpu_get_id())
+		return idc_send_msg(&migrate, IDC_BLOCKING);
+
+	if (type == IDC_MSG_PPL_MIGRATE_OUT)
+		return pipeline_migrate_out(p, core);
+
+	return pipeline_migrate_in(p);
+}
+
+/* move an active pipeline to core, called on the master core */
+int pipeline_migrate(struct pipeline *p, int core)
+{
+	int old_core = p->ipc_pipe.core;
+	int ret;
+
+	trace_pipe("mig");
+	trace_value((p->ipc_pipe.comp_id << 16) | (old_core << 8) | core);
+
+	if (core == old_core)
+		return 0;
+
+	if (p->status != COMP_STATE_ACTIVE || !cpu_is_core_enabled(core))
+		return -EINVAL;
+
+	ret = pipeline_migrate_on_core(p, IDC_MSG_PPL_MIGRATE_OUT, old_core,
+				       core);
+	if (ret < 0)
+		goto err;
+
+	/* IDC returns no result, the pipeline tells if it was handed over */
+	dcache_invalidate_region(p, sizeof(*p));
+	if (p->ipc_pipe.core != core) {
+		ret = -EBUSY;
+		goto err;
+	}
+
+	ret = pipeline_migrate_on_core(p, IDC_MSG_PPL_MIGRATE_IN, core, core);
+	if (ret < 0)
+		goto err;
+
+	return 0;
+
+err:
+	trace_pipe_error("mgE");
+	trace_error_value(ret);
+	return ret;
+}
+
 /*
  * Send pipeline component params from host to endpoints.
  * Params always start at host (PCM) and go downstream for playback and
@@ -857,6 +1098,28 @@ int pipeline_reset(struct pipeline *p, struct comp_dev *host)
 	return ret;
 }
 
+/* copy with the cache synced for the data exchanged with DMA */
+static int pipeline_comp_copy(struct comp_dev *current)
+{
+	struct comp_buffer *buffer;
+	struct list_item *clist;
+	int err;
+
+	list_for_item(clist, &current->bsource_list) {
+		buffer = container_of(clist, struct comp_buffer, sink_list);
+		buffer_sync(buffer);
+	}
+
+	err = comp_copy(current);
+
+	list_for_item(clist, &current->bsink_list) {
+		buffer = container_of(clist, struct comp_buffer, source_list);
+		buffer_sync(buffer);
+	}
+
+	return err;
+}
+
 /*
  * Upstream Copy and Process.
  *
@@ -908,7 +1171,7 @@ static int pipeline_copy_from_upstream(struct comp_dev *start,
 
 copy:
 	/* we are at the upstream end point component so copy the buffers */
-	err = comp_copy(current);
+	err = pipeline_comp_copy(current);
 
 	/* return back downstream */
 	tracev_pipe("CD+");
@@ -939,7 +1202,7 @@ static int pipeline_copy_to_downstream(struct comp_dev *start,
 
 	/* component copy/process to downstream */
 	if (current != start) {
-		err = comp_copy(current);
+		err = pipeline_comp_copy(current);
 
 		/* stop going downstream if we reach an end point in this pipeline */
 		if (current->is_endpoint)
@@ -1148,13 +1411,12 @@ static void pipeline_for_each_upstream(struct pipeline *p,
 }
 
 /*
- * Send an XRUN to each host for this component.
+ * Record an XRUN for this component. The pipeline task tries to catch up
+ * first, so the hosts are only told when that fails.
  */
 void pipeline_xrun(struct pipeline *p, struct comp_dev *dev,
 	int32_t bytes)
 {
-	struct sof_ipc_stream_posn posn;
-
 	/* don't flood host */
 	if (p->xrun_bytes)
 		return;
@@ -1163,8 +1425,21 @@ void pipeline_xrun(struct pipeline *p, struct comp_dev *dev,
 	if (dev->state != COMP_STATE_ACTIVE)
 		return;
 
+	p->xrun_bytes = bytes;
+	p->xrun_comp = dev;
+}
+
+/* send the recorded XRUN to each host of the pipeline */
+static void pipeline_xrun_notify(struct pipeline *p)
+{
+	struct comp_dev *dev = p->xrun_comp;
+	struct sof_ipc_stream_posn posn;
+
+	if (!dev)
+		return;
+
 	memset(&posn, 0, sizeof(posn));
-	p->xrun_bytes = posn.xrun_size = bytes;
+	posn.xrun_size = p->xrun_bytes;
 	posn.xrun_comp_id = dev->comp.id;
 
 	if (dev->params.direction == SOF_IPC_STREAM_PLAYBACK) {
@@ -1190,6 +1465,97 @@ static int pipeline_copy(struct comp_dev *dev)
 	return 0;
 }
 
+/*
+ * The buffer the scheduling component exchanges with its DMA, its source
+ * when it consumes the stream and its sink when it produces it.
+ */
+static struct comp_buffer *pipeline_sched_buffer(struct pipeline *p)
+{
+	struct comp_dev *dev = p->sched_comp;
+
+	if (!list_is_empty(&dev->bsource_list))
+		return list_first_item(&dev->bsource_list,
+				       struct comp_buffer, sink_list);
+
+	if (!list_is_empty(&dev->bsink_list))
+		return list_first_item(&dev->bsink_list,
+				       struct comp_buffer, source_list);
+
+	return NULL;
+}
+
+/* has the scheduling component a missed period for the pipeline to copy ? */
+static int pipeline_behind(struct pipeline *p)
+{
+	struct comp_dev *dev = p->sched_comp;
+	struct comp_buffer *buffer = pipeline_sched_buffer(p);
+	uint32_t bytes = dev->frames * comp_frame_bytes(dev);
+
+	if (!buffer || !bytes)
+		return 0;
+
+	if (buffer->sink == dev)
+		return buffer->free >= bytes;
+
+	return buffer->avail >= bytes;
+}
+
+/* can the scheduling component DMA run its next period ? */
+static int pipeline_sched_ready(struct pipeline *p)
+{
+	struct comp_dev *dev = p->sched_comp;
+	struct comp_buffer *buffer = pipeline_sched_buffer(p);
+	uint32_t bytes = dev->frames * comp_frame_bytes(dev);
+
+	if (!buffer)
+		return 1;
+
+	if (buffer->sink == dev)
+		return buffer->avail >= bytes;
+
+	return buffer->free >= bytes;
+}
+
+/*
+ * Copy the periods the scheduling component missed while the task was late,
+ * within the catch up budget. A copy that fails only ends the catch up, the
+ * XRUN is cleared if the scheduling component DMA can run its next period.
+ */
+static int pipeline_catch_up(struct pipeline *p)
+{
+	struct comp_buffer *buffer = pipeline_sched_buffer(p);
+	uint32_t periods = 0;
+	uint32_t avail;
+
+	while (periods < PIPELINE_CATCHUP_PERIODS && pipeline_behind(p)) {
+		avail = buffer->avail;
+		if (pipeline_copy(p->sched_comp) < 0)
+			break;
+
+		/* variable size copies succeed with nothing to copy */
+		if (buffer->avail == avail)
+			break;
+		periods++;
+	}
+
+	if (!pipeline_sched_ready(p)) {
+		trace_pipe_error("pcu");
+		trace_error_value(periods);
+		return -EIO;
+	}
+
+	if (periods || p->xrun_bytes) {
+		tracev_pipe("PCu");
+		tracev_value(periods);
+		p->catch_ups++;
+		p->catch_up_periods += periods;
+	}
+
+	p->xrun_bytes = 0;
+	p->xrun_comp = NULL;
+	return 0;
+}
+
 /* recover the pipeline from a XRUN condition */
 static int pipeline_xrun_recover(struct pipeline *p)
 {
@@ -1204,6 +1570,8 @@ static int pipeline_xrun_recover(struct pipeline *p)
 		return ret;
 	}
 	p->xrun_bytes = 0;
+	p->xrun_comp = NULL;
+	p->recovers++;
 
 	/* prepare the pipeline */
 	ret = pipeline_prepare(p, p->source_comp);
@@ -1262,26 +1630,32 @@ static void pipeline_task(void *arg)
 {
 	struct pipeline *p = arg;
 	struct comp_dev *dev = p->sched_comp;
-	int err;
+	int err = 0;
 
 	tracev_pipe("PWs");
 
-	/* are we in xrun ? */
-	if (p->xrun_bytes) {
-		err = pipeline_xrun_recover(p);
-		if (err < 0)
-			return; /* failed - host will stop this pipeline */
-		goto sched;
-	}
+	/* copy the period unless we are in xrun */
+	if (!p->xrun_bytes)
+		err = pipeline_copy(dev);
+
+	/* copy any missed periods before recovering */
+	if (err < 0 || p->xrun_bytes || pipeline_behind(p))
+		err = pipeline_catch_up(p);
 
-	err = pipeline_copy(dev);
 	if (err < 0) {
+		pipeline_xrun_notify(p);
 		err = pipeline_xrun_recover(p);
 		if (err < 0)
 			return; /* failed - host will stop this pipeline */
 	}
 
-sched:
+	/* the load balancer on the master reads them from memory */
+	if (p->ipc_pipe.core != PLATFORM_MASTER_CORE_ID) {
+		dcache_writeback_region(&p->status, sizeof(p->status));
+		dcache_writeback_region(&p->pipe_task.total_rtime,
+					sizeof(p->pipe_task.total_rtime));
+	}
+
 	tracev_pipe("PWe");
 }
 
@@ -551,7 +551,7 @@ static struct comp_dev *src_new(struct sof_ipc_comp *comp)
 		return NULL;
 	}
 
-	dev = rzalloc(RZONE_RUNTIME, SOF_MEM_CAPS_RAM,
+	dev = rzalloc_slab(RZONE_RUNTIME, SLAB_COMP_DEV,
 		COMP_SIZE(struct sof_ipc_comp_src));
 	if (!dev)
 		return NULL;
@@ -816,17 +816,13 @@ static int src_copy(struct comp_dev *dev)
 	need_source = cd->param.blk_in * dev->frame_bytes;
 	need_sink = cd->param.blk_out * dev->frame_bytes;
 
-	/* make sure source component buffer has enough data available and that
-	 * the sink component buffer has enough free bytes for copy. Also
-	 * check for XRUNs.
+	/* blk_in and blk_out are the lower bound of a variable size copy,
+	 * with less source data or sink space wait for the next copy. XRUNs
+	 * are detected by the pipeline end points.
 	 */
-	if (source->avail < need_source) {
-		trace_src_error("xru");
-		return -EIO;	/* xrun */
-	}
-	if (sink->free < need_sink) {
-		trace_src_error("xro");
-		return -EIO;	/* xrun */
+	if (source->avail < need_source || sink->free < need_sink) {
+		tracev_src("swt");
+		return 0;
 	}
 
 	cd->src_func(dev, source, sink, &consumed, &produced);
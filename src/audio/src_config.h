@@ -64,6 +64,18 @@
 #define SRC_HIFI3	1
 #define SRC_HIFIEP	0
 #endif
+#elif defined OPS_HIFI3_EMU
+/* GCC with host emulation of HiFi3 intrinsics */
+#define SRC_SHORT	0
+#define SRC_GENERIC	0
+#define SRC_HIFIEP	0
+#define SRC_HIFI3	1
+#elif defined OPS_HIFI2EP_EMU
+/* GCC with host emulation of HiFi2 EP intrinsics */
+#define SRC_SHORT	1
+#define SRC_GENERIC	0
+#define SRC_HIFIEP	1
+#define SRC_HIFI3	0
 #else
 /* GCC */
 #if defined(CONFIG_HOST)
@@ -72,7 +72,7 @@ static inline void fir_filter(ae_q32s *rp, const void *cp, ae_q32s *wp0,
 	ae_q32s *wp = wp0;
 	int i;
 	int j;
-	const int inc = sizeof(ae_p24x2f);
+	const int inc = nch * sizeof(int32_t);
 
 	/* 2ch FIR case */
 	if (nch == 2) {
@@ -151,7 +151,8 @@ static inline void fir_filter(ae_q32s *rp, const void *cp, ae_q32s *wp0,
 		 */
 		for (i = 0; i < taps_div_4; i++) {
 			/* Load two coefficients */
-			coef2 = *coefp++;
+			coef2 = AE_LP16X2F_I(coefp, 0);
+			coefp++;
 
 			/* Load two data samples */
 			AE_LP24F_C(p0, dp0, inc);
@@ -164,7 +165,8 @@ static inline void fir_filter(ae_q32s *rp, const void *cp, ae_q32s *wp0,
 			AE_MULAAFP24S_HH_LL(a0, data2, coef2);
 
 			/* Repeat for next two filter taps */
-			coef2 = *coefp++;
+			coef2 = AE_LP16X2F_I(coefp, 0);
+			coefp++;
 			AE_LP24F_C(p0, dp0, inc);
 			AE_LP24F_C(p1, dp0, inc);
 			data2 = AE_SELP24_LL(p0, p1);
@@ -203,7 +205,7 @@ static inline void fir_filter(ae_q32s *rp, const void *cp, ae_q32s *wp0,
 	ae_q32s *wp = wp0;
 	int i;
 	int j;
-	const int inc = sizeof(ae_p24x2f);
+	const int inc = nch * sizeof(int32_t);
 
 	/* 2ch FIR case */
 	if (nch == 2) {
@@ -286,7 +288,8 @@ static inline void fir_filter(ae_q32s *rp, const void *cp, ae_q32s *wp0,
 		 */
 		for (i = 0; i < taps_div_4; i++) {
 			/* Load two coefficients */
-			coef2 = *coefp++;
+			coef2 = AE_LP24X2F_I(coefp, 0);
+			coefp++;
 
 			/* Load two data samples and place them to L and H of
 			 * data2.
@@ -303,7 +306,8 @@ static inline void fir_filter(ae_q32s *rp, const void *cp, ae_q32s *wp0,
 			AE_MULAAFP24S_HH_LL(a0, data2, coef2);
 
 			/* Repeat for next two filter taps */
-			coef2 = *coefp++;
+			coef2 = AE_LP24X2F_I(coefp, 0);
+			coefp++;
 			AE_LP24F_C(p0, dp0, inc);
 			AE_LP24F_C(p1, dp0, inc);
 			data2 = AE_SELP24_LH(p0, p1);
@@ -347,7 +351,7 @@ void src_polyphase_stage_cir(struct src_stage_prm *s)
 	const int blk_in_words = nch * cfg->blk_in;
 	const int blk_out_words = nch * cfg->num_of_subfilters;
 	const int sz = sizeof(int32_t);
-	const int n_sz = -sizeof(int32_t);
+	const int n_sz = -(int)sizeof(int32_t);
 	const int rewind_sz = sz * (nch * (cfg->blk_in
 		+ (cfg->num_of_subfilters - 1) * cfg->idm) - nch);
 	const int nch_x_idm_sz = -nch * cfg->idm * sizeof(int32_t);
@@ -460,7 +464,7 @@ void src_polyphase_stage_cir_s24(struct src_stage_prm *s)
 	const int blk_in_words = nch * cfg->blk_in;
 	const int blk_out_words = nch * cfg->num_of_subfilters;
 	const int sz = sizeof(int32_t);
-	const int n_sz = -sizeof(int32_t);
+	const int n_sz = -(int)sizeof(int32_t);
 	const int rewind_sz = sz * (nch * (cfg->blk_in
 		+ (cfg->num_of_subfilters - 1) * cfg->idm) - nch);
 	const int nch_x_idm_sz = -nch * cfg->idm * sizeof(int32_t);
@@ -290,7 +290,7 @@ static inline void fir_filter(ae_f32 *rp, const void *cp, ae_f32 *wp0,
 		 */
 		for (i = 0; i < taps_div_4; i++) {
 			/* Load two coefficients */
-			coef2 = *coefp++;
+			AE_L32X2F24_IP(coef2, coefp, sizeof(ae_f24x2));
 
 			/* Load two data samples, place to high and
 			 * low of data2.
@@ -307,7 +307,7 @@ static inline void fir_filter(ae_f32 *rp, const void *cp, ae_f32 *wp0,
 			AE_MULAAFD24_HH_LL(a0, data2, coef2);
 
 			/* Repeat the same for next two filter taps */
-			coef2 = *coefp++;
+			AE_L32X2F24_IP(coef2, coefp, sizeof(ae_f24x2));
 			AE_L32F24_XC(d0, dp0, inc);
 			AE_L32F24_XC(d1, dp0, inc);
 			data2 = AE_SELP24_LL(d0, d1);
@@ -351,7 +351,7 @@ void src_polyphase_stage_cir(struct src_stage_prm *s)
 	const int blk_in_words = nch * cfg->blk_in;
 	const int blk_out_words = nch * cfg->num_of_subfilters;
 	const int sz = sizeof(int32_t);
-	const int n_sz = -sizeof(int32_t);
+	const int n_sz = -(int)sizeof(int32_t);
 	const int rewind_sz = sz * (nch * (cfg->blk_in
 		+ (cfg->num_of_subfilters - 1) * cfg->idm) - nch);
 	const int nch_x_idm_sz = -nch * cfg->idm * sizeof(int32_t);
@@ -468,7 +468,7 @@ void src_polyphase_stage_cir_s24(struct src_stage_prm *s)
 	const int blk_in_words = nch * cfg->blk_in;
 	const int blk_out_words = nch * cfg->num_of_subfilters;
 	const int sz = sizeof(int32_t);
-	const int n_sz = -sizeof(int32_t);
+	const int n_sz = -(int)sizeof(int32_t);
 	const int rewind_sz = sz * (nch * (cfg->blk_in
 		+ (cfg->num_of_subfilters - 1) * cfg->idm) - nch);
 	const int nch_x_idm_sz = -nch * cfg->idm * sizeof(int32_t);
@@ -404,7 +404,7 @@ static struct comp_dev *tone_new(struct sof_ipc_comp *comp)
 
 	trace_tone("new");
 
-	dev = rzalloc(RZONE_RUNTIME, SOF_MEM_CAPS_RAM,
+	dev = rzalloc_slab(RZONE_RUNTIME, SLAB_COMP_DEV,
 		COMP_SIZE(struct sof_ipc_comp_tone));
 	if (dev == NULL)
 		return NULL;
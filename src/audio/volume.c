@@ -92,6 +92,9 @@ static uint64_t vol_work(void *data, uint64_t delay)
 	int again = 0;
 	int i, new_vol;
 
+	/* the ramp runs outside of copy() and cmd() */
+	comp_pm_dirty(dev);
+
 	/* inc/dec each volume if it's not at target */
 	for (i = 0; i < PLATFORM_MAX_CHANNELS; i++) {
 
@@ -175,7 +178,7 @@ static struct comp_dev *volume_new(struct sof_ipc_comp *comp)
 
 	trace_volume("new");
 
-	dev = rzalloc(RZONE_RUNTIME, SOF_MEM_CAPS_RAM,
+	dev = rzalloc_slab(RZONE_RUNTIME, SLAB_COMP_DEV,
 		COMP_SIZE(struct sof_ipc_comp_volume));
 	if (dev == NULL)
 		return NULL;
@@ -434,13 +437,18 @@ static int volume_trigger(struct comp_dev *dev, int cmd)
 /**
  * \brief Copies and processes stream data.
  * \param[in,out] dev Volume base component device.
- * \return Error code.
+ * \return Number of frames copied.
  */
 static int volume_copy(struct comp_dev *dev)
 {
 	struct comp_data *cd = comp_get_drvdata(dev);
 	struct comp_buffer *sink;
 	struct comp_buffer *source;
+	uint32_t source_frame_bytes;
+	uint32_t sink_frame_bytes;
+	uint32_t frames;
+	uint32_t copied;
+	uint32_t n;
 
 	tracev_volume("cpy");
 
@@ -450,29 +458,27 @@ static int volume_copy(struct comp_dev *dev)
 	sink = list_first_item(&dev->bsink_list,
 			       struct comp_buffer, source_list);
 
-	/* make sure source component buffer has enough data available and that
-	 * the sink component buffer has enough free bytes for copy. Also
-	 * check for XRUNs
+	/* copy whatever source data fits in the sink, in whole frames. Less
+	 * than a period is not a XRUN, pipeline end points detect those.
 	 */
-	if (source->avail < cd->source_period_bytes) {
-		trace_volume_error("xru");
-		comp_underrun(dev, source, cd->source_period_bytes, 0);
-		return -EIO;	/* xrun */
-	}
-	if (sink->free < cd->sink_period_bytes) {
-		trace_volume_error("xro");
-		comp_overrun(dev, sink, cd->sink_period_bytes, 0);
-		return -EIO;	/* xrun */
+	source_frame_bytes = cd->source_period_bytes / dev->frames;
+	sink_frame_bytes = cd->sink_period_bytes / dev->frames;
+	frames = comp_buffer_get_copy_frames(source, source_frame_bytes,
+					     sink, sink_frame_bytes);
+
+	/* copy and scale volume up to each buffer wrap */
+	for (copied = 0; copied < frames; copied += n) {
+		n = comp_buffer_get_contig_frames(source, source_frame_bytes,
+						  sink, sink_frame_bytes,
+						  frames - copied);
+		cd->scale_vol(dev, sink, source, n);
+
+		/* calc new free and available */
+		comp_update_buffer_produce(sink, n * sink_frame_bytes);
+		comp_update_buffer_consume(source, n * source_frame_bytes);
 	}
 
-	/* copy and scale volume */
-	cd->scale_vol(dev, sink, source);
-
-	/* calc new free and available */
-	comp_update_buffer_produce(sink, cd->sink_period_bytes);
-	comp_update_buffer_consume(source, cd->source_period_bytes);
-
-	return dev->frames;
+	return frames;
 }
 
 /**
@@ -55,6 +55,11 @@
 
 #endif
 
+/* GCC with host emulation of HiFi3 intrinsics */
+#if defined(OPS_HIFI3_EMU)
+#undef CONFIG_GENERIC
+#endif
+
 /** \brief Volume trace function. */
 #define trace_volume(__e)	trace_event(TRACE_CLASS_VOLUME, __e)
 
@@ -115,7 +120,8 @@ struct comp_data {
 	uint32_t min_volume;			/**< minimum volume level */
 	uint32_t max_volume;			/**< maximum volume level */
 	void (*scale_vol)(struct comp_dev *dev, struct comp_buffer *sink,
-		struct comp_buffer *source);	/**< volume processing function */
+		struct comp_buffer *source,
+		uint32_t frames);		/**< volume processing function */
 	struct work volwork;			/**< volume scheduled work function */
 	struct sof_ipc_ctrl_value_chan *hvol;	/**< host volume readback */
 };
@@ -126,14 +132,15 @@ struct comp_func_map {
 	uint16_t sink;				/**< sink frame format */
 	uint16_t channels;			/**< number of stream channels */
 	void (*func)(struct comp_dev *dev, struct comp_buffer *sink,
-		struct comp_buffer *source);	/**< volume processing function */
+		struct comp_buffer *source,
+		uint32_t frames);		/**< volume processing function */
 };
 
 /** \brief Map of formats with dedicated processing functions. */
 extern const struct comp_func_map func_map[];
 
 typedef void (*scale_vol)(struct comp_dev *, struct comp_buffer *,
-			  struct comp_buffer *);
+			  struct comp_buffer *, uint32_t);
 
 /**
  * \brief Retrievies volume processing function.
@@ -47,12 +47,13 @@
  * \param[in,out] dev Volume base component device.
  * \param[in,out] sink Destination buffer.
  * \param[in,out] source Source buffer.
+ * \param[in] frames Number of frames to process.
  *
  * Copy and scale volume from 16 bit source buffer
  * to 32 bit destination buffer for 2 channels.
  */
 static void vol_s16_to_s32_2ch(struct comp_dev *dev, struct comp_buffer *sink,
-			       struct comp_buffer *source)
+			       struct comp_buffer *source, uint32_t frames)
 {
 	struct comp_data *cd = comp_get_drvdata(dev);
 	int16_t *src = (int16_t *)source->r_ptr;
@@ -61,7 +62,7 @@ static void vol_s16_to_s32_2ch(struct comp_dev *dev, struct comp_buffer *sink,
 
 	/* buffer sizes are always divisible by period frames */
 	/* Samples are Q1.15 --> Q1.31 and volume is Q1.16 */
-	for (i = 0; i < dev->frames * 2; i += 2) {
+	for (i = 0; i < frames * 2; i += 2) {
 		dest[i] = (int32_t)src[i] * cd->volume[0];
 		dest[i + 1] = (int32_t)src[i + 1] * cd->volume[1];
 	}
@@ -72,12 +73,13 @@ static void vol_s16_to_s32_2ch(struct comp_dev *dev, struct comp_buffer *sink,
  * \param[in,out] dev Volume base component device.
  * \param[in,out] sink Destination buffer.
  * \param[in,out] source Source buffer.
+ * \param[in] frames Number of frames to process.
  *
  * Copy and scale volume from 32 bit source buffer
  * to 16 bit destination buffer for 2 channels.
  */
 static void vol_s32_to_s16_2ch(struct comp_dev *dev, struct comp_buffer *sink,
-			       struct comp_buffer *source)
+			       struct comp_buffer *source, uint32_t frames)
 {
 	struct comp_data *cd = comp_get_drvdata(dev);
 	int32_t *src = (int32_t *)source->r_ptr;
@@ -86,7 +88,7 @@ static void vol_s32_to_s16_2ch(struct comp_dev *dev, struct comp_buffer *sink,
 
 	/* buffer sizes are always divisible by period frames */
 	/* Samples are Q1.31 --> Q1.15 and volume is Q1.16 */
-	for (i = 0; i < dev->frames * 2; i += 2) {
+	for (i = 0; i < frames * 2; i += 2) {
 		dest[i] = (int16_t)q_multsr_sat_32x32(
 			src[i], cd->volume[0], Q_SHIFT_BITS_64(31, 16, 15));
 		dest[i + 1] = (int16_t)q_multsr_sat_32x32(
@@ -99,12 +101,13 @@ static void vol_s32_to_s16_2ch(struct comp_dev *dev, struct comp_buffer *sink,
  * \param[in,out] dev Volume base component device.
  * \param[in,out] sink Destination buffer.
  * \param[in,out] source Source buffer.
+ * \param[in] frames Number of frames to process.
  *
  * Copy and scale volume from 32 bit source buffer
  * to 32 bit destination buffer for 2 channels.
  */
 static void vol_s32_to_s32_2ch(struct comp_dev *dev, struct comp_buffer *sink,
-			       struct comp_buffer *source)
+			       struct comp_buffer *source, uint32_t frames)
 {
 	struct comp_data *cd = comp_get_drvdata(dev);
 	int32_t *src = (int32_t *)source->r_ptr;
@@ -113,7 +116,7 @@ static void vol_s32_to_s32_2ch(struct comp_dev *dev, struct comp_buffer *sink,
 
 	/* buffer sizes are always divisible by period frames */
 	/* Samples are Q1.31 --> Q1.31 and volume is Q1.16 */
-	for (i = 0; i < dev->frames * 2; i += 2) {
+	for (i = 0; i < frames * 2; i += 2) {
 		dest[i] = q_multsr_sat_32x32(
 			src[i], cd->volume[0], Q_SHIFT_BITS_64(31, 16, 31));
 		dest[i + 1] = q_multsr_sat_32x32(
@@ -126,12 +129,13 @@ static void vol_s32_to_s32_2ch(struct comp_dev *dev, struct comp_buffer *sink,
  * \param[in,out] dev Volume base component device.
  * \param[in,out] sink Destination buffer.
  * \param[in,out] source Source buffer.
+ * \param[in] frames Number of frames to process.
  *
  * Copy and scale volume from 16 bit source buffer
  * to 16 bit destination buffer for 2 channels.
  */
 static void vol_s16_to_s16_2ch(struct comp_dev *dev, struct comp_buffer *sink,
-			       struct comp_buffer *source)
+			       struct comp_buffer *source, uint32_t frames)
 {
 	struct comp_data *cd = comp_get_drvdata(dev);
 	int16_t *src = (int16_t *)source->r_ptr;
@@ -140,7 +144,7 @@ static void vol_s16_to_s16_2ch(struct comp_dev *dev, struct comp_buffer *sink,
 
 	/* buffer sizes are always divisible by period frames */
 	/* Samples are Q1.15 --> Q1.15 and volume is Q1.16 */
-	for (i = 0; i < dev->frames * 2; i += 2) {
+	for (i = 0; i < frames * 2; i += 2) {
 		dest[i] = q_multsr_sat_16x16(
 			src[i], cd->volume[0], Q_SHIFT_BITS_32(15, 16, 15));
 		dest[i + 1] = q_multsr_sat_16x16(
@@ -153,12 +157,13 @@ static void vol_s16_to_s16_2ch(struct comp_dev *dev, struct comp_buffer *sink,
  * \param[in,out] dev Volume base component device.
  * \param[in,out] sink Destination buffer.
  * \param[in,out] source Source buffer.
+ * \param[in] frames Number of frames to process.
  *
  * Copy and scale volume from 16 bit source buffer
  * to 24/32 bit destination buffer for 2 channels.
  */
 static void vol_s16_to_s24_2ch(struct comp_dev *dev, struct comp_buffer *sink,
-			       struct comp_buffer *source)
+			       struct comp_buffer *source, uint32_t frames)
 {
 	struct comp_data *cd = comp_get_drvdata(dev);
 	int16_t *src = (int16_t *)source->r_ptr;
@@ -167,7 +172,7 @@ static void vol_s16_to_s24_2ch(struct comp_dev *dev, struct comp_buffer *sink,
 
 	/* buffer sizes are always divisible by period frames */
 	/* Samples are Q1.15 and volume is Q1.16 */
-	for (i = 0; i < dev->frames * 2; i += 2) {
+	for (i = 0; i < frames * 2; i += 2) {
 		dest[i] = q_multsr_sat_32x32(
 			src[i], cd->volume[0], Q_SHIFT_BITS_64(15, 16, 23));
 		dest[i + 1] = q_multsr_sat_32x32(
@@ -180,12 +185,13 @@ static void vol_s16_to_s24_2ch(struct comp_dev *dev, struct comp_buffer *sink,
  * \param[in,out] dev Volume base component device.
  * \param[in,out] sink Destination buffer.
  * \param[in,out] source Source buffer.
+ * \param[in] frames Number of frames to process.
  *
  * Copy and scale volume from 24/32 bit source buffer
  * to 16 bit destination buffer for 2 channels.
  */
 static void vol_s24_to_s16_2ch(struct comp_dev *dev, struct comp_buffer *sink,
-			       struct comp_buffer *source)
+			       struct comp_buffer *source, uint32_t frames)
 {
 	struct comp_data *cd = comp_get_drvdata(dev);
 	int32_t *src = (int32_t *)source->r_ptr;
@@ -194,7 +200,7 @@ static void vol_s24_to_s16_2ch(struct comp_dev *dev, struct comp_buffer *sink,
 
 	/* buffer sizes are always divisible by period frames */
 	/* Samples are Q1.23 --> Q1.15 and volume is Q1.16 */
-	for (i = 0; i < dev->frames * 2; i += 2) {
+	for (i = 0; i < frames * 2; i += 2) {
 		dest[i] = (int16_t)q_multsr_sat_32x32(
 			sign_extend_s24(src[i]), cd->volume[0],
 			Q_SHIFT_BITS_64(23, 16, 15));
@@ -209,12 +215,13 @@ static void vol_s24_to_s16_2ch(struct comp_dev *dev, struct comp_buffer *sink,
  * \param[in,out] dev Volume base component device.
  * \param[in,out] sink Destination buffer.
  * \param[in,out] source Source buffer.
+ * \param[in] frames Number of frames to process.
  *
  * Copy and scale volume from 32 bit source buffer
  * to 24/32 bit destination buffer for 2 channels.
  */
 static void vol_s32_to_s24_2ch(struct comp_dev *dev, struct comp_buffer *sink,
-			       struct comp_buffer *source)
+			       struct comp_buffer *source, uint32_t frames)
 {
 	struct comp_data *cd = comp_get_drvdata(dev);
 	int32_t *src = (int32_t *)source->r_ptr;
@@ -223,7 +230,7 @@ static void vol_s32_to_s24_2ch(struct comp_dev *dev, struct comp_buffer *sink,
 
 	/* buffer sizes are always divisible by period frames */
 	/* Samples are Q1.31 --> Q1.23 and volume is Q1.16 */
-	for (i = 0; i < dev->frames * 2; i += 2) {
+	for (i = 0; i < frames * 2; i += 2) {
 		dest[i] = q_multsr_sat_32x32(
 			src[i], cd->volume[0], Q_SHIFT_BITS_64(31, 16, 23));
 		dest[i + 1] = q_multsr_sat_32x32(
@@ -236,12 +243,13 @@ static void vol_s32_to_s24_2ch(struct comp_dev *dev, struct comp_buffer *sink,
  * \param[in,out] dev Volume base component device.
  * \param[in,out] sink Destination buffer.
  * \param[in,out] source Source buffer.
+ * \param[in] frames Number of frames to process.
  *
  * Copy and scale volume from 24/32 bit source buffer
  * to 32 bit destination buffer for 2 channels.
  */
 static void vol_s24_to_s32_2ch(struct comp_dev *dev, struct comp_buffer *sink,
-			       struct comp_buffer *source)
+			       struct comp_buffer *source, uint32_t frames)
 {
 	struct comp_data *cd = comp_get_drvdata(dev);
 	int32_t *src = (int32_t *)source->r_ptr;
@@ -250,7 +258,7 @@ static void vol_s24_to_s32_2ch(struct comp_dev *dev, struct comp_buffer *sink,
 
 	/* buffer sizes are always divisible by period frames */
 	/* Samples are Q1.23 --> Q1.31 and volume is Q1.16 */
-	for (i = 0; i < dev->frames * 2; i += 2) {
+	for (i = 0; i < frames * 2; i += 2) {
 		dest[i] = q_multsr_sat_32x32(
 			sign_extend_s24(src[i]), cd->volume[0],
 			Q_SHIFT_BITS_64(23, 16, 31));
@@ -265,12 +273,13 @@ static void vol_s24_to_s32_2ch(struct comp_dev *dev, struct comp_buffer *sink,
  * \param[in,out] dev Volume base component device.
  * \param[in,out] sink Destination buffer.
  * \param[in,out] source Source buffer.
+ * \param[in] frames Number of frames to process.
  *
  * Copy and scale volume from 24/32 bit source buffer
  * to 24/32 bit destination buffer for 2 channels.
  */
 static void vol_s24_to_s24_2ch(struct comp_dev *dev, struct comp_buffer *sink,
-			       struct comp_buffer *source)
+			       struct comp_buffer *source, uint32_t frames)
 {
 	struct comp_data *cd = comp_get_drvdata(dev);
 	int32_t i, *src = (int32_t *)source->r_ptr;
@@ -278,7 +287,7 @@ static void vol_s24_to_s24_2ch(struct comp_dev *dev, struct comp_buffer *sink,
 
 	/* buffer sizes are always divisible by period frames */
 	/* Samples are Q1.23 --> Q1.23 and volume is Q1.16 */
-	for (i = 0; i < dev->frames * 2; i += 2) {
+	for (i = 0; i < frames * 2; i += 2) {
 		dest[i] = q_multsr_sat_32x32(
 			sign_extend_s24(src[i]), cd->volume[0],
 			Q_SHIFT_BITS_64(23, 16, 23));
@@ -294,12 +303,13 @@ static void vol_s24_to_s24_2ch(struct comp_dev *dev, struct comp_buffer *sink,
  * \param[in,out] dev Volume base component device.
  * \param[in,out] sink Destination buffer.
  * \param[in,out] source Source buffer.
+ * \param[in] frames Number of frames to process.
  *
  * Copy and scale volume from 16 bit source buffer
  * to 32 bit destination buffer for 4 channels.
  */
 static void vol_s16_to_s32_4ch(struct comp_dev *dev, struct comp_buffer *sink,
-			       struct comp_buffer *source)
+			       struct comp_buffer *source, uint32_t frames)
 {
 	struct comp_data *cd = comp_get_drvdata(dev);
 	int16_t *src = (int16_t *)source->r_ptr;
@@ -308,7 +318,7 @@ static void vol_s16_to_s32_4ch(struct comp_dev *dev, struct comp_buffer *sink,
 
 	/* buffer sizes are always divisible by period frames */
 	/* Samples are Q1.15 --> Q1.31 and volume is Q1.16 */
-	for (i = 0; i < dev->frames * 4; i += 4) {
+	for (i = 0; i < frames * 4; i += 4) {
 		dest[i] = (int32_t)src[i] * cd->volume[0];
 		dest[i + 1] = (int32_t)src[i + 1] * cd->volume[1];
 		dest[i + 2] = (int32_t)src[i + 2] * cd->volume[2];
@@ -321,12 +331,13 @@ static void vol_s16_to_s32_4ch(struct comp_dev *dev, struct comp_buffer *sink,
  * \param[in,out] dev Volume base component device.
  * \param[in,out] sink Destination buffer.
  * \param[in,out] source Source buffer.
+ * \param[in] frames Number of frames to process.
  *
  * Copy and scale volume from 32 bit source buffer
  * to 16 bit destination buffer for 4 channels.
  */
 static void vol_s32_to_s16_4ch(struct comp_dev *dev, struct comp_buffer *sink,
-			       struct comp_buffer *source)
+			       struct comp_buffer *source, uint32_t frames)
 {
 	struct comp_data *cd = comp_get_drvdata(dev);
 	int32_t *src = (int32_t *)source->r_ptr;
@@ -335,7 +346,7 @@ static void vol_s32_to_s16_4ch(struct comp_dev *dev, struct comp_buffer *sink,
 
 	/* buffer sizes are always divisible by period frames */
 	/* Samples are Q1.31 --> Q1.15 and volume is Q1.16 */
-	for (i = 0; i < dev->frames * 4; i += 4) {
+	for (i = 0; i < frames * 4; i += 4) {
 		dest[i] = (int16_t)q_multsr_sat_32x32(src[i], cd->volume[0],
 						      Q_SHIFT_BITS_64(31, 16,
 								      15));
@@ -362,12 +373,13 @@ static void vol_s32_to_s16_4ch(struct comp_dev *dev, struct comp_buffer *sink,
  * \param[in,out] dev Volume base component device.
  * \param[in,out] sink Destination buffer.
  * \param[in,out] source Source buffer.
+ * \param[in] frames Number of frames to process.
  *
  * Copy and scale volume from 32 bit source buffer
  * to 32 bit destination buffer for 4 channels.
  */
 static void vol_s32_to_s32_4ch(struct comp_dev *dev, struct comp_buffer *sink,
-			       struct comp_buffer *source)
+			       struct comp_buffer *source, uint32_t frames)
 {
 	struct comp_data *cd = comp_get_drvdata(dev);
 	int32_t *src = (int32_t *)source->r_ptr;
@@ -376,7 +388,7 @@ static void vol_s32_to_s32_4ch(struct comp_dev *dev, struct comp_buffer *sink,
 
 	/* buffer sizes are always divisible by period frames */
 	/* Samples are Q1.31 --> Q1.31 and volume is Q1.16 */
-	for (i = 0; i < dev->frames * 4; i += 4) {
+	for (i = 0; i < frames * 4; i += 4) {
 		dest[i] = q_multsr_sat_32x32(src[i], cd->volume[0],
 					     Q_SHIFT_BITS_64(31, 16, 31));
 		dest[i + 1] = q_multsr_sat_32x32(src[i + 1], cd->volume[1],
@@ -393,12 +405,13 @@ static void vol_s32_to_s32_4ch(struct comp_dev *dev, struct comp_buffer *sink,
  * \param[in,out] dev Volume base component device.
  * \param[in,out] sink Destination buffer.
  * \param[in,out] source Source buffer.
+ * \param[in] frames Number of frames to process.
  *
  * Copy and scale volume from 16 bit source buffer
  * to 16 bit destination buffer for 4 channels.
  */
 static void vol_s16_to_s16_4ch(struct comp_dev *dev, struct comp_buffer *sink,
-			       struct comp_buffer *source)
+			       struct comp_buffer *source, uint32_t frames)
 {
 	struct comp_data *cd = comp_get_drvdata(dev);
 	int16_t *src = (int16_t *)source->r_ptr;
@@ -407,7 +420,7 @@ static void vol_s16_to_s16_4ch(struct comp_dev *dev, struct comp_buffer *sink,
 
 	/* buffer sizes are always divisible by period frames */
 	/* Samples are Q1.15 --> Q1.15 and volume is Q1.16 */
-	for (i = 0; i < dev->frames * 4; i += 4) {
+	for (i = 0; i < frames * 4; i += 4) {
 		dest[i] = q_multsr_sat_16x16(src[i], cd->volume[0],
 					     Q_SHIFT_BITS_32(15, 16, 15));
 		dest[i + 1] = q_multsr_sat_16x16(src[i + 1], cd->volume[1],
@@ -424,12 +437,13 @@ static void vol_s16_to_s16_4ch(struct comp_dev *dev, struct comp_buffer *sink,
  * \param[in,out] dev Volume base component device.
  * \param[in,out] sink Destination buffer.
  * \param[in,out] source Source buffer.
+ * \param[in] frames Number of frames to process.
  *
  * Copy and scale volume from 16 bit source buffer
  * to 24/32 bit destination buffer for 4 channels.
  */
 static void vol_s16_to_s24_4ch(struct comp_dev *dev, struct comp_buffer *sink,
-			       struct comp_buffer *source)
+			       struct comp_buffer *source, uint32_t frames)
 {
 	struct comp_data *cd = comp_get_drvdata(dev);
 	int16_t *src = (int16_t *)source->r_ptr;
@@ -438,7 +452,7 @@ static void vol_s16_to_s24_4ch(struct comp_dev *dev, struct comp_buffer *sink,
 
 	/* buffer sizes are always divisible by period frames */
 	/* Samples are Q1.15 and volume is Q1.16 */
-	for (i = 0; i < dev->frames * 4; i += 4) {
+	for (i = 0; i < frames * 4; i += 4) {
 		dest[i] = q_multsr_sat_32x32(src[i], cd->volume[0],
 					     Q_SHIFT_BITS_64(15, 16, 23));
 		dest[i + 1] = q_multsr_sat_32x32(src[i + 1], cd->volume[1],
@@ -455,12 +469,13 @@ static void vol_s16_to_s24_4ch(struct comp_dev *dev, struct comp_buffer *sink,
  * \param[in,out] dev Volume base component device.
  * \param[in,out] sink Destination buffer.
  * \param[in,out] source Source buffer.
+ * \param[in] frames Number of frames to process.
  *
  * Copy and scale volume from 24/32 bit source buffer
  * to 16 bit destination buffer for 4 channels.
  */
 static void vol_s24_to_s16_4ch(struct comp_dev *dev, struct comp_buffer *sink,
-			       struct comp_buffer *source)
+			       struct comp_buffer *source, uint32_t frames)
 {
 	struct comp_data *cd = comp_get_drvdata(dev);
 	int32_t *src = (int32_t *)source->r_ptr;
@@ -469,7 +484,7 @@ static void vol_s24_to_s16_4ch(struct comp_dev *dev, struct comp_buffer *sink,
 
 	/* buffer sizes are always divisible by period frames */
 	/* Samples are Q1.23 --> Q1.15 and volume is Q1.16 */
-	for (i = 0; i < dev->frames * 4; i += 4) {
+	for (i = 0; i < frames * 4; i += 4) {
 		sample = sign_extend_s24(src[i]);
 		dest[i] = (int16_t)q_multsr_sat_32x32(sample, cd->volume[0],
 						      Q_SHIFT_BITS_64(23, 16,
@@ -500,12 +515,13 @@ static void vol_s24_to_s16_4ch(struct comp_dev *dev, struct comp_buffer *sink,
  * \param[in,out] dev Volume base component device.
  * \param[in,out] sink Destination buffer.
  * \param[in,out] source Source buffer.
+ * \param[in] frames Number of frames to process.
  *
  * Copy and scale volume from 32 bit source buffer
  * to 24/32 bit destination buffer for 4 channels.
  */
 static void vol_s32_to_s24_4ch(struct comp_dev *dev, struct comp_buffer *sink,
-			       struct comp_buffer *source)
+			       struct comp_buffer *source, uint32_t frames)
 {
 	struct comp_data *cd = comp_get_drvdata(dev);
 	int32_t *src = (int32_t *)source->r_ptr;
@@ -514,7 +530,7 @@ static void vol_s32_to_s24_4ch(struct comp_dev *dev, struct comp_buffer *sink,
 
 	/* buffer sizes are always divisible by period frames */
 	/* Samples are Q1.31 --> Q1.23 and volume is Q1.16 */
-	for (i = 0; i < dev->frames * 4; i += 4) {
+	for (i = 0; i < frames * 4; i += 4) {
 		dest[i] = q_multsr_sat_32x32(src[i], cd->volume[0],
 					     Q_SHIFT_BITS_64(31, 16, 23));
 		dest[i + 1] = q_multsr_sat_32x32(src[i + 1], cd->volume[1],
@@ -531,12 +547,13 @@ static void vol_s32_to_s24_4ch(struct comp_dev *dev, struct comp_buffer *sink,
  * \param[in,out] dev Volume base component device.
  * \param[in,out] sink Destination buffer.
  * \param[in,out] source Source buffer.
+ * \param[in] frames Number of frames to process.
  *
  * Copy and scale volume from 24/32 bit source buffer
  * to 32 bit destination buffer for 4 channels.
  */
 static void vol_s24_to_s32_4ch(struct comp_dev *dev, struct comp_buffer *sink,
-			       struct comp_buffer *source)
+			       struct comp_buffer *source, uint32_t frames)
 {
 	struct comp_data *cd = comp_get_drvdata(dev);
 	int32_t *src = (int32_t *)source->r_ptr;
@@ -545,7 +562,7 @@ static void vol_s24_to_s32_4ch(struct comp_dev *dev, struct comp_buffer *sink,
 
 	/* buffer sizes are always divisible by period frames */
 	/* Samples are Q1.23 --> Q1.31 and volume is Q1.16 */
-	for (i = 0; i < dev->frames * 4; i += 4) {
+	for (i = 0; i < frames * 4; i += 4) {
 		dest[i] = q_multsr_sat_32x32(sign_extend_s24(src[i]),
 					     cd->volume[0],
 					     Q_SHIFT_BITS_64(23, 16, 31));
@@ -566,12 +583,13 @@ static void vol_s24_to_s32_4ch(struct comp_dev *dev, struct comp_buffer *sink,
  * \param[in,out] dev Volume base component device.
  * \param[in,out] sink Destination buffer.
  * \param[in,out] source Source buffer.
+ * \param[in] frames Number of frames to process.
  *
  * Copy and scale volume from 24/32 bit source buffer
  * to 24/32 bit destination buffer for 4 channels.
  */
 static void vol_s24_to_s24_4ch(struct comp_dev *dev, struct comp_buffer *sink,
-			       struct comp_buffer *source)
+			       struct comp_buffer *source, uint32_t frames)
 {
 	struct comp_data *cd = comp_get_drvdata(dev);
 	int32_t i, *src = (int32_t *)source->r_ptr;
@@ -579,7 +597,7 @@ static void vol_s24_to_s24_4ch(struct comp_dev *dev, struct comp_buffer *sink,
 
 	/* buffer sizes are always divisible by period frames */
 	/* Samples are Q1.23 --> Q1.23 and volume is Q1.16 */
-	for (i = 0; i < dev->frames * 4; i += 4) {
+	for (i = 0; i < frames * 4; i += 4) {
 		dest[i] = q_multsr_sat_32x32(sign_extend_s24(src[i]),
 					     cd->volume[0],
 					     Q_SHIFT_BITS_64(23, 16, 23));
@@ -601,7 +619,7 @@ static void vol_s24_to_s24_4ch(struct comp_dev *dev, struct comp_buffer *sink,
 
 /* copy and scale volume from 16 bit source buffer to 32 bit dest buffer */
 static void vol_s16_to_s32_8ch(struct comp_dev *dev, struct comp_buffer *sink,
-			       struct comp_buffer *source)
+			       struct comp_buffer *source, uint32_t frames)
 {
 	struct comp_data *cd = comp_get_drvdata(dev);
 	int16_t *src = (int16_t *)source->r_ptr;
@@ -610,7 +628,7 @@ static void vol_s16_to_s32_8ch(struct comp_dev *dev, struct comp_buffer *sink,
 
 	/* buffer sizes are always divisible by period frames */
 	/* Samples are Q1.15 --> Q1.31 and volume is Q1.16 */
-	for (i = 0; i < dev->frames * 8; i += 8) {
+	for (i = 0; i < frames * 8; i += 8) {
 		dest[i] = (int32_t)src[i] * cd->volume[0];
 		dest[i + 1] = (int32_t)src[i + 1] * cd->volume[1];
 		dest[i + 2] = (int32_t)src[i + 2] * cd->volume[2];
@@ -624,7 +642,7 @@ static void vol_s16_to_s32_8ch(struct comp_dev *dev, struct comp_buffer *sink,
 
 /* copy and scale volume from 32 bit source buffer to 16 bit dest buffer */
 static void vol_s32_to_s16_8ch(struct comp_dev *dev, struct comp_buffer *sink,
-			       struct comp_buffer *source)
+			       struct comp_buffer *source, uint32_t frames)
 {
 	struct comp_data *cd = comp_get_drvdata(dev);
 	int32_t *src = (int32_t *)source->r_ptr;
@@ -633,7 +651,7 @@ static void vol_s32_to_s16_8ch(struct comp_dev *dev, struct comp_buffer *sink,
 
 	/* buffer sizes are always divisible by period frames */
 	/* Samples are Q1.31 --> Q1.15 and volume is Q1.16 */
-	for (i = 0; i < dev->frames * 8; i += 8) {
+	for (i = 0; i < frames * 8; i += 8) {
 		dest[i] = (int16_t)q_multsr_sat_32x32(src[i], cd->volume[0],
 						      Q_SHIFT_BITS_64(31, 16,
 								      15));
@@ -677,7 +695,7 @@ static void vol_s32_to_s16_8ch(struct comp_dev *dev, struct comp_buffer *sink,
 
 /* copy and scale volume from 32 bit source buffer to 32 bit dest buffer */
 static void vol_s32_to_s32_8ch(struct comp_dev *dev, struct comp_buffer *sink,
-			       struct comp_buffer *source)
+			       struct comp_buffer *source, uint32_t frames)
 {
 	struct comp_data *cd = comp_get_drvdata(dev);
 	int32_t *src = (int32_t *)source->r_ptr;
@@ -686,7 +704,7 @@ static void vol_s32_to_s32_8ch(struct comp_dev *dev, struct comp_buffer *sink,
 
 	/* buffer sizes are always divisible by period frames */
 	/* Samples are Q1.31 --> Q1.31 and volume is Q1.16 */
-	for (i = 0; i < dev->frames * 8; i += 8) {
+	for (i = 0; i < frames * 8; i += 8) {
 		dest[i] = q_multsr_sat_32x32(src[i], cd->volume[0],
 					     Q_SHIFT_BITS_64(31, 16, 31));
 		dest[i + 1] = q_multsr_sat_32x32(src[i + 1], cd->volume[1],
@@ -708,7 +726,7 @@ static void vol_s32_to_s32_8ch(struct comp_dev *dev, struct comp_buffer *sink,
 
 /* copy and scale volume from 16 bit source buffer to 16 bit dest buffer */
 static void vol_s16_to_s16_8ch(struct comp_dev *dev, struct comp_buffer *sink,
-			       struct comp_buffer *source)
+			       struct comp_buffer *source, uint32_t frames)
 {
 	struct comp_data *cd = comp_get_drvdata(dev);
 	int16_t *src = (int16_t *)source->r_ptr;
@@ -717,7 +735,7 @@ static void vol_s16_to_s16_8ch(struct comp_dev *dev, struct comp_buffer *sink,
 
 	/* buffer sizes are always divisible by period frames */
 	/* Samples are Q1.15 --> Q1.15 and volume is Q1.16 */
-	for (i = 0; i < dev->frames * 8; i += 8) {
+	for (i = 0; i < frames * 8; i += 8) {
 		dest[i] = q_multsr_sat_16x16(src[i], cd->volume[0],
 					     Q_SHIFT_BITS_32(15, 16, 15));
 		dest[i + 1] = q_multsr_sat_16x16(src[i + 1], cd->volume[1],
@@ -741,7 +759,7 @@ static void vol_s16_to_s16_8ch(struct comp_dev *dev, struct comp_buffer *sink,
  * on 32 bit boundary buffer
  */
 static void vol_s16_to_s24_8ch(struct comp_dev *dev, struct comp_buffer *sink,
-			       struct comp_buffer *source)
+			       struct comp_buffer *source, uint32_t frames)
 {
 	struct comp_data *cd = comp_get_drvdata(dev);
 	int16_t *src = (int16_t *)source->r_ptr;
@@ -750,7 +768,7 @@ static void vol_s16_to_s24_8ch(struct comp_dev *dev, struct comp_buffer *sink,
 
 	/* buffer sizes are always divisible by period frames */
 	/* Samples are Q1.15 and volume is Q1.16 */
-	for (i = 0; i < dev->frames * 8; i += 8) {
+	for (i = 0; i < frames * 8; i += 8) {
 		dest[i] = q_multsr_sat_32x32(src[i], cd->volume[0],
 					     Q_SHIFT_BITS_64(15, 16, 23));
 		dest[i + 1] = q_multsr_sat_32x32(src[i + 1], cd->volume[1],
@@ -774,7 +792,7 @@ static void vol_s16_to_s24_8ch(struct comp_dev *dev, struct comp_buffer *sink,
  * on 32 bit boundary dest buffer
  */
 static void vol_s24_to_s16_8ch(struct comp_dev *dev, struct comp_buffer *sink,
-			       struct comp_buffer *source)
+			       struct comp_buffer *source, uint32_t frames)
 {
 	struct comp_data *cd = comp_get_drvdata(dev);
 	int32_t *src = (int32_t *)source->r_ptr;
@@ -783,7 +801,7 @@ static void vol_s24_to_s16_8ch(struct comp_dev *dev, struct comp_buffer *sink,
 
 	/* buffer sizes are always divisible by period frames */
 	/* Samples are Q1.23 --> Q1.15 and volume is Q1.16 */
-	for (i = 0; i < dev->frames * 8; i += 8) {
+	for (i = 0; i < frames * 8; i += 8) {
 		sample = sign_extend_s24(src[i]);
 		dest[i] = (int16_t)q_multsr_sat_32x32(sample, cd->volume[0],
 						      Q_SHIFT_BITS_64(23, 16,
@@ -837,7 +855,7 @@ static void vol_s24_to_s16_8ch(struct comp_dev *dev, struct comp_buffer *sink,
  * on 32 bit boundary dest buffer
  */
 static void vol_s32_to_s24_8ch(struct comp_dev *dev, struct comp_buffer *sink,
-			       struct comp_buffer *source)
+			       struct comp_buffer *source, uint32_t frames)
 {
 	struct comp_data *cd = comp_get_drvdata(dev);
 	int32_t *src = (int32_t *)source->r_ptr;
@@ -846,7 +864,7 @@ static void vol_s32_to_s24_8ch(struct comp_dev *dev, struct comp_buffer *sink,
 
 	/* buffer sizes are always divisible by period frames */
 	/* Samples are Q1.31 --> Q1.23 and volume is Q1.16 */
-	for (i = 0; i < dev->frames * 8; i += 8) {
+	for (i = 0; i < frames * 8; i += 8) {
 		dest[i] = q_multsr_sat_32x32(src[i], cd->volume[0],
 					     Q_SHIFT_BITS_64(31, 16, 23));
 		dest[i + 1] = q_multsr_sat_32x32(src[i + 1], cd->volume[1],
@@ -870,7 +888,7 @@ static void vol_s32_to_s24_8ch(struct comp_dev *dev, struct comp_buffer *sink,
  * on 32 bit boundary dest buffer
  */
 static void vol_s24_to_s32_8ch(struct comp_dev *dev, struct comp_buffer *sink,
-			       struct comp_buffer *source)
+			       struct comp_buffer *source, uint32_t frames)
 {
 	struct comp_data *cd = comp_get_drvdata(dev);
 	int32_t *src = (int32_t *)source->r_ptr;
@@ -879,7 +897,7 @@ static void vol_s24_to_s32_8ch(struct comp_dev *dev, struct comp_buffer *sink,
 
 	/* buffer sizes are always divisible by period frames */
 	/* Samples are Q1.23 --> Q1.31 and volume is Q1.16 */
-	for (i = 0; i < dev->frames * 8; i += 8) {
+	for (i = 0; i < frames * 8; i += 8) {
 		dest[i] = q_multsr_sat_32x32(sign_extend_s24(src[i]),
 					     cd->volume[0],
 					     Q_SHIFT_BITS_64(23, 16, 31));
@@ -911,7 +929,7 @@ static void vol_s24_to_s32_8ch(struct comp_dev *dev, struct comp_buffer *sink,
  * dest buffer.
  */
 static void vol_s24_to_s24_8ch(struct comp_dev *dev, struct comp_buffer *sink,
-			       struct comp_buffer *source)
+			       struct comp_buffer *source, uint32_t frames)
 {
 	struct comp_data *cd = comp_get_drvdata(dev);
 	int32_t i, *src = (int32_t *)source->r_ptr;
@@ -919,7 +937,7 @@ static void vol_s24_to_s24_8ch(struct comp_dev *dev, struct comp_buffer *sink,
 
 	/* buffer sizes are always divisible by period frames */
 	/* Samples are Q1.23 --> Q1.23 and volume is Q1.16 */
-	for (i = 0; i < dev->frames * 8; i += 8) {
+	for (i = 0; i < frames * 8; i += 8) {
 		dest[i] = q_multsr_sat_32x32(sign_extend_s24(src[i]),
 					     cd->volume[0],
 					     Q_SHIFT_BITS_64(23, 16, 23));
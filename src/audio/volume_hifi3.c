@@ -36,7 +36,7 @@
 
 #include "volume.h"
 
-#if defined(__XCC__) && XCHAL_HAVE_HIFI3
+#ifndef CONFIG_GENERIC
 
 #include <xtensa/tie/xt_hifi3.h>
 
@@ -48,9 +48,10 @@
  * \param[in,out] dev Volume base component device.
  * \param[in,out] sink Destination buffer.
  * \param[in,out] source Source buffer.
+ * \param[in] frames Number of frames to process.
  */
 static void vol_s16_to_s16(struct comp_dev *dev, struct comp_buffer *sink,
-			   struct comp_buffer *source)
+			   struct comp_buffer *source, uint32_t frames)
 {
 	struct comp_data *cd = comp_get_drvdata(dev);
 	uint32_t vol_scaled[SOF_IPC_MAX_CHANNELS];
@@ -68,7 +69,7 @@ static void vol_s16_to_s16(struct comp_dev *dev, struct comp_buffer *sink,
 		vol_scaled[channel] = cd->volume[channel] * VOL_SCALE;
 
 	/* Main processing loop */
-	for (i = 0; i < dev->frames; i++) {
+	for (i = 0; i < frames; i++) {
 		/* Processing per channel */
 		for (channel = 0; channel < dev->params.channels; channel++) {
 			/* Load the input sample */
@@ -95,9 +96,10 @@ static void vol_s16_to_s16(struct comp_dev *dev, struct comp_buffer *sink,
  * \param[in,out] dev Volume base component device.
  * \param[in,out] sink Destination buffer.
  * \param[in,out] source Source buffer.
+ * \param[in] frames Number of frames to process.
  */
 static void vol_s16_to_sX(struct comp_dev *dev, struct comp_buffer *sink,
-			  struct comp_buffer *source)
+			  struct comp_buffer *source, uint32_t frames)
 {
 	struct comp_data *cd = comp_get_drvdata(dev);
 	uint32_t vol_scaled[SOF_IPC_MAX_CHANNELS];
@@ -122,7 +124,7 @@ static void vol_s16_to_sX(struct comp_dev *dev, struct comp_buffer *sink,
 		vol_scaled[channel] = cd->volume[channel] * VOL_SCALE;
 
 	/* Main processing loop */
-	for (i = 0; i < dev->frames; i++) {
+	for (i = 0; i < frames; i++) {
 		/* Processing per channel */
 		for (channel = 0; channel < dev->params.channels; channel++) {
 			/* Load the input sample */
@@ -151,9 +153,10 @@ static void vol_s16_to_sX(struct comp_dev *dev, struct comp_buffer *sink,
  * \param[in,out] dev Volume base component device.
  * \param[in,out] sink Destination buffer.
  * \param[in,out] source Source buffer.
+ * \param[in] frames Number of frames to process.
  */
 static void vol_sX_to_s16(struct comp_dev *dev, struct comp_buffer *sink,
-			  struct comp_buffer *source)
+			  struct comp_buffer *source, uint32_t frames)
 {
 	struct comp_data *cd = comp_get_drvdata(dev);
 	uint32_t vol_scaled[SOF_IPC_MAX_CHANNELS];
@@ -176,7 +179,7 @@ static void vol_sX_to_s16(struct comp_dev *dev, struct comp_buffer *sink,
 		vol_scaled[channel] = cd->volume[channel] * VOL_SCALE;
 
 	/* Main processing loop */
-	for (i = 0; i < dev->frames; i++) {
+	for (i = 0; i < frames; i++) {
 		/* Processing per channel */
 		for (channel = 0; channel < dev->params.channels; channel++) {
 			/* Load the input sample */
@@ -206,9 +209,10 @@ static void vol_sX_to_s16(struct comp_dev *dev, struct comp_buffer *sink,
  * \param[in,out] dev Volume base component device.
  * \param[in,out] sink Destination buffer.
  * \param[in,out] source Source buffer.
+ * \param[in] frames Number of frames to process.
  */
 static void vol_s24_to_s24_s32(struct comp_dev *dev, struct comp_buffer *sink,
-			       struct comp_buffer *source)
+			       struct comp_buffer *source, uint32_t frames)
 {
 	struct comp_data *cd = comp_get_drvdata(dev);
 	uint32_t vol_scaled[SOF_IPC_MAX_CHANNELS];
@@ -231,7 +235,7 @@ static void vol_s24_to_s24_s32(struct comp_dev *dev, struct comp_buffer *sink,
 		vol_scaled[channel] = cd->volume[channel] * VOL_SCALE;
 
 	/* Main processing loop */
-	for (i = 0; i < dev->frames; i++) {
+	for (i = 0; i < frames; i++) {
 		/* Processing per channel */
 		for (channel = 0; channel < dev->params.channels; channel++) {
 			/* Load the input sample */
@@ -260,9 +264,10 @@ static void vol_s24_to_s24_s32(struct comp_dev *dev, struct comp_buffer *sink,
  * \param[in,out] dev Volume base component device.
  * \param[in,out] sink Destination buffer.
  * \param[in,out] source Source buffer.
+ * \param[in] frames Number of frames to process.
  */
 static void vol_s32_to_s24_s32(struct comp_dev *dev, struct comp_buffer *sink,
-			       struct comp_buffer *source)
+			       struct comp_buffer *source, uint32_t frames)
 {
 	struct comp_data *cd = comp_get_drvdata(dev);
 	uint32_t vol_scaled[SOF_IPC_MAX_CHANNELS];
@@ -285,7 +290,7 @@ static void vol_s32_to_s24_s32(struct comp_dev *dev, struct comp_buffer *sink,
 		vol_scaled[channel] = cd->volume[channel] * VOL_SCALE;
 
 	/* Main processing loop */
-	for (i = 0; i < dev->frames; i++) {
+	for (i = 0; i < frames; i++) {
 		/* Processing per channel */
 		for (channel = 0; channel < dev->params.channels; channel++) {
 			/* Load the input sample */
@@ -482,6 +482,52 @@ static int hda_dma_stop(struct dma *dma, int channel)
 	return 0;
 }
 
+/* cyclic channels copy from a work on the core that started them */
+static inline int hda_dma_work_running(struct dma *dma, int channel)
+{
+	struct dma_pdata *p = dma_get_drvdata(dma);
+
+	return p->chan[channel].dma_ch_work.cb &&
+		((p->chan[channel].state & HDA_STATE_INIT) ||
+		 (host_dma_reg_read(dma, channel, DGCS) & DGCS_GEN));
+}
+
+/* the work queue timers of all cores count the same clock, so the work
+ * keeps its timeout on the new core
+ */
+static int hda_dma_migrate_out(struct dma *dma, int channel)
+{
+	struct dma_pdata *p = dma_get_drvdata(dma);
+	uint32_t flags;
+
+	spin_lock_irq(&dma->lock, flags);
+
+	trace_host("Dmo");
+
+	if (hda_dma_work_running(dma, channel))
+		work_cancel_default(&p->chan[channel].dma_ch_work);
+
+	spin_unlock_irq(&dma->lock, flags);
+	return 0;
+}
+
+static int hda_dma_migrate_in(struct dma *dma, int channel)
+{
+	struct dma_pdata *p = dma_get_drvdata(dma);
+	struct work *work = &p->chan[channel].dma_ch_work;
+	uint32_t flags;
+
+	spin_lock_irq(&dma->lock, flags);
+
+	trace_host("Dmi");
+
+	if (hda_dma_work_running(dma, channel))
+		work_reschedule_default_at(work, work->timeout);
+
+	spin_unlock_irq(&dma->lock, flags);
+	return 0;
+}
+
 /* fill in "status" with current DMA channel state and position */
 static int hda_dma_status(struct dma *dma, int channel,
 	struct dma_chan_status *status, uint8_t direction)
@@ -686,6 +732,8 @@ const struct dma_ops hda_host_dma_ops = {
 	.status		= hda_dma_status,
 	.set_config	= hda_dma_set_config,
 	.set_cb		= hda_dma_set_cb,
+	.migrate_out	= hda_dma_migrate_out,
+	.migrate_in	= hda_dma_migrate_in,
 	.pm_context_restore		= hda_dma_pm_context_restore,
 	.pm_context_store		= hda_dma_pm_context_store,
 	.probe		= hda_dma_probe,
@@ -703,6 +751,8 @@ const struct dma_ops hda_link_dma_ops = {
 	.status		= hda_dma_status,
 	.set_config	= hda_dma_set_config,
 	.set_cb		= hda_dma_set_cb,
+	.migrate_out	= hda_dma_migrate_out,
+	.migrate_in	= hda_dma_migrate_in,
 	.pm_context_restore		= hda_dma_pm_context_restore,
 	.pm_context_store		= hda_dma_pm_context_store,
 	.probe		= hda_dma_probe,
@@ -466,6 +466,51 @@ out:
 	return ret;
 }
 
+/*
+ * Restart a channel stopped at the end of a block from its current
+ * descriptor. The descriptors from set_config() are reused as they are,
+ * so clients with a cyclic descriptor list only need this every period.
+ * The block length is given by the descriptors and the client callback.
+ */
+static int dw_dma_copy(struct dma *dma, int channel, int bytes,
+		       uint32_t flags)
+{
+	struct dma_pdata *p = dma_get_drvdata(dma);
+	struct dw_lli2 *lli = p->chan[channel].lli_current;
+	uint32_t lock_flags;
+	int ret = 0;
+
+	spin_lock_irq(&dma->lock, lock_flags);
+
+	tracev_dma("Dcp");
+
+	/* previous block must be complete */
+	if (p->chan[channel].status != COMP_STATE_PREPARE || !lli) {
+		ret = -EBUSY;
+		trace_dma_error("eC0");
+		trace_error_value(p->chan[channel].status);
+		goto out;
+	}
+
+#if DW_USE_HW_LLI
+	dw_write(dma, DW_LLP(channel), (uint32_t)lli);
+#endif
+	dw_write(dma, DW_SAR(channel), lli->sar);
+	dw_write(dma, DW_DAR(channel), lli->dar);
+	dw_write(dma, DW_CTRL_LOW(channel), lli->ctrl_lo);
+	dw_write(dma, DW_CTRL_HIGH(channel), lli->ctrl_hi);
+	dw_write(dma, DW_CFG_LOW(channel), p->chan[channel].cfg_lo);
+	dw_write(dma, DW_CFG_HIGH(channel), p->chan[channel].cfg_hi);
+
+	/* enable the channel */
+	p->chan[channel].status = COMP_STATE_ACTIVE;
+	dw_write(dma, DW_DMA_CHAN_EN, CHAN_ENABLE(channel));
+
+out:
+	spin_unlock_irq(&dma->lock, lock_flags);
+	return ret;
+}
+
 static int dw_dma_release(struct dma *dma, int channel)
 {
 	struct dma_pdata *p = dma_get_drvdata(dma);
@@ -503,6 +548,58 @@ out:
 	return 0;
 }
 
+/*
+ * Hand the block interrupt or the timer work of a running channel over to
+ * another core. The channel keeps transferring, an interrupt raised while
+ * no core has it enabled stays pending until the new core enables it. The
+ * work queue timers of all cores count the same clock, so the work keeps
+ * its timeout.
+ */
+static int dw_dma_migrate_out(struct dma *dma, int channel)
+{
+	struct dma_pdata *p = dma_get_drvdata(dma);
+	uint32_t flags;
+
+	spin_lock_irq(&dma->lock, flags);
+
+	trace_dma("Dmo");
+
+	if (p->chan[channel].status != COMP_STATE_ACTIVE)
+		goto out;
+
+	if (p->chan[channel].timer_delay)
+		work_cancel_default(&p->chan[channel].dma_ch_work);
+	else
+		dw_dma_interrupt_unregister(dma, channel);
+
+out:
+	spin_unlock_irq(&dma->lock, flags);
+	return 0;
+}
+
+static int dw_dma_migrate_in(struct dma *dma, int channel)
+{
+	struct dma_pdata *p = dma_get_drvdata(dma);
+	struct work *work = &p->chan[channel].dma_ch_work;
+	uint32_t flags;
+
+	spin_lock_irq(&dma->lock, flags);
+
+	trace_dma("Dmi");
+
+	if (p->chan[channel].status != COMP_STATE_ACTIVE)
+		goto out;
+
+	if (p->chan[channel].timer_delay)
+		work_reschedule_default_at(work, work->timeout);
+	else
+		dw_dma_interrupt_register(dma, channel);
+
+out:
+	spin_unlock_irq(&dma->lock, flags);
+	return 0;
+}
+
 #if defined CONFIG_BAYTRAIL || defined CONFIG_CHERRYTRAIL
 static int dw_dma_stop(struct dma *dma, int channel)
 {
@@ -527,7 +624,9 @@ static int dw_dma_stop(struct dma *dma, int channel)
 	if (!p->chan[channel].timer_delay)
 		dw_write(dma, DW_CLEAR_BLOCK, 0x1 << channel);
 
+	/* next start begins at the first descriptor */
 	p->chan[channel].status = COMP_STATE_PREPARE;
+	p->chan[channel].lli_current = p->chan[channel].lli;
 
 	spin_unlock_irq(&dma->lock, flags);
 	return ret;
@@ -570,7 +669,9 @@ static int dw_dma_stop(struct dma *dma, int channel)
 		dw_dma_interrupt_unregister(dma, channel);
 	}
 
+	/* next start begins at the first descriptor */
 	p->chan[channel].status = COMP_STATE_PREPARE;
+	p->chan[channel].lli_current = p->chan[channel].lli;
 
 	spin_unlock_irq(&dma->lock, flags);
 	return ret;
@@ -1318,11 +1419,14 @@ const struct dma_ops dw_dma_ops = {
 	.channel_put	= dw_dma_channel_put,
 	.start		= dw_dma_start,
 	.stop		= dw_dma_stop,
+	.copy		= dw_dma_copy,
 	.pause		= dw_dma_pause,
 	.release	= dw_dma_release,
 	.status		= dw_dma_status,
 	.set_config	= dw_dma_set_config,
 	.set_cb		= dw_dma_set_cb,
+	.migrate_out	= dw_dma_migrate_out,
+	.migrate_in	= dw_dma_migrate_in,
 	.pm_context_restore		= dw_dma_pm_context_restore,
 	.pm_context_store		= dw_dma_pm_context_store,
 	.probe		= dw_dma_probe,
@@ -34,27 +34,497 @@
 #include <stdlib.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <malloc.h>
 #include <sof/alloc.h>
+#include <uapi/ipc.h>
 #include "host/common_test.h"
+#include "host/alloc.h"
 
-/* testbench mem alloc definition */
+/*
+ * testbench mem alloc definition
+ *
+ * Every allocation is prefixed with a header recording its size, zone,
+ * caps and owner so usage can be accounted per heap zone, per caps and
+ * per topology component. Sizes are the requested bytes, firmware block
+ * allocators round these up to their block sizes.
+ *
+ * Pipeline arenas follow the firmware allocator, see sof/alloc.h. Host
+ * memory satisfies any caps so only uncached allocations and audio
+ * buffers bypass them.
+ */
+
+struct tb_arena {
+	int pipeline_id;
+	char *base;		/* arena memory, NULL if arena is unused */
+	size_t used;		/* bytes handed out from base */
+	size_t last;		/* offset of the most recent allocation */
+	uint32_t live;		/* number of allocations not yet freed */
+	int released;		/* pipeline freed, release on last free */
+};
+
+struct tb_mem_hdr {
+	size_t bytes;
+	uint32_t caps;
+	int zone;		/* zone type index */
+	int owner;		/* component id or TB_MEM_OWNER_NONE */
+	struct tb_arena *arena;	/* arena holding the allocation or NULL */
+} __attribute__ ((__aligned__(16)));
+
+/* saved ops of a driver with wrapped ops */
+struct tb_mem_drv {
+	struct comp_driver *drv;
+	struct comp_ops ops;
+};
+
+static const char * const tb_mem_zone_name[TB_MEM_ZONES] = {
+	"sys", "runtime", "buffer",
+};
+
+static const char * const tb_mem_caps_name[TB_MEM_CAPS] = {
+	"ram", "rom", "ext", "lp", "hp", "dma", "cache", "exec",
+};
+
+static struct tb_mem_stats tb_mem_zone[TB_MEM_ZONES];
+static struct tb_mem_stats tb_mem_caps[TB_MEM_CAPS];
+static struct tb_mem_stats tb_mem_comp[TB_MEM_MAX_OWNERS];
+static struct tb_mem_stats tb_mem_other;
+static struct tb_mem_stats tb_mem_total;
+static char *tb_mem_name[TB_MEM_MAX_OWNERS];
+static struct tb_mem_drv tb_mem_drv[TB_MEM_MAX_DRIVERS];
+static int tb_mem_current = TB_MEM_OWNER_NONE;
+static struct tb_arena tb_arena[HEAP_ARENA_COUNT];
+static struct tb_arena *tb_arena_current;
+static uint32_t tb_arena_created;
+
+static inline int tb_mem_zone_index(int zone)
+{
+	switch (zone & RZONE_TYPE_MASK) {
+	case RZONE_SYS:
+		return 0;
+	case RZONE_BUFFER:
+		return 2;
+	default:
+		return 1;
+	}
+}
+
+static inline struct tb_mem_stats *tb_mem_owner_stats(int owner)
+{
+	if (owner < 0 || owner >= TB_MEM_MAX_OWNERS)
+		return &tb_mem_other;
+
+	return &tb_mem_comp[owner];
+}
+
+static void tb_mem_add(struct tb_mem_stats *stats, size_t bytes)
+{
+	stats->bytes += bytes;
+	stats->allocs++;
+	if (stats->bytes > stats->peak)
+		stats->peak = stats->bytes;
+}
+
+static void tb_mem_sub(struct tb_mem_stats *stats, size_t bytes)
+{
+	stats->bytes -= bytes;
+	stats->frees++;
+}
+
+static void tb_mem_account(struct tb_mem_hdr *hdr, int alloc)
+{
+	void (*update)(struct tb_mem_stats *stats, size_t bytes) =
+		alloc ? tb_mem_add : tb_mem_sub;
+	int i;
+
+	update(&tb_mem_total, hdr->bytes);
+	update(&tb_mem_zone[hdr->zone], hdr->bytes);
+	update(tb_mem_owner_stats(hdr->owner), hdr->bytes);
+
+	for (i = 0; i < TB_MEM_CAPS; i++) {
+		if (hdr->caps & (1 << i))
+			update(&tb_mem_caps[i], hdr->bytes);
+	}
+}
+
+static struct tb_arena *tb_arena_find(int pipeline_id)
+{
+	int i;
+
+	for (i = 0; i < HEAP_ARENA_COUNT; i++) {
+		if (tb_arena[i].base && !tb_arena[i].released &&
+		    tb_arena[i].pipeline_id == pipeline_id)
+			return &tb_arena[i];
+	}
+
+	return NULL;
+}
+
+static struct tb_arena *tb_arena_new(int pipeline_id)
+{
+	struct tb_arena *arena;
+	int i;
+
+	for (i = 0; i < HEAP_ARENA_COUNT; i++) {
+		if (!tb_arena[i].base)
+			break;
+	}
+
+	if (i == HEAP_ARENA_COUNT)
+		return NULL;
+
+	arena = &tb_arena[i];
+	arena->base = malloc(HEAP_ARENA_SIZE);
+	if (!arena->base)
+		return NULL;
+
+	arena->pipeline_id = pipeline_id;
+	arena->used = 0;
+	arena->last = 0;
+	arena->live = 0;
+	arena->released = 0;
+	tb_arena_created++;
+
+	return arena;
+}
+
+static void tb_arena_free_memory(struct tb_arena *arena)
+{
+	if (tb_arena_current == arena)
+		tb_arena_current = NULL;
+
+	free(arena->base);
+	arena->base = NULL;
+}
+
+/* header and data from the selected arena, NULL if it has no room */
+static struct tb_mem_hdr *tb_arena_alloc(int zone, size_t bytes)
+{
+	struct tb_arena *arena = tb_arena_current;
+	struct tb_mem_hdr *hdr;
+	size_t offset;
+
+	/* audio buffers are stream memory, not topology objects */
+	if (!arena || (zone & RZONE_FLAG_MASK) == RZONE_FLAG_UNCACHED ||
+	    (zone & RZONE_TYPE_MASK) == RZONE_BUFFER)
+		return NULL;
+
+	offset = (arena->used + sizeof(*hdr) - 1) & ~(sizeof(*hdr) - 1);
+	if (offset + sizeof(*hdr) + bytes > HEAP_ARENA_SIZE)
+		return NULL;
+
+	arena->last = offset;
+	arena->used = offset + sizeof(*hdr) + bytes;
+	arena->live++;
+
+	hdr = (struct tb_mem_hdr *)(arena->base + offset);
+	hdr->arena = arena;
+
+	return hdr;
+}
+
+static void tb_arena_free(struct tb_mem_hdr *hdr)
+{
+	struct tb_arena *arena = hdr->arena;
+
+	arena->live--;
+
+	/* most recent allocation can be handed out again */
+	if ((char *)hdr == arena->base + arena->last)
+		arena->used = arena->last;
+
+	if (!arena->live) {
+		arena->used = 0;
+		arena->last = 0;
+		if (arena->released)
+			tb_arena_free_memory(arena);
+	}
+}
+
+int arena_select(int pipeline_id)
+{
+	int prev = tb_arena_current ? tb_arena_current->pipeline_id :
+		ARENA_NONE;
+	struct tb_arena *arena = NULL;
+
+	if (pipeline_id != ARENA_NONE) {
+		arena = tb_arena_find(pipeline_id);
+		if (!arena)
+			arena = tb_arena_new(pipeline_id);
+	}
+
+	tb_arena_current = arena;
+	return prev;
+}
+
+void arena_release(int pipeline_id)
+{
+	struct tb_arena *arena = tb_arena_find(pipeline_id);
+
+	if (!arena)
+		return;
+
+	arena->released = 1;
+	if (!arena->live)
+		tb_arena_free_memory(arena);
+}
+
+static void *tb_mem_alloc(int zone, uint32_t caps, size_t bytes, int zero)
+{
+	struct tb_mem_hdr *hdr;
+
+	hdr = tb_arena_alloc(zone, bytes);
+	if (hdr) {
+		if (zero)
+			memset(hdr + 1, 0, bytes);
+	} else {
+		hdr = zero ? calloc(sizeof(*hdr) + bytes, 1) :
+			malloc(sizeof(*hdr) + bytes);
+		if (!hdr) {
+			tb_mem_zone[tb_mem_zone_index(zone)].failed++;
+			tb_mem_owner_stats(tb_mem_current)->failed++;
+			tb_mem_total.failed++;
+			return NULL;
+		}
+		hdr->arena = NULL;
+	}
+
+	hdr->bytes = bytes;
+	hdr->caps = caps;
+	hdr->zone = tb_mem_zone_index(zone);
+	hdr->owner = tb_mem_current;
+	tb_mem_account(hdr, 1);
+
+	return hdr + 1;
+}
 
 void *rmalloc(int zone, uint32_t caps, size_t bytes)
 {
-	return malloc(bytes);
+	return tb_mem_alloc(zone, caps, bytes, 0);
 }
 
 void *rzalloc(int zone, uint32_t caps, size_t bytes)
 {
-	return calloc(bytes, 1);
+	return tb_mem_alloc(zone, caps, bytes, 1);
+}
+
+/* there are no block sizes to round up to on the host, so slab objects
+ * are allocated from the host heap, never from the selected arena
+ */
+void *rzalloc_slab(int zone, int slab, size_t bytes)
+{
+	struct tb_arena *arena = tb_arena_current;
+	void *ptr;
+
+	tb_arena_current = NULL;
+	ptr = tb_mem_alloc(zone, SOF_MEM_CAPS_RAM, bytes, 1);
+	tb_arena_current = arena;
+
+	return ptr;
 }
 
 void rfree(void *ptr)
 {
-	free(ptr);
+	struct tb_mem_hdr *hdr;
+
+	if (!ptr)
+		return;
+
+	hdr = (struct tb_mem_hdr *)ptr - 1;
+	tb_mem_account(hdr, 0);
+
+	if (hdr->arena)
+		tb_arena_free(hdr);
+	else
+		free(hdr);
 }
 
+/* buffers always come from the buffer heap in firmware */
 void *rballoc(int zone, uint32_t caps, size_t bytes)
 {
-	return malloc(bytes);
+	return tb_mem_alloc(RZONE_BUFFER, caps, bytes, 0);
+}
+
+/* PM context is not saved on the host, there are no changes to track */
+void mm_pm_dirty(void *ptr)
+{
+}
+
+int tb_mem_owner(int owner)
+{
+	int prev = tb_mem_current;
+
+	tb_mem_current = owner;
+	return prev;
+}
+
+void tb_mem_owner_name(int owner, const char *name)
+{
+	if (owner < 0 || owner >= TB_MEM_MAX_OWNERS)
+		return;
+
+	free(tb_mem_name[owner]);
+	tb_mem_name[owner] = strdup(name);
+}
+
+static const struct comp_ops *tb_mem_drv_ops(struct comp_dev *dev)
+{
+	int i;
+
+	for (i = 0; i < TB_MEM_MAX_DRIVERS; i++) {
+		if (tb_mem_drv[i].drv == dev->drv)
+			return &tb_mem_drv[i].ops;
+	}
+
+	/* not reached, ops are only wrapped for tracked drivers */
+	abort();
+}
+
+static int tb_mem_params(struct comp_dev *dev)
+{
+	int owner = tb_mem_owner(dev->comp.id);
+	int ret = tb_mem_drv_ops(dev)->params(dev);
+
+	tb_mem_owner(owner);
+	return ret;
+}
+
+static int tb_mem_cmd(struct comp_dev *dev, int cmd, void *data)
+{
+	int owner = tb_mem_owner(dev->comp.id);
+	int ret = tb_mem_drv_ops(dev)->cmd(dev, cmd, data);
+
+	tb_mem_owner(owner);
+	return ret;
+}
+
+static int tb_mem_trigger(struct comp_dev *dev, int cmd)
+{
+	int owner = tb_mem_owner(dev->comp.id);
+	int ret = tb_mem_drv_ops(dev)->trigger(dev, cmd);
+
+	tb_mem_owner(owner);
+	return ret;
+}
+
+static int tb_mem_prepare(struct comp_dev *dev)
+{
+	int owner = tb_mem_owner(dev->comp.id);
+	int ret = tb_mem_drv_ops(dev)->prepare(dev);
+
+	tb_mem_owner(owner);
+	return ret;
+}
+
+static int tb_mem_reset(struct comp_dev *dev)
+{
+	int owner = tb_mem_owner(dev->comp.id);
+	int ret = tb_mem_drv_ops(dev)->reset(dev);
+
+	tb_mem_owner(owner);
+	return ret;
+}
+
+/*
+ * Wrap the driver ops that may allocate so allocations are attributed to
+ * the calling component. Allocations in new() are attributed by the
+ * topology loader and copy() is left alone as it must not allocate.
+ */
+int tb_mem_track_comp(struct comp_dev *dev)
+{
+	struct comp_ops *ops = &dev->drv->ops;
+	int i;
+
+	for (i = 0; i < TB_MEM_MAX_DRIVERS; i++) {
+		if (tb_mem_drv[i].drv == dev->drv)
+			return 0;
+		if (!tb_mem_drv[i].drv)
+			break;
+	}
+
+	if (i == TB_MEM_MAX_DRIVERS)
+		return -ENOMEM;
+
+	tb_mem_drv[i].drv = dev->drv;
+	tb_mem_drv[i].ops = *ops;
+
+	if (ops->params)
+		ops->params = tb_mem_params;
+	if (ops->cmd)
+		ops->cmd = tb_mem_cmd;
+	if (ops->trigger)
+		ops->trigger = tb_mem_trigger;
+	if (ops->prepare)
+		ops->prepare = tb_mem_prepare;
+	if (ops->reset)
+		ops->reset = tb_mem_reset;
+
+	return 0;
+}
+
+static void tb_mem_print_stats(const char *name,
+			       const struct tb_mem_stats *stats)
+{
+	printf("%-16s %10zu %10zu %8u %8u %6u\n", name, stats->peak,
+	       stats->bytes, stats->allocs, stats->frees, stats->failed);
+}
+
+/* current bytes are leaks when printed after the pipeline is freed */
+void tb_mem_print(void)
+{
+	char name[DEBUG_MSG_LEN];
+	int i;
+
+	printf("%-16s %10s %10s %8s %8s %6s\n", "Memory", "peak", "current",
+	       "allocs", "frees", "failed");
+
+	for (i = 0; i < TB_MEM_ZONES; i++) {
+		sprintf(name, "zone %s", tb_mem_zone_name[i]);
+		tb_mem_print_stats(name, &tb_mem_zone[i]);
+	}
+
+	for (i = 0; i < TB_MEM_CAPS; i++) {
+		if (!tb_mem_caps[i].allocs)
+			continue;
+		sprintf(name, "caps %s", tb_mem_caps_name[i]);
+		tb_mem_print_stats(name, &tb_mem_caps[i]);
+	}
+
+	for (i = 0; i < TB_MEM_MAX_OWNERS; i++) {
+		if (!tb_mem_comp[i].allocs && !tb_mem_comp[i].failed)
+			continue;
+		snprintf(name, sizeof(name), "%d %s", i,
+			 tb_mem_name[i] ? tb_mem_name[i] : "");
+		tb_mem_print_stats(name, &tb_mem_comp[i]);
+	}
+
+	tb_mem_print_stats("other", &tb_mem_other);
+	tb_mem_print_stats("total", &tb_mem_total);
+}
+
+/*
+ * Host heap fragmentation, free bytes the allocator holds below the top of
+ * the heap where they can only be reused by allocations that fit them.
+ */
+void tb_mem_print_heap(const char *when)
+{
+	struct mallinfo2 mi = mallinfo2();
+	size_t trapped = mi.fordblks - mi.keepcost;
+	uint32_t arenas = 0;
+	size_t used = 0;
+	int i;
+
+	for (i = 0; i < HEAP_ARENA_COUNT; i++) {
+		if (tb_arena[i].base) {
+			arenas++;
+			used += tb_arena[i].used;
+		}
+	}
+
+	printf("Heap %s: %zu bytes, %zu in use, %zu free in %zu chunks ",
+	       when, mi.arena, mi.uordblks, trapped, mi.ordblks);
+	printf("(%.1f%% fragmented), arenas %u live %u created %zu used\n",
+	       mi.arena ? 100.0 * trapped / mi.arena : 0.0, arenas,
+	       tb_arena_created, used);
 }
@@ -49,6 +49,8 @@
 #include <sof/intel-ipc.h>
 #include <sof/audio/pipeline.h>
 #include "host/common_test.h"
+#include "host/dai.h"
+#include "host/dma.h"
 #include "host/topology.h"
 
 /* print debug messages */
@@ -65,6 +67,10 @@ int tb_pipeline_setup(struct sof *sof)
 	/* init components */
 	sys_comp_init();
 
+	/* install the emulated DMA controllers and DAIs */
+	emu_dma_init();
+	emu_dai_init();
+
 	/* init IPC */
 	if (ipc_init(sof) < 0) {
 		fprintf(stderr, "error: IPC init\n");
@@ -87,6 +93,7 @@ int tb_pipeline_start(struct ipc *ipc, int nch, char *bits_in,
 		      struct sof_ipc_pipe_new *ipc_pipe)
 {
 	struct ipc_comp_dev *pcm_dev;
+	struct sof_ipc_stream *stream;
 	struct pipeline *p;
 	struct comp_dev *cd;
 	int ret;
@@ -112,6 +119,11 @@ int tb_pipeline_start(struct ipc *ipc, int nch, char *bits_in,
 	/* Component prepare */
 	ret = pipeline_prepare(p, cd);
 
+	/* a pipeline on another core gets the trigger from the IPC data */
+	stream = ipc->comp_data;
+	stream->hdr.size = sizeof(*stream);
+	stream->comp_id = ipc_pipe->sched_id;
+
 	/* Start the pipeline */
 	ret = pipeline_trigger(p, cd, COMP_TRIGGER_START);
 	if (ret < 0)
@@ -220,37 +232,3 @@ int get_index_by_type(uint32_t comp_type,
 
 	return -EINVAL;
 }
-
-/* The following definitions are to satisfy libsof linker errors */
-
-struct dai *dai_get(uint32_t type, uint32_t index, uint32_t flags)
-{
-	return NULL;
-}
-
-void dai_put(struct dai *dai)
-{
-}
-
-struct dma *dma_get(uint32_t dir, uint32_t caps, uint32_t dev, uint32_t flags)
-{
-	return NULL;
-}
-
-void dma_put(struct dma *dma)
-{
-}
-
-int dma_sg_alloc(struct dma_sg_elem_array *elem_array,
-		 int zone,
-		 uint32_t direction,
-		 uint32_t buffer_count, uint32_t buffer_bytes,
-		 uintptr_t dma_buffer_addr, uintptr_t external_addr)
-{
-	return 0;
-}
-
-void dma_sg_free(struct dma_sg_elem_array *elem_array)
-{
-}
-
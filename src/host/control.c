@@ -0,0 +1,404 @@
+/*
+ * Copyright (c) 2018, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of the Intel Corporation nor the
+ *     names of its contributors may be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Timed control events for the testbench.
+ *
+ * Each line of the control event file is
+ *
+ *   <frame> <comp_id> volume <value> [<value> ...]
+ *   <frame> <comp_id> switch <value> [<value> ...]
+ *   <frame> <comp_id> enum <ctrl_index> <value> [<value> ...]
+ *   <frame> <comp_id> bytes <ctrl_index> <blob_file>
+ *
+ * where frame is the input frame position. Values are per channel for
+ * volume and switch and per control element for enum, bytes sends the
+ * binary blob file with an ABI header. Lines starting with # are
+ * comments. Events must be in frame order.
+ *
+ * Events are delivered with comp_cmd() at the first period boundary at
+ * or after their frame. An event is settled when the component has no
+ * deferred work pending at a period boundary, e.g. a volume ramp has
+ * completed, which gives the glitch free switch latency.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <sof/ipc.h>
+#include <sof/audio/component.h>
+#include <uapi/ipc.h>
+#include <uapi/abi.h>
+#include "host/common_test.h"
+#include "host/control.h"
+
+static struct tb_ctrl_event *events;
+static int num_events;
+static int next_event;
+
+static struct sof_ipc_ctrl_data *tb_ctrl_alloc(uint32_t comp_id,
+					       size_t payload)
+{
+	struct sof_ipc_ctrl_data *cdata;
+	size_t size = sizeof(*cdata) + payload;
+
+	cdata = calloc(size, 1);
+	if (!cdata)
+		return NULL;
+
+	cdata->rhdr.hdr.cmd = SOF_IPC_GLB_COMP_MSG;
+	cdata->rhdr.hdr.size = size;
+	cdata->comp_id = comp_id;
+
+	return cdata;
+}
+
+/* per channel values for volume and switch controls */
+static int tb_ctrl_parse_chan(struct tb_ctrl_event *ev, char **tok)
+{
+	uint32_t values[TB_CTRL_MAX_ELEMS];
+	int n = 0;
+	int i;
+
+	while (*tok && n < TB_CTRL_MAX_ELEMS) {
+		values[n++] = strtoul(*tok, NULL, 0);
+		*tok = strtok(NULL, " \t\n");
+	}
+
+	if (!n)
+		return -EINVAL;
+
+	ev->cdata = tb_ctrl_alloc(ev->comp_id,
+				  n * sizeof(struct sof_ipc_ctrl_value_chan));
+	if (!ev->cdata)
+		return -ENOMEM;
+
+	ev->cmd = COMP_CMD_SET_VALUE;
+	ev->cdata->type = SOF_CTRL_TYPE_VALUE_CHAN_SET;
+	ev->cdata->cmd = strcmp(ev->type, "volume") ?
+		SOF_CTRL_CMD_SWITCH : SOF_CTRL_CMD_VOLUME;
+	ev->cdata->num_elems = n;
+	for (i = 0; i < n; i++) {
+		ev->cdata->chanv[i].channel = i;
+		ev->cdata->chanv[i].value = values[i];
+	}
+
+	return 0;
+}
+
+/* enum element values as component data with ABI header */
+static int tb_ctrl_parse_enum(struct tb_ctrl_event *ev, uint32_t index,
+			      char **tok)
+{
+	struct sof_ipc_ctrl_value_comp *compv;
+	int32_t values[TB_CTRL_MAX_ELEMS];
+	size_t size;
+	int n = 0;
+	int i;
+
+	while (*tok && n < TB_CTRL_MAX_ELEMS) {
+		values[n++] = strtol(*tok, NULL, 0);
+		*tok = strtok(NULL, " \t\n");
+	}
+
+	if (!n)
+		return -EINVAL;
+
+	size = n * sizeof(*compv);
+	ev->cdata = tb_ctrl_alloc(ev->comp_id, sizeof(struct sof_abi_hdr) +
+				  size);
+	if (!ev->cdata)
+		return -ENOMEM;
+
+	ev->cmd = COMP_CMD_SET_DATA;
+	ev->cdata->type = SOF_CTRL_TYPE_DATA_SET;
+	ev->cdata->cmd = SOF_CTRL_CMD_ENUM;
+	ev->cdata->index = index;
+	ev->cdata->num_elems = n;
+	ev->cdata->data->magic = SOF_ABI_MAGIC;
+	ev->cdata->data->abi = SOF_ABI_VERSION;
+	ev->cdata->data->comp_abi = SOF_ABI_VERSION;
+	ev->cdata->data->size = size;
+
+	compv = (struct sof_ipc_ctrl_value_comp *)ev->cdata->data->data;
+	for (i = 0; i < n; i++) {
+		compv[i].index = i;
+		compv[i].svalue = values[i];
+	}
+
+	return 0;
+}
+
+/* binary blob from file with ABI header */
+static int tb_ctrl_parse_bytes(struct tb_ctrl_event *ev, uint32_t index,
+			       const char *filename)
+{
+	FILE *fh;
+	long size;
+	int ret = 0;
+
+	fh = fopen(filename, "rb");
+	if (!fh) {
+		fprintf(stderr, "error: opening blob %s\n", filename);
+		return -EINVAL;
+	}
+
+	fseek(fh, 0, SEEK_END);
+	size = ftell(fh);
+	fseek(fh, 0, SEEK_SET);
+	if (size <= 0) {
+		ret = -EINVAL;
+		goto out;
+	}
+
+	ev->cdata = tb_ctrl_alloc(ev->comp_id, sizeof(struct sof_abi_hdr) +
+				  size);
+	if (!ev->cdata) {
+		ret = -ENOMEM;
+		goto out;
+	}
+
+	ev->cmd = COMP_CMD_SET_DATA;
+	ev->cdata->type = SOF_CTRL_TYPE_DATA_SET;
+	ev->cdata->cmd = SOF_CTRL_CMD_BINARY;
+	ev->cdata->index = index;
+	ev->cdata->num_elems = size;
+	ev->cdata->data->magic = SOF_ABI_MAGIC;
+	ev->cdata->data->abi = SOF_ABI_VERSION;
+	ev->cdata->data->comp_abi = SOF_ABI_VERSION;
+	ev->cdata->data->size = size;
+
+	if (fread(ev->cdata->data->data, size, 1, fh) != 1)
+		ret = -EIO;
+
+out:
+	fclose(fh);
+	return ret;
+}
+
+static int tb_ctrl_parse_line(struct tb_ctrl_event *ev, char *line)
+{
+	char *tok;
+	uint32_t index;
+
+	tok = strtok(line, " \t\n");
+	if (!tok || tok[0] == '#')
+		return 0;
+	ev->frame = strtoull(tok, NULL, 0);
+
+	tok = strtok(NULL, " \t\n");
+	if (!tok)
+		return -EINVAL;
+	ev->comp_id = strtoul(tok, NULL, 0);
+
+	tok = strtok(NULL, " \t\n");
+	if (!tok)
+		return -EINVAL;
+	strncpy(ev->type, tok, sizeof(ev->type) - 1);
+
+	tok = strtok(NULL, " \t\n");
+	if (!tok)
+		return -EINVAL;
+
+	if (!strcmp(ev->type, "volume") || !strcmp(ev->type, "switch"))
+		return tb_ctrl_parse_chan(ev, &tok) < 0 ? -EINVAL : 1;
+
+	index = strtoul(tok, NULL, 0);
+	tok = strtok(NULL, " \t\n");
+	if (!tok)
+		return -EINVAL;
+
+	if (!strcmp(ev->type, "enum"))
+		return tb_ctrl_parse_enum(ev, index, &tok) < 0 ? -EINVAL : 1;
+
+	if (!strcmp(ev->type, "bytes"))
+		return tb_ctrl_parse_bytes(ev, index, tok) < 0 ? -EINVAL : 1;
+
+	return -EINVAL;
+}
+
+int tb_ctrl_load(const char *filename)
+{
+	struct tb_ctrl_event *ev;
+	char line[TB_CTRL_LINE_LEN];
+	FILE *fh;
+	int line_num = 0;
+	int ret = 0;
+
+	fh = fopen(filename, "r");
+	if (!fh) {
+		fprintf(stderr, "error: opening control file %s\n", filename);
+		return -EINVAL;
+	}
+
+	while (fgets(line, sizeof(line), fh)) {
+		line_num++;
+
+		ev = realloc(events, (num_events + 1) * sizeof(*ev));
+		if (!ev) {
+			ret = -ENOMEM;
+			break;
+		}
+		events = ev;
+		ev = &events[num_events];
+		memset(ev, 0, sizeof(*ev));
+
+		ret = tb_ctrl_parse_line(ev, line);
+		if (ret < 0) {
+			fprintf(stderr, "error: control file %s line %d\n",
+				filename, line_num);
+			free(ev->cdata);
+			break;
+		}
+
+		/* skip comments and empty lines */
+		if (!ret)
+			continue;
+
+		if (num_events && ev->frame < events[num_events - 1].frame) {
+			fprintf(stderr, "error: %s line %d out of order\n",
+				filename, line_num);
+			free(ev->cdata);
+			ret = -EINVAL;
+			break;
+		}
+
+		num_events++;
+		ret = 0;
+	}
+
+	fclose(fh);
+	return ret;
+}
+
+static uint64_t tb_ctrl_time_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+void tb_ctrl_deliver(struct ipc *ipc, uint64_t frame)
+{
+	struct tb_ctrl_event *ev;
+	struct ipc_comp_dev *icd;
+	uint64_t start;
+
+	while (next_event < num_events && events[next_event].frame <= frame) {
+		ev = &events[next_event++];
+		ev->delivered = 1;
+		ev->delivered_frame = frame;
+
+		icd = ipc_get_comp(ipc, ev->comp_id);
+		if (!icd || icd->type != COMP_TYPE_COMPONENT) {
+			fprintf(stderr, "error: no component %u for control\n",
+				ev->comp_id);
+			ev->ret = -ENODEV;
+			continue;
+		}
+
+		start = tb_ctrl_time_ns();
+		ev->ret = comp_cmd(icd->cd, ev->cmd, ev->cdata);
+		ev->cost_ns = tb_ctrl_time_ns() - start;
+	}
+}
+
+void tb_ctrl_settle(struct ipc *ipc, uint64_t frame)
+{
+	struct tb_ctrl_event *ev;
+	struct ipc_comp_dev *icd;
+	int i;
+
+	for (i = 0; i < next_event; i++) {
+		ev = &events[i];
+		if (ev->settled || ev->ret < 0 || frame == ev->delivered_frame)
+			continue;
+
+		/* settled once component has no deferred work */
+		icd = ipc_get_comp(ipc, ev->comp_id);
+		if (!tb_work_pending(icd->cd)) {
+			ev->settled = 1;
+			ev->settled_frame = frame;
+		}
+	}
+}
+
+void tb_ctrl_print(uint32_t rate)
+{
+	struct tb_ctrl_event *ev;
+	uint64_t latency;
+	int i;
+
+	if (!num_events)
+		return;
+
+	printf("Control events:\n");
+	printf("%10s %10s %4s %-8s %6s %10s %10s %10s\n", "frame",
+	       "delivered", "comp", "type", "ret", "cost us", "latency",
+	       "ms");
+
+	for (i = 0; i < num_events; i++) {
+		ev = &events[i];
+		if (!ev->delivered) {
+			printf("%10lu %10s %4u %-8s not delivered\n",
+			       (unsigned long)ev->frame, "-", ev->comp_id,
+			       ev->type);
+			continue;
+		}
+
+		printf("%10lu %10lu %4u %-8s %6d %10.2f ",
+		       (unsigned long)ev->frame,
+		       (unsigned long)ev->delivered_frame, ev->comp_id,
+		       ev->type, ev->ret, ev->cost_ns / 1e3);
+
+		if (!ev->settled) {
+			printf("%10s %10s\n", "-", "-");
+			continue;
+		}
+
+		latency = ev->settled_frame - ev->delivered_frame;
+		printf("%10lu %10.2f\n", (unsigned long)latency,
+		       rate ? 1e3 * latency / rate : 0.0);
+	}
+}
+
+void tb_ctrl_free(void)
+{
+	int i;
+
+	for (i = 0; i < num_events; i++)
+		free(events[i].cdata);
+
+	free(events);
+	events = NULL;
+	num_events = 0;
+	next_event = 0;
+}
@@ -0,0 +1,267 @@
+/*
+ * Copyright (c) 2018, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of the Intel Corporation nor the
+ *     names of its contributors may be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+#include <sched.h>
+#include <pthread.h>
+#include <sof/lock.h>
+#include <sof/list.h>
+#include <sof/cpu.h>
+#include <sof/schedule.h>
+#include <arch/cache.h>
+#include <platform/platcfg.h>
+#include "host/cpu.h"
+
+/*
+ * testbench core emulation
+ *
+ * The thread that sets up the testbench is the master core. Enabling a
+ * slave core starts a thread that acts as the core until it is disabled:
+ * it serves the IDC messages sent to it and runs the tasks queued to its
+ * scheduler in queue order, each to completion. The core id is thread
+ * local, so cpu_get_id() in library code gives the core running it and
+ * schedule_task() queues tasks of other cores to their thread.
+ *
+ * Idle threads poll and yield instead of sleeping, trading host CPU time
+ * for a wake up latency closer to an IDC interrupt.
+ */
+
+struct emu_core {
+	pthread_t thread;
+	uint32_t enabled;	/* thread runs until cleared */
+	uint32_t busy;		/* running a task */
+	spinlock_t lock;	/* protects tasks and busy */
+	struct list_item tasks;	/* tasks queued to the core */
+	struct emu_cpu_stats stats;
+};
+
+__thread int emu_cpu_id = PLATFORM_MASTER_CORE_ID;
+
+/* host memory is coherent, cache operations of all cores only count */
+struct dcache_stats dcache_stats;
+
+static struct emu_core emu_cores[PLATFORM_CORE_COUNT];
+
+uint64_t emu_cpu_time_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static inline int emu_cpu_is_slave(int id)
+{
+	return id >= 0 && id < PLATFORM_CORE_COUNT &&
+		id != PLATFORM_MASTER_CORE_ID;
+}
+
+/* take the next task off the queue, the core is busy until it is done */
+static struct task *emu_cpu_next_task(struct emu_core *core)
+{
+	struct task *task = NULL;
+
+	spin_lock(&core->lock);
+
+	if (!list_is_empty(&core->tasks)) {
+		task = list_first_item(&core->tasks, struct task, list);
+		list_item_del(&task->list);
+		task->state = TASK_STATE_RUNNING;
+		core->busy = 1;
+	}
+
+	spin_unlock(&core->lock);
+
+	return task;
+}
+
+static void emu_cpu_task_done(struct emu_core *core, struct task *task)
+{
+	spin_lock(&core->lock);
+
+	/* the task may have been queued again while running */
+	if (task->state == TASK_STATE_RUNNING)
+		task->state = TASK_STATE_COMPLETED;
+	core->busy = 0;
+
+	spin_unlock(&core->lock);
+}
+
+static void *emu_cpu_thread(void *arg)
+{
+	struct emu_core *core = arg;
+	struct task *task;
+	uint64_t start;
+	uint64_t run;
+	int msgs;
+
+	emu_cpu_id = core - emu_cores;
+
+	while (__atomic_load_n(&core->enabled, __ATOMIC_ACQUIRE)) {
+		start = emu_cpu_time_ns();
+
+		msgs = emu_idc_process(emu_cpu_id);
+
+		task = emu_cpu_next_task(core);
+		if (task) {
+			run = emu_cpu_time_ns();
+			if (task->func)
+				task->func(task->data);
+			task->total_rtime += emu_cpu_time_ns() - run;
+			emu_cpu_task_done(core, task);
+			core->stats.tasks++;
+		}
+
+		if (!task && !msgs) {
+			sched_yield();
+			continue;
+		}
+
+		core->stats.idc += msgs;
+		core->stats.busy_ns += emu_cpu_time_ns() - start;
+	}
+
+	return NULL;
+}
+
+void emu_cpu_enable_core(int id)
+{
+	struct emu_core *core;
+
+	if (!emu_cpu_is_slave(id) || emu_cpu_is_core_enabled(id))
+		return;
+
+	core = &emu_cores[id];
+	spinlock_init(&core->lock);
+	list_init(&core->tasks);
+	core->busy = 0;
+
+	__atomic_store_n(&core->enabled, 1, __ATOMIC_RELEASE);
+	if (pthread_create(&core->thread, NULL, emu_cpu_thread, core)) {
+		fprintf(stderr, "error: can't start core %d\n", id);
+		__atomic_store_n(&core->enabled, 0, __ATOMIC_RELEASE);
+	}
+}
+
+/* tasks still queued are dropped like on a core power down */
+void emu_cpu_disable_core(int id)
+{
+	struct emu_core *core;
+
+	if (!emu_cpu_is_slave(id) || !emu_cpu_is_core_enabled(id))
+		return;
+
+	core = &emu_cores[id];
+	__atomic_store_n(&core->enabled, 0, __ATOMIC_RELEASE);
+	pthread_join(core->thread, NULL);
+}
+
+/* IDC_MSG_POWER_DOWN, the thread is stopped by emu_cpu_disable_core() */
+void cpu_power_down_core(void)
+{
+}
+
+int emu_cpu_is_core_enabled(int id)
+{
+	if (id == PLATFORM_MASTER_CORE_ID)
+		return 1;
+
+	if (!emu_cpu_is_slave(id))
+		return 0;
+
+	return __atomic_load_n(&emu_cores[id].enabled, __ATOMIC_ACQUIRE);
+}
+
+void emu_cpu_schedule(struct task *task)
+{
+	struct emu_core *core = &emu_cores[task->core];
+
+	spin_lock(&core->lock);
+
+	/* a task runs once for any number of requests while queued */
+	if (task->state != TASK_STATE_QUEUED) {
+		list_item_append(&task->list, &core->tasks);
+		task->state = TASK_STATE_QUEUED;
+	}
+
+	spin_unlock(&core->lock);
+}
+
+/* remove a task still queued to a slave core, like schedule_task_cancel() */
+void emu_cpu_cancel(struct task *task)
+{
+	struct emu_core *core;
+
+	if (!emu_cpu_is_slave(task->core))
+		return;
+
+	core = &emu_cores[task->core];
+
+	spin_lock(&core->lock);
+
+	if (task->state == TASK_STATE_QUEUED) {
+		task->state = TASK_STATE_CANCEL;
+		list_item_del(&task->list);
+	}
+
+	spin_unlock(&core->lock);
+}
+
+void emu_cpu_wait_idle(int id)
+{
+	struct emu_core *core;
+	int idle;
+
+	if (!emu_cpu_is_slave(id) || id == emu_cpu_id)
+		return;
+
+	core = &emu_cores[id];
+
+	while (emu_cpu_is_core_enabled(id)) {
+		spin_lock(&core->lock);
+		idle = list_is_empty(&core->tasks) && !core->busy;
+		spin_unlock(&core->lock);
+
+		if (idle)
+			break;
+
+		/* the core may wait for a reply from us */
+		emu_idc_process(emu_cpu_id);
+		sched_yield();
+	}
+}
+
+struct emu_cpu_stats *emu_cpu_get_stats(int id)
+{
+	if (id < 0 || id >= PLATFORM_CORE_COUNT)
+		return NULL;
+
+	return &emu_cores[id].stats;
+}
@@ -0,0 +1,204 @@
+/*
+ * Copyright (c) 2018, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of the Intel Corporation nor the
+ *     names of its contributors may be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <sof/sof.h>
+#include <sof/alloc.h>
+#include <sof/dai.h>
+#include <sof/lock.h>
+#include <sof/audio/component.h>
+#include "host/dai.h"
+
+/*
+ * testbench DAI emulation
+ *
+ * SSP ports whose FIFOs are memory the emulated DMA moves samples through.
+ * The SSP configuration sets the FIFO rate, so DAI DMA transfers complete
+ * on the period clock of the stream. Playback samples leaving the FIFO
+ * and capture samples entering it go to and come from an optional line
+ * handler, capture without one records silence.
+ */
+
+struct emu_dai_pdata {
+	struct emu_dai_fifo fifo[2];
+};
+
+static struct dai emu_ssp[EMU_DAI_SSP_COUNT];
+
+static struct dai_type_info emu_dai_types[] = {
+	{
+		.type = SOF_DAI_INTEL_SSP,
+		.dai_array = emu_ssp,
+		.num_dais = ARRAY_SIZE(emu_ssp),
+	},
+};
+
+static int emu_dai_set_config(struct dai *dai,
+			      struct sof_ipc_dai_config *config)
+{
+	struct emu_dai_pdata *p = dai_get_drvdata(dai);
+	uint32_t frame_bytes;
+	int i;
+
+	if (config->type != SOF_DAI_INTEL_SSP)
+		return -EINVAL;
+
+	/* frame size as computed by the DAI component */
+	switch (config->ssp.sample_valid_bits) {
+	case 16:
+		frame_bytes = 2 * config->ssp.tdm_slots;
+		break;
+	case 17 ... 32:
+		frame_bytes = 4 * config->ssp.tdm_slots;
+		break;
+	default:
+		return -EINVAL;
+	}
+
+	for (i = 0; i < ARRAY_SIZE(p->fifo); i++)
+		p->fifo[i].rate = config->ssp.fsync_rate * frame_bytes;
+
+	return 0;
+}
+
+static int emu_dai_trigger(struct dai *dai, int cmd, int direction)
+{
+	struct emu_dai_pdata *p = dai_get_drvdata(dai);
+
+	switch (cmd) {
+	case COMP_TRIGGER_START:
+	case COMP_TRIGGER_RELEASE:
+		p->fifo[direction].running = 1;
+		break;
+	case COMP_TRIGGER_STOP:
+	case COMP_TRIGGER_PAUSE:
+		p->fifo[direction].running = 0;
+		break;
+	default:
+		break;
+	}
+
+	return 0;
+}
+
+static int emu_dai_pm_context_restore(struct dai *dai)
+{
+	return 0;
+}
+
+static int emu_dai_pm_context_store(struct dai *dai)
+{
+	return 0;
+}
+
+/* the emulated port has no loopback path */
+static int emu_dai_set_loopback_mode(struct dai *dai, uint32_t lbm)
+{
+	return lbm ? -EINVAL : 0;
+}
+
+static int emu_dai_probe(struct dai *dai)
+{
+	struct emu_dai_pdata *p;
+	int i;
+
+	if (dai_get_drvdata(dai))
+		return -EEXIST;
+
+	p = rzalloc(RZONE_SYS, SOF_MEM_CAPS_RAM, sizeof(*p));
+	if (!p)
+		return -ENOMEM;
+
+	/* the DMA finds the FIFO at the DAI FIFO address */
+	for (i = 0; i < ARRAY_SIZE(p->fifo); i++) {
+		p->fifo[i].direction = i;
+		dai->plat_data.fifo[i].offset = (uintptr_t)&p->fifo[i];
+	}
+
+	dai_set_drvdata(dai, p);
+	return 0;
+}
+
+static int emu_dai_remove(struct dai *dai)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(dai->plat_data.fifo); i++)
+		dai->plat_data.fifo[i].offset = 0;
+
+	rfree(dai_get_drvdata(dai));
+	dai_set_drvdata(dai, NULL);
+	return 0;
+}
+
+static const struct dai_ops emu_dai_ops = {
+	.set_config		= emu_dai_set_config,
+	.trigger		= emu_dai_trigger,
+	.pm_context_restore	= emu_dai_pm_context_restore,
+	.pm_context_store	= emu_dai_pm_context_store,
+	.probe			= emu_dai_probe,
+	.remove			= emu_dai_remove,
+	.set_loopback_mode	= emu_dai_set_loopback_mode,
+};
+
+struct emu_dai_fifo *emu_dai_get_fifo(struct dai *dai, int direction)
+{
+	struct emu_dai_pdata *p = dai_get_drvdata(dai);
+
+	return p ? &p->fifo[direction] : NULL;
+}
+
+void emu_dai_fifo_xfer(struct emu_dai_fifo *fifo, void *samples,
+		       uint32_t bytes)
+{
+	if (fifo->running)
+		fifo->bytes += bytes;
+	else
+		fifo->idle_bytes += bytes;
+
+	if (fifo->line)
+		fifo->line(fifo->line_data, samples, bytes);
+	else if (fifo->direction == SOF_IPC_STREAM_CAPTURE)
+		memset(samples, 0, bytes);
+}
+
+void emu_dai_init(void)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(emu_ssp); i++) {
+		emu_ssp[i].type = SOF_DAI_INTEL_SSP;
+		emu_ssp[i].index = i;
+		emu_ssp[i].ops = &emu_dai_ops;
+		spinlock_init(&emu_ssp[i].lock);
+	}
+
+	dai_install(emu_dai_types, ARRAY_SIZE(emu_dai_types));
+}
@@ -0,0 +1,557 @@
+/*
+ * Copyright (c) 2018, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of the Intel Corporation nor the
+ *     names of its contributors may be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <sof/sof.h>
+#include <sof/alloc.h>
+#include <sof/atomic.h>
+#include <sof/dma.h>
+#include <sof/lock.h>
+#include <sof/math/numbers.h>
+#include <sof/audio/component.h>
+#include <platform/dma.h>
+#include "host/dai.h"
+#include "host/dma.h"
+
+/*
+ * testbench DMA emulation
+ *
+ * Software DMA controllers with the semantics of the DW DMA driver, one
+ * for host transfers and one for DAI transfers. Every element of the
+ * configured list is a memcpy() completed on a virtual clock advanced by
+ * emu_dma_run(). Memory to memory transfers take their size divided by
+ * EMU_DMA_BYTES_PER_US to complete, transfers through an emulated DAI
+ * FIFO (see host/dai.h) complete at the FIFO rate so that the DAI period
+ * clock paces them like the hardware handshake.
+ *
+ * On completion the client callback decides how to go on like with
+ * dw-dma: DMA_RELOAD_LLI moves to the next element, DMA_RELOAD_END moves
+ * to the next element and stops the channel, any other size transfers
+ * the returned element next without moving along the list. A non cyclic
+ * list stops at its last element.
+ *
+ * Jitter injection delays each completion, and with it the callback, by
+ * a pseudo random time up to the configured maximum. The transfers after
+ * it keep their nominal times, so a late callback is followed by the
+ * catch up ones like after a late interrupt on the DSP.
+ */
+
+struct emu_dma_chan {
+	uint32_t status;
+	int reserved;
+	struct dma_sg_elem *elems;
+	uint32_t count;
+	uint32_t cyclic;
+	uint32_t direction;
+	uint32_t current;	/* element transferred by the list */
+	struct dma_sg_elem next; /* element given by the callback */
+	int next_pending;
+	uint64_t start;		/* time the channel was started */
+	uint64_t sent;		/* bytes done since start */
+	uint64_t due;		/* nominal completion time */
+	uint32_t delay;		/* injected delay of the completion */
+
+	void (*cb)(void *data, uint32_t type, struct dma_sg_elem *next);
+	void *cb_data;
+	int cb_type;
+};
+
+struct emu_dma_pdata {
+	struct emu_dma_chan chan[EMU_DMA_CHANNELS];
+	struct emu_dma_stats stats;
+};
+
+static const struct dma_ops emu_dma_ops;
+
+static struct dma emu_dma[] = {
+{
+	.plat_data = {
+		.id		= DMA_ID_DMAC0,
+		.dir		= DMA_DIR_HMEM_TO_LMEM |
+				  DMA_DIR_LMEM_TO_HMEM | DMA_DIR_MEM_TO_MEM,
+		.devs		= DMA_DEV_HOST,
+		.channels	= EMU_DMA_CHANNELS,
+	},
+	.ops		= &emu_dma_ops,
+},
+{
+	.plat_data = {
+		.id		= DMA_ID_DMAC1,
+		.dir		= DMA_DIR_MEM_TO_DEV | DMA_DIR_DEV_TO_MEM,
+		.caps		= DMA_CAP_GP_LP | DMA_CAP_GP_HP,
+		.devs		= DMA_DEV_SSP | DMA_DEV_DMIC,
+		.channels	= EMU_DMA_CHANNELS,
+	},
+	.ops		= &emu_dma_ops,
+},
+};
+
+/* virtual time of the last emu_dma_run() or of the completion running */
+static uint64_t emu_dma_time;
+
+/* completion jitter, maximum in usecs and generator state */
+static uint32_t emu_dma_jitter;
+static uint32_t emu_dma_seed = 1;
+
+/* emulated DAI FIFO at the device end of the channel, if any */
+static struct emu_dai_fifo *emu_dma_fifo(struct emu_dma_chan *chan,
+					 struct dma_sg_elem *elem)
+{
+	switch (chan->direction) {
+	case DMA_DIR_MEM_TO_DEV:
+		return (struct emu_dai_fifo *)elem->dest;
+	case DMA_DIR_DEV_TO_MEM:
+		return (struct emu_dai_fifo *)elem->src;
+	default:
+		return NULL;
+	}
+}
+
+/* set the nominal completion time and delay of the element */
+static void emu_dma_schedule(struct emu_dma_chan *chan,
+			     struct dma_sg_elem *elem)
+{
+	struct emu_dai_fifo *fifo = emu_dma_fifo(chan, elem);
+	uint64_t sent = chan->sent + elem->size;
+
+	if (fifo && fifo->rate)
+		chan->due = chan->start +
+			(sent * 1000000 + fifo->rate - 1) / fifo->rate;
+	else
+		chan->due = chan->start +
+			(sent + EMU_DMA_BYTES_PER_US - 1) /
+			EMU_DMA_BYTES_PER_US;
+
+	chan->delay = 0;
+	if (emu_dma_jitter) {
+		/* LCG from C99, good enough for repeatable delays */
+		emu_dma_seed = emu_dma_seed * 1103515245 + 12345;
+		chan->delay = (emu_dma_seed >> 16) % (emu_dma_jitter + 1);
+	}
+}
+
+static int emu_dma_channel_get(struct dma *dma, int req_chan)
+{
+	struct emu_dma_pdata *p = dma_get_drvdata(dma);
+	uint32_t flags;
+	int i;
+
+	spin_lock_irq(&dma->lock, flags);
+
+	/* use the requested channel if it is free */
+	if (req_chan >= 0 && req_chan < EMU_DMA_CHANNELS &&
+	    !p->chan[req_chan].reserved)
+		i = req_chan;
+	else
+		for (i = 0; i < EMU_DMA_CHANNELS; i++)
+			if (!p->chan[i].reserved)
+				break;
+
+	if (i < EMU_DMA_CHANNELS) {
+		p->chan[i].reserved = 1;
+		p->chan[i].status = COMP_STATE_INIT;
+		atomic_add(&dma->num_channels_busy, 1);
+	} else {
+		i = -ENODEV;
+	}
+
+	spin_unlock_irq(&dma->lock, flags);
+	return i;
+}
+
+static void emu_dma_channel_put(struct dma *dma, int channel)
+{
+	struct emu_dma_pdata *p = dma_get_drvdata(dma);
+	struct emu_dma_chan *chan = &p->chan[channel];
+	uint32_t flags;
+
+	spin_lock_irq(&dma->lock, flags);
+
+	/* the DAI component puts its channel on reset and again on free */
+	if (chan->reserved) {
+		rfree(chan->elems);
+		memset(chan, 0, sizeof(*chan));
+		atomic_sub(&dma->num_channels_busy, 1);
+	}
+
+	spin_unlock_irq(&dma->lock, flags);
+}
+
+/* run the channel from its current element */
+static int emu_dma_run_channel(struct dma *dma, int channel)
+{
+	struct emu_dma_pdata *p = dma_get_drvdata(dma);
+	struct emu_dma_chan *chan = &p->chan[channel];
+
+	if (chan->status != COMP_STATE_PREPARE || !chan->count)
+		return -EBUSY;
+
+	chan->status = COMP_STATE_ACTIVE;
+	chan->next_pending = 0;
+	chan->start = emu_dma_time;
+	chan->sent = 0;
+	emu_dma_schedule(chan, chan->elems + chan->current);
+
+	return 0;
+}
+
+static int emu_dma_start(struct dma *dma, int channel)
+{
+	struct emu_dma_pdata *p = dma_get_drvdata(dma);
+	uint32_t flags;
+	int ret;
+
+	spin_lock_irq(&dma->lock, flags);
+
+	ret = emu_dma_run_channel(dma, channel);
+	if (!ret)
+		p->stats.starts++;
+
+	spin_unlock_irq(&dma->lock, flags);
+	return ret;
+}
+
+/* restart a channel stopped at the end of a block, see dw_dma_copy() */
+static int emu_dma_copy(struct dma *dma, int channel, int bytes,
+			uint32_t flags)
+{
+	struct emu_dma_pdata *p = dma_get_drvdata(dma);
+	uint32_t lock_flags;
+	int ret;
+
+	spin_lock_irq(&dma->lock, lock_flags);
+
+	ret = emu_dma_run_channel(dma, channel);
+	if (!ret)
+		p->stats.copies++;
+
+	spin_unlock_irq(&dma->lock, lock_flags);
+	return ret;
+}
+
+static int emu_dma_stop(struct dma *dma, int channel)
+{
+	struct emu_dma_pdata *p = dma_get_drvdata(dma);
+	uint32_t flags;
+
+	/* next start begins at the first element, like dw-dma */
+	spin_lock_irq(&dma->lock, flags);
+	p->chan[channel].status = COMP_STATE_PREPARE;
+	p->chan[channel].current = 0;
+	spin_unlock_irq(&dma->lock, flags);
+
+	return 0;
+}
+
+static int emu_dma_pause(struct dma *dma, int channel)
+{
+	struct emu_dma_pdata *p = dma_get_drvdata(dma);
+	uint32_t flags;
+
+	spin_lock_irq(&dma->lock, flags);
+	if (p->chan[channel].status == COMP_STATE_ACTIVE)
+		p->chan[channel].status = COMP_STATE_PAUSED;
+	spin_unlock_irq(&dma->lock, flags);
+
+	return 0;
+}
+
+static int emu_dma_release(struct dma *dma, int channel)
+{
+	struct emu_dma_pdata *p = dma_get_drvdata(dma);
+	uint32_t flags;
+
+	spin_lock_irq(&dma->lock, flags);
+	if (p->chan[channel].status == COMP_STATE_PAUSED)
+		p->chan[channel].status = COMP_STATE_ACTIVE;
+	spin_unlock_irq(&dma->lock, flags);
+
+	return 0;
+}
+
+static int emu_dma_status(struct dma *dma, int channel,
+			  struct dma_chan_status *status, uint8_t direction)
+{
+	struct emu_dma_pdata *p = dma_get_drvdata(dma);
+
+	status->state = p->chan[channel].status;
+	status->timestamp = emu_dma_time;
+
+	return 0;
+}
+
+static int emu_dma_set_config(struct dma *dma, int channel,
+			      struct dma_sg_config *config)
+{
+	struct emu_dma_pdata *p = dma_get_drvdata(dma);
+	struct emu_dma_chan *chan = &p->chan[channel];
+	uint32_t count = config->elem_array.count;
+	uint32_t flags;
+	int ret = 0;
+
+	if (!count)
+		return -EINVAL;
+
+	spin_lock_irq(&dma->lock, flags);
+
+	/* realloc elements only when the count changes like dw-dma */
+	if (count != chan->count) {
+		rfree(chan->elems);
+		chan->count = 0;
+		chan->elems = rzalloc(RZONE_RUNTIME, SOF_MEM_CAPS_RAM,
+				      sizeof(*chan->elems) * count);
+		if (!chan->elems) {
+			ret = -ENOMEM;
+			goto out;
+		}
+		chan->count = count;
+	}
+
+	memcpy(chan->elems, config->elem_array.elems,
+	       sizeof(*chan->elems) * count);
+	chan->cyclic = config->cyclic;
+	chan->direction = config->direction;
+	chan->current = 0;
+	chan->status = COMP_STATE_PREPARE;
+	p->stats.configs++;
+
+out:
+	spin_unlock_irq(&dma->lock, flags);
+	return ret;
+}
+
+static int emu_dma_set_cb(struct dma *dma, int channel, int type,
+	void (*cb)(void *data, uint32_t type, struct dma_sg_elem *next),
+	void *data)
+{
+	struct emu_dma_pdata *p = dma_get_drvdata(dma);
+	uint32_t flags;
+
+	spin_lock_irq(&dma->lock, flags);
+	p->chan[channel].cb = cb;
+	p->chan[channel].cb_data = data;
+	p->chan[channel].cb_type = type;
+	spin_unlock_irq(&dma->lock, flags);
+
+	return 0;
+}
+
+static int emu_dma_pm_context_restore(struct dma *dma)
+{
+	return 0;
+}
+
+static int emu_dma_pm_context_store(struct dma *dma)
+{
+	return 0;
+}
+
+static int emu_dma_probe(struct dma *dma)
+{
+	struct emu_dma_pdata *p;
+
+	if (dma_get_drvdata(dma))
+		return -EEXIST;
+
+	p = rzalloc(RZONE_SYS, SOF_MEM_CAPS_RAM, sizeof(*p));
+	if (!p)
+		return -ENOMEM;
+
+	dma_set_drvdata(dma, p);
+	return 0;
+}
+
+static int emu_dma_remove(struct dma *dma)
+{
+	rfree(dma_get_drvdata(dma));
+	dma_set_drvdata(dma, NULL);
+	return 0;
+}
+
+/* complete the transfer in flight and set up the next one */
+static void emu_dma_complete(struct emu_dma_pdata *p,
+			     struct emu_dma_chan *chan)
+{
+	struct emu_dai_fifo *fifo;
+	struct dma_sg_elem *elem;
+	struct dma_sg_elem next = {
+		.src = DMA_RELOAD_LLI,
+		.dest = DMA_RELOAD_LLI,
+		.size = DMA_RELOAD_LLI,
+	};
+
+	elem = chan->next_pending ? &chan->next : chan->elems + chan->current;
+	fifo = emu_dma_fifo(chan, elem);
+	if (!fifo)
+		memcpy((void *)elem->dest, (void *)elem->src, elem->size);
+	else if (chan->direction == DMA_DIR_MEM_TO_DEV)
+		emu_dai_fifo_xfer(fifo, (void *)elem->src, elem->size);
+	else
+		emu_dai_fifo_xfer(fifo, (void *)elem->dest, elem->size);
+
+	chan->sent += elem->size;
+	p->stats.transfers++;
+	p->stats.bytes += elem->size;
+	p->stats.jitter += chan->delay;
+	p->stats.jitter_max = MAX(p->stats.jitter_max, chan->delay);
+
+	if (chan->cb)
+		chan->cb(chan->cb_data, chan->cb_type & DMA_IRQ_TYPE_LLIST ?
+			 DMA_IRQ_TYPE_LLIST : DMA_IRQ_TYPE_BLOCK, &next);
+
+	chan->next_pending = 0;
+
+	switch (next.size) {
+	case DMA_RELOAD_END:
+		chan->status = COMP_STATE_PREPARE;
+		if (++chan->current == chan->count)
+			chan->current = 0;
+		return;
+	case DMA_RELOAD_LLI:
+		if (++chan->current == chan->count) {
+			chan->current = 0;
+			if (!chan->cyclic) {
+				chan->status = COMP_STATE_PREPARE;
+				return;
+			}
+		}
+		elem = chan->elems + chan->current;
+		break;
+	default:
+		chan->next = next;
+		chan->next_pending = 1;
+		elem = &chan->next;
+		break;
+	}
+
+	emu_dma_schedule(chan, elem);
+}
+
+/* complete transfers in time order, so callbacks see each other's work */
+void emu_dma_run(uint64_t time)
+{
+	struct emu_dma_pdata *p;
+	struct emu_dma_pdata *first_p;
+	struct emu_dma_chan *chan;
+	struct emu_dma_chan *first;
+	struct dma *dma;
+	uint64_t first_time;
+	int j;
+
+	while (1) {
+		first = NULL;
+		first_time = 0;
+
+		for (dma = emu_dma; dma < emu_dma + ARRAY_SIZE(emu_dma);
+		     dma++) {
+			p = dma_get_drvdata(dma);
+			if (!p)
+				continue;
+
+			for (j = 0; j < EMU_DMA_CHANNELS; j++) {
+				chan = &p->chan[j];
+				if (chan->status != COMP_STATE_ACTIVE ||
+				    chan->due + chan->delay > time ||
+				    (first &&
+				     chan->due + chan->delay >= first_time))
+					continue;
+
+				first = chan;
+				first_p = p;
+				first_time = chan->due + chan->delay;
+			}
+		}
+
+		if (!first)
+			break;
+
+		/* transfers started by the callback follow its time */
+		emu_dma_time = MAX(emu_dma_time, first_time);
+		emu_dma_complete(first_p, first);
+	}
+
+	emu_dma_time = time;
+}
+
+void emu_dma_set_jitter(uint32_t max_us, uint32_t seed)
+{
+	struct emu_dma_pdata *p;
+	struct dma *dma;
+
+	emu_dma_jitter = max_us;
+	emu_dma_seed = seed;
+
+	/* delay stats start over with the new jitter */
+	for (dma = emu_dma; dma < emu_dma + ARRAY_SIZE(emu_dma); dma++) {
+		p = dma_get_drvdata(dma);
+		if (p) {
+			p->stats.jitter = 0;
+			p->stats.jitter_max = 0;
+		}
+	}
+}
+
+struct emu_dma_stats *emu_dma_get_stats(struct dma *dma)
+{
+	struct emu_dma_pdata *p;
+
+	if (dma->ops != &emu_dma_ops)
+		return NULL;
+
+	p = dma_get_drvdata(dma);
+	return p ? &p->stats : NULL;
+}
+
+void emu_dma_init(void)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(emu_dma); i++)
+		spinlock_init(&emu_dma[i].lock);
+
+	dma_install(emu_dma, ARRAY_SIZE(emu_dma));
+}
+
+static const struct dma_ops emu_dma_ops = {
+	.channel_get	= emu_dma_channel_get,
+	.channel_put	= emu_dma_channel_put,
+	.start		= emu_dma_start,
+	.stop		= emu_dma_stop,
+	.copy		= emu_dma_copy,
+	.pause		= emu_dma_pause,
+	.release	= emu_dma_release,
+	.status		= emu_dma_status,
+	.set_config	= emu_dma_set_config,
+	.set_cb		= emu_dma_set_cb,
+	.pm_context_restore	= emu_dma_pm_context_restore,
+	.pm_context_store	= emu_dma_pm_context_store,
+	.probe		= emu_dma_probe,
+	.remove		= emu_dma_remove,
+};
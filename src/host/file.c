@@ -34,6 +34,9 @@
 #include <stdio.h>
 #include <stdint.h>
 #include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
 #include <errno.h>
 #include <inttypes.h>
 #include <sof/sof.h>
@@ -45,6 +48,7 @@
 #include <sof/audio/component.h>
 #include <sof/audio/format.h>
 #include <sof/audio/pipeline.h>
+#include <sof/math/numbers.h>
 #include <uapi/ipc.h>
 #include "host/common_test.h"
 #include "host/file.h"
@@ -87,47 +91,19 @@ static int read_samples_32(struct comp_dev *dev, struct comp_buffer *sink,
 
 			/* copy sample per channel */
 			for (i = 0; i < nch; i++) {
-				/* read sample from file */
-				switch (cd->fs.f_format) {
-				/* text input file */
-				case FILE_TEXT:
-					if (fmt == SOF_IPC_FRAME_S32_LE)
-						ret = fscanf(cd->fs.rfh, "%d",
-							     dest);
-
-					/* mask bits if 24-bit samples */
-					if (fmt == SOF_IPC_FRAME_S24_4LE) {
-						ret = fscanf(cd->fs.rfh, "%d",
-							     &sample);
-						*dest = sample & 0x00ffffff;
-					}
-					/* quit if eof is reached */
-					if (ret == EOF) {
-						cd->fs.reached_eof = 1;
-						goto quit;
-					}
-					break;
-
-				/* raw input file */
-				default:
-					if (fmt == SOF_IPC_FRAME_S32_LE)
-						ret = fread(dest,
-							    sizeof(int32_t),
-							    1, cd->fs.rfh);
-
-					/* mask bits if 24-bit samples */
-					if (fmt == SOF_IPC_FRAME_S24_4LE) {
-						ret = fread(&sample,
-							    sizeof(int32_t),
-							    1, cd->fs.rfh);
-						*dest = sample & 0x00ffffff;
-					}
-					/* quit if eof is reached */
-					if (ret != 1) {
-						cd->fs.reached_eof = 1;
-						goto quit;
-					}
-					break;
+				/* read sample from text file */
+				if (fmt == SOF_IPC_FRAME_S32_LE)
+					ret = fscanf(cd->fs.rfh, "%d", dest);
+
+				/* mask bits if 24-bit samples */
+				if (fmt == SOF_IPC_FRAME_S24_4LE) {
+					ret = fscanf(cd->fs.rfh, "%d", &sample);
+					*dest = sample & 0x00ffffff;
+				}
+				/* quit if eof is reached */
+				if (ret == EOF) {
+					cd->fs.reached_eof = 1;
+					goto quit;
 				}
 				dest++;
 				n_samples++;
@@ -165,27 +141,11 @@ static int read_samples_16(struct comp_dev *dev, struct comp_buffer *sink,
 
 			/* copy sample per channel */
 			for (i = 0; i < nch; i++) {
-				/* read sample from file */
+				/* read sample from text file */
 				ret = fscanf(cd->fs.rfh, "%hd", dest);
-				switch (cd->fs.f_format) {
-				/* text input file */
-				case FILE_TEXT:
-					ret = fscanf(cd->fs.rfh, "%hd", dest);
-					if (ret == EOF) {
-						cd->fs.reached_eof = 1;
-						goto quit;
-					}
-					break;
-
-				/* rw pcm input file */
-				default:
-					ret = fread(dest, sizeof(int16_t), 1,
-						    cd->fs.rfh);
-					if (ret != 1) {
-						cd->fs.reached_eof = 1;
-						goto quit;
-					}
-					break;
+				if (ret == EOF) {
+					cd->fs.reached_eof = 1;
+					goto quit;
 				}
 
 				dest++;
@@ -225,24 +185,10 @@ static int write_samples_16(struct comp_dev *dev, struct comp_buffer *source,
 
 			/* copy sample per channel */
 			for (i = 0; i < nch; i++) {
-				switch (cd->fs.f_format) {
-				/* text output file */
-				case FILE_TEXT:
-					ret = fprintf(cd->fs.wfh,
-						      "%d\n", *src);
-					if (ret < 0)
-						goto quit;
-					break;
-
-				/* raw pcm output file */
-				default:
-					ret = fwrite(src,
-						     sizeof(int16_t),
-						     1, cd->fs.wfh);
-					if (ret != 1)
-						goto quit;
-					break;
-				}
+				/* write sample to text file */
+				ret = fprintf(cd->fs.wfh, "%d\n", *src);
+				if (ret < 0)
+					goto quit;
 
 				src++;
 				n_samples++;
@@ -281,39 +227,17 @@ static int write_samples_32(struct comp_dev *dev, struct comp_buffer *source,
 
 			/* copy sample per channel */
 			for (i = 0; i < nch; i++) {
-				switch (cd->fs.f_format) {
-				/* text output file */
-				case FILE_TEXT:
-					if (fmt == SOF_IPC_FRAME_S32_LE)
-						ret = fprintf(cd->fs.wfh,
-							      "%d\n", *src);
-					if (fmt == SOF_IPC_FRAME_S24_4LE) {
-						sample = *src << 8;
-						ret = fprintf(cd->fs.wfh,
-							      "%d\n",
-							      sample >> 8);
-					}
-					if (ret < 0)
-						goto quit;
-					break;
-
-				/* raw pcm output file */
-				default:
-					if (fmt == SOF_IPC_FRAME_S32_LE)
-						ret = fwrite(src,
-							     sizeof(int32_t),
-							     1, cd->fs.wfh);
-					if (fmt == SOF_IPC_FRAME_S24_4LE) {
-						sample = *src << 8;
-						sample >>= 8;
-						ret = fwrite(&sample,
-							     sizeof(int32_t),
-							     1, cd->fs.wfh);
-					}
-					if (ret != 1)
-						goto quit;
-					break;
+				/* write sample to text file */
+				if (fmt == SOF_IPC_FRAME_S32_LE)
+					ret = fprintf(cd->fs.wfh, "%d\n",
+						      *src);
+				if (fmt == SOF_IPC_FRAME_S24_4LE) {
+					sample = *src << 8;
+					ret = fprintf(cd->fs.wfh, "%d\n",
+						      sample >> 8);
 				}
+				if (ret < 0)
+					goto quit;
 
 				/* increment read pointer */
 				src++;
@@ -330,37 +254,352 @@ quit:
 	return n_samples;
 }
 
-/* function for processing 32-bit samples */
-static int file_s32_default(struct comp_dev *dev, struct comp_buffer *sink,
-			    struct comp_buffer *source, uint32_t frames)
+/* little endian sample and header field access in file block buffer */
+static inline uint32_t file_get_le(const uint8_t *p, int bytes)
+{
+	uint32_t v = 0;
+	int i;
+
+	for (i = bytes - 1; i >= 0; i--)
+		v = (v << 8) | p[i];
+
+	return v;
+}
+
+static inline void file_put_le(uint8_t *p, uint32_t v, int bytes)
+{
+	int i;
+
+	for (i = 0; i < bytes; i++) {
+		p[i] = v & 0xff;
+		v >>= 8;
+	}
+}
+
+/* sign extend sample of bytes container read from file */
+static inline int32_t file_get_sample(const uint8_t *p, int bytes)
+{
+	int s = 32 - 8 * bytes;
+
+	return (int32_t)(file_get_le(p, bytes) << s) >> s;
+}
+
+/*
+ * Refill block buffer from file, partial samples left in the buffer are
+ * moved to the beginning. Returns number of bytes read.
+ */
+static size_t file_fill(struct file_state *fs)
+{
+	size_t left = fs->buf_len - fs->buf_pos;
+	size_t size = FILE_BLOCK_BYTES - left;
+	size_t ret;
+
+	memmove(fs->buf, fs->buf + fs->buf_pos, left);
+	fs->buf_pos = 0;
+	fs->buf_len = left;
+
+	if (fs->data_left < size)
+		size = fs->data_left;
+	if (!size)
+		return 0;
+
+	ret = fread(fs->buf + left, 1, size, fs->rfh);
+	fs->buf_len += ret;
+	fs->data_left -= ret;
+
+	return ret;
+}
+
+/* write block buffer to file */
+static int file_flush(struct file_state *fs)
+{
+	size_t ret;
+
+	if (!fs->buf_len)
+		return 0;
+
+	ret = fwrite(fs->buf, 1, fs->buf_len, fs->wfh);
+	fs->n_bytes += ret;
+	fs->buf_len = 0;
+
+	return ret == 0 ? -EIO : 0;
+}
+
+/* read bytes from file through block buffer */
+static int file_read_bytes(struct file_state *fs, uint8_t *data, size_t n)
+{
+	while (fs->buf_len - fs->buf_pos < n) {
+		if (!file_fill(fs))
+			return -EIO;
+	}
+
+	if (data)
+		memcpy(data, fs->buf + fs->buf_pos, n);
+	fs->buf_pos += n;
+
+	return 0;
+}
+
+/* skip bytes in file, also works for pipes that can't seek */
+static int file_skip_bytes(struct file_state *fs, size_t n)
+{
+	size_t bytes;
+
+	while (n) {
+		bytes = MIN(n, FILE_BLOCK_BYTES / 2);
+		if (file_read_bytes(fs, NULL, bytes) < 0)
+			return -EIO;
+		n -= bytes;
+	}
+
+	return 0;
+}
+
+/*
+ * Parse wav file header up to start of data chunk. Chunks are read in
+ * stream order without seeking so stdin can be used for input.
+ */
+static int wav_read_header(struct file_comp_data *cd)
+{
+	struct file_state *fs = &cd->fs;
+	uint8_t hdr[WAV_FMT_MAX_BYTES];
+	uint32_t size;
+	int block_align;
+	int tag;
+	int fmt_found = 0;
+
+	if (file_read_bytes(fs, hdr, 12) < 0 || memcmp(hdr, "RIFF", 4) ||
+	    memcmp(hdr + 8, "WAVE", 4)) {
+		fprintf(stderr, "error: %s is not a wav file\n", fs->fn);
+		return -EINVAL;
+	}
+
+	while (1) {
+		if (file_read_bytes(fs, hdr, 8) < 0) {
+			fprintf(stderr, "error: no wav data in %s\n", fs->fn);
+			return -EINVAL;
+		}
+
+		size = file_get_le(hdr + 4, 4);
+		if (!memcmp(hdr, "data", 4))
+			break;
+
+		if (memcmp(hdr, "fmt ", 4)) {
+			/* skip unknown chunk with pad byte */
+			if (file_skip_bytes(fs, size + (size & 1)) < 0)
+				return -EINVAL;
+			continue;
+		}
+
+		if (size < 16 || size > WAV_FMT_MAX_BYTES ||
+		    file_read_bytes(fs, hdr, size + (size & 1)) < 0) {
+			fprintf(stderr, "error: wav fmt chunk in %s\n", fs->fn);
+			return -EINVAL;
+		}
+
+		tag = file_get_le(hdr, 2);
+		cd->channels = file_get_le(hdr + 2, 2);
+		cd->rate = file_get_le(hdr + 4, 4);
+		block_align = file_get_le(hdr + 12, 2);
+		fs->sample_bits = file_get_le(hdr + 14, 2);
+
+		/* valid bits and format from extensible fmt */
+		if (tag == WAV_FORMAT_EXTENSIBLE && size >= 26) {
+			fs->sample_bits = file_get_le(hdr + 18, 2);
+			tag = file_get_le(hdr + 24, 2);
+		}
+
+		if (tag != WAV_FORMAT_PCM || !cd->channels) {
+			fprintf(stderr, "error: wav format %x not supported\n",
+				tag);
+			return -EINVAL;
+		}
+
+		fs->sample_bytes = block_align / cd->channels;
+		fmt_found = 1;
+	}
+
+	if (!fmt_found) {
+		fprintf(stderr, "error: no wav fmt in %s\n", fs->fn);
+		return -EINVAL;
+	}
+
+	/* streamed wav has unknown data size, read until eof */
+	if (size == WAV_SIZE_STREAM || !size)
+		return 0;
+
+	/* don't read trailing chunks as samples */
+	if (fs->buf_len - fs->buf_pos > size) {
+		fs->buf_len = fs->buf_pos + size;
+		fs->data_left = 0;
+	} else {
+		fs->data_left = size - (fs->buf_len - fs->buf_pos);
+	}
+
+	return 0;
+}
+
+/*
+ * Write wav header to block buffer. Sizes are unknown at this point and
+ * are set for a stream, file_free() updates them if file can seek.
+ */
+static void wav_write_header(struct file_comp_data *cd)
+{
+	struct file_state *fs = &cd->fs;
+	uint8_t *hdr = fs->buf;
+	int block_align = fs->sample_bytes * cd->channels;
+
+	memcpy(hdr, "RIFF", 4);
+	file_put_le(hdr + 4, WAV_SIZE_STREAM, 4);
+	memcpy(hdr + 8, "WAVEfmt ", 8);
+	file_put_le(hdr + 16, 16, 4);
+	file_put_le(hdr + 20, WAV_FORMAT_PCM, 2);
+	file_put_le(hdr + 22, cd->channels, 2);
+	file_put_le(hdr + 24, cd->rate, 4);
+	file_put_le(hdr + 28, cd->rate * block_align, 4);
+	file_put_le(hdr + 32, block_align, 2);
+	file_put_le(hdr + 34, fs->sample_bits, 2);
+	memcpy(hdr + 36, "data", 4);
+	file_put_le(hdr + 40, WAV_SIZE_STREAM, 4);
+
+	fs->buf_len = WAV_HEADER_BYTES;
+}
+
+/* update wav header sizes after all samples are written */
+static void wav_update_header(struct file_state *fs)
+{
+	uint8_t size[4];
+	uint64_t data_bytes = fs->n_bytes - WAV_HEADER_BYTES;
+
+	/* pipes can't seek, leave stream sizes */
+	if (fs->n_bytes < WAV_HEADER_BYTES ||
+	    data_bytes > WAV_SIZE_STREAM - 36 ||
+	    fseek(fs->wfh, 4, SEEK_SET) < 0)
+		return;
+
+	file_put_le(size, data_bytes + 36, 4);
+	fwrite(size, 1, 4, fs->wfh);
+	fseek(fs->wfh, 40, SEEK_SET);
+	file_put_le(size, data_bytes, 4);
+	fwrite(size, 1, 4, fs->wfh);
+}
+
+/*
+ * Read 16/24/32-bit samples from raw or wav file in blocks
+ * returns number of samples read in whole frames
+ */
+static int read_samples_block(struct comp_dev *dev, struct comp_buffer *sink,
+			      int n, int fmt, int nch)
 {
 	struct file_comp_data *cd = comp_get_drvdata(dev);
-	int nch = dev->params.channels;
+	struct file_state *fs = &cd->fs;
+	int bytes = dev->params.sample_container_bytes;
+	uint8_t *dest = sink->w_ptr;
+	uint8_t *src;
+	int32_t sample;
 	int n_samples = 0;
+	int avail, n_wrap, n_min, i;
+
+	while (n_samples < n) {
+		avail = (fs->buf_len - fs->buf_pos) / fs->sample_bytes;
+		if (!avail) {
+			if (!file_fill(fs)) {
+				fs->reached_eof = 1;
+				break;
+			}
+			continue;
+		}
 
-	switch (cd->fs.mode) {
-	case FILE_READ:
-		/* read samples */
-		n_samples = read_samples_32(dev, sink, frames * nch,
-					    SOF_IPC_FRAME_S32_LE, nch);
-		break;
-	case FILE_WRITE:
-		/* write samples */
-		n_samples = write_samples_32(dev, source, frames * nch,
-					     SOF_IPC_FRAME_S32_LE, nch);
-		break;
-	default:
-		/* TODO: duplex mode */
-		break;
+		/* check for buffer wrap and copy to the end of the buffer */
+		n_wrap = ((uint8_t *)sink->end_addr - dest) / bytes;
+		n_min = MIN(n - n_samples, MIN(avail, n_wrap));
+		src = fs->buf + fs->buf_pos;
+
+		for (i = 0; i < n_min; i++) {
+			sample = file_get_sample(src, fs->sample_bytes) >>
+				fs->shift;
+			if (fmt == SOF_IPC_FRAME_S16_LE)
+				*(int16_t *)dest = sample;
+			else if (fmt == SOF_IPC_FRAME_S24_4LE)
+				*(int32_t *)dest = sample & 0x00ffffff;
+			else
+				*(int32_t *)dest = sample;
+			src += fs->sample_bytes;
+			dest += bytes;
+		}
+
+		fs->buf_pos += n_min * fs->sample_bytes;
+		n_samples += n_min;
+
+		/* check for buffer wrap and update pointer */
+		if (dest >= (uint8_t *)sink->end_addr)
+			dest = sink->addr;
+	}
+
+	/* drop partial frame at end of file */
+	return n_samples - n_samples % nch;
+}
+
+/*
+ * Write 16/24/32-bit samples to raw or wav file in blocks
+ * returns number of samples written
+ */
+static int write_samples_block(struct comp_dev *dev,
+			       struct comp_buffer *source, int n, int fmt)
+{
+	struct file_comp_data *cd = comp_get_drvdata(dev);
+	struct file_state *fs = &cd->fs;
+	int bytes = dev->params.sample_container_bytes;
+	uint8_t *src = source->r_ptr;
+	uint8_t *dest;
+	int32_t sample;
+	int n_samples = 0;
+	int space, n_wrap, n_min, i;
+
+	/* header is written with first samples when format is known */
+	if (fs->f_format == FILE_WAV && !fs->n_bytes && !fs->buf_len)
+		wav_write_header(cd);
+
+	while (n_samples < n) {
+		space = (FILE_BLOCK_BYTES - fs->buf_len) / fs->sample_bytes;
+		if (!space) {
+			if (file_flush(fs) < 0)
+				break;
+			continue;
+		}
+
+		/* check for buffer wrap and copy to the end of the buffer */
+		n_wrap = ((uint8_t *)source->end_addr - src) / bytes;
+		n_min = MIN(n - n_samples, MIN(space, n_wrap));
+		dest = fs->buf + fs->buf_len;
+
+		for (i = 0; i < n_min; i++) {
+			if (fmt == SOF_IPC_FRAME_S16_LE)
+				sample = *(int16_t *)src;
+			else if (fmt == SOF_IPC_FRAME_S24_4LE)
+				sample = sign_extend_s24(*(int32_t *)src);
+			else
+				sample = *(int32_t *)src;
+			file_put_le(dest, (uint32_t)sample << fs->shift,
+				    fs->sample_bytes);
+			dest += fs->sample_bytes;
+			src += bytes;
+		}
+
+		fs->buf_len += n_min * fs->sample_bytes;
+		n_samples += n_min;
+
+		/* check for buffer wrap and update pointer */
+		if (src >= (uint8_t *)source->end_addr)
+			src = source->addr;
 	}
 
-	cd->fs.n += n_samples;
 	return n_samples;
 }
 
-/* function for processing 16-bit samples */
-static int file_s16(struct comp_dev *dev, struct comp_buffer *sink,
-		    struct comp_buffer *source, uint32_t frames)
+/* read or write samples from/to file in any format */
+static int file_samples(struct comp_dev *dev, struct comp_buffer *sink,
+			struct comp_buffer *source, uint32_t frames, int fmt)
 {
 	struct file_comp_data *cd = comp_get_drvdata(dev);
 	int nch = dev->params.channels;
@@ -369,11 +608,27 @@ static int file_s16(struct comp_dev *dev, struct comp_buffer *sink,
 	switch (cd->fs.mode) {
 	case FILE_READ:
 		/* read samples */
-		n_samples = read_samples_16(dev, sink, frames * nch, nch);
+		if (cd->fs.f_format != FILE_TEXT)
+			n_samples = read_samples_block(dev, sink, frames * nch,
+						       fmt, nch);
+		else if (fmt == SOF_IPC_FRAME_S16_LE)
+			n_samples = read_samples_16(dev, sink, frames * nch,
+						    nch);
+		else
+			n_samples = read_samples_32(dev, sink, frames * nch,
+						    fmt, nch);
 		break;
 	case FILE_WRITE:
 		/* write samples */
-		n_samples = write_samples_16(dev, source, frames * nch, nch);
+		if (cd->fs.f_format != FILE_TEXT)
+			n_samples = write_samples_block(dev, source,
+							frames * nch, fmt);
+		else if (fmt == SOF_IPC_FRAME_S16_LE)
+			n_samples = write_samples_16(dev, source, frames * nch,
+						     nch);
+		else
+			n_samples = write_samples_32(dev, source, frames * nch,
+						     fmt, nch);
 		break;
 	default:
 		/* TODO: duplex mode */
@@ -384,44 +639,121 @@ static int file_s16(struct comp_dev *dev, struct comp_buffer *sink,
 	return n_samples;
 }
 
+/* function for processing 32-bit samples */
+static int file_s32_default(struct comp_dev *dev, struct comp_buffer *sink,
+			    struct comp_buffer *source, uint32_t frames)
+{
+	return file_samples(dev, sink, source, frames, SOF_IPC_FRAME_S32_LE);
+}
+
+/* function for processing 16-bit samples */
+static int file_s16(struct comp_dev *dev, struct comp_buffer *sink,
+		    struct comp_buffer *source, uint32_t frames)
+{
+	return file_samples(dev, sink, source, frames, SOF_IPC_FRAME_S16_LE);
+}
+
 /* function for processing 24-bit samples */
 static int file_s24(struct comp_dev *dev, struct comp_buffer *sink,
 		    struct comp_buffer *source, uint32_t frames)
 {
-	struct file_comp_data *cd = comp_get_drvdata(dev);
-	int nch = dev->params.channels;
-	int n_samples = 0;
+	return file_samples(dev, sink, source, frames, SOF_IPC_FRAME_S24_4LE);
+}
 
-	switch (cd->fs.mode) {
-	case FILE_READ:
-		/* read samples */
-		n_samples = read_samples_32(dev, sink, frames * nch,
-					    SOF_IPC_FRAME_S24_4LE, nch);
-		break;
-	case FILE_WRITE:
-		/* write samples */
-		n_samples = write_samples_32(dev, source, frames * nch,
-					     SOF_IPC_FRAME_S24_4LE, nch);
-		break;
-	default:
-		/* TODO: duplex mode */
-		break;
+/*
+ * Set file sample layout for stream format, wav input must match
+ * the format and channels of the stream.
+ */
+static int file_set_layout(struct comp_dev *dev, int fmt)
+{
+	struct file_comp_data *cd = comp_get_drvdata(dev);
+	struct file_state *fs = &cd->fs;
+	int bits = fmt == SOF_IPC_FRAME_S16_LE ? 16 :
+		fmt == SOF_IPC_FRAME_S24_4LE ? 24 : 32;
+
+	fs->shift = 0;
+
+	if (fs->f_format == FILE_WAV && fs->mode == FILE_READ) {
+		if (fs->sample_bits != bits ||
+		    fs->sample_bytes * 8 < bits || fs->sample_bytes > 4 ||
+		    cd->channels != dev->params.channels) {
+			fprintf(stderr, "error: %s has %d ch %d bit samples\n",
+				fs->fn, cd->channels, fs->sample_bits);
+			return -EINVAL;
+		}
+		fs->shift = fs->sample_bytes * 8 - bits;
+		return 0;
 	}
 
-	cd->fs.n += n_samples;
-	return n_samples;
+	/* raw files use sample container size, wav packs 24-bit to 3 bytes */
+	fs->sample_bits = bits;
+	if (fs->f_format == FILE_WAV)
+		fs->sample_bytes = bits / 8;
+	else
+		fs->sample_bytes = dev->params.sample_container_bytes;
+	cd->channels = dev->params.channels;
+
+	return 0;
 }
 
 static enum file_format get_file_format(char *filename)
 {
 	char *ext = strrchr(filename, '.');
 
+	if (!ext)
+		return FILE_RAW;
+
 	if (!strcmp(ext, ".txt"))
 		return FILE_TEXT;
 
+	if (!strcmp(ext, ".wav"))
+		return FILE_WAV;
+
 	return FILE_RAW;
 }
 
+/* stdout reserved for samples written to "-" */
+static int file_stdout_fd = -1;
+
+/*
+ * Reserve stdout for sample output and redirect other prints to stderr,
+ * must be called before any prints when output file is "-".
+ */
+int file_stdout_reserve(void)
+{
+	fflush(stdout);
+
+	file_stdout_fd = dup(STDOUT_FILENO);
+	if (file_stdout_fd < 0)
+		return -errno;
+
+	if (dup2(STDERR_FILENO, STDOUT_FILENO) < 0)
+		return -errno;
+
+	return 0;
+}
+
+static FILE *file_open(struct file_state *fs)
+{
+	int stdio = !strcmp(fs->fn, FILE_STDIO_NAME);
+
+	if (fs->mode == FILE_READ)
+		return stdio ? stdin : fopen(fs->fn, "rb");
+
+	if (stdio && file_stdout_fd >= 0)
+		return fdopen(file_stdout_fd, "wb");
+
+	return stdio ? stdout : fopen(fs->fn, "wb");
+}
+
+static void file_close(FILE *fh)
+{
+	if (fh == stdin || fh == stdout)
+		fflush(fh);
+	else
+		fclose(fh);
+}
+
 static struct comp_dev *file_new(struct sof_ipc_comp *comp)
 {
 	struct comp_dev *dev;
@@ -463,21 +795,17 @@ static struct comp_dev *file_new(struct sof_ipc_comp *comp)
 	/* open file handle(s) depending on mode */
 	switch (cd->fs.mode) {
 	case FILE_READ:
-		cd->fs.rfh = fopen(cd->fs.fn, "r");
+		cd->fs.rfh = file_open(&cd->fs);
 		if (!cd->fs.rfh) {
 			fprintf(stderr, "error: opening file %s\n", cd->fs.fn);
-			free(cd);
-			free(dev);
-			return NULL;
+			goto err;
 		}
 		break;
 	case FILE_WRITE:
-		cd->fs.wfh = fopen(cd->fs.fn, "w");
+		cd->fs.wfh = file_open(&cd->fs);
 		if (!cd->fs.wfh) {
 			fprintf(stderr, "error: opening file %s\n", cd->fs.fn);
-			free(cd);
-			free(dev);
-			return NULL;
+			goto err;
 		}
 		break;
 	default:
@@ -488,22 +816,55 @@ static struct comp_dev *file_new(struct sof_ipc_comp *comp)
 	cd->fs.reached_eof = 0;
 	cd->fs.n = 0;
 
+	/* raw and wav samples are read and written in blocks */
+	cd->fs.buf = malloc(FILE_BLOCK_BYTES);
+	if (!cd->fs.buf)
+		goto err_close;
+	cd->fs.data_left = UINT64_MAX;
+
+	/* stdin is a wav stream if it starts with riff header */
+	if (cd->fs.mode == FILE_READ && cd->fs.f_format == FILE_RAW &&
+	    !strcmp(cd->fs.fn, FILE_STDIO_NAME) && file_fill(&cd->fs) >= 4 &&
+	    !memcmp(cd->fs.buf, "RIFF", 4))
+		cd->fs.f_format = FILE_WAV;
+
+	if (cd->fs.mode == FILE_READ && cd->fs.f_format == FILE_WAV &&
+	    wav_read_header(cd) < 0)
+		goto err_close;
+
 	dev->state = COMP_STATE_READY;
 
 	return dev;
+
+err_close:
+	file_close(cd->fs.mode == FILE_READ ? cd->fs.rfh : cd->fs.wfh);
+err:
+	free(cd->fs.buf);
+	free(cd->fs.fn);
+	rfree(cd);
+	free(dev);
+	return NULL;
 }
 
 static void file_free(struct comp_dev *dev)
 {
 	struct file_comp_data *cd = comp_get_drvdata(dev);
 
-	if (cd->fs.mode == FILE_READ)
-		fclose(cd->fs.rfh);
-	else
-		fclose(cd->fs.wfh);
+	if (cd->fs.mode == FILE_READ) {
+		file_close(cd->fs.rfh);
+	} else {
+		if (cd->fs.f_format != FILE_TEXT &&
+		    file_flush(&cd->fs) < 0)
+			fprintf(stderr, "error: writing file %s\n",
+				cd->fs.fn);
+		if (cd->fs.f_format == FILE_WAV)
+			wav_update_header(&cd->fs);
+		file_close(cd->fs.wfh);
+	}
 
+	free(cd->fs.buf);
 	free(cd->fs.fn);
-	free(cd);
+	rfree(cd);
 	free(dev);
 
 	debug_print("free file component\n");
@@ -537,7 +898,11 @@ static int file_params(struct comp_dev *dev)
 	    config->frame_fmt != SOF_IPC_FRAME_S16_LE)
 		return -EINVAL;
 
-	return 0;
+	/* wav output rate unless set by the testbench */
+	if (cd->fs.mode == FILE_WRITE && !cd->rate)
+		cd->rate = dev->params.rate;
+
+	return file_set_layout(dev, config->frame_fmt);
 }
 
 static int fr_cmd(struct comp_dev *dev, struct sof_ipc_ctrl_data *cdata)
@@ -576,6 +941,7 @@ static int file_copy(struct comp_dev *dev)
 	struct comp_buffer *buffer;
 	struct file_comp_data *cd = comp_get_drvdata(dev);
 	int ret = 0, bytes;
+	uint32_t frames;
 
 	switch (cd->fs.mode) {
 	case FILE_READ:
@@ -583,10 +949,14 @@ static int file_copy(struct comp_dev *dev)
 		buffer = list_first_item(&dev->bsink_list, struct comp_buffer,
 					 source_list);
 
+		/* the input can have a different period than the pipeline */
+		frames = cd->copy_frames ? cd->copy_frames : dev->frames;
+
 		/* test sink has enough free frames */
-		if (buffer->free >= cd->period_bytes && !cd->fs.reached_eof) {
+		if (buffer->free >= frames * dev->frame_bytes &&
+		    !cd->fs.reached_eof) {
 			/* read PCM samples from file */
-			ret = cd->file_func(dev, buffer, NULL, dev->frames);
+			ret = cd->file_func(dev, buffer, NULL, frames);
 
 			/* update sink buffer pointers */
 			bytes = dev->params.sample_container_bytes;
@@ -649,6 +1019,12 @@ static int file_prepare(struct comp_dev *dev)
 		return -EINVAL;
 	}
 
+	/* a file read period must fit in the buffer */
+	if (cd->copy_frames > dev->frames * periods) {
+		fprintf(stderr, "error: file period exceeds buffer size\n");
+		return -EINVAL;
+	}
+
 	/* set downstream buffer size */
 	switch (config->frame_fmt) {
 	case(SOF_IPC_FRAME_S16_LE):
@@ -0,0 +1,176 @@
+/*
+ * Copyright (c) 2018, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of the Intel Corporation nor the
+ *     names of its contributors may be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdint.h>
+#include <errno.h>
+#include <sched.h>
+#include <sof/idc.h>
+#include <sof/notifier.h>
+#include <platform/platcfg.h>
+#include "host/cpu.h"
+
+/*
+ * testbench IDC emulation
+ *
+ * Every source and target core pair has a mailbox slot standing in for
+ * the IDC registers. The sender fills in the message and publishes it by
+ * moving the slot from FREE to SENT, the target claims it by moving it to
+ * TAKEN, executes it on its own thread through the firmware idc_cmd() and
+ * then sets DONE before freeing the slot, so no locks are shared between
+ * the cores. A blocking sender spins on DONE, serving its own slots
+ * meanwhile like the IDC interrupt would, and gives up after
+ * EMU_IDC_TIMEOUT_NS. A message not yet claimed by then is withdrawn.
+ *
+ * The master core serves its slots only while waiting for a slave in
+ * emu_cpu_wait_idle().
+ */
+
+/* generous compared to the DSP, host threads can be preempted */
+#define EMU_IDC_TIMEOUT_NS	1000000000ULL
+
+#define EMU_IDC_FREE	0
+#define EMU_IDC_SENT	1
+#define EMU_IDC_TAKEN	2
+
+struct emu_idc_slot {
+	struct idc_msg msg;
+	uint32_t state;		/* EMU_IDC_ */
+	uint32_t done;		/* message executed by the target */
+};
+
+/* indexed by target core, then source core */
+static struct emu_idc_slot emu_idc_slots[PLATFORM_CORE_COUNT]
+					[PLATFORM_CORE_COUNT];
+
+/* indexed by source core, only written by the source thread */
+static struct emu_idc_stats emu_idc_stats[PLATFORM_CORE_COUNT];
+
+/* no notifier in host builds, IDC_MSG_NOTIFY serves as a ping */
+void notifier_notify(void)
+{
+}
+
+int emu_idc_send_msg(struct idc_msg *msg, uint32_t mode)
+{
+	struct emu_idc_stats *stats;
+	struct emu_idc_slot *slot;
+	int core = emu_cpu_id;
+	uint32_t sent = EMU_IDC_SENT;
+	uint64_t start = emu_cpu_time_ns();
+	uint64_t elapsed;
+
+	tracev_idc("Msg");
+
+	if (msg->core >= PLATFORM_CORE_COUNT || msg->core == core)
+		return -EINVAL;
+
+	slot = &emu_idc_slots[msg->core][core];
+	stats = &emu_idc_stats[core];
+
+	/* the previous message may still be executed */
+	while (__atomic_load_n(&slot->state, __ATOMIC_ACQUIRE) !=
+	       EMU_IDC_FREE) {
+		if (emu_cpu_time_ns() - start > EMU_IDC_TIMEOUT_NS)
+			goto timeout;
+		sched_yield();
+	}
+
+	slot->msg.header = msg->header;
+	slot->msg.extension = msg->extension;
+	slot->msg.core = core;
+	slot->done = 0;
+	__atomic_store_n(&slot->state, EMU_IDC_SENT, __ATOMIC_RELEASE);
+
+	if (mode != IDC_BLOCKING)
+		return 0;
+
+	while (!__atomic_load_n(&slot->done, __ATOMIC_ACQUIRE)) {
+		if (emu_cpu_time_ns() - start > EMU_IDC_TIMEOUT_NS) {
+			__atomic_compare_exchange_n(&slot->state, &sent,
+						    EMU_IDC_FREE, 0,
+						    __ATOMIC_ACQ_REL,
+						    __ATOMIC_ACQUIRE);
+			goto timeout;
+		}
+
+		/* the target may be sending to us at the same time */
+		emu_idc_process(core);
+		sched_yield();
+	}
+
+	elapsed = emu_cpu_time_ns() - start;
+	stats->msgs++;
+	stats->total_ns += elapsed;
+	if (elapsed > stats->max_ns)
+		stats->max_ns = elapsed;
+
+	return 0;
+
+timeout:
+	trace_idc_error("eS0");
+	stats->timeouts++;
+	return -ETIME;
+}
+
+/* execute the messages sent to a core, returns how many there were */
+int emu_idc_process(int core)
+{
+	struct emu_idc_slot *slot;
+	uint32_t sent;
+	int count = 0;
+	int i;
+
+	for (i = 0; i < PLATFORM_CORE_COUNT; i++) {
+		slot = &emu_idc_slots[core][i];
+		sent = EMU_IDC_SENT;
+
+		if (!__atomic_compare_exchange_n(&slot->state, &sent,
+						 EMU_IDC_TAKEN, 0,
+						 __ATOMIC_ACQUIRE,
+						 __ATOMIC_RELAXED))
+			continue;
+
+		trace_idc("Cmd");
+
+		idc_cmd(&slot->msg);
+
+		__atomic_store_n(&slot->done, 1, __ATOMIC_RELEASE);
+		__atomic_store_n(&slot->state, EMU_IDC_FREE, __ATOMIC_RELEASE);
+		count++;
+	}
+
+	return count;
+}
+
+struct emu_idc_stats *emu_idc_get_stats(int core)
+{
+	if (core < 0 || core >= PLATFORM_CORE_COUNT)
+		return NULL;
+
+	return &emu_idc_stats[core];
+}
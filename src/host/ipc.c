@@ -33,10 +33,15 @@
 
 #include <sof/ipc.h>
 #include <sof/intel-ipc.h>
+#include <platform/mailbox.h>
 
 /* testbench ipc */
 struct ipc *_ipc;
 
+/* mailbox windows, see platform/memory.h */
+uint8_t emu_mailbox[MAILBOX_TRACE_OFFSET + MAILBOX_TRACE_SIZE];
+uint8_t emu_hostbox[MAILBOX_HOSTBOX_SIZE];
+
 int platform_ipc_init(struct ipc *ipc)
 {
 	struct intel_ipc_data *iipc;
@@ -60,6 +65,11 @@ int platform_ipc_init(struct ipc *ipc)
 
 /* The following definitions are to satisfy libsof linker errors */
 
+void ipc_stream_publish_position(struct comp_dev *cdev,
+				 struct sof_ipc_stream_posn *posn)
+{
+}
+
 int ipc_stream_send_position(struct comp_dev *cdev,
 			     struct sof_ipc_stream_posn *posn)
 {
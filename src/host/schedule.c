@@ -33,8 +33,12 @@
 
 #include <sof/audio/component.h>
 #include <sof/task.h>
+#include <sof/cpu.h>
+#include <sof/clk.h>
 #include <stdint.h>
 #include <sof/wait.h>
+#include "host/common_test.h"
+#include "host/cpu.h"
 
 /* scheduler testbench definition */
 
@@ -46,21 +50,39 @@ struct schedule_data {
 
 static struct schedule_data *sch;
 
+/* testbench work queue on stream time */
+static struct list_item tb_work_list;
+static uint64_t tb_work_time;
+
 void schedule_task_complete(struct task *task)
 {
+	spin_lock(&sch->lock);
 	list_item_del(&task->list);
 	task->state = TASK_STATE_COMPLETED;
+	spin_unlock(&sch->lock);
 }
 
-/* schedule task */
+/* schedule task, tasks of other enabled cores run on their thread */
 void schedule_task(struct task *task, uint64_t start, uint64_t deadline)
 {
+	uint64_t run_start;
+
 	task->deadline = deadline;
+
+	if (task->core != cpu_get_id() && cpu_is_core_enabled(task->core)) {
+		emu_cpu_schedule(task);
+		return;
+	}
+
+	spin_lock(&sch->lock);
 	list_item_prepend(&task->list, &sch->list);
 	task->state = TASK_STATE_QUEUED;
+	spin_unlock(&sch->lock);
 
+	run_start = emu_cpu_time_ns();
 	if (task->func)
 		task->func(task->data);
+	task->total_rtime += emu_cpu_time_ns() - run_start;
 
 	schedule_task_complete(task);
 }
@@ -74,6 +96,8 @@ int scheduler_init(struct sof *sof)
 	list_init(&sch->list);
 	spinlock_init(&sch->lock);
 
+	list_init(&tb_work_list);
+
 	return 0;
 }
 
@@ -87,17 +111,94 @@ void schedule_task_idle(struct task *task, uint64_t deadline)
 {
 }
 
+/* tasks of the calling core run synchronously, only slaves queue them */
 int schedule_task_cancel(struct task *task)
 {
+	emu_cpu_cancel(task);
 	return 0;
 }
 
-/* testbench work definition */
+/* task run times are measured in emulated nanoseconds */
+uint64_t clock_ms_to_ticks(int clock, uint64_t ms)
+{
+	return ms * 1000000;
+}
+
+/*
+ * testbench work definition
+ *
+ * Work runs on stream time advanced by the testbench once per pipeline
+ * period, so deferred component work like volume ramps progresses at the
+ * same rate relative to the audio as in firmware.
+ */
 
 void work_schedule_default(struct work *w, uint64_t timeout)
 {
+	w->timeout = tb_work_time + timeout;
+
+	if (!w->pending) {
+		list_item_append(&w->list, &tb_work_list);
+		w->pending = 1;
+	}
+}
+
+void work_reschedule_default(struct work *w, uint64_t timeout)
+{
+	work_schedule_default(w, timeout);
+}
+
+void work_cancel_default(struct work *w)
+{
+	if (w->pending) {
+		list_item_del(&w->list);
+		w->pending = 0;
+	}
 }
 
-void work_cancel_default(struct work *work)
+/* run all work due at stream time in usecs */
+void tb_work_run(uint64_t time)
 {
+	struct list_item *wlist;
+	struct list_item *tlist;
+	struct work *w;
+	uint64_t reschedule;
+	int again = 1;
+
+	tb_work_time = time;
+
+	/* work rescheduled within the period runs again */
+	while (again) {
+		again = 0;
+		list_for_item_safe(wlist, tlist, &tb_work_list) {
+			w = container_of(wlist, struct work, list);
+			if (w->timeout > time)
+				continue;
+
+			list_item_del(&w->list);
+			w->pending = 0;
+
+			reschedule = w->cb(w->cb_data, time - w->timeout);
+			if (reschedule) {
+				w->timeout += reschedule;
+				list_item_append(&w->list, &tb_work_list);
+				w->pending = 1;
+				again |= w->timeout <= time;
+			}
+		}
+	}
+}
+
+/* check if there is work pending for data */
+int tb_work_pending(void *data)
+{
+	struct list_item *wlist;
+	struct work *w;
+
+	list_for_item(wlist, &tb_work_list) {
+		w = container_of(wlist, struct work, list);
+		if (w->cb_data == data)
+			return 1;
+	}
+
+	return 0;
 }
@@ -31,12 +31,19 @@
 
 #include <sof/ipc.h>
 #include <sof/list.h>
+#include <sof/cpu.h>
+#include <arch/cache.h>
 #include <getopt.h>
+#include <inttypes.h>
 #include <dlfcn.h>
 #include "host/common_test.h"
 #include "host/topology.h"
 #include "host/trace.h"
 #include "host/file.h"
+#include "host/alloc.h"
+#include "host/control.h"
+#include "host/dma.h"
+#include "host/cpu.h"
 
 #define TESTBENCH_NCH 2 /* Stereo */
 
@@ -53,6 +60,11 @@ static struct sof sof;
 static int fr_id; /* comp id for fileread */
 static int fw_id; /* comp id for filewrite */
 static int sched_id; /* comp id for scheduling comp */
+static int soak_cycles; /* pipeline open/close cycles before the run */
+static int stream_cycles; /* stream open/close cycles on one topology */
+static int copy_frames; /* input period in frames, 0 for pipeline period */
+static int pipe_core = -1; /* pipeline core, -1 for the topology one */
+static int migrate_periods; /* periods between migrations, 0 for none */
 
 int debug;
 
@@ -115,44 +127,251 @@ static void print_usage(char *executable)
 {
 	printf("Usage: %s -i <input_file> -o <output_file> ", executable);
 	printf("-t <tplg_file> -b <input_format> ");
-	printf("-a <comp1=comp1_library,comp2=comp2_library>\n");
+	printf("-a <comp1=comp1_library,comp2=comp2_library> ");
+	printf("[-c <control_file>] [-s <soak_cycles>] ");
+	printf("[-S <stream_cycles>] ");
+	printf("[-p <input_period_frames>] [-C <core>] ");
+	printf("[-M <migrate_periods>]\n");
 	printf("input_format should be S16_LE, S32_LE, S24_LE or FLOAT_LE\n");
+	printf("Files with .txt extension are text, .wav are RIFF wav ");
+	printf("and others raw pcm. Use - for stdin/stdout, wav input ");
+	printf("on stdin is detected and makes stdout output wav.\n");
+	printf("Soak cycles create, prepare, reset and free the pipeline ");
+	printf("and report heap fragmentation before the run.\n");
+	printf("Stream cycles do the same on one topology load, like a ");
+	printf("PCM opened and closed again and again.\n");
+	printf("Input period reads the input in blocks of a different ");
+	printf("size than the pipeline period.\n");
+	printf("Core runs the pipeline on a thread emulating that DSP ");
+	printf("core, with IDC from the master core.\n");
+	printf("Migrate periods enables all cores and moves the pipeline ");
+	printf("to the next core every that many periods.\n");
 	printf("Example Usage:\n");
 	printf("%s -i in.txt -o out.txt -t test.tplg ", executable);
 	printf("-r 48000 -R 96000 ");
 	printf("-b S16_LE -a vol=libsof_volume.so\n");
 }
 
-/* free components */
+/* free pipelines, then their components and buffers, over IPC */
 static void free_comps(void)
 {
 	struct list_item *clist;
 	struct list_item *temp;
 	struct ipc_comp_dev *icd = NULL;
 
+	list_for_item_safe(clist, temp, &sof.ipc->shared_ctx->comp_list) {
+		icd = container_of(clist, struct ipc_comp_dev, list);
+		if (icd->type == COMP_TYPE_PIPELINE)
+			ipc_pipeline_free(sof.ipc,
+					  icd->pipeline->ipc_pipe.comp_id);
+	}
+
 	list_for_item_safe(clist, temp, &sof.ipc->shared_ctx->comp_list) {
 		icd = container_of(clist, struct ipc_comp_dev, list);
 		switch (icd->type) {
 		case COMP_TYPE_COMPONENT:
-			comp_free(icd->cd);
-			list_item_del(&icd->list);
-			rfree(icd);
+			ipc_comp_free(sof.ipc, icd->cd->comp.id);
 			break;
 		case COMP_TYPE_BUFFER:
-			rfree(icd->cb->addr);
-			rfree(icd->cb);
-			list_item_del(&icd->list);
-			rfree(icd);
+			ipc_buffer_free(sof.ipc, icd->cb->ipc_buffer.comp.id);
 			break;
 		default:
-			rfree(icd->pipeline);
-			list_item_del(&icd->list);
-			rfree(icd);
 			break;
 		}
 	}
 }
 
+/* work of the pipeline core and IDC round trips from the master core */
+static void cpu_report(int core)
+{
+	struct emu_idc_stats *idc = emu_idc_get_stats(PLATFORM_MASTER_CORE_ID);
+	struct emu_cpu_stats *cpu = emu_cpu_get_stats(core);
+
+	printf("Pipeline core: %d\n", core);
+	if (core == PLATFORM_MASTER_CORE_ID)
+		return;
+
+	printf("Core %d: %" PRIu64 " tasks, %" PRIu64 " IDC messages, ",
+	       core, cpu->tasks, cpu->idc);
+	printf("busy %.2f us\n", cpu->busy_ns / 1e3);
+	printf("IDC round trips: %" PRIu64 ", average %.2f us, ", idc->msgs,
+	       idc->msgs ? idc->total_ns / 1e3 / idc->msgs : 0.0);
+	printf("max %.2f us, timeouts %" PRIu64 "\n", idc->max_ns / 1e3,
+	       idc->timeouts);
+}
+
+/* input and output sample rates, wav header rate by default */
+static void set_rates(struct file_comp_data *frcd,
+		      struct file_comp_data *fwcd,
+		      struct sof_ipc_pipe_new *ipc_pipe)
+{
+	/* wav input and output follow each other on stdin/stdout */
+	if (frcd->fs.f_format == FILE_WAV &&
+	    !strcmp(output_file, FILE_STDIO_NAME))
+		fwcd->fs.f_format = FILE_WAV;
+
+	if (!fs_in)
+		fs_in = frcd->rate;
+
+	if (!fs_in)
+		fs_in = ipc_pipe->deadline * ipc_pipe->frames_per_sched;
+
+	if (!fs_out)
+		fs_out = frcd->rate;
+
+	if (!fs_out)
+		fs_out = ipc_pipe->deadline * ipc_pipe->frames_per_sched;
+
+	/* wav output header rate */
+	fwcd->rate = fs_out;
+}
+
+/*
+ * Shortest low latency period of a pipeline at the input rate, with the
+ * topology work scaled to the period, or 0 when no period fits the budget.
+ * desc is set up for that period.
+ */
+static uint32_t min_latency_frames(struct sof_ipc_pipe_new *ipc_pipe,
+				   struct sof_ipc_pipe_new *desc)
+{
+	uint32_t frames;
+
+	*desc = *ipc_pipe;
+	for (frames = PIPELINE_LL_FRAMES_MIN;
+	     (uint64_t)frames * 1000000 <=
+	     (uint64_t)fs_in * PIPELINE_LL_PERIOD_MAX; frames++) {
+		desc->deadline = (uint64_t)frames * 1000000 / fs_in;
+		desc->frames_per_sched = frames;
+		if (ipc_pipe->frames_per_sched)
+			desc->mips = (uint64_t)ipc_pipe->mips * frames /
+				ipc_pipe->frames_per_sched;
+
+		if (desc->deadline && !pipeline_ll_budget(desc))
+			return frames;
+	}
+
+	return 0;
+}
+
+/* minimum achievable latency of every pipeline in the topology */
+static void latency_report(char *report)
+{
+	struct sof_ipc_pipe_new desc;
+	struct ipc_comp_dev *icd;
+	struct list_item *clist;
+	uint32_t frames;
+	int len = 0;
+
+	report[0] = '\0';
+	list_for_item(clist, &sof.ipc->shared_ctx->comp_list) {
+		icd = container_of(clist, struct ipc_comp_dev, list);
+		if (icd->type != COMP_TYPE_PIPELINE || len >= DEBUG_MSG_LEN)
+			continue;
+
+		frames = min_latency_frames(&icd->pipeline->ipc_pipe, &desc);
+		if (!frames) {
+			len += snprintf(report + len, DEBUG_MSG_LEN - len,
+					"pipeline %u: no low latency period\n",
+					desc.pipeline_id);
+			continue;
+		}
+
+		/* one period of processing and the DMA buffer periods */
+		len += snprintf(report + len, DEBUG_MSG_LEN - len,
+				"pipeline %u: %u frames period, %u periods "
+				"buffered, %u us\n", desc.pipeline_id, frames,
+				pipeline_ll_periods(&desc), desc.deadline *
+				(1 + pipeline_ll_periods(&desc)));
+	}
+}
+
+/* open and close the stream like the host driver, without any copies */
+static int soak_stream(void)
+{
+	struct ipc_comp_dev *pcm_dev;
+	struct file_comp_data *frcd, *fwcd;
+	struct pipeline *p;
+
+	pcm_dev = ipc_get_comp(sof.ipc, fw_id);
+	fwcd = comp_get_drvdata(pcm_dev->cd);
+	pcm_dev = ipc_get_comp(sof.ipc, fr_id);
+	frcd = comp_get_drvdata(pcm_dev->cd);
+	pcm_dev = ipc_get_comp(sof.ipc, sched_id);
+	p = pcm_dev->cd->pipeline;
+	set_rates(frcd, fwcd, &p->ipc_pipe);
+
+	if (tb_pipeline_params(sof.ipc, TESTBENCH_NCH, bits_in,
+			       &p->ipc_pipe) < 0 ||
+	    pipeline_prepare(p, pcm_dev->cd) < 0 ||
+	    pipeline_reset(p, pcm_dev->cd) < 0)
+		return -EINVAL;
+
+	return 0;
+}
+
+static int soak_topology(char *pipeline)
+{
+	return parse_topology(tplg_file, &sof, &fr_id, &fw_id, &sched_id,
+			      bits_in, input_file, output_file, lib_table,
+			      pipeline);
+}
+
+/* the topology is loaded and freed again around the stream */
+static int soak_cycle(void)
+{
+	char pipeline[DEBUG_MSG_LEN];
+
+	if (soak_topology(pipeline) < 0 || soak_stream() < 0)
+		return -EINVAL;
+
+	free_comps();
+	return 0;
+}
+
+static void soak_cycles_run(int cycles, int (*cycle)(void))
+{
+	char when[DEBUG_MSG_LEN];
+	int i;
+
+	tb_mem_print_heap("before soak");
+
+	for (i = 0; i < cycles; i++) {
+		if (cycle() < 0) {
+			fprintf(stderr, "error: soak cycle %d\n", i);
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	sprintf(when, "after %d cycles", cycles);
+	tb_mem_print_heap(when);
+}
+
+static void soak(void)
+{
+	char pipeline[DEBUG_MSG_LEN];
+
+	if (!strcmp(input_file, FILE_STDIO_NAME)) {
+		fprintf(stderr, "error: soak cycles need an input file\n");
+		exit(EXIT_FAILURE);
+	}
+
+	tb_enable_trace(false);
+
+	if (soak_cycles)
+		soak_cycles_run(soak_cycles, soak_cycle);
+
+	if (stream_cycles) {
+		if (soak_topology(pipeline) < 0) {
+			fprintf(stderr, "error: soak topology\n");
+			exit(EXIT_FAILURE);
+		}
+		soak_cycles_run(stream_cycles, soak_stream);
+		free_comps();
+	}
+
+	tb_enable_trace(true);
+}
+
 static int set_up_library_table(void)
 {
 	int i;
@@ -176,7 +395,8 @@ static void parse_input_args(int argc, char **argv)
 {
 	int option = 0;
 
-	while ((option = getopt(argc, argv, "hdi:o:t:b:a:r:R:")) != -1) {
+	while ((option = getopt(argc, argv,
+				"hdi:o:t:b:a:r:R:c:s:S:p:C:M:")) != -1) {
 		switch (option) {
 		/* input sample file */
 		case 'i':
@@ -213,6 +433,37 @@ static void parse_input_args(int argc, char **argv)
 			fs_out = atoi(optarg);
 			break;
 
+		/* timed control events */
+		case 'c':
+			if (tb_ctrl_load(optarg) < 0)
+				exit(EXIT_FAILURE);
+			break;
+
+		/* pipeline open/close cycles */
+		case 's':
+			soak_cycles = atoi(optarg);
+			break;
+
+		/* stream open/close cycles without topology reload */
+		case 'S':
+			stream_cycles = atoi(optarg);
+			break;
+
+		/* input period mismatched with the pipeline period */
+		case 'p':
+			copy_frames = atoi(optarg);
+			break;
+
+		/* pipeline core */
+		case 'C':
+			pipe_core = atoi(optarg);
+			break;
+
+		/* pipeline migration period */
+		case 'M':
+			migrate_periods = atoi(optarg);
+			break;
+
 		/* enable debug prints */
 		case 'd':
 			debug = 1;
@@ -235,9 +486,16 @@ int main(int argc, char **argv)
 	struct comp_dev *cd;
 	struct file_comp_data *frcd, *fwcd;
 	char pipeline[DEBUG_MSG_LEN];
+	char latency[DEBUG_MSG_LEN];
 	clock_t tic, toc;
 	double c_realtime, t_exec;
+	uint64_t frames;
+	uint64_t stream_time;
+	uint32_t catch_ups, recovers, migrations;
+	uint32_t periods = 0;
+	struct dcache_stats cache;
 	int n_in, n_out, ret;
+	int core;
 	int i;
 
 	/* initialize input and output sample rates */
@@ -266,12 +524,23 @@ int main(int argc, char **argv)
 		exit(EXIT_FAILURE);
 	}
 
+	/* samples go to stdout, move all other prints to stderr */
+	if (!strcmp(output_file, FILE_STDIO_NAME) &&
+	    file_stdout_reserve() < 0) {
+		fprintf(stderr, "error: reserving stdout for output\n");
+		exit(EXIT_FAILURE);
+	}
+
 	/* initialize ipc and scheduler */
 	if (tb_pipeline_setup(&sof) < 0) {
 		fprintf(stderr, "error: pipeline init\n");
 		exit(EXIT_FAILURE);
 	}
 
+	/* stream open/close cycles to check for heap fragmentation */
+	if (soak_cycles || stream_cycles)
+		soak();
+
 	/* parse topology file and create pipeline */
 	if (parse_topology(tplg_file, &sof, &fr_id, &fw_id, &sched_id, bits_in,
 	    input_file, output_file, lib_table, pipeline) < 0) {
@@ -284,18 +553,30 @@ int main(int argc, char **argv)
 	fwcd = comp_get_drvdata(pcm_dev->cd);
 	pcm_dev = ipc_get_comp(sof.ipc, fr_id);
 	frcd = comp_get_drvdata(pcm_dev->cd);
+	frcd->copy_frames = copy_frames;
 
 	/* Run pipeline until EOF from fileread */
 	pcm_dev = ipc_get_comp(sof.ipc, sched_id);
 	p = pcm_dev->cd->pipeline;
 	ipc_pipe = &p->ipc_pipe;
 
-	/* input and output sample rate */
-	if (!fs_in)
-		fs_in = ipc_pipe->deadline * ipc_pipe->frames_per_sched;
+	/* input and output sample rate and wav output format */
+	set_rates(frcd, fwcd, ipc_pipe);
 
-	if (!fs_out)
-		fs_out = ipc_pipe->deadline * ipc_pipe->frames_per_sched;
+	/* start the thread of the pipeline core */
+	if (pipe_core >= 0) {
+		ipc_pipe->core = pipe_core;
+		schedule_task_config(&p->pipe_task, p->pipe_task.priority,
+				     pipe_core);
+	}
+	if (ipc_pipe->core >= PLATFORM_CORE_COUNT) {
+		fprintf(stderr, "error: invalid pipeline core %d\n",
+			ipc_pipe->core);
+		exit(EXIT_FAILURE);
+	}
+	cpu_enable_core(ipc_pipe->core);
+	for (i = 0; migrate_periods && i < PLATFORM_CORE_COUNT; i++)
+		cpu_enable_core(i);
 
 	/* set pipeline params and trigger start */
 	if (tb_pipeline_start(sof.ipc, TESTBENCH_NCH, bits_in, ipc_pipe) < 0) {
@@ -305,28 +586,64 @@ int main(int argc, char **argv)
 
 	cd = pcm_dev->cd;
 	tb_enable_trace(false); /* reduce trace output */
+	cache = dcache_stats;
 	tic = clock();
 
-	while (frcd->fs.reached_eof == 0)
+	/*
+	 * Control events are delivered, emulated DMA transfers completed and
+	 * deferred work is run on stream time at period boundaries. Copies
+	 * on another core are waited for, so the master core only touches
+	 * the pipeline while that core is idle.
+	 */
+	while (frcd->fs.reached_eof == 0) {
+		tb_ctrl_deliver(sof.ipc, frcd->fs.n / TESTBENCH_NCH);
 		pipeline_schedule_copy(p, 0);
+		emu_cpu_wait_idle(ipc_pipe->core);
+		frames = frcd->fs.n / TESTBENCH_NCH;
+		stream_time = frames * 1000000 / fs_in;
+		emu_dma_run(stream_time);
+		emu_cpu_wait_idle(ipc_pipe->core);
+		tb_work_run(stream_time);
+		tb_ctrl_settle(sof.ipc, frames);
+		periods++;
+
+		/* the pipeline is idle between two periods */
+		if (migrate_periods && periods % migrate_periods == 0 &&
+		    pipeline_migrate(p, (ipc_pipe->core + 1) %
+				     PLATFORM_CORE_COUNT) < 0) {
+			fprintf(stderr, "error: pipeline migration\n");
+			exit(EXIT_FAILURE);
+		}
+	}
 
 	if (!frcd->fs.reached_eof)
 		printf("warning: possible pipeline xrun\n");
 
 	/* reset and free pipeline */
 	toc = clock();
+	cache.writeback = dcache_stats.writeback - cache.writeback;
+	cache.invalidate = dcache_stats.invalidate - cache.invalidate;
 	tb_enable_trace(true);
 	ret = pipeline_reset(p, cd);
 	if (ret < 0) {
 		fprintf(stderr, "error: pipeline reset\n");
 		exit(EXIT_FAILURE);
 	}
+	core = ipc_pipe->core;
+	for (i = 0; i < PLATFORM_CORE_COUNT; i++)
+		cpu_disable_core(i);
 
 	n_in = frcd->fs.n;
 	n_out = fwcd->fs.n;
 	t_exec = (double)(toc - tic) / CLOCKS_PER_SEC;
 	c_realtime = (double)n_out / TESTBENCH_NCH / fs_out / t_exec;
 
+	/* low latency model of the pipelines before they are freed */
+	latency_report(latency);
+	catch_ups = p->catch_ups;
+	recovers = p->recovers;
+	migrations = p->migrations;
+
 	/* free all components/buffers in pipeline */
 	free_comps();
 
@@ -347,8 +664,22 @@ int main(int argc, char **argv)
 	printf("Output sample count: %d\n", n_out);
 	printf("Total execution time: %.2f us, %.2f x realtime\n",
 	       1e3 * t_exec, c_realtime);
+	tb_ctrl_print(fs_in);
+	printf("Pipeline catch ups: %u, xrun recoveries: %u\n", catch_ups,
+	       recovers);
+	cpu_report(core);
+	printf("Pipeline migrations: %u\n", migrations);
+	printf("Cache maintenance per period: %.1f bytes written back, ",
+	       periods ? (double)cache.writeback / periods : 0.0);
+	printf("%.1f bytes invalidated\n",
+	       periods ? (double)cache.invalidate / periods : 0.0);
+	printf("Minimum low latency mode latency:\n");
+	printf("%s", latency);
+	printf("Firmware heap usage, current bytes after pipeline free:\n");
+	tb_mem_print();
 
 	/* free all other data */
+	tb_ctrl_free();
 	free(bits_in);
 	free(input_file);
 	free(tplg_file);
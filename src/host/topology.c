@@ -41,6 +41,7 @@
 #include <sof/audio/component.h>
 #include "host/topology.h"
 #include "host/file.h"
+#include "host/alloc.h"
 
 FILE *file;
 char pipeline_string[DEBUG_MSG_LEN];
@@ -654,6 +655,7 @@ static int load_widget(struct sof *sof, int *fr_id, int *fw_id,
 		       int comp_index, int pipeline_id)
 {
 	struct snd_soc_tplg_dapm_widget *widget;
+	struct ipc_comp_dev *icd;
 	char message[DEBUG_MSG_LEN];
 	size_t read_size, size;
 	int ret = 0;
@@ -690,6 +692,9 @@ static int load_widget(struct sof *sof, int *fr_id, int *fw_id,
 	/* register comp driver */
 	register_comp(temp_comp_list[comp_index].type);
 
+	/* name component in memory accounting table */
+	tb_mem_owner_name(comp_id, widget->name);
+
 	/* load widget based on type */
 	switch (temp_comp_list[comp_index].type) {
 	/* load pga widget */
@@ -758,6 +763,13 @@ static int load_widget(struct sof *sof, int *fr_id, int *fw_id,
 		break;
 	}
 
+	/* attribute runtime allocations of the component */
+	icd = ipc_get_comp(sof->ipc, comp_id);
+	if (icd && icd->type == COMP_TYPE_COMPONENT &&
+	    tb_mem_track_comp(icd->cd) < 0)
+		fprintf(stderr, "warning: no mem tracking for %s\n",
+			widget->name);
+
 	/* load widget kcontrols */
 	if (widget->num_kcontrols > 0)
 		if (load_controls(sof, widget->num_kcontrols) < 0) {
@@ -781,7 +793,7 @@ int parse_topology(char *filename, struct sof *sof, int *fr_id, int *fw_id,
 	struct sof_ipc_pipe_new pipeline;
 	char message[DEBUG_MSG_LEN];
 	int next_comp_id = 0, num_comps = 0;
-	int i, ret = 0;
+	int i, owner, ret = 0;
 	size_t file_size, size;
 
 	/* open topology file */
@@ -792,6 +804,7 @@ int parse_topology(char *filename, struct sof *sof, int *fr_id, int *fw_id,
 	}
 
 	lib_table = library_table;
+	pipeline_string[0] = '\0';
 
 	/* file size */
 	fseek(file, 0, SEEK_END);
@@ -828,11 +841,15 @@ int parse_topology(char *filename, struct sof *sof, int *fr_id, int *fw_id,
 			temp_comp_list = (struct comp_info *)malloc(size);
 			num_comps = hdr->count;
 
-			for (i = 0; i < hdr->count; i++)
+			/* widget allocations are attributed to its comp id */
+			for (i = 0; i < hdr->count; i++) {
+				owner = tb_mem_owner(next_comp_id);
 				load_widget(sof, fr_id, fw_id, sched_id,
 					    bits_in, temp_comp_list,
 					    &pipeline, next_comp_id++,
 					    i, hdr->index);
+				tb_mem_owner(owner);
+			}
 			break;
 
 		/* set up component connections from pipeline graph */
@@ -34,6 +34,8 @@
 #include <stdint.h>
 #include <stdio.h>
 #include <string.h>
+#include <sof/trace.h>
+#include <sof/dma-trace.h>
 #include "host/common_test.h"
 #include "host/trace.h"
 
@@ -42,6 +44,14 @@
 
 /* enable trace by default in testbench */
 static int test_bench_trace = 1;
+
+/* same runtime filter defaults as the firmware */
+struct trace_filter trace_filter = {
+	.mask = {
+		[LOG_LEVEL_CRITICAL] = 0xffffffff,
+		[LOG_LEVEL_INFO] = 0xffffffff,
+	},
+};
 int num_trace_classes;
 
 /* set up trace class identifier table based on SOF trace header file */
@@ -271,6 +281,47 @@ void _trace_event_mbox_atomic3(uint32_t event, uint32_t param1,
 	_trace_event3(event, param1, param2, param3);
 }
 
+/* print trace event */
+void _trace_event4(uint32_t event, uint32_t param1, uint32_t param2,
+		   uint32_t param3, uint32_t param4)
+{
+	char a, b, c;
+	char *trace_class = NULL;
+
+	if (test_bench_trace > 0) {
+		a = event & 0xff;
+		b = (event >> 8) & 0xff;
+		c = (event >> 16) & 0xff;
+
+		/* look up subsystem from trace class table */
+		trace_class = strdup(get_trace_class(event >> 24));
+
+		/* print trace event stderr*/
+		if (strcmp(trace_class, "value") == 0)
+			fprintf
+			(stderr,
+			"Trace value %d, param1 %d param2 %d param3 %d param4 %d\n",
+			event, param1, param2, param3, param4);
+		else
+			fprintf(stderr, "Trace %s %c%c%c\n", trace_class,
+				c, b, a);
+	}
+
+	free(trace_class);
+}
+
+void _trace_event_mbox_atomic4(uint32_t event, uint32_t param1,
+			       uint32_t param2, uint32_t param3,
+			       uint32_t param4)
+{
+	_trace_event4(event, param1, param2, param3, param4);
+}
+
+/* IDC_MSG_TRACE_FLUSH, the testbench has no DMA trace */
+void dma_trace_schedule_copy(void)
+{
+}
+
 /* enable trace in testbench */
 void tb_enable_trace(bool enable)
 {
@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2018, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of the Intel Corporation nor the
+ *     names of its contributors may be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _HOST_ALLOC_H
+#define _HOST_ALLOC_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sof/audio/component.h>
+
+/* allocations not made on behalf of a topology component */
+#define TB_MEM_OWNER_NONE	-1
+
+/* max component ids and drivers tracked */
+#define TB_MEM_MAX_OWNERS	64
+#define TB_MEM_MAX_DRIVERS	16
+
+/* heap zone types tracked, RZONE_SYS/RUNTIME/BUFFER */
+#define TB_MEM_ZONES		3
+
+/* number of SOF_MEM_CAPS_ bits */
+#define TB_MEM_CAPS		8
+
+/* allocation statistics in requested bytes */
+struct tb_mem_stats {
+	size_t bytes;		/* bytes currently allocated */
+	size_t peak;		/* peak bytes allocated */
+	uint32_t allocs;	/* number of allocations */
+	uint32_t frees;		/* number of frees */
+	uint32_t failed;	/* number of failed allocations */
+};
+
+/* set owner for following allocations, returns previous owner */
+int tb_mem_owner(int owner);
+
+/* name owner in the memory table */
+void tb_mem_owner_name(int owner, const char *name);
+
+/* attribute allocations made in component ops to the component */
+int tb_mem_track_comp(struct comp_dev *dev);
+
+/* print zone, caps and per component memory tables */
+void tb_mem_print(void);
+
+/* print host heap fragmentation and pipeline arena counts */
+void tb_mem_print_heap(const char *when);
+
+#endif
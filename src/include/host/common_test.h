@@ -75,6 +75,10 @@ extern int debug;
 
 int scheduler_init(struct sof *sof);
 
+void tb_work_run(uint64_t time);
+
+int tb_work_pending(void *data);
+
 void sys_comp_file_init(void);
 
 void sys_comp_filewrite_init(void);
@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2018, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of the Intel Corporation nor the
+ *     names of its contributors may be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _HOST_CONTROL_H
+#define _HOST_CONTROL_H
+
+#include <stdint.h>
+#include <sof/ipc.h>
+
+/* max payload elements and line length in control event file */
+#define TB_CTRL_MAX_ELEMS	SOF_IPC_MAX_CHANNELS
+#define TB_CTRL_LINE_LEN	256
+
+/* control event delivered to a component at an input frame position */
+struct tb_ctrl_event {
+	uint64_t frame;		/* requested input frame */
+	uint32_t comp_id;
+	int cmd;		/* COMP_CMD_ */
+	char type[16];		/* event type from file */
+	struct sof_ipc_ctrl_data *cdata;
+
+	/* results */
+	int ret;		/* comp_cmd() return value */
+	int delivered;
+	int settled;
+	uint64_t delivered_frame;
+	uint64_t settled_frame;
+	uint64_t cost_ns;	/* comp_cmd() processing time */
+};
+
+/* load control events from file */
+int tb_ctrl_load(const char *filename);
+
+/* deliver events due at the period boundary at input frame */
+void tb_ctrl_deliver(struct ipc *ipc, uint64_t frame);
+
+/* check delivered events for switch completion at input frame */
+void tb_ctrl_settle(struct ipc *ipc, uint64_t frame);
+
+/* print event cost and switch latency table */
+void tb_ctrl_print(uint32_t rate);
+
+void tb_ctrl_free(void);
+
+#endif
@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2018, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of the Intel Corporation nor the
+ *     names of its contributors may be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _HOST_CPU_H
+#define _HOST_CPU_H
+
+#include <stdint.h>
+#include <sof/schedule.h>
+#include <sof/idc.h>
+
+/* work done by an emulated core */
+struct emu_cpu_stats {
+	uint64_t tasks;		/* tasks run */
+	uint64_t idc;		/* IDC messages received */
+	uint64_t busy_ns;	/* time spent running tasks and IDC */
+};
+
+/* IDC round trips started by a core */
+struct emu_idc_stats {
+	uint64_t msgs;		/* blocking messages sent */
+	uint64_t timeouts;	/* messages not done in time */
+	uint64_t total_ns;	/* sum of the round trip times */
+	uint64_t max_ns;	/* longest round trip */
+};
+
+/* core the calling thread runs as */
+extern __thread int emu_cpu_id;
+
+/* start and stop the thread of a slave core */
+void emu_cpu_enable_core(int id);
+void emu_cpu_disable_core(int id);
+int emu_cpu_is_core_enabled(int id);
+
+/* queue a task to the scheduler of an enabled slave core */
+void emu_cpu_schedule(struct task *task);
+
+/* remove a task from the queue of a slave core unless it already runs */
+void emu_cpu_cancel(struct task *task);
+
+/*
+ * Wait until a core has run everything queued to it, serving the IDC
+ * messages sent to the calling core meanwhile.
+ */
+void emu_cpu_wait_idle(int id);
+
+/* stats of a core, or NULL if the id is not valid */
+struct emu_cpu_stats *emu_cpu_get_stats(int id);
+
+/* send and serve emulated IDC messages, see host/idc.c */
+int emu_idc_send_msg(struct idc_msg *msg, uint32_t mode);
+int emu_idc_process(int core);
+struct emu_idc_stats *emu_idc_get_stats(int core);
+
+/* monotonic host time used for the stats */
+uint64_t emu_cpu_time_ns(void);
+
+#endif
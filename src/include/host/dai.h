@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2018, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of the Intel Corporation nor the
+ *     names of its contributors may be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _HOST_DAI_H
+#define _HOST_DAI_H
+
+#include <stdint.h>
+#include <sof/dai.h>
+
+/* emulated SSP ports */
+#define EMU_DAI_SSP_COUNT	4
+
+/*
+ * FIFO of an emulated DAI direction. Its address is the DAI FIFO offset
+ * given to the DMA, which moves samples through it at the rate set by
+ * the DAI configuration like the DMA handshake does on the DSP.
+ */
+struct emu_dai_fifo {
+	int direction;		/* SOF_IPC_STREAM_PLAYBACK or _CAPTURE */
+	uint32_t rate;		/* bytes per second, 0 until configured */
+	int running;		/* DAI triggered */
+	uint64_t bytes;		/* bytes moved while running */
+	uint64_t idle_bytes;	/* bytes moved while the DAI was stopped */
+
+	/* line side, playback gets samples and capture fills them */
+	void (*line)(void *data, void *samples, uint32_t bytes);
+	void *line_data;
+};
+
+/* install the emulated DAIs */
+void emu_dai_init(void);
+
+/* FIFO of the DAI direction, or NULL if the DAI is not probed */
+struct emu_dai_fifo *emu_dai_get_fifo(struct dai *dai, int direction);
+
+/* move bytes of samples through the FIFO, called by the DMA */
+void emu_dai_fifo_xfer(struct emu_dai_fifo *fifo, void *samples,
+		       uint32_t bytes);
+
+#endif
@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2018, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of the Intel Corporation nor the
+ *     names of its contributors may be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _HOST_DMA_H
+#define _HOST_DMA_H
+
+#include <stdint.h>
+#include <sof/dma.h>
+
+/* channels per emulated DMA controller */
+#define EMU_DMA_CHANNELS	8
+
+/* memory to memory transfer rate, sets when a transfer completes */
+#define EMU_DMA_BYTES_PER_US	400
+
+/* work done by the channels of an emulated DMA controller */
+struct emu_dma_stats {
+	uint64_t configs;	/* set_config() calls */
+	uint64_t starts;	/* start() calls */
+	uint64_t copies;	/* copy() restarts */
+	uint64_t transfers;	/* completed elements */
+	uint64_t bytes;		/* bytes copied */
+	uint64_t jitter;	/* injected completion delay in usecs */
+	uint32_t jitter_max;	/* longest injected delay in usecs */
+};
+
+/* install the emulated host and DAI DMA controllers */
+void emu_dma_init(void);
+
+/* complete all transfers due by time in usecs */
+void emu_dma_run(uint64_t time);
+
+/*
+ * Delay completions randomly by up to max_us, repeatable for a seed.
+ * Restarts the delay stats.
+ */
+void emu_dma_set_jitter(uint32_t max_us, uint32_t seed);
+
+/* stats of the controller, or NULL if dma is not emulated */
+struct emu_dma_stats *emu_dma_get_stats(struct dma *dma);
+
+#endif
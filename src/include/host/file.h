@@ -43,8 +43,22 @@ enum file_mode {
 enum file_format {
 	FILE_TEXT = 0,
 	FILE_RAW,
+	FILE_WAV,
 };
 
+/* file name for stdin/stdout */
+#define FILE_STDIO_NAME		"-"
+
+/* block size for raw and wav file I/O */
+#define FILE_BLOCK_BYTES	(64 * 1024)
+
+/* wav file header */
+#define WAV_HEADER_BYTES	44
+#define WAV_FMT_MAX_BYTES	40
+#define WAV_FORMAT_PCM		0x0001
+#define WAV_FORMAT_EXTENSIBLE	0xfffe
+#define WAV_SIZE_STREAM		0xffffffff
+
 /* file component state */
 struct file_state {
 	char *fn;
@@ -53,6 +67,14 @@ struct file_state {
 	int n;
 	enum file_mode mode;
 	enum file_format f_format;
+	uint8_t *buf; /* raw and wav I/O block buffer */
+	size_t buf_pos;
+	size_t buf_len;
+	uint64_t data_left; /* bytes left in wav data chunk */
+	uint64_t n_bytes; /* bytes written to file */
+	int sample_bytes; /* sample container bytes in file */
+	int sample_bits; /* valid sample bits in file */
+	int shift; /* valid bits MSB aligned in container */
 };
 
 /* file comp data */
@@ -61,6 +83,7 @@ struct file_comp_data {
 	uint32_t channels;
 	uint32_t frame_bytes;
 	uint32_t rate;
+	uint32_t copy_frames; /* frames read per copy, 0 for pipeline period */
 	struct file_state fs;
 	int (*file_func)(struct comp_dev *dev, struct comp_buffer *sink,
 			 struct comp_buffer *source, uint32_t frames);
@@ -74,4 +97,6 @@ struct sof_ipc_comp_file {
 	char *fn;
 	enum file_mode mode;
 };
+
+int file_stdout_reserve(void);
 #endif
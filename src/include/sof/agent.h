@@ -41,10 +41,13 @@ struct sof;
 struct sa {
 	uint64_t last_idle;	/* time of last idle */
 	uint64_t ticks;
+	uint64_t last_balance;	/* time of last pipeline load balance */
+	uint64_t balance_ticks;
 	struct work work;
 };
 
 void sa_enter_idle(struct sof *sof);
+void sa_balance(struct sof *sof);
 void sa_init(struct sof *sof);
 
 #endif
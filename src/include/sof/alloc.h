@@ -35,6 +35,7 @@
 #include <string.h>
 #include <stdint.h>
 #include <sof/bit.h>
+#include <sof/list.h>
 #include <sof/platform.h>
 #include <platform/memory.h>
 #include <arch/spinlock.h>
@@ -69,15 +70,18 @@ struct sof;
 
 struct dma_copy;
 struct dma_sg_config;
+struct sof_ipc_heap_info;
 
 struct mm_info {
 	uint32_t used;
 	uint32_t free;
+	uint32_t peak;		/* high-water mark of used */
+	uint32_t failed;	/* allocations that could not be satisfied */
 };
 
 struct block_hdr {
 	uint16_t size;		/* size in blocks for continuous allocation */
-	uint16_t used;		/* usage flags for page */
+	uint16_t used;		/* set on the first block of an allocation */
 } __attribute__ ((packed));
 
 struct block_map {
@@ -86,11 +90,47 @@ struct block_map {
 	uint16_t free_count;	/* number of free blocks */
 	uint16_t first_free;	/* index of first free block */
 	struct block_hdr *block;	/* base block header */
+	uint32_t *used_map;	/* usage bitmap, one bit per block */
+	uint32_t *dirty_map;	/* blocks changed since the last PM save */
 	uint32_t base;		/* base address of space */
+	uint16_t max_used;	/* high-water mark of used blocks */
+	uint16_t failed;	/* allocations this map could not satisfy */
 } __attribute__ ((__aligned__(PLATFORM_DCACHE_ALIGN)));
 
-#define BLOCK_DEF(sz, cnt, hdr) \
-	{.block_size = sz, .count = cnt, .free_count = cnt, .block = hdr}
+/* number of words in a block usage bitmap */
+#define BLOCK_MAP_WORDS(cnt)	(((cnt) + 31) >> 5)
+
+#define BLOCK_DEF(sz, cnt, hdr, bmp, dirty) \
+	{.block_size = sz, .count = cnt, .free_count = cnt, .block = hdr, \
+	 .used_map = bmp, .dirty_map = dirty}
+
+/*
+ * Pipeline arenas
+ *
+ * The private data components allocate on topology load is allocated from
+ * an arena owned by their pipeline id while the arena is selected. The fixed
+ * size component, buffer and pipeline objects come from the slab caches
+ * instead. Arena memory is a single allocation from the buffer heap that is
+ * handed out in order and given back to the heap in one go once the pipeline
+ * is freed, so topology reloads do not fragment the heaps. Individual frees
+ * only return memory to the arena when it is the most recent allocation, or
+ * when the arena becomes empty, so stream params() and prepare() and the
+ * audio buffers of rballoc() never use it.
+ */
+#define ARENA_NONE		-1
+#define HEAP_ARENA_COUNT	8
+#define HEAP_ARENA_SIZE		0x1000
+
+struct mm_arena {
+	int pipeline_id;	/* owning pipeline id */
+	uint32_t base;		/* arena memory, 0 if arena is unused */
+	uint32_t size;		/* size of arena memory */
+	uint32_t used;		/* bytes handed out from base */
+	uint32_t last;		/* offset of the most recent allocation */
+	uint32_t caps;		/* caps of the heap backing the arena */
+	uint32_t live;		/* number of allocations not yet freed */
+	uint32_t released;	/* pipeline freed, release on last free */
+};
 
 struct mm_heap {
 	uint32_t blocks;
@@ -101,6 +141,33 @@ struct mm_heap {
 	struct mm_info info;
 } __attribute__ ((__aligned__(PLATFORM_DCACHE_ALIGN)));
 
+/*
+ * Slab caches
+ *
+ * The objects created for every component, buffer and pipeline on topology
+ * load are allocated from caches of equally sized objects that init_heap()
+ * carves from the buffer heap. IPC creates them on the master core, so only
+ * that core has objects, as many as a playback and a capture pipeline of
+ * host, volume and DAI need. An allocation does not scan the block maps and
+ * the objects are only rounded up to the cache line instead of to the next
+ * block size. Requests larger than the cache object, made on another core
+ * or made when the objects are all in use fall back to the runtime heap,
+ * never to a pipeline arena.
+ */
+#define SLAB_COMP_DEV	0	/* struct comp_dev with its IPC comp data */
+#define SLAB_BUFFER	1	/* struct comp_buffer */
+#define SLAB_PIPELINE	2	/* struct pipeline */
+#define SLAB_IPC_COMP	3	/* struct ipc_comp_dev, used uncached */
+#define SLAB_COUNT	4
+
+struct mm_slab {
+	uint32_t size;		/* object size */
+	uint32_t caps;		/* object memory capabilities */
+	uint32_t count;		/* objects, at most 32 */
+	uint32_t base;		/* objects of the master core */
+	uint32_t free;		/* free objects mask */
+};
+
 /* heap block memory map */
 struct mm {
 	/* system heap - used during init cannot be freed */
@@ -110,6 +177,13 @@ struct mm {
 	/* general component buffer heap */
 	struct mm_heap buffer[PLATFORM_HEAP_BUFFER];
 
+	/* pipeline arenas and the arena selected on each core */
+	struct mm_arena arena[HEAP_ARENA_COUNT];
+	struct mm_arena *arena_current[PLATFORM_HEAP_SYSTEM];
+
+	/* slab caches for fixed size objects */
+	struct mm_slab slab[SLAB_COUNT];
+
 	struct mm_info total;
 	spinlock_t lock;	/* all allocs and frees are atomic */
 } __attribute__ ((__aligned__(PLATFORM_DCACHE_ALIGN)));
@@ -122,6 +196,15 @@ void rfree(void *ptr);
 /* heap allocation and free for buffers on 1k boundary */
 void *rballoc(int zone, uint32_t flags, size_t bytes);
 
+/* zeroed object from slab cache, falls back to the runtime heap */
+void *rzalloc_slab(int zone, int slab, size_t bytes);
+
+/* select pipeline arena for allocations on this core, returns previous */
+int arena_select(int pipeline_id);
+
+/* give pipeline arena back to the heap once it holds no allocations */
+void arena_release(int pipeline_id);
+
 /* system heap allocation for specific core */
 void *rzalloc_core_sys(int core, size_t bytes);
 
@@ -131,6 +214,58 @@ void *memset(void *s, int c, size_t n);
 int rstrlen(const char *s);
 int rstrcmp(const char *s1, const char *s2);
 
+/* heap statistics for debug, -EINVAL if there is no such heap */
+int mm_heap_info(uint32_t zone, uint32_t index, struct sof_ipc_heap_info *info,
+		 size_t size);
+
+/* trace statistics of all heaps every period_ms, 0 stops sampling */
+void mm_heap_sample(uint32_t period_ms);
+
+/*
+ * PM context image
+ *
+ * The host keeps the image between D3 entries. It mirrors every heap at a
+ * fixed offset, so a save only copies the allocator state and the heap
+ * blocks changed since the previous save. The header lists the regions of
+ * DSP memory that are restored and is written last, only num_regions
+ * entries of the region table are copied.
+ */
+#define MM_PM_MAGIC	0x50464f53	/* "SOFP" */
+#define MM_PM_REGIONS	64
+
+struct mm_pm_region {
+	uint32_t addr;		/* DSP address */
+	uint32_t offset;	/* offset of the copy in the image */
+	uint32_t size;
+};
+
+struct mm_pm_hdr {
+	uint32_t magic;
+	uint32_t size;		/* image size */
+	uint32_t saved;		/* bytes copied by the last save */
+	uint32_t num_regions;
+	struct mm_pm_region region[MM_PM_REGIONS];
+};
+
+/*
+ * A PM context save only copies the heap blocks allocated or marked with
+ * mm_pm_dirty() since the previous save, any other write is lost across D3.
+ * Code changing the links or state of heap objects marks them, components
+ * are marked at the save for all their changes flagged by comp_pm_dirty(),
+ * which comp_copy() and comp_cmd() do and work callbacks of components must
+ * do. Audio data and the state set up by params() and prepare() are not
+ * kept, the host prepares the streams again after D3.
+ */
+void mm_pm_dirty(void *ptr);
+
+/* mark the objects linked by item, whose links are about to change */
+static inline void mm_pm_dirty_list(struct list_item *item)
+{
+	mm_pm_dirty(item->prev);
+	mm_pm_dirty(item);
+	mm_pm_dirty(item->next);
+}
+
 /* Heap save/restore contents and context for PM D0/D3 events */
 uint32_t mm_pm_context_size(void);
 int mm_pm_context_save(struct dma_copy *dc, struct dma_sg_config *sg);
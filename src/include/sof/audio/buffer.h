@@ -40,6 +40,7 @@
 #include <sof/audio/component.h>
 #include <sof/trace.h>
 #include <sof/schedule.h>
+#include <sof/math/numbers.h>
 #include <uapi/ipc.h>
 
 /* pipeline tracing */
@@ -60,6 +61,8 @@ struct comp_buffer {
 	void *r_ptr;		/* buffer read position */
 	void *addr;		/* buffer base address */
 	void *end_addr;		/* buffer end address */
+	void *sync_ptr;		/* start of data not synced with DMA yet */
+	uint32_t sync_bytes;	/* bytes not synced with DMA yet */
 
 	/* IPC configuration */
 	struct sof_ipc_buffer ipc_buffer;
@@ -85,6 +88,12 @@ void comp_update_buffer_produce(struct comp_buffer *buffer, uint32_t bytes);
 /* called by a component after consuming data from this buffer */
 void comp_update_buffer_consume(struct comp_buffer *buffer, uint32_t bytes);
 
+/* write back or invalidate the data produced since the last sync */
+void buffer_sync(struct comp_buffer *buffer);
+
+/* cache operation on the buffer and its unread data for another core */
+void buffer_cache(struct comp_buffer *buffer, int cmd);
+
 static inline void buffer_zero(struct comp_buffer *buffer)
 {
 	tracev_buffer("BZr");
@@ -119,6 +128,40 @@ static inline uint32_t comp_buffer_get_copy_bytes(struct comp_buffer *source,
 		return source->avail;
 }
 
+/* get the number of whole frames that can be copied between sink and source */
+static inline uint32_t comp_buffer_get_copy_frames(struct comp_buffer *source,
+	uint32_t source_frame_bytes, struct comp_buffer *sink,
+	uint32_t sink_frame_bytes)
+{
+	return MIN(source->avail / source_frame_bytes,
+		   sink->free / sink_frame_bytes);
+}
+
+/* check a buffer holds whole frames, copies split at the buffer wrap would
+ * otherwise never reach the end of it. Frame size 0 is not checked.
+ */
+static inline int comp_buffer_check_frames(struct comp_buffer *buffer,
+	uint32_t frame_bytes)
+{
+	if (frame_bytes && buffer->size % frame_bytes)
+		return -EINVAL;
+
+	return 0;
+}
+
+/* get how many of the frames can be copied before a buffer pointer wraps,
+ * 0 unless both buffers pass comp_buffer_check_frames()
+ */
+static inline uint32_t comp_buffer_get_contig_frames(struct comp_buffer *source,
+	uint32_t source_frame_bytes, struct comp_buffer *sink,
+	uint32_t sink_frame_bytes, uint32_t frames)
+{
+	frames = MIN(frames,
+		     (source->end_addr - source->r_ptr) / source_frame_bytes);
+
+	return MIN(frames, (sink->end_addr - sink->w_ptr) / sink_frame_bytes);
+}
+
 static inline void buffer_reset_pos(struct comp_buffer *buffer)
 {
 	/* reset read and write pointer to buffer bas */
@@ -130,6 +173,9 @@ static inline void buffer_reset_pos(struct comp_buffer *buffer)
 	/* ther are no avail samples at reset */
 	buffer->avail = 0;
 
+	/* the cleared contents need no sync */
+	buffer->sync_bytes = 0;
+
 	/* clear buffer contents */
 	buffer_zero(buffer);
 }
@@ -97,6 +97,8 @@
 #define COMP_TRIGGER_RESET	6	/* reset component */
 #define COMP_TRIGGER_PREPARE	7	/* prepare component */
 #define COMP_TRIGGER_XRUN	8	/* XRUN component */
+#define COMP_TRIGGER_MIGRATE_OUT 9	/* stream leaves this core */
+#define COMP_TRIGGER_MIGRATE_IN	10	/* stream moves to this core */
 
 /*
  * standard component control commands
@@ -203,6 +205,7 @@ struct comp_dev {
 	uint16_t state;			/* COMP_STATE_ */
 	uint16_t is_endpoint;		/* component is end point in pipeline */
 	uint16_t is_dma_connected;	/* component is connected to DMA */
+	uint16_t pm_dirty;		/* changed since the last PM save */
 	spinlock_t lock;		/* lock for this component */
 	uint64_t position;		/* component rendering position */
 	uint32_t frames;		/* number of frames we copy to sink */
@@ -279,6 +282,14 @@ static inline int comp_host_buffer(struct comp_dev *dev,
 	return 0;
 }
 
+/* component state changed, it is marked for the next PM context save by
+ * ipc_comp_pm_dirty()
+ */
+static inline void comp_pm_dirty(struct comp_dev *dev)
+{
+	dev->pm_dirty = 1;
+}
+
 /* send component command - mandatory */
 static inline int comp_cmd(struct comp_dev *dev, int cmd, void *data)
 {
@@ -293,6 +304,8 @@ static inline int comp_cmd(struct comp_dev *dev, int cmd, void *data)
 		return -EINVAL;
 	}
 
+	comp_pm_dirty(dev);
+
 	return dev->drv->ops.cmd(dev, cmd, data);
 }
 
@@ -311,6 +324,8 @@ static inline int comp_prepare(struct comp_dev *dev)
 /* copy component buffers - mandatory */
 static inline int comp_copy(struct comp_dev *dev)
 {
+	comp_pm_dirty(dev);
+
 	return dev->drv->ops.copy(dev);
 }
 
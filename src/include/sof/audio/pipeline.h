@@ -40,6 +40,7 @@
 #include <sof/audio/component.h>
 #include <sof/trace.h>
 #include <sof/schedule.h>
+#include <sof/math/numbers.h>
 #include <uapi/ipc.h>
 
 /* pipeline tracing */
@@ -47,6 +48,32 @@
 #define trace_pipe_error(__e)	trace_error(TRACE_CLASS_PIPE, __e)
 #define tracev_pipe(__e)	tracev_event(TRACE_CLASS_PIPE, __e)
 
+/*
+ * Low latency mode.
+ *
+ * Pipelines with a deadline of PIPELINE_LL_PERIOD_MAX usecs or less copy
+ * in a TASK_PRI_LL task. Their DMA buffers hold the period in flight and
+ * whole periods covering PIPELINE_LL_MARGIN usecs plus the period work,
+ * in place of the periods asked by topology. Their periods must be at
+ * least PIPELINE_LL_FRAMES_MIN frames and the per period work with the
+ * scheduling overhead must fit PIPELINE_LL_LOAD_MAX percent of the period
+ * at the maximum core clock.
+ */
+#define PIPELINE_LL_PERIOD_MAX	500	/* usecs */
+#define PIPELINE_LL_FRAMES_MIN	8
+#define PIPELINE_LL_MARGIN	100	/* usecs for DMA IRQ latency */
+#define PIPELINE_LL_LOAD_MAX	75	/* percent */
+
+/*
+ * Catch up.
+ *
+ * A pipeline task that runs late copies the periods the scheduling
+ * component missed, up to PIPELINE_CATCHUP_PERIODS in one run, as long as
+ * its sources have the data and its sinks the space. The host is told
+ * about an XRUN and the pipeline is recovered only when this fails.
+ */
+#define PIPELINE_CATCHUP_PERIODS	4
+
 struct ipc_pipeline_dev;
 struct ipc;
 
@@ -59,8 +86,16 @@ struct pipeline {
 
 	/* runtime status */
 	int32_t xrun_bytes;		/* last xrun length */
+	struct comp_dev *xrun_comp;	/* component reporting the xrun */
 	uint32_t status;		/* pipeline status */
 
+	/* xrun statistics */
+	uint32_t catch_ups;		/* runs copying missed periods */
+	uint32_t catch_up_periods;	/* missed periods copied */
+	uint32_t recovers;		/* full xrun recoveries */
+
+	uint32_t migrations;		/* moves to another core */
+
 	/* lists */
 	struct list_item comp_list;		/* list of components */
 	struct list_item buffer_list;		/* list of buffers */
@@ -109,6 +144,11 @@ void pipeline_cache(struct pipeline *p, struct comp_dev *dev, int cmd);
 /* trigger pipeline - atomic */
 int pipeline_trigger(struct pipeline *p, struct comp_dev *host_cd, int cmd);
 
+/* move a running pipeline to another core between two periods */
+int pipeline_migrate(struct pipeline *p, int core);
+int pipeline_migrate_out(struct pipeline *p, int core);
+int pipeline_migrate_in(struct pipeline *p);
+
 /* initialise pipeline subsys */
 int pipeline_init(void);
 
@@ -132,4 +172,27 @@ void pipeline_schedule(void *arg);
 /* notify host that we have XRUN */
 void pipeline_xrun(struct pipeline *p, struct comp_dev *dev, int32_t bytes);
 
+/* check the work of a low latency pipeline fits its period */
+int pipeline_ll_budget(struct sof_ipc_pipe_new *pipe_desc);
+
+static inline int pipeline_is_ll(struct sof_ipc_pipe_new *pipe_desc)
+{
+	return pipe_desc->deadline &&
+		pipe_desc->deadline <= PIPELINE_LL_PERIOD_MAX;
+}
+
+/* DMA buffer periods of a low latency pipeline */
+uint32_t pipeline_ll_periods(struct sof_ipc_pipe_new *pipe_desc);
+
+/* DMA buffer periods of the pipeline for the ones asked by topology */
+static inline uint32_t pipeline_dma_periods(struct pipeline *p,
+					    uint32_t periods)
+{
+	if (!pipeline_is_ll(&p->ipc_pipe))
+		return periods;
+
+	/* the margin sets the periods, deeper topology buffers are cut */
+	return pipeline_ll_periods(&p->ipc_pipe);
+}
+
 #endif
@@ -39,6 +39,8 @@
 
 #include <arch/cpu.h>
 
+void cpu_power_down_core(void);
+
 static inline int cpu_get_id(void)
 {
 	return arch_cpu_get_id();
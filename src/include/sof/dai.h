@@ -96,7 +96,7 @@ struct dai_slot_map {
 };
 
 struct dai_plat_fifo_data {
-	uint32_t offset;
+	uintptr_t offset;
 	uint32_t width;
 	uint32_t depth;
 	uint32_t watermark;
@@ -40,6 +40,7 @@
 #include <sof/timer.h>
 #include <sof/dma.h>
 #include <sof/work.h>
+#include <sof/cpu.h>
 #include <platform/platform.h>
 #include <platform/timer.h>
 
@@ -52,6 +53,34 @@ struct dma_trace_buf {
 	uint32_t avail;		/* avail bytes in buffer */
 };
 
+/* per core trace ring size in bytes, must be a power of two */
+#define DMA_TRACE_RING_SIZE	(DMA_TRACE_LOCAL_SIZE / 2)
+
+/* ring fill that schedules a copy ahead of the period */
+#define DMA_TRACE_WATERMARK	(DMA_TRACE_RING_SIZE / 2)
+
+/* longest copy period the work backs off to while there is nothing to copy */
+#define DMA_TRACE_PERIOD_MAX	(DMA_TRACE_PERIOD * 8)
+
+/* recent burst starts kept, the mailbox flush starts at one of them */
+#define DMA_TRACE_BURSTS	8
+
+/*
+ * Single producer, single consumer trace ring. Only the owning core writes
+ * entries and w_pos, only the master core drains entries and moves r_pos.
+ * Each entry is a uint32_t length followed by the log entry itself. The
+ * control words are shared between cores, so each ring is allocated on
+ * its own cache lines and only used through the uncached alias.
+ */
+struct dma_trace_ring {
+	void *addr;		/* ring base address */
+	uint32_t w_pos;		/* free running write position */
+	uint32_t r_pos;		/* free running read position */
+	uint32_t dropped;	/* entries dropped as the ring was full */
+	uint32_t flush;		/* master asked to drain, cleared on drain */
+	struct work flush_work;	/* asks the master from the owning core */
+};
+
 struct dma_trace_data {
 	struct dma_sg_config config;
 	struct dma_trace_buf dmatb;
@@ -65,6 +94,14 @@ struct dma_trace_data {
 	uint32_t enabled;
 	uint32_t copy_in_progress;
 	uint32_t stream_tag;
+	uint32_t dropped;	/* dropped entries reported so far */
+	uint32_t period;	/* current copy period in us */
+	uint32_t flushes;	/* DMA copies to host */
+	uint32_t bytes;		/* bytes copied to host */
+	uint32_t pos;		/* free running local buffer write position */
+	uint32_t burst[DMA_TRACE_BURSTS];	/* pos of recent bursts */
+	uint32_t burst_index;	/* next burst[] entry to replace */
+	struct dma_trace_ring *ring[PLATFORM_CORE_COUNT];
 	spinlock_t lock;
 };
 
@@ -75,6 +112,7 @@ int dma_trace_host_buffer(struct dma_trace_data *d,
 			  uint32_t host_size);
 int dma_trace_enable(struct dma_trace_data *d);
 void dma_trace_flush(void *t);
+void dma_trace_schedule_copy(void);
 
 void dtrace_event(const char *e, uint32_t size);
 void dtrace_event_atomic(const char *e, uint32_t length);
@@ -95,8 +95,8 @@ struct dma;
  *  \brief Element of SG list (as array item).
  */
 struct dma_sg_elem {
-	uint32_t src;	/**< source address */
-	uint32_t dest;	/**< destination address */
+	uintptr_t src;	/**< source address */
+	uintptr_t dest;	/**< destination address */
 	uint32_t size;	/**< size (in bytes) */
 };
 
@@ -150,6 +150,10 @@ struct dma_ops {
 		void (*cb)(void *data, uint32_t type, struct dma_sg_elem *next),
 		void *data);
 
+	/* move the period events of a running channel between cores */
+	int (*migrate_out)(struct dma *dma, int channel);
+	int (*migrate_in)(struct dma *dma, int channel);
+
 	int (*pm_context_restore)(struct dma *dma);
 	int (*pm_context_store)(struct dma *dma);
 
@@ -285,6 +289,22 @@ static inline int dma_set_config(struct dma *dma, int channel,
 	return dma->ops->set_config(dma, channel, config);
 }
 
+/* stop taking the channel period events on this core, optional */
+static inline int dma_migrate_out(struct dma *dma, int channel)
+{
+	if (dma->ops->migrate_out)
+		return dma->ops->migrate_out(dma, channel);
+	return 0;
+}
+
+/* take the channel period events on this core, optional */
+static inline int dma_migrate_in(struct dma *dma, int channel)
+{
+	if (dma->ops->migrate_in)
+		return dma->ops->migrate_in(dma, channel);
+	return 0;
+}
+
 static inline int dma_pm_context_restore(struct dma *dma)
 {
 	return dma->ops->pm_context_restore(dma);
@@ -373,6 +393,8 @@ int dma_copy_from_host_nowait(struct dma_copy *dc, struct dma_sg_config *host_sg
 	int32_t host_offset, void *local_ptr, int32_t size);
 
 /* DMA copy data from DSP to host */
+int dma_copy_to_host(struct dma_copy *dc, struct dma_sg_config *host_sg,
+	int32_t host_offset, void *local_ptr, int32_t size);
 int dma_copy_to_host_nowait(struct dma_copy *dc, struct dma_sg_config *host_sg,
 	int32_t host_offset, void *local_ptr, int32_t size);
 
@@ -98,6 +98,22 @@
 #define IDC_MSG_NOTIFY		IDC_TYPE(0x5)
 #define IDC_MSG_NOTIFY_EXT	IDC_EXTENSION(0x0)
 
+/** \brief IDC pipeline migrate out message, pauses and hands it over. */
+#define IDC_MSG_PPL_MIGRATE_OUT		IDC_TYPE(0x6)
+
+/** \brief IDC pipeline migrate in message, takes over and releases it. */
+#define IDC_MSG_PPL_MIGRATE_IN		IDC_TYPE(0x7)
+
+/** \brief IDC pipeline migrate extension, pipeline id and new core. */
+#define IDC_MSG_PPL_MIGRATE_EXT(id, core) \
+	IDC_EXTENSION(((core) << 24) | ((id) & 0xffffff))
+#define IDC_MSG_PPL_MIGRATE_ID(x)	((x) & 0xffffff)
+#define IDC_MSG_PPL_MIGRATE_CORE(x)	(((x) >> 24) & 0x3f)
+
+/** \brief IDC trace flush message, a slave trace ring is filling up. */
+#define IDC_MSG_TRACE_FLUSH	IDC_TYPE(0x8)
+#define IDC_MSG_TRACE_FLUSH_EXT	IDC_EXTENSION(0x0)
+
 /** \brief Decodes IDC message type. */
 #define iTS(x)	(((x) >> IDC_TYPE_SHIFT) & IDC_TYPE_MASK)
 
@@ -117,4 +133,6 @@ struct idc {
 	struct task idc_task;		/**< IDC processing task */
 };
 
+void idc_cmd(struct idc_msg *msg);
+
 #endif
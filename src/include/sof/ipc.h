@@ -49,7 +49,15 @@ struct dai_config;
 #define tracev_ipc(__e)	tracev_event(TRACE_CLASS_IPC, __e)
 #define trace_ipc_error(__e)	trace_error(TRACE_CLASS_IPC, __e)
 
-#define MSG_QUEUE_SIZE		12
+#define MSG_QUEUE_SIZE		12	/* messages allocated at boot */
+#define MSG_QUEUE_MAX		24	/* messages the queue can grow to */
+#define MSG_HASH_SIZE		16	/* queued message lookup buckets */
+
+/* outbound message priorities, lower values are sent first */
+#define IPC_MSG_PRIO_URGENT	0	/* xruns, errors and anything else */
+#define IPC_MSG_PRIO_POSN	1	/* stream positions */
+#define IPC_MSG_PRIO_TRACE	2	/* DMA trace positions */
+#define IPC_MSG_PRIO_COUNT	3
 
 #define COMP_TYPE_COMPONENT	1
 #define COMP_TYPE_BUFFER	2
@@ -67,6 +75,10 @@ struct ipc_comp_dev {
 		struct pipeline *pipeline;
 	};
 
+	/* pipeline load balancing, only updated by the master core */
+	uint64_t balance_rtime;		/* run time at the last balance */
+	uint32_t load;			/* per mille of a core */
+
 	/* lists */
 	struct list_item list;		/* list in components */
 };
@@ -80,15 +92,28 @@ struct ipc_msg {
 	struct list_item list;
 	void (*cb)(void *cb_data, void *mailbox_data);
 	void *cb_data;
+	uint32_t prio;		/* IPC_MSG_PRIO_ */
+	uint32_t comp_id;	/* coalescing key together with header */
+	struct ipc_msg *hash_next;	/* next queued message in bucket */
 };
 
 struct ipc_shared_context {
 	struct ipc_msg *dsp_msg;	/* current message to host */
 	uint32_t dsp_pending;
-	struct list_item msg_list;
+	struct list_item msg_list;	/* queued messages in priority order */
 	struct list_item empty_list;
 	struct ipc_msg message[MSG_QUEUE_SIZE];
 
+	/* last queued message of each priority, NULL if none */
+	struct ipc_msg *msg_tail[IPC_MSG_PRIO_COUNT];
+
+	/* queued messages by header and comp_id */
+	struct ipc_msg *msg_hash[MSG_HASH_SIZE];
+
+	uint32_t msg_count;	/* messages allocated */
+	uint32_t msg_coalesced;	/* messages replaced by a newer one */
+	uint32_t msg_dropped;	/* messages lost to a full queue */
+
 	struct list_item comp_list;	/* list of component devices */
 };
 
@@ -114,6 +139,10 @@ struct ipc {
 	/* processing task */
 	struct task ipc_task;
 
+	/* pipeline load balancing */
+	uint64_t balance_time;		/* time of the last balance */
+	uint64_t balance_request;	/* pending balance time, 0 none */
+
 	void *private;
 };
 
@@ -130,7 +159,10 @@ void ipc_free(struct ipc *ipc);
 int ipc_process_msg_queue(void);
 void ipc_process_task(void *data);
 void ipc_schedule_process(struct ipc *ipc);
+void ipc_schedule_balance(struct ipc *ipc, uint64_t time);
 
+void ipc_stream_publish_position(struct comp_dev *cdev,
+		struct sof_ipc_stream_posn *posn);
 int ipc_stream_send_position(struct comp_dev *cdev,
 		struct sof_ipc_stream_posn *posn);
 int ipc_stream_send_xrun(struct comp_dev *cdev,
@@ -138,6 +170,7 @@ int ipc_stream_send_xrun(struct comp_dev *cdev,
 
 int ipc_queue_host_message(struct ipc *ipc, uint32_t header, void *tx_data,
 			   size_t tx_bytes, uint32_t replace);
+struct ipc_msg *ipc_msg_dequeue(struct ipc *ipc);
 
 void ipc_platform_do_cmd(struct ipc *ipc);
 void ipc_platform_send_msg(struct ipc *ipc);
@@ -150,6 +183,13 @@ int ipc_parse_page_descriptors(uint8_t *page_table,
 int ipc_get_page_descriptors(struct dma *dmac, uint8_t *page_table,
 			     struct sof_ipc_host_buffer *ring);
 
+/*
+ * Compound messages, every message in it is run by ipc_compound_cmd().
+ */
+int ipc_compound_read(struct sof_ipc_hdr *hdr);
+int ipc_glb_compound_message(uint32_t header);
+int ipc_compound_cmd(uint32_t header);
+
 /*
  * IPC Component creation and destruction.
  */
@@ -169,6 +209,15 @@ int ipc_pipeline_new(struct ipc *ipc, struct sof_ipc_pipe_new *pipeline);
 int ipc_pipeline_free(struct ipc *ipc, uint32_t comp_id);
 int ipc_pipeline_complete(struct ipc *ipc, uint32_t comp_id);
 
+/*
+ * Move a pipeline from the busiest to the least busy core, time is on the
+ * clock of the task run times. Returns 1 if a pipeline was moved.
+ */
+int ipc_pipeline_balance(struct ipc *ipc, uint64_t time);
+
+/* mark the components changed since the last PM context save */
+void ipc_comp_pm_dirty(struct ipc *ipc);
+
 /*
  * Pipeline component and buffer connections.
  */
@@ -190,4 +239,8 @@ int ipc_dma_trace_send_position(void);
 
 /* get posn offset by pipeline. */
 int ipc_get_posn_offset(struct ipc *ipc, struct pipeline *pipe);
+
+/* update the stream position slot of the component pipeline */
+void ipc_stream_posn_write(struct comp_dev *cdev,
+			   struct sof_ipc_stream_posn *posn);
 #endif
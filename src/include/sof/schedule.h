@@ -57,6 +57,9 @@ struct sof;
 #define TASK_PRI_MED	0
 #define TASK_PRI_HIGH	-20
 
+/* low latency class, runs before all others and is never deferred */
+#define TASK_PRI_LL	(TASK_PRI_HIGH - 1)
+
 #define TASK_PRI_IPC	1
 #define TASK_PRI_IDC	1
 
@@ -78,7 +81,8 @@ struct task {
 	void (*func)(void *arg);
 
 	/* runtime duration in scheduling clock base */
-	uint64_t max_rtime;		/* max time taken to run */
+	uint64_t max_rtime;		/* max time taken to run, LL only */
+	uint64_t total_rtime;		/* time taken by all runs */
 	completion_t complete;
 };
 
@@ -94,6 +98,8 @@ int schedule_task_cancel(struct task *task);
 
 void schedule_task_complete(struct task *task);
 
+void schedule_task_rtime(struct task *task, uint64_t rtime);
+
 static inline void schedule_task_init(struct task *task, void (*func)(void *),
 	void *data)
 {
@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2018, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of the Intel Corporation nor the
+ *     names of its contributors may be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Sequence counter for data that one agent updates and other agents or the
+ * host read without taking a lock. The writer makes the counter odd while
+ * it updates the data, readers retry until they see the same even count
+ * before and after reading it.
+ */
+
+#ifndef __INCLUDE_SEQLOCK__
+#define __INCLUDE_SEQLOCK__
+
+#include <stdint.h>
+
+/* full memory barrier, memw on xtensa */
+#define seq_barrier()	__sync_synchronize()
+
+static inline void seq_write_begin(volatile uint32_t *seq)
+{
+	*seq = *seq + 1;
+	seq_barrier();
+}
+
+static inline void seq_write_end(volatile uint32_t *seq)
+{
+	seq_barrier();
+	*seq = *seq + 1;
+}
+
+/* wait for a stable count and return it */
+static inline uint32_t seq_read_begin(const volatile uint32_t *seq)
+{
+	uint32_t start;
+
+	do {
+		start = *seq;
+	} while (start & 1);
+
+	seq_barrier();
+	return start;
+}
+
+/* non zero if the data changed since seq_read_begin() returned start */
+static inline int seq_read_retry(const volatile uint32_t *seq, uint32_t start)
+{
+	seq_barrier();
+	return *seq != start;
+}
+
+#endif
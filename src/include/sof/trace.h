@@ -39,7 +39,10 @@
 #include <sof/mailbox.h>
 #include <sof/debug.h>
 #include <sof/timer.h>
+#include <arch/cache.h>
+#include <sof/platform.h>
 #include <platform/platform.h>
+#include <platform/memory.h>
 #include <platform/timer.h>
 #include <uapi/logging.h>
 
@@ -123,6 +126,24 @@ void _trace_event_mbox_atomic4(uint32_t log_entry, uint32_t param1,
 void trace_flush(void);
 void trace_off(void);
 void trace_init(struct sof *sof);
+void trace_level_set(uint32_t level, uint32_t class_mask);
+
+/*
+ * Runtime trace filter, bit n of mask[level] enables class n at that level.
+ * It is read through the uncached alias so that all cores see updates from
+ * the IPC handler, and fills a data cache line so that no cached neighbour
+ * can write a stale copy back over it. Level and class are constants at
+ * every call site, so the check is one load and one branch.
+ */
+struct trace_filter {
+	uint32_t mask[LOG_LEVEL_COUNT];
+} __attribute__((__aligned__(PLATFORM_DCACHE_ALIGN)));
+
+extern struct trace_filter trace_filter;
+
+#define trace_class_enabled(level, class) \
+	(((volatile struct trace_filter *)cache_to_uncache(&trace_filter))-> \
+	 mask[level] & (1 << LOG_CLASS_INDEX(class)))
 
 #if TRACE
 
@@ -147,29 +168,34 @@ void trace_init(struct sof *sof);
  */
 #if TRACEM
 /* send all trace to mbox and local trace buffer */
-#define trace_event(__c, __e, ...) \
-	_log_message(_mbox,, LOG_LEVEL_VERBOSE, __c, __e, ##__VA_ARGS__)
-#define trace_event_atomic(__c, __e, ...) \
-	_log_message(_mbox, _atomic, LOG_LEVEL_VERBOSE, __c, __e, ##__VA_ARGS__)
+#define _trace_level(__l, __c, __e, ...) \
+	_log_message(_mbox,, __l, __c, __e, ##__VA_ARGS__)
+#define _trace_level_atomic(__l, __c, __e, ...) \
+	_log_message(_mbox, _atomic, __l, __c, __e, ##__VA_ARGS__)
 #else
 /* send trace events only to the local trace buffer */
+#define _trace_level(__l, __c, __e, ...) \
+	_log_message(,, __l, __c, __e, ##__VA_ARGS__)
+#define _trace_level_atomic(__l, __c, __e, ...) \
+	_log_message(, _atomic, __l, __c, __e, ##__VA_ARGS__)
+#endif
 #define trace_event(__c, __e, ...) \
-	_log_message(,, LOG_LEVEL_VERBOSE, __c, __e, ##__VA_ARGS__)
+	_trace_level(LOG_LEVEL_INFO, __c, __e, ##__VA_ARGS__)
 #define trace_event_atomic(__c, __e, ...) \
-	_log_message(, _atomic, LOG_LEVEL_VERBOSE, __c, __e, ##__VA_ARGS__)
-#endif
+	_trace_level_atomic(LOG_LEVEL_INFO, __c, __e, ##__VA_ARGS__)
 #define trace_value(x)		trace_event(0, "value %u", x)
 #define trace_value_atomic(x)	trace_event_atomic(0, "value %u", x)
 
 #define trace_point(x) platform_trace_point(x)
 
-/* verbose tracing */
+/* verbose tracing, off at runtime until enabled per class over IPC */
 #if TRACEV
-#define tracev_event(__c, __e, ...) trace_event(__c, __e, ##__VA_ARGS__)
-#define tracev_value(x)	trace_value(x)
+#define tracev_event(__c, __e, ...) \
+	_trace_level(LOG_LEVEL_VERBOSE, __c, __e, ##__VA_ARGS__)
+#define tracev_value(x)	tracev_event(0, "value %u", x)
 #define tracev_event_atomic(__c, __e, ...) \
-	trace_event_atomic(__c, __e, ##__VA_ARGS__)
-#define tracev_value_atomic(x)	trace_value_atomic(x)
+	_trace_level_atomic(LOG_LEVEL_VERBOSE, __c, __e, ##__VA_ARGS__)
+#define tracev_value_atomic(x)	tracev_event_atomic(0, "value %u", x)
 #else
 #define tracev_event(__c, __e, ...)
 #define tracev_event_atomic(__c, __e, ...)
@@ -254,7 +280,8 @@ typedef void(*log_func)();
 #define __log_message(func_name, lvl, comp_id, format, ...)		\
 {									\
 	_DECLARE_LOG_ENTRY(lvl, format, comp_id, PP_NARG(__VA_ARGS__));	\
-	BASE_LOG(func_name, &log_entry, ##__VA_ARGS__)	\
+	if (trace_class_enabled(lvl, comp_id))				\
+		BASE_LOG(func_name, &log_entry, ##__VA_ARGS__)		\
 }
 
 #define _log_message(mbox, atomic, level, comp_id, format, ...)	\
@@ -55,7 +55,7 @@
 	)
 
 #define SOF_ABI_MAJOR 1
-#define SOF_ABI_MINOR 0
+#define SOF_ABI_MINOR 1
 #define SOF_ABI_MICRO 0
 
 #define SOF_ABI_VERSION SOF_ABI_VER(SOF_ABI_MAJOR, SOF_ABI_MINOR, SOF_ABI_MICRO)
@@ -131,6 +131,12 @@
 /* trace and debug */
 #define SOF_IPC_TRACE_DMA_PARAMS		SOF_CMD_TYPE(0x001)
 #define SOF_IPC_TRACE_DMA_POSITION		SOF_CMD_TYPE(0x002)
+#define SOF_IPC_TRACE_HEAP_INFO			SOF_CMD_TYPE(0x003)
+#define SOF_IPC_TRACE_HEAP_SAMPLE		SOF_CMD_TYPE(0x004)
+#define SOF_IPC_TRACE_LEVEL			SOF_CMD_TYPE(0x005)
+#define SOF_IPC_TRACE_DMA_STATS			SOF_CMD_TYPE(0x006)
+#define SOF_IPC_TRACE_MSG_STATS			SOF_CMD_TYPE(0x007)
+#define SOF_IPC_TRACE_PIPE_STATS		SOF_CMD_TYPE(0x008)
 
 /* Get message component id */
 #define SOF_IPC_MESSAGE_ID(x)			((x) & 0xffff)
@@ -193,14 +199,27 @@ struct sof_ipc_reply {
  * Compound commands - SOF_IPC_GLB_COMPOUND.
  *
  * Compound commands are sent to the DSP as a single IPC operation. The
- * commands are split into blocks and each block has a header. This header
- * identifies the command type and the number of commands before the next
- * header.
+ * header is followed by count complete topology or DAI messages, each
+ * with its own struct sof_ipc_hdr and starting on a 32 bit boundary. The
+ * whole compound can use the full host mailbox, every message in it is
+ * limited to SOF_IPC_MSG_MAX_SIZE.
+ *
+ * Messages are run in order until one fails. The reply carries the error
+ * code of every message that was run, so the number of codes is the index
+ * of the failing message plus one.
  */
 
+#define SOF_IPC_COMPOUND_MAX_COUNT	64
+
 struct sof_ipc_compound_hdr {
 	struct sof_ipc_hdr hdr;
-	uint32_t count;		/* count of 0 means end of compound sequence */
+	uint32_t count;		/* number of messages */
+}  __attribute__((packed));
+
+struct sof_ipc_compound_reply {
+	struct sof_ipc_reply rhdr;
+	uint32_t count;		/* number of messages that were run */
+	int32_t error[];	/* error code of every message that was run */
 }  __attribute__((packed));
 
 /*
@@ -571,6 +590,19 @@ struct sof_ipc_stream_posn {
 	int32_t xrun_size;	/* XRUN size in bytes */
 }  __attribute__((packed));
 
+/*
+ * Stream position slot in the stream mailbox at the posn_offset of the PCM
+ * params reply. The DSP updates it every period without any IPC, seq is odd
+ * while it does. Readers take seq, retry while it is odd, read posn and
+ * retry if seq has changed. Slots are spaced by the DSP cache line size,
+ * so only posn_offset locates one.
+ */
+struct sof_ipc_stream_posn_slot {
+	struct sof_ipc_stream_posn posn;
+	uint32_t seq;		/* update sequence count */
+	uint32_t reserved;
+}  __attribute__((packed));
+
 /*
  * Component Mixers and Controls
  */
@@ -976,6 +1008,90 @@ struct sof_ipc_dma_trace_posn {
 	uint32_t messages;	/* total trace messages */
 }  __attribute__((packed));
 
+/* DMA trace statistics reply - SOF_IPC_TRACE_DMA_STATS */
+struct sof_ipc_dma_trace_stats {
+	struct sof_ipc_reply rhdr;
+	uint32_t flushes;	/* DMA copies to host */
+	uint32_t bytes;		/* bytes copied to host */
+	uint32_t dropped;	/* entries dropped as a trace ring was full */
+	uint32_t messages;	/* total trace messages */
+	uint32_t period_us;	/* current copy period */
+}  __attribute__((packed));
+
+/* DSP to host message queue statistics reply - SOF_IPC_TRACE_MSG_STATS */
+struct sof_ipc_msg_stats {
+	struct sof_ipc_reply rhdr;
+	uint32_t count;		/* messages allocated for the queue */
+	uint32_t coalesced;	/* messages replaced by a newer one */
+	uint32_t dropped;	/* messages lost to a full queue */
+}  __attribute__((packed));
+
+/* stream pipeline XRUN statistics reply - SOF_IPC_TRACE_PIPE_STATS */
+struct sof_ipc_pipe_stats {
+	struct sof_ipc_reply rhdr;
+	uint32_t comp_id;	/* stream component queried */
+	uint32_t catch_ups;	/* task runs copying missed periods */
+	uint32_t catch_up_periods; /* missed periods copied */
+	uint32_t recovers;	/* full XRUN recoveries */
+}  __attribute__((packed));
+
+/* Runtime trace filter - SOF_IPC_TRACE_LEVEL */
+struct sof_ipc_trace_level {
+	struct sof_ipc_hdr hdr;
+	uint32_t level;		/* LOG_LEVEL_ the mask applies to */
+	uint32_t class_mask;	/* bit n enables TRACE_CLASS n at level */
+}  __attribute__((packed));
+
+/*
+ * Heap statistics
+ */
+
+/* heap zones */
+enum sof_ipc_heap_zone {
+	SOF_IPC_HEAP_SYSTEM = 0,
+	SOF_IPC_HEAP_RUNTIME,
+	SOF_IPC_HEAP_BUFFER,
+};
+
+/* Heap statistics query - SOF_IPC_TRACE_HEAP_INFO */
+struct sof_ipc_heap_query {
+	struct sof_ipc_hdr hdr;
+	uint32_t zone;		/* enum sof_ipc_heap_zone */
+	uint32_t index;		/* heap index within the zone */
+}  __attribute__((packed));
+
+/* Heap block map statistics, counts in blocks */
+struct sof_ipc_heap_map_info {
+	uint32_t block_size;	/* block size in bytes */
+	uint32_t count;		/* blocks in map */
+	uint32_t free_count;	/* free blocks */
+	uint32_t max_used;	/* high-water mark of used blocks */
+	uint32_t max_run;	/* largest continuous run of free blocks */
+	uint32_t failed;	/* allocations this map could not satisfy */
+}  __attribute__((packed));
+
+/* Heap statistics reply - SOF_IPC_TRACE_HEAP_INFO, sizes in bytes */
+struct sof_ipc_heap_info {
+	struct sof_ipc_reply rhdr;
+	uint32_t zone;		/* enum sof_ipc_heap_zone */
+	uint32_t index;		/* heap index within the zone */
+	uint32_t num_heaps;	/* heaps in the zone */
+	uint32_t caps;		/* SOF_MEM_CAPS_ */
+	uint32_t size;
+	uint32_t used;
+	uint32_t free;
+	uint32_t peak;		/* high-water mark of used */
+	uint32_t failed;	/* failed allocations */
+	uint32_t num_maps;
+	struct sof_ipc_heap_map_info map[];
+}  __attribute__((packed));
+
+/* Heap statistics sampling to trace - SOF_IPC_TRACE_HEAP_SAMPLE */
+struct sof_ipc_heap_sample {
+	struct sof_ipc_hdr hdr;
+	uint32_t period_ms;	/* sampling period, 0 stops sampling */
+}  __attribute__((packed));
+
 /*
  * Architecture specific debug
  */
@@ -81,6 +81,11 @@ struct system_time {
 
 #define LOG_LEVEL_CRITICAL	1  /* (FDK fatal) */
 #define LOG_LEVEL_VERBOSE	2
+#define LOG_LEVEL_INFO		3  /* new in ABI 1.1 */
+#define LOG_LEVEL_COUNT		4
+
+/* class index of a TRACE_CLASS_ value, bit number in a class mask */
+#define LOG_CLASS_INDEX(class)	((class) >> 24)
 
 /*
  * Layout of a log fifo.
@@ -104,12 +109,46 @@ struct log_buffer_status {
  * The header is followed by an array of arguments (uint32_t[]).
  * Number of arguments is specified by the params_num field of log_entry,
  * and is 0-based value (entry_len=0 means there is 1 argument).
+ *
+ * The mailbox trace holds these full entries and the DMA trace the compact
+ * stream below. Full entries start with LOG_ENTRY_MAGIC, which no compact
+ * stream byte at a record boundary matches, so readers tell them apart.
  */
+#define LOG_ENTRY_MAGIC		0xfd
+
 struct log_entry_header {
-	uint32_t rsvd : 24;	/* Unused */
+	uint32_t magic : 8;	/* LOG_ENTRY_MAGIC */
+	uint32_t rsvd : 16;	/* Unused */
 	uint32_t core_id : 8;	/* Reporting core's id */
 
 	uint64_t timestamp;	/* Timestamp (in dsp ticks) */
 } __attribute__((__packed__));
 
+/*
+ * Compact DMA trace stream.
+ *
+ * Every drain of the trace rings writes a burst: a base record with the
+ * full timestamp of the first event, then the events of the burst, then
+ * padding up to the next 32 bit word. An event is a tag byte followed by
+ * varints of the timestamp delta to the previous event (zigzag signed), of
+ * the log entry address relative to entry_base and of each parameter.
+ * Varints hold 7 bits per byte, least significant first, with bit 7 set in
+ * all but the last byte. The base record carries the version of the format.
+ */
+#define LOG_COMPACT_BURST	0xff	/* tag of a burst base record */
+#define LOG_COMPACT_PAD		0xfe	/* tag of a padding byte */
+#define LOG_COMPACT_VERSION	1	/* version of the compact format */
+
+/* event tag, core id in the high nibble and params count in the low one */
+#define LOG_COMPACT_TAG(core, params)	(((core) << 4) | (params))
+#define LOG_COMPACT_TAG_CORE(tag)	((tag) >> 4)
+#define LOG_COMPACT_TAG_PARAMS(tag)	((tag) & 0xf)
+
+struct log_compact_burst {
+	uint8_t tag;		/* LOG_COMPACT_BURST */
+	uint8_t version;	/* LOG_COMPACT_VERSION */
+	uint64_t timestamp;	/* timestamp of the first event, dsp ticks */
+	uint32_t entry_base;	/* base address of the log entries */
+} __attribute__((__packed__));
+
 #endif //#ifndef __INCLUDE_LOGGING__
@@ -165,10 +165,8 @@ void ipc_platform_send_msg(struct ipc *ipc)
 		goto out;
 
 	/* now send the message */
-	msg = list_first_item(&ipc->shared_ctx->msg_list, struct ipc_msg,
-			      list);
+	msg = ipc_msg_dequeue(ipc);
 	mailbox_dspbox_write(0, msg->tx_data, msg->tx_size);
-	list_item_del(&msg->list);
 	ipc->shared_ctx->dsp_msg = msg;
 	tracev_ipc("Msg");
 
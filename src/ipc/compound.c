@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2018, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of the Intel Corporation nor the
+ *     names of its contributors may be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Compound IPC messages, SOF_IPC_GLB_COMPOUND. The messages of a compound
+ * are read from the host mailbox and run one at a time through
+ * ipc_compound_cmd().
+ */
+
+#include <stdint.h>
+#include <errno.h>
+#include <sof/ipc.h>
+#include <sof/mailbox.h>
+#include <sof/trace.h>
+#include <platform/mailbox.h>
+#include <uapi/ipc.h>
+
+extern struct ipc *_ipc;
+
+/* read the rest of the compound header, the messages are read when run */
+int ipc_compound_read(struct sof_ipc_hdr *hdr)
+{
+	if (hdr->size < sizeof(struct sof_ipc_compound_hdr) ||
+	    hdr->size > MAILBOX_HOSTBOX_SIZE) {
+		trace_ipc_error("ebc");
+		return -EINVAL;
+	}
+
+	mailbox_hostbox_read(hdr + 1, sizeof(*hdr),
+			     sizeof(struct sof_ipc_compound_hdr) -
+			     sizeof(*hdr));
+	return 0;
+}
+
+/* read the message at offset into comp_data */
+static int ipc_compound_msg_read(struct sof_ipc_hdr *hdr, uint32_t offset,
+				 uint32_t size)
+{
+	/* message header must be complete */
+	if (offset + sizeof(*hdr) > size)
+		goto err;
+
+	mailbox_hostbox_read(hdr, offset, sizeof(*hdr));
+
+	/* message must be complete and fit in comp_data */
+	if (hdr->size < sizeof(*hdr) || hdr->size > SOF_IPC_MSG_MAX_SIZE ||
+	    offset + hdr->size > size)
+		goto err;
+
+	mailbox_hostbox_read(hdr + 1, offset + sizeof(*hdr),
+			     hdr->size - sizeof(*hdr));
+	dcache_writeback_region(hdr, hdr->size);
+	return 0;
+
+err:
+	trace_ipc_error("eCs");
+	return -EINVAL;
+}
+
+/*
+ * Run the messages of a compound one after the other. Each one is copied
+ * to comp_data so the usual handlers run unchanged. Handlers that write a
+ * reply only overwrite the start of the mailbox, which has already been
+ * read by then, and the compound reply replaces those replies at the end.
+ */
+int ipc_glb_compound_message(uint32_t header)
+{
+	struct sof_ipc_compound_hdr *compound = _ipc->comp_data;
+	struct sof_ipc_hdr *hdr = _ipc->comp_data;
+	struct sof_ipc_compound_reply reply;
+	int32_t error[SOF_IPC_COMPOUND_MAX_COUNT];
+	uint32_t size = compound->hdr.size;
+	uint32_t count = compound->count;
+	uint32_t offset = sizeof(*compound);
+	uint32_t i;
+	int err = 0;
+
+	trace_ipc("Cmp");
+
+	if (count > SOF_IPC_COMPOUND_MAX_COUNT) {
+		trace_ipc_error("eCn");
+		return -EINVAL;
+	}
+
+	for (i = 0; i < count; i++) {
+		err = ipc_compound_msg_read(hdr, offset, size);
+		if (!err) {
+			/* next message starts on a 32 bit boundary */
+			offset += (hdr->size + 3) & ~3;
+
+			err = ipc_compound_cmd(hdr->cmd);
+		}
+
+		/* positive means the handler wrote its own reply */
+		error[i] = err > 0 ? 0 : err;
+		if (err < 0) {
+			i++;
+			break;
+		}
+	}
+
+	reply.rhdr.hdr.cmd = header;
+	reply.rhdr.hdr.size = sizeof(reply) + i * sizeof(error[0]);
+	reply.rhdr.error = err < 0 ? err : 0;
+	reply.count = i;
+	mailbox_hostbox_write(0, &reply, sizeof(reply));
+	mailbox_hostbox_write(sizeof(reply), error, i * sizeof(error[0]));
+	return 1;
+}
@@ -81,21 +81,21 @@ static void dma_complete(void *data, uint32_t type, struct dma_sg_elem *next)
 	if (type == DMA_IRQ_TYPE_LLIST)
 		wait_completed(comp);
 
-	ipc_dma_trace_send_position();
-
 	next->size = DMA_RELOAD_END;
 }
 
 #endif
 
+/* wait 100 usecs for each DMA copy to finish */
+#define DMA_COPY_TIMEOUT	100
+
 /* Copy DSP memory to host memory.
  * Copies DSP memory to host in a single PAGE_SIZE or smaller block. Does not
  * waits/sleeps and can be used in IRQ context.
  */
 #if defined CONFIG_DMA_GW
 
-int dma_copy_to_host_nowait(struct dma_copy *dc, struct dma_sg_config *host_sg,
-			    int32_t host_offset, void *local_ptr, int32_t size)
+static int dma_copy_host_nowait(struct dma_copy *dc, int32_t size)
 {
 	int ret;
 
@@ -108,10 +108,39 @@ int dma_copy_to_host_nowait(struct dma_copy *dc, struct dma_sg_config *host_sg,
 	return size;
 }
 
-#else
-
 int dma_copy_to_host_nowait(struct dma_copy *dc, struct dma_sg_config *host_sg,
 			    int32_t host_offset, void *local_ptr, int32_t size)
+{
+	return dma_copy_host_nowait(dc, size);
+}
+
+int dma_copy_from_host_nowait(struct dma_copy *dc,
+			      struct dma_sg_config *host_sg,
+			      int32_t host_offset, void *local_ptr,
+			      int32_t size)
+{
+	return dma_copy_host_nowait(dc, size);
+}
+
+/* gateway copies the whole request at once */
+int dma_copy_to_host(struct dma_copy *dc, struct dma_sg_config *host_sg,
+		     int32_t host_offset, void *local_ptr, int32_t size)
+{
+	return dma_copy_host_nowait(dc, size);
+}
+
+int dma_copy_from_host(struct dma_copy *dc, struct dma_sg_config *host_sg,
+		       int32_t host_offset, void *local_ptr, int32_t size)
+{
+	return dma_copy_host_nowait(dc, size);
+}
+
+#else
+
+static int dma_copy_host_nowait(struct dma_copy *dc,
+				struct dma_sg_config *host_sg,
+				int32_t host_offset, void *local_ptr,
+				int32_t size, uint32_t dir)
 {
 	struct dma_sg_config config;
 	struct dma_sg_elem *host_sg_elem;
@@ -128,15 +157,20 @@ int dma_copy_to_host_nowait(struct dma_copy *dc, struct dma_sg_config *host_sg,
 		return -EINVAL;
 
 	/* set up DMA configuration */
-	config.direction = DMA_DIR_LMEM_TO_HMEM;
+	config.direction = dir;
 	config.src_width = sizeof(uint32_t);
 	config.dest_width = sizeof(uint32_t);
 	config.cyclic = 0;
 	dma_sg_init(&config.elem_array);
 
 	/* configure local DMA elem */
-	local_sg_elem.dest = host_sg_elem->dest + offset;
-	local_sg_elem.src = (uint32_t)local_ptr;
+	if (dir == DMA_DIR_LMEM_TO_HMEM) {
+		local_sg_elem.dest = host_sg_elem->dest + offset;
+		local_sg_elem.src = (uint32_t)local_ptr;
+	} else {
+		local_sg_elem.dest = (uint32_t)local_ptr;
+		local_sg_elem.src = host_sg_elem->dest + offset;
+	}
 	if (size >= HOST_PAGE_SIZE - offset)
 		local_sg_elem.size = HOST_PAGE_SIZE - offset;
 	else
@@ -158,6 +192,72 @@ int dma_copy_to_host_nowait(struct dma_copy *dc, struct dma_sg_config *host_sg,
 	return local_sg_elem.size;
 }
 
+/* copy in PAGE_SIZE or smaller blocks, waiting for each one to finish */
+static int dma_copy_host(struct dma_copy *dc, struct dma_sg_config *host_sg,
+			 int32_t host_offset, void *local_ptr, int32_t size,
+			 uint32_t dir)
+{
+	int32_t offset = 0;
+	int ret;
+
+	while (offset < size) {
+		wait_init(&dc->complete);
+		dc->complete.timeout = DMA_COPY_TIMEOUT;
+
+		ret = dma_copy_host_nowait(dc, host_sg, host_offset + offset,
+					   (char *)local_ptr + offset,
+					   size - offset, dir);
+		if (ret <= 0)
+			return ret < 0 ? ret : -EINVAL;
+
+		/* wait for DMA to complete */
+		if (wait_for_completion_timeout(&dc->complete) < 0) {
+			trace_dma_error("ex1");
+			return -EIO;
+		}
+
+		offset += ret;
+	}
+
+	/* bytes copied */
+	return size;
+}
+
+int dma_copy_to_host_nowait(struct dma_copy *dc, struct dma_sg_config *host_sg,
+			    int32_t host_offset, void *local_ptr, int32_t size)
+{
+	return dma_copy_host_nowait(dc, host_sg, host_offset, local_ptr, size,
+				    DMA_DIR_LMEM_TO_HMEM);
+}
+
+int dma_copy_from_host_nowait(struct dma_copy *dc,
+			      struct dma_sg_config *host_sg,
+			      int32_t host_offset, void *local_ptr,
+			      int32_t size)
+{
+	return dma_copy_host_nowait(dc, host_sg, host_offset, local_ptr, size,
+				    DMA_DIR_HMEM_TO_LMEM);
+}
+
+/* Copy DSP memory to host memory.
+ * Copies any size, waiting for each PAGE_SIZE or smaller block to finish.
+ * Cannot be used in IRQ context.
+ */
+int dma_copy_to_host(struct dma_copy *dc, struct dma_sg_config *host_sg,
+		     int32_t host_offset, void *local_ptr, int32_t size)
+{
+	return dma_copy_host(dc, host_sg, host_offset, local_ptr, size,
+			     DMA_DIR_LMEM_TO_HMEM);
+}
+
+/* Copy host memory to DSP memory, waits like dma_copy_to_host() */
+int dma_copy_from_host(struct dma_copy *dc, struct dma_sg_config *host_sg,
+		       int32_t host_offset, void *local_ptr, int32_t size)
+{
+	return dma_copy_host(dc, host_sg, host_offset, local_ptr, size,
+			     DMA_DIR_HMEM_TO_LMEM);
+}
+
 #endif
 
 int dma_copy_new(struct dma_copy *dc)
@@ -182,7 +282,7 @@ int dma_copy_new(struct dma_copy *dc)
 		return dc->chan;
 	}
 
-	dc->complete.timeout = 100;	/* wait 100 usecs for DMA to finish */
+	dc->complete.timeout = DMA_COPY_TIMEOUT;
 	dma_set_cb(dc->dmac, dc->chan, DMA_IRQ_TYPE_LLIST, dma_complete,
 		&dc->complete);
 #endif
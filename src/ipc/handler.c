@@ -79,6 +79,10 @@ static inline struct sof_ipc_hdr *mailbox_validate(void)
 	/* read component values from the inbox */
 	mailbox_hostbox_read(hdr, 0, sizeof(*hdr));
 
+	/* compound messages are read one message at a time when run */
+	if (iGS(hdr->cmd) == iGS(SOF_IPC_GLB_COMPOUND))
+		return ipc_compound_read(hdr) ? NULL : hdr;
+
 	/* validate component header */
 	if (hdr->size > SOF_IPC_MSG_MAX_SIZE) {
 		trace_ipc_error("ebg");
@@ -350,25 +354,32 @@ static int ipc_stream_position(uint32_t header)
 	pipeline_get_timestamp(pcm_dev->cd->pipeline, pcm_dev->cd, &posn);
 
 	/* copy positions to stream region */
-	mailbox_stream_write(pcm_dev->cd->pipeline->posn_offset,
-			     &posn, sizeof(posn));
+	ipc_stream_posn_write(pcm_dev->cd, &posn);
 
 	return 1;
 }
 
 /* send stream position */
-int ipc_stream_send_position(struct comp_dev *cdev,
+void ipc_stream_publish_position(struct comp_dev *cdev,
 	struct sof_ipc_stream_posn *posn)
 {
-	tracev_ipc("Pos");
 	posn->rhdr.hdr.cmd = SOF_IPC_GLB_STREAM_MSG | SOF_IPC_STREAM_POSITION |
 		cdev->comp.id;
 	posn->rhdr.hdr.size = sizeof(*posn);
 	posn->comp_id = cdev->comp.id;
 
-	mailbox_stream_write(cdev->pipeline->posn_offset, posn, sizeof(*posn));
+	ipc_stream_posn_write(cdev, posn);
+}
+
+int ipc_stream_send_position(struct comp_dev *cdev,
+	struct sof_ipc_stream_posn *posn)
+{
+	tracev_ipc("Pos");
+	ipc_stream_publish_position(cdev, posn);
+
+	/* the host only needs the latest position of each stream */
 	return ipc_queue_host_message(_ipc, posn->rhdr.hdr.cmd, posn,
-				      sizeof(*posn), 0);
+				      sizeof(*posn), 1);
 }
 
 /* send stream position TODO: send compound message  */
@@ -379,7 +390,7 @@ int ipc_stream_send_xrun(struct comp_dev *cdev,
 	posn->rhdr.hdr.size = sizeof(*posn);
 	posn->comp_id = cdev->comp.id;
 
-	mailbox_stream_write(cdev->pipeline->posn_offset, posn, sizeof(*posn));
+	ipc_stream_posn_write(cdev, posn);
 	return ipc_queue_host_message(_ipc, posn->rhdr.hdr.cmd, posn,
 				      sizeof(*posn), 0);
 }
@@ -520,26 +531,93 @@ static int ipc_pm_context_size(uint32_t header)
 
 	bzero(&pm_ctx, sizeof(pm_ctx));
 
-	/* TODO: calculate the context and size of host buffers required */
+	/* host buffer must hold the heap context image */
+	pm_ctx.hdr.size = sizeof(pm_ctx);
+	pm_ctx.size = mm_pm_context_size();
 
 	/* write the context to the host driver */
 	mailbox_hostbox_write(0, &pm_ctx, sizeof(pm_ctx));
 	return 1;
 }
 
+#ifdef CONFIG_HOST_PTABLE
+/* DMA the heap context image to or from the host PM context buffer */
+static int ipc_pm_context_copy(struct sof_ipc_pm_ctx *pm_ctx, int save)
+{
+	struct intel_ipc_data *iipc = ipc_get_drvdata(_ipc);
+	struct dma_sg_config config;
+	struct dma_copy dc;
+	int err;
+
+	/* nothing to copy if the host has no context buffer */
+	if (!pm_ctx->buffer.pages || !pm_ctx->buffer.size)
+		return 0;
+
+	bzero(&config, sizeof(config));
+	dma_sg_init(&config.elem_array);
+
+	/* use DMA to read in compressed page table ringbuffer from host */
+	err = ipc_get_page_descriptors(iipc->dmac, iipc->page_table,
+				       &pm_ctx->buffer);
+	if (err < 0) {
+		trace_ipc_error("eMp");
+		goto out;
+	}
+
+	err = ipc_parse_page_descriptors(iipc->page_table, &pm_ctx->buffer,
+					 &config.elem_array,
+					 save ? SOF_IPC_STREAM_CAPTURE :
+					 SOF_IPC_STREAM_PLAYBACK);
+	if (err < 0) {
+		trace_ipc_error("eMP");
+		goto out;
+	}
+
+	err = dma_copy_new(&dc);
+	if (err < 0)
+		goto out;
+
+	if (save)
+		err = mm_pm_context_save(&dc, &config);
+	else
+		err = mm_pm_context_restore(&dc, &config);
+	dma_copy_free(&dc);
+
+out:
+	dma_sg_free(&config.elem_array);
+	return err;
+}
+#else
+/* DMA gateways need a stream tag the PM context IPC does not carry, the
+ * host boots the firmware again on D0 instead
+ */
+static int ipc_pm_context_copy(struct sof_ipc_pm_ctx *pm_ctx, int save)
+{
+	return 0;
+}
+#endif
+
 static int ipc_pm_context_save(uint32_t header)
 {
 	struct sof_ipc_pm_ctx *pm_ctx = _ipc->comp_data;
 	struct intel_ipc_data *iipc = ipc_get_drvdata(_ipc);
+	int ret;
 
 	trace_ipc("PMs");
 
 	/* TODO: check we are inactive - all streams are suspended */
 
-	/* TODO: mask ALL platform interrupts except DMA */
-
-	/* TODO now save the context - create SG buffer config using */
-	//mm_pm_context_save(struct dma_sg_config *sg);
+	/* save the heaps while the DMA completion interrupts still run, only
+	 * the memory changed since the last save is copied
+	 */
+	ipc_comp_pm_dirty(_ipc);
+	ret = ipc_pm_context_copy(pm_ctx, 1);
+	if (ret < 0) {
+		trace_ipc_error("eMs");
+		trace_error_value(ret);
+		return ret;
+	}
+	pm_ctx->size = ret;
 
 	/* mask all DSP interrupts */
 	arch_interrupt_disable_mask(0xffff);
@@ -553,9 +631,6 @@ static int ipc_pm_context_save(uint32_t header)
 
 	/* TODO: disable SSP and DMA HW */
 
-	/* TODO: save the context */
-	//reply.entries_no = 0;
-
 	/* write the context to the host driver */
 	mailbox_hostbox_write(0, pm_ctx, sizeof(*pm_ctx));
 
@@ -567,10 +642,19 @@ static int ipc_pm_context_save(uint32_t header)
 static int ipc_pm_context_restore(uint32_t header)
 {
 	struct sof_ipc_pm_ctx *pm_ctx = _ipc->comp_data;
+	int ret;
 
 	trace_ipc("PMr");
 
-	/* restore context placeholder */
+	/* restore the heaps saved on D3 */
+	ret = ipc_pm_context_copy(pm_ctx, 0);
+	if (ret < 0) {
+		trace_ipc_error("eMr");
+		trace_error_value(ret);
+		return ret;
+	}
+	pm_ctx->size = ret;
+
 	mailbox_hostbox_write(0, pm_ctx, sizeof(*pm_ctx));
 
 	return 1;
@@ -707,6 +791,154 @@ int ipc_dma_trace_send_position(void)
 				      sizeof(posn), 1);
 }
 
+/* reply with statistics of the requested heap */
+static int ipc_heap_info(uint32_t header)
+{
+	struct sof_ipc_heap_query *query = _ipc->comp_data;
+	struct sof_ipc_heap_info *info = _ipc->comp_data;
+	int err;
+
+	trace_ipc("Hin");
+
+	/* sanity check size */
+	if (IPC_INVALID_SIZE(query)) {
+		trace_ipc_error("eHs");
+		return -EINVAL;
+	}
+
+	/* reply is built in place of the query */
+	err = mm_heap_info(query->zone, query->index, info,
+			   SOF_IPC_MSG_MAX_SIZE);
+	if (err < 0)
+		return err;
+
+	info->rhdr.hdr.cmd = header;
+	info->rhdr.hdr.size = sizeof(*info) +
+		info->num_maps * sizeof(info->map[0]);
+	info->rhdr.error = 0;
+
+	mailbox_hostbox_write(0, info, info->rhdr.hdr.size);
+	return 1;
+}
+
+static int ipc_heap_sample(uint32_t header)
+{
+	struct sof_ipc_heap_sample *sample = _ipc->comp_data;
+
+	trace_ipc("Hsa");
+
+	/* sanity check size */
+	if (IPC_INVALID_SIZE(sample)) {
+		trace_ipc_error("eHs");
+		return -EINVAL;
+	}
+
+	mm_heap_sample(sample->period_ms);
+	return 0;
+}
+
+static int ipc_trace_level(uint32_t header)
+{
+	struct sof_ipc_trace_level *filter = _ipc->comp_data;
+
+	trace_ipc("Tlv");
+
+	/* sanity check size */
+	if (IPC_INVALID_SIZE(filter)) {
+		trace_ipc_error("eTs");
+		return -EINVAL;
+	}
+
+	if (filter->level < LOG_LEVEL_CRITICAL ||
+	    filter->level >= LOG_LEVEL_COUNT) {
+		trace_ipc_error("eTl");
+		return -EINVAL;
+	}
+
+	trace_level_set(filter->level, filter->class_mask);
+	return 0;
+}
+
+static int ipc_dma_trace_stats(uint32_t header)
+{
+	struct sof_ipc_dma_trace_stats stats;
+	struct dma_trace_data *d = _ipc->dmat;
+
+	trace_ipc("Tst");
+
+	stats.rhdr.hdr.cmd = header;
+	stats.rhdr.hdr.size = sizeof(stats);
+	stats.rhdr.error = 0;
+	stats.flushes = d->flushes;
+	stats.bytes = d->bytes;
+	stats.dropped = d->dropped;
+	stats.messages = d->messages;
+	stats.period_us = d->period;
+
+	mailbox_hostbox_write(0, &stats, sizeof(stats));
+	return 1;
+}
+
+static int ipc_msg_stats(uint32_t header)
+{
+	struct sof_ipc_msg_stats stats;
+	struct ipc_shared_context *ctx = _ipc->shared_ctx;
+
+	trace_ipc("Tms");
+
+	stats.rhdr.hdr.cmd = header;
+	stats.rhdr.hdr.size = sizeof(stats);
+	stats.rhdr.error = 0;
+	stats.count = ctx->msg_count;
+	stats.coalesced = ctx->msg_coalesced;
+	stats.dropped = ctx->msg_dropped;
+
+	mailbox_hostbox_write(0, &stats, sizeof(stats));
+	return 1;
+}
+
+static int ipc_pipe_stats(uint32_t header)
+{
+	struct sof_ipc_stream *stream = _ipc->comp_data;
+	struct sof_ipc_pipe_stats stats;
+	struct ipc_comp_dev *pcm_dev;
+	struct pipeline *p;
+
+	trace_ipc("Tps");
+
+	/* sanity check size */
+	if (IPC_INVALID_SIZE(stream)) {
+		trace_ipc_error("ePs");
+		return -EINVAL;
+	}
+
+	/* get the pcm_dev */
+	pcm_dev = ipc_get_comp(_ipc, stream->comp_id);
+	if (pcm_dev == NULL) {
+		trace_ipc_error("ePc");
+		return -ENODEV;
+	}
+
+	/* sanity check comp */
+	if (pcm_dev->cd->pipeline == NULL) {
+		trace_ipc_error("eP1");
+		trace_error_value(stream->comp_id);
+		return -EINVAL;
+	}
+	p = pcm_dev->cd->pipeline;
+
+	stats.rhdr.hdr.cmd = header;
+	stats.rhdr.hdr.size = sizeof(stats);
+	stats.rhdr.error = 0;
+	stats.comp_id = stream->comp_id;
+	stats.catch_ups = p->catch_ups;
+	stats.catch_up_periods = p->catch_up_periods;
+	stats.recovers = p->recovers;
+
+	mailbox_hostbox_write(0, &stats, sizeof(stats));
+	return 1;
+}
+
 static int ipc_glb_debug_message(uint32_t header)
 {
 	uint32_t cmd = (header & SOF_CMD_TYPE_MASK) >> SOF_CMD_TYPE_SHIFT;
@@ -716,6 +948,18 @@ static int ipc_glb_debug_message(uint32_t header)
 	switch (cmd) {
 	case iCS(SOF_IPC_TRACE_DMA_PARAMS):
 		return ipc_dma_trace_config(header);
+	case iCS(SOF_IPC_TRACE_HEAP_INFO):
+		return ipc_heap_info(header);
+	case iCS(SOF_IPC_TRACE_HEAP_SAMPLE):
+		return ipc_heap_sample(header);
+	case iCS(SOF_IPC_TRACE_LEVEL):
+		return ipc_trace_level(header);
+	case iCS(SOF_IPC_TRACE_DMA_STATS):
+		return ipc_dma_trace_stats(header);
+	case iCS(SOF_IPC_TRACE_MSG_STATS):
+		return ipc_msg_stats(header);
+	case iCS(SOF_IPC_TRACE_PIPE_STATS):
+		return ipc_pipe_stats(header);
 	default:
 		trace_ipc_error("eDc");
 		trace_error_value(header);
@@ -954,6 +1198,25 @@ static int ipc_glb_tplg_message(uint32_t header)
 	}
 }
 
+/*
+ * Compound IPC Operations.
+ */
+
+/* runs one message of a compound, see compound.c */
+int ipc_compound_cmd(uint32_t header)
+{
+	switch (iGS(header)) {
+	case iGS(SOF_IPC_GLB_TPLG_MSG):
+		return ipc_glb_tplg_message(header);
+	case iGS(SOF_IPC_GLB_DAI_MSG):
+		return ipc_glb_dai_message(header);
+	default:
+		trace_ipc_error("eCt");
+		trace_error_value(header);
+		return -EINVAL;
+	}
+}
+
 /*
  * Global IPC Operations.
  */
@@ -975,7 +1238,7 @@ int ipc_cmd(void)
 	case iGS(SOF_IPC_GLB_REPLY):
 		return 0;
 	case iGS(SOF_IPC_GLB_COMPOUND):
-		return -EINVAL;	/* TODO */
+		return ipc_glb_compound_message(hdr->cmd);
 	case iGS(SOF_IPC_GLB_TPLG_MSG):
 		return ipc_glb_tplg_message(hdr->cmd);
 	case iGS(SOF_IPC_GLB_PM_MSG):
@@ -995,146 +1258,6 @@ int ipc_cmd(void)
 	}
 }
 
-/* locks held by caller */
-static inline struct ipc_msg *msg_get_empty(struct ipc *ipc)
-{
-	struct ipc_msg *msg = NULL;
-
-	if (!list_is_empty(&ipc->shared_ctx->empty_list)) {
-		msg = list_first_item(&ipc->shared_ctx->empty_list,
-				      struct ipc_msg, list);
-		list_item_del(&msg->list);
-	}
-
-	return msg;
-}
-
-static inline struct ipc_msg *ipc_glb_stream_message_find(struct ipc *ipc,
-	struct sof_ipc_stream_posn *posn)
-{
-	struct list_item *plist;
-	struct ipc_msg *msg = NULL;
-	struct sof_ipc_stream_posn *old_posn = NULL;
-	uint32_t cmd;
-
-	/* Check whether the command is expected */
-	cmd = (posn->rhdr.hdr.cmd & SOF_CMD_TYPE_MASK) >> SOF_CMD_TYPE_SHIFT;
-
-	switch (cmd) {
-	case iCS(SOF_IPC_STREAM_TRIG_XRUN):
-	case iCS(SOF_IPC_STREAM_POSITION):
-
-		/* iterate host message list for searching */
-		list_for_item(plist, &ipc->shared_ctx->msg_list) {
-			msg = container_of(plist, struct ipc_msg, list);
-			if (msg->header == posn->rhdr.hdr.cmd) {
-				old_posn = (struct sof_ipc_stream_posn *)msg->tx_data;
-				if (old_posn->comp_id == posn->comp_id)
-					return msg;
-			}
-		}
-		break;
-	default:
-		break;
-	}
-
-	/* no match */
-	return NULL;
-}
-
-static inline struct ipc_msg *ipc_glb_trace_message_find(struct ipc *ipc,
-	struct sof_ipc_dma_trace_posn *posn)
-{
-	struct list_item *plist;
-	struct ipc_msg *msg = NULL;
-	uint32_t cmd;
-
-	/* Check whether the command is expected */
-	cmd = (posn->rhdr.hdr.cmd & SOF_CMD_TYPE_MASK) >> SOF_CMD_TYPE_SHIFT;
-
-	switch (cmd) {
-	case iCS(SOF_IPC_TRACE_DMA_POSITION):
-		/* iterate host message list for searching */
-		list_for_item(plist, &ipc->shared_ctx->msg_list) {
-			msg = container_of(plist, struct ipc_msg, list);
-			if (msg->header == posn->rhdr.hdr.cmd)
-				return msg;
-		}
-		break;
-	default:
-		break;
-	}
-
-	/* no match */
-	return NULL;
-}
-
-static inline struct ipc_msg *msg_find(struct ipc *ipc, uint32_t header,
-	void *tx_data)
-{
-	uint32_t type;
-
-	/* use different sub function for different global message type */
-	type = (header & SOF_GLB_TYPE_MASK) >> SOF_GLB_TYPE_SHIFT;
-
-	switch (type) {
-	case iGS(SOF_IPC_GLB_STREAM_MSG):
-		return ipc_glb_stream_message_find(ipc,
-			(struct sof_ipc_stream_posn *)tx_data);
-	case iGS(SOF_IPC_GLB_TRACE_MSG):
-		return ipc_glb_trace_message_find(ipc,
-			(struct sof_ipc_dma_trace_posn *)tx_data);
-	default:
-		/* not found */
-		return NULL;
-	}
-}
-
-int ipc_queue_host_message(struct ipc *ipc, uint32_t header, void *tx_data,
-			   size_t tx_bytes, uint32_t replace)
-{
-	struct ipc_msg *msg = NULL;
-	uint32_t flags, found = 0;
-	int ret = 0;
-
-	spin_lock_irq(&ipc->lock, flags);
-
-	/* do we need to replace an existing message? */
-	if (replace)
-		msg = msg_find(ipc, header, tx_data);
-
-	/* do we need to use a new empty message? */
-	if (msg)
-		found = 1;
-	else
-		msg = msg_get_empty(ipc);
-
-	if (msg == NULL) {
-		trace_error(TRACE_CLASS_IPC, "eQb header 0x08x replace %d",
-			    header, replace);
-		ret = -EBUSY;
-		goto out;
-	}
-
-	/* prepare the message */
-	msg->header = header;
-	msg->tx_size = tx_bytes;
-
-	/* copy mailbox data to message */
-	if (tx_bytes > 0 && tx_bytes < SOF_IPC_MSG_MAX_SIZE)
-		rmemcpy(msg->tx_data, tx_data, tx_bytes);
-
-	if (!found) {
-		/* now queue the message */
-		ipc->shared_ctx->dsp_pending = 1;
-		list_item_append(&msg->list, &ipc->shared_ctx->msg_list);
-	}
-
-out:
-	spin_unlock_irq(&ipc->lock, flags);
-	return ret;
-}
-
 /* process current message */
 int ipc_process_msg_queue(void)
 {
@@ -1145,11 +1268,26 @@ int ipc_process_msg_queue(void)
 
 void ipc_process_task(void *data)
 {
+	uint64_t time;
+
 	if (_ipc->host_pending)
 		ipc_platform_do_cmd(_ipc);
+
+	/* host commands free and trigger pipelines, never balance meanwhile */
+	if (_ipc->balance_request) {
+		time = _ipc->balance_request;
+		_ipc->balance_request = 0;
+		ipc_pipeline_balance(_ipc, time);
+	}
 }
 
 void ipc_schedule_process(struct ipc *ipc)
 {
 	schedule_task(&ipc->ipc_task, 0, 100);
 }
+
+void ipc_schedule_balance(struct ipc *ipc, uint64_t time)
+{
+	ipc->balance_request = time;
+	schedule_task(&ipc->ipc_task, 0, 100);
+}
@@ -39,10 +39,17 @@
 #include <sof/alloc.h>
 #include <sof/ipc.h>
 #include <sof/debug.h>
+#include <sof/cpu.h>
+#include <sof/interrupt.h>
+#include <sof/mailbox.h>
+#include <sof/seqlock.h>
+#include <arch/cache.h>
 #include <platform/platform.h>
+#include <platform/mailbox.h>
 #include <sof/audio/component.h>
 #include <sof/audio/pipeline.h>
 #include <sof/audio/buffer.h>
+#include <sof/audio/format.h>
 
 /*
  * Components, buffers and pipelines all use the same set of monotonic ID
@@ -78,10 +85,17 @@ struct ipc_comp_dev *ipc_get_comp(struct ipc *ipc, uint32_t id)
 	return NULL;
 }
 
+/*
+ * Position slots start on a cache line of their own, so writing back one
+ * slot never writes back a neighbour updated by another core.
+ */
+#define IPC_POSN_SLOT_SIZE \
+	ALIGN_UP(sizeof(struct sof_ipc_stream_posn_slot), PLATFORM_DCACHE_ALIGN)
+
 int ipc_get_posn_offset(struct ipc *ipc, struct pipeline *pipe)
 {
 	int i;
-	uint32_t posn_size = sizeof(struct sof_ipc_stream_posn);
+	uint32_t posn_size = IPC_POSN_SLOT_SIZE;
 
 	for (i = 0; i < PLATFORM_MAX_STREAMS; i++) {
 		if (ipc->posn_map[i] == pipe)
@@ -99,10 +113,47 @@ int ipc_get_posn_offset(struct ipc *ipc, struct pipeline *pipe)
 	return -EINVAL;
 }
 
+/* seq of the slot at offset, the slots are cache line aligned and posn is
+ * a whole number of words, so seq is an aligned word of the packed slot
+ */
+static inline uint32_t *ipc_stream_posn_seq(uint32_t offset)
+{
+	STATIC_ASSERT(offsetof(struct sof_ipc_stream_posn_slot, seq) %
+		      sizeof(uint32_t) == 0, posn_seq_unaligned);
+
+	return (uint32_t *)(MAILBOX_STREAM_BASE + offset +
+			    offsetof(struct sof_ipc_stream_posn_slot, seq));
+}
+
+/*
+ * Update the stream position slot, the host reads it back without IPC.
+ * Host DMA irqs and IPC stream queries both publish, so the update runs
+ * with irqs off to keep a single writer.
+ */
+void ipc_stream_posn_write(struct comp_dev *cdev,
+			   struct sof_ipc_stream_posn *posn)
+{
+	uint32_t *seq = ipc_stream_posn_seq(cdev->pipeline->posn_offset);
+	uint32_t flags;
+
+	flags = interrupt_global_disable();
+
+	seq_write_begin(seq);
+	dcache_writeback_region(seq, sizeof(*seq));
+
+	mailbox_stream_write(cdev->pipeline->posn_offset, posn, sizeof(*posn));
+
+	seq_write_end(seq);
+	dcache_writeback_region(seq, sizeof(*seq));
+
+	interrupt_global_enable(flags);
+}
+
 int ipc_comp_new(struct ipc *ipc, struct sof_ipc_comp *comp)
 {
 	struct comp_dev *cd;
 	struct ipc_comp_dev *icd;
+	int arena;
 	int ret = 0;
 
 	/* check whether component already exists */
@@ -113,16 +164,18 @@ int ipc_comp_new(struct ipc *ipc, struct sof_ipc_comp *comp)
 		return -EINVAL;
 	}
 
-	/* create component */
+	/* component private data comes from its pipeline arena */
+	arena = arena_select(comp->pipeline_id);
 	cd = comp_new(comp);
+	arena_select(arena);
 	if (cd == NULL) {
 		trace_ipc_error("eCn");
 		return -EINVAL;
 	}
 
 	/* allocate the IPC component container */
-	icd = rzalloc(RZONE_RUNTIME | RZONE_FLAG_UNCACHED, SOF_MEM_CAPS_RAM,
-		      sizeof(struct ipc_comp_dev));
+	icd = rzalloc_slab(RZONE_RUNTIME | RZONE_FLAG_UNCACHED, SLAB_IPC_COMP,
+			   sizeof(struct ipc_comp_dev));
 	if (icd == NULL) {
 		trace_ipc_error("eCm");
 		rfree(cd);
@@ -133,6 +186,7 @@ int ipc_comp_new(struct ipc *ipc, struct sof_ipc_comp *comp)
 
 	/* add new component to the list */
 	list_item_append(&icd->list, &ipc->shared_ctx->comp_list);
+	mm_pm_dirty_list(&icd->list);
 	return ret;
 }
 
@@ -147,6 +201,7 @@ int ipc_comp_free(struct ipc *ipc, uint32_t comp_id)
 
 	/* free component and remove from list */
 	comp_free(icd->cd);
+	mm_pm_dirty_list(&icd->list);
 	list_item_del(&icd->list);
 	rfree(icd);
 
@@ -175,8 +230,8 @@ int ipc_buffer_new(struct ipc *ipc, struct sof_ipc_buffer *desc)
 		return -ENOMEM;
 	}
 
-	ibd = rzalloc(RZONE_RUNTIME | RZONE_FLAG_UNCACHED, SOF_MEM_CAPS_RAM,
-		      sizeof(struct ipc_comp_dev));
+	ibd = rzalloc_slab(RZONE_RUNTIME | RZONE_FLAG_UNCACHED, SLAB_IPC_COMP,
+			   sizeof(struct ipc_comp_dev));
 	if (ibd == NULL) {
 		rfree(buffer);
 		return -ENOMEM;
@@ -186,6 +241,7 @@ int ipc_buffer_new(struct ipc *ipc, struct sof_ipc_buffer *desc)
 
 	/* add new buffer to the list */
 	list_item_append(&ibd->list, &ipc->shared_ctx->comp_list);
+	mm_pm_dirty_list(&ibd->list);
 	return ret;
 }
 
@@ -200,6 +256,7 @@ int ipc_buffer_free(struct ipc *ipc, uint32_t buffer_id)
 
 	/* free buffer and remove from list */
 	buffer_free(ibd->cb);
+	mm_pm_dirty_list(&ibd->list);
 	list_item_del(&ibd->list);
 	rfree(ibd);
 
@@ -280,8 +337,8 @@ int ipc_pipeline_new(struct ipc *ipc,
 	}
 
 	/* allocate the IPC pipeline container */
-	ipc_pipe = rzalloc(RZONE_RUNTIME | RZONE_FLAG_UNCACHED,
-			   SOF_MEM_CAPS_RAM, sizeof(struct ipc_comp_dev));
+	ipc_pipe = rzalloc_slab(RZONE_RUNTIME | RZONE_FLAG_UNCACHED,
+				SLAB_IPC_COMP, sizeof(struct ipc_comp_dev));
 	if (ipc_pipe == NULL) {
 		pipeline_free(pipe);
 		return -ENOMEM;
@@ -292,6 +349,7 @@ int ipc_pipeline_new(struct ipc *ipc,
 
 	/* add new pipeline to the list */
 	list_item_append(&ipc_pipe->list, &ipc->shared_ctx->comp_list);
+	mm_pm_dirty_list(&ipc_pipe->list);
 	return 0;
 }
 
@@ -312,6 +370,7 @@ int ipc_pipeline_free(struct ipc *ipc, uint32_t comp_id)
 		return ret;
 	}
 
+	mm_pm_dirty_list(&ipc_pipe->list);
 	list_item_del(&ipc_pipe->list);
 	rfree(ipc_pipe);
 
@@ -331,6 +390,175 @@ int ipc_pipeline_complete(struct ipc *ipc, uint32_t comp_id)
 	return pipeline_complete(ipc_pipe->pipeline);
 }
 
+/*
+ * Pipeline load balancing. The load of a pipeline is the share of a core
+ * its task took since the last balance, in per mille. When the busiest
+ * enabled core is above IPC_BALANCE_HOT and the least busy one is at least
+ * IPC_BALANCE_DIFF below it, the active pipeline of the busy core that best
+ * evens out the two is moved over. Pipelines as big as the difference stay
+ * where they are, moving them would only swap the cores. Pipelines are
+ * handed over between two periods with their DMA running, see
+ * pipeline_migrate().
+ */
+#define IPC_BALANCE_HOT		600
+#define IPC_BALANCE_DIFF	200
+
+static uint32_t ipc_pipeline_load(struct ipc_comp_dev *icd, uint64_t elapsed)
+{
+	struct pipeline *p = icd->pipeline;
+	uint64_t rtime;
+
+	/* published by the slave core at the end of every period */
+	if (p->ipc_pipe.core != cpu_get_id()) {
+		dcache_invalidate_region(&p->status, sizeof(p->status));
+		dcache_invalidate_region(&p->pipe_task.total_rtime,
+					 sizeof(p->pipe_task.total_rtime));
+	}
+
+	rtime = p->pipe_task.total_rtime - icd->balance_rtime;
+	icd->balance_rtime = p->pipe_task.total_rtime;
+	icd->load = p->status == COMP_STATE_ACTIVE ?
+		rtime * 1000 / elapsed : 0;
+
+	return icd->load;
+}
+
+int ipc_pipeline_balance(struct ipc *ipc, uint64_t time)
+{
+	uint32_t core_load[PLATFORM_CORE_COUNT] = { 0 };
+	struct ipc_comp_dev *best = NULL;
+	struct ipc_comp_dev *icd;
+	struct list_item *clist;
+	uint64_t elapsed = time - ipc->balance_time;
+	uint32_t best_cost = UINT32_MAX;
+	uint32_t cost;
+	uint32_t diff;
+	int hot = -1;
+	int cold = -1;
+	int core;
+	int ret;
+
+	if (!elapsed)
+		return 0;
+
+	ipc->balance_time = time;
+
+	list_for_item(clist, &ipc->shared_ctx->comp_list) {
+		icd = container_of(clist, struct ipc_comp_dev, list);
+		if (icd->type != COMP_TYPE_PIPELINE)
+			continue;
+
+		core = icd->pipeline->ipc_pipe.core;
+		if (core < PLATFORM_CORE_COUNT)
+			core_load[core] += ipc_pipeline_load(icd, elapsed);
+	}
+
+	for (core = 0; core < PLATFORM_CORE_COUNT; core++) {
+		if (!cpu_is_core_enabled(core))
+			continue;
+
+		if (hot < 0 || core_load[core] > core_load[hot])
+			hot = core;
+		if (cold < 0 || core_load[core] < core_load[cold])
+			cold = core;
+	}
+
+	if (hot < 0 || core_load[hot] < IPC_BALANCE_HOT ||
+	    core_load[hot] - core_load[cold] < IPC_BALANCE_DIFF)
+		return 0;
+
+	diff = core_load[hot] - core_load[cold];
+
+	/* the best pipeline leaves both cores closest to each other */
+	list_for_item(clist, &ipc->shared_ctx->comp_list) {
+		icd = container_of(clist, struct ipc_comp_dev, list);
+		if (icd->type != COMP_TYPE_PIPELINE ||
+		    icd->pipeline->ipc_pipe.core != hot ||
+		    icd->pipeline->status != COMP_STATE_ACTIVE ||
+		    !icd->load || icd->load >= diff)
+			continue;
+
+		cost = diff > 2 * icd->load ? diff - 2 * icd->load :
+			2 * icd->load - diff;
+		if (cost < best_cost) {
+			best_cost = cost;
+			best = icd;
+		}
+	}
+
+	if (!best)
+		return 0;
+
+	trace_ipc("PBm");
+	trace_value((hot << 16) | core_load[hot]);
+	trace_value((cold << 16) | core_load[cold]);
+
+	ret = pipeline_migrate(best->pipeline, cold);
+	if (ret < 0) {
+		trace_ipc_error("ePB");
+		trace_error_value(best->pipeline->ipc_pipe.comp_id);
+		return ret;
+	}
+
+	return 1;
+}
+
+/*
+ * Components flag every change of their state with comp_pm_dirty(). The
+ * structure and private data of each flagged component, its buffers and
+ * its pipeline are marked for the PM context save. Private data in a
+ * pipeline arena is marked up to the end of the arena, so the allocations
+ * a component makes after it are saved too.
+ */
+void ipc_comp_pm_dirty(struct ipc *ipc)
+{
+	struct ipc_comp_dev *icd;
+	struct comp_buffer *buffer;
+	struct list_item *clist;
+	struct list_item *blist;
+	struct comp_dev *cd;
+	uint16_t *flag;
+	int remote;
+
+	list_for_item(clist, &ipc->shared_ctx->comp_list) {
+		icd = container_of(clist, struct ipc_comp_dev, list);
+		if (icd->type != COMP_TYPE_COMPONENT)
+			continue;
+
+		cd = icd->cd;
+		flag = &cd->pm_dirty;
+
+		/* written back by the slave core when its pipeline stops */
+		remote = cd->pipeline &&
+			cd->pipeline->ipc_pipe.core != cpu_get_id();
+		if (remote)
+			dcache_invalidate_region(flag, sizeof(*flag));
+
+		if (!cd->pm_dirty)
+			continue;
+
+		mm_pm_dirty(cd);
+		mm_pm_dirty(cd->private);
+		mm_pm_dirty(cd->pipeline);
+
+		list_for_item(blist, &cd->bsink_list) {
+			buffer = container_of(blist, struct comp_buffer,
+					      source_list);
+			mm_pm_dirty(buffer);
+		}
+
+		list_for_item(blist, &cd->bsource_list) {
+			buffer = container_of(blist, struct comp_buffer,
+					      sink_list);
+			mm_pm_dirty(buffer);
+		}
+
+		cd->pm_dirty = 0;
+		if (remote)
+			dcache_writeback_invalidate_region(flag, sizeof(*flag));
+	}
+}
+
 int ipc_comp_dai_config(struct ipc *ipc, struct sof_ipc_dai_config *config)
 {
 	struct sof_ipc_comp_dai *dai;
@@ -544,6 +772,7 @@ int ipc_init(struct sof *sof)
 	for (i = 0; i < MSG_QUEUE_SIZE; i++)
 		list_item_prepend(&sof->ipc->shared_ctx->message[i].list,
 				  &sof->ipc->shared_ctx->empty_list);
+	sof->ipc->shared_ctx->msg_count = MSG_QUEUE_SIZE;
 
 	return platform_ipc_init(sof->ipc);
 }
@@ -0,0 +1,250 @@
+/*
+ * Copyright (c) 2018, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of the Intel Corporation nor the
+ *     names of its contributors may be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <errno.h>
+#include <sof/sof.h>
+#include <sof/alloc.h>
+#include <sof/ipc.h>
+#include <sof/list.h>
+#include <sof/lock.h>
+#include <sof/trace.h>
+#include <uapi/ipc.h>
+
+/*
+ * Outbound message queue. Queued messages are kept in msg_list in priority
+ * order, FIFO within a priority, and are also hashed by header and comp_id
+ * so a newer message can replace a queued one without walking the queue.
+ * The queue grows from the runtime heap up to MSG_QUEUE_MAX messages, then
+ * lower priority messages are dropped to make room. Locks held by callers.
+ */
+
+static inline uint32_t msg_prio(uint32_t header)
+{
+	switch (header & SOF_GLB_TYPE_MASK) {
+	case SOF_IPC_GLB_TRACE_MSG:
+		return IPC_MSG_PRIO_TRACE;
+	case SOF_IPC_GLB_STREAM_MSG:
+		if ((header & SOF_CMD_TYPE_MASK) == SOF_IPC_STREAM_POSITION)
+			return IPC_MSG_PRIO_POSN;
+		return IPC_MSG_PRIO_URGENT;
+	default:
+		return IPC_MSG_PRIO_URGENT;
+	}
+}
+
+/* stream messages carry the component in the payload */
+static inline uint32_t msg_comp_id(uint32_t header, void *tx_data)
+{
+	if ((header & SOF_GLB_TYPE_MASK) == SOF_IPC_GLB_STREAM_MSG)
+		return ((struct sof_ipc_stream_posn *)tx_data)->comp_id;
+
+	return 0;
+}
+
+static inline struct ipc_msg **msg_bucket(struct ipc_shared_context *ctx,
+					  uint32_t header, uint32_t comp_id)
+{
+	uint32_t hash = header ^ (header >> SOF_CMD_TYPE_SHIFT) ^ comp_id;
+
+	return &ctx->msg_hash[hash & (MSG_HASH_SIZE - 1)];
+}
+
+static struct ipc_msg *msg_find(struct ipc_shared_context *ctx,
+				uint32_t header, uint32_t comp_id)
+{
+	struct ipc_msg *msg = *msg_bucket(ctx, header, comp_id);
+
+	while (msg) {
+		if (msg->header == header && msg->comp_id == comp_id)
+			return msg;
+		msg = msg->hash_next;
+	}
+
+	return NULL;
+}
+
+static void msg_enqueue(struct ipc_shared_context *ctx, struct ipc_msg *msg)
+{
+	struct ipc_msg **bucket = msg_bucket(ctx, msg->header, msg->comp_id);
+	int prio;
+
+	/* behind the last message of the same or a higher priority */
+	for (prio = msg->prio; prio >= 0; prio--) {
+		if (ctx->msg_tail[prio]) {
+			list_item_prepend(&msg->list,
+					  &ctx->msg_tail[prio]->list);
+			break;
+		}
+	}
+
+	if (prio < 0)
+		list_item_prepend(&msg->list, &ctx->msg_list);
+
+	ctx->msg_tail[msg->prio] = msg;
+
+	msg->hash_next = *bucket;
+	*bucket = msg;
+}
+
+static void msg_unlink(struct ipc_shared_context *ctx, struct ipc_msg *msg)
+{
+	struct ipc_msg **bucket = msg_bucket(ctx, msg->header, msg->comp_id);
+	struct ipc_msg *prev = NULL;
+
+	/* previous message becomes the tail if it has the same priority */
+	if (ctx->msg_tail[msg->prio] == msg) {
+		if (msg->list.prev != &ctx->msg_list) {
+			prev = container_of(msg->list.prev, struct ipc_msg,
+					    list);
+			if (prev->prio != msg->prio)
+				prev = NULL;
+		}
+		ctx->msg_tail[msg->prio] = prev;
+	}
+
+	list_item_del(&msg->list);
+
+	while (*bucket != msg)
+		bucket = &(*bucket)->hash_next;
+	*bucket = msg->hash_next;
+}
+
+static struct ipc_msg *msg_get_empty(struct ipc *ipc)
+{
+	struct ipc_shared_context *ctx = ipc->shared_ctx;
+	struct ipc_msg *msg = NULL;
+
+	if (!list_is_empty(&ctx->empty_list)) {
+		msg = list_first_item(&ctx->empty_list, struct ipc_msg, list);
+		list_item_del(&msg->list);
+		return msg;
+	}
+
+	/* grow the pool, messages are never freed */
+	if (ctx->msg_count < MSG_QUEUE_MAX) {
+		msg = rzalloc(RZONE_RUNTIME | RZONE_FLAG_UNCACHED,
+			      SOF_MEM_CAPS_RAM, sizeof(*msg));
+		if (msg)
+			ctx->msg_count++;
+	}
+
+	return msg;
+}
+
+/* reuse the newest queued message of the lowest priority below prio */
+static struct ipc_msg *msg_evict(struct ipc_shared_context *ctx,
+				 int prio)
+{
+	struct ipc_msg *msg;
+	int i;
+
+	for (i = IPC_MSG_PRIO_COUNT - 1; i > prio; i--) {
+		msg = ctx->msg_tail[i];
+		if (msg) {
+			msg_unlink(ctx, msg);
+			ctx->msg_dropped++;
+			return msg;
+		}
+	}
+
+	return NULL;
+}
+
+/* take the next message to send off the queue */
+struct ipc_msg *ipc_msg_dequeue(struct ipc *ipc)
+{
+	struct ipc_msg *msg;
+
+	if (list_is_empty(&ipc->shared_ctx->msg_list))
+		return NULL;
+
+	msg = list_first_item(&ipc->shared_ctx->msg_list, struct ipc_msg,
+			      list);
+	msg_unlink(ipc->shared_ctx, msg);
+
+	return msg;
+}
+
+int ipc_queue_host_message(struct ipc *ipc, uint32_t header, void *tx_data,
+			   size_t tx_bytes, uint32_t replace)
+{
+	struct ipc_shared_context *ctx = ipc->shared_ctx;
+	struct ipc_msg *msg = NULL;
+	uint32_t prio = msg_prio(header);
+	uint32_t comp_id = msg_comp_id(header, tx_data);
+	uint32_t flags, found = 0;
+	int ret = 0;
+
+	spin_lock_irq(&ipc->lock, flags);
+
+	/* do we need to replace an existing message? */
+	if (replace)
+		msg = msg_find(ctx, header, comp_id);
+
+	/* do we need to use a new empty message? */
+	if (msg) {
+		found = 1;
+		ctx->msg_coalesced++;
+	} else {
+		msg = msg_get_empty(ipc);
+
+		/* queue is full, drop a less important message */
+		if (msg == NULL)
+			msg = msg_evict(ctx, prio);
+	}
+
+	if (msg == NULL) {
+		ctx->msg_dropped++;
+		trace_error(TRACE_CLASS_IPC, "eQb header 0x08x replace %d",
+			    header, replace);
+		ret = -EBUSY;
+		goto out;
+	}
+
+	/* prepare the message */
+	msg->header = header;
+	msg->tx_size = tx_bytes;
+
+	/* copy mailbox data to message */
+	if (tx_bytes > 0 && tx_bytes < SOF_IPC_MSG_MAX_SIZE)
+		rmemcpy(msg->tx_data, tx_data, tx_bytes);
+
+	if (!found) {
+		/* now queue the message */
+		msg->prio = prio;
+		msg->comp_id = comp_id;
+		ipc->shared_ctx->dsp_pending = 1;
+		msg_enqueue(ctx, msg);
+	}
+
+out:
+	spin_unlock_irq(&ipc->lock, flags);
+	return ret;
+}
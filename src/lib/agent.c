@@ -41,6 +41,7 @@
 #include <sof/alloc.h>
 #include <sof/clk.h>
 #include <sof/trace.h>
+#include <sof/ipc.h>
 #include <platform/timer.h>
 #include <platform/platform.h>
 #include <platform/clk.h>
@@ -49,6 +50,9 @@
 #define trace_sa(__e)	trace_event_atomic(TRACE_CLASS_SA, __e)
 #define trace_sa_value(__e)	trace_value_atomic(__e)
 
+/* pipeline load balancing period in us */
+#define SA_BALANCE_TIME		100000
+
 /*
  * Notify the SA that we are about to enter idle state (WFI).
  */
@@ -59,6 +63,24 @@ void sa_enter_idle(struct sof *sof)
 	sa->last_idle = platform_timer_get(platform_timer);
 }
 
+/*
+ * Request a pipeline load balance from the master idle loop. It runs in the
+ * IPC task, so host messages changing the pipelines are never processed
+ * meanwhile.
+ */
+void sa_balance(struct sof *sof)
+{
+	struct sa *sa = sof->sa;
+	uint64_t current;
+
+	current = platform_timer_get(platform_timer);
+	if (current - sa->last_balance < sa->balance_ticks)
+		return;
+
+	sa->last_balance = current;
+	ipc_schedule_balance(sof->ipc, current);
+}
+
 static uint64_t validate(void *data, uint64_t delay)
 {
 	struct sa *sa = data;
@@ -92,6 +114,9 @@ void sa_init(struct sof *sof)
 		PLATFORM_IDLE_TIME / 1000;
 	trace_sa_value(sa->ticks);
 
+	sa->balance_ticks = clock_ms_to_ticks(PLATFORM_WORKQ_CLOCK, 1) *
+		SA_BALANCE_TIME / 1000;
+
 	/* set lst idle time to now to give time for boot completion */
 	sa->last_idle = platform_timer_get(platform_timer) + sa->ticks;
 	work_init(&sa->work, validate, sa, WORK_ASYNC);
@@ -36,6 +36,13 @@
 #include <sof/trace.h>
 #include <sof/lock.h>
 #include <sof/cpu.h>
+#include <sof/math/numbers.h>
+#include <sof/work.h>
+#include <sof/ipc.h>
+#include <sof/dma.h>
+#include <sof/audio/component.h>
+#include <sof/audio/buffer.h>
+#include <sof/audio/pipeline.h>
 #include <platform/memory.h>
 #include <stdint.h>
 
@@ -76,6 +83,12 @@ static inline void flush_block_map(struct block_map *map)
 {
 	dcache_writeback_invalidate_region(map->block,
 					   sizeof(*map->block) * map->count);
+	dcache_writeback_invalidate_region(map->used_map,
+					   sizeof(*map->used_map) *
+					   BLOCK_MAP_WORDS(map->count));
+	dcache_writeback_invalidate_region(map->dirty_map,
+					   sizeof(*map->dirty_map) *
+					   BLOCK_MAP_WORDS(map->count));
 	dcache_writeback_invalidate_region(map, sizeof(*map));
 }
 
@@ -83,7 +96,8 @@ static inline void flush_block_map(struct block_map *map)
 static inline uint32_t block_get_size(struct block_map *map)
 {
 	return sizeof(*map) + map->count *
-		(map->block_size + sizeof(struct block_hdr));
+		(map->block_size + sizeof(struct block_hdr)) +
+		BLOCK_MAP_WORDS(map->count) * sizeof(*map->used_map) * 2;
 }
 
 /* total size of heap */
@@ -99,6 +113,127 @@ static inline uint32_t heap_get_size(struct mm_heap *heap)
 	return size;
 }
 
+/* set or clear the bits of blocks [start, start + count) in a map bitmap */
+static void map_set_bits(uint32_t *map_bits, unsigned int start,
+			 unsigned int count, int set)
+{
+	uint32_t *bmp = cache_to_uncache(map_bits);
+	unsigned int word = start >> 5;
+	unsigned int bit = start & 31;
+	unsigned int n;
+	uint32_t mask;
+
+	while (count) {
+		n = MIN(count, 32 - bit);
+		mask = n == 32 ? 0xffffffff : ((1U << n) - 1) << bit;
+
+		if (set)
+			bmp[word] |= mask;
+		else
+			bmp[word] &= ~mask;
+
+		count -= n;
+		bit = 0;
+		word++;
+	}
+}
+
+static inline void map_set_used(struct block_map *map, unsigned int start,
+				unsigned int count, int used)
+{
+	map_set_bits(map->used_map, start, count, used);
+}
+
+/* blocks changed since the last PM context save, see mm_pm_context_save() */
+static inline void map_set_dirty(struct block_map *map, unsigned int start,
+				 unsigned int count, int dirty)
+{
+	map_set_bits(map->dirty_map, start, count, dirty);
+}
+
+/*
+ * Find the first block at or after "from" whose bit in a map bitmap equals
+ * "set". Returns map->count when there is none. Bits past the end of the
+ * map are always clear, so the result is clamped to the map size.
+ */
+static unsigned int map_find_bits(struct block_map *map, uint32_t *map_bits,
+				  unsigned int from, int set)
+{
+	uint32_t *bmp = cache_to_uncache(map_bits);
+	unsigned int words = BLOCK_MAP_WORDS(map->count);
+	unsigned int word = from >> 5;
+	uint32_t invert = set ? 0 : 0xffffffff;
+	uint32_t bits;
+	unsigned int idx;
+
+	if (from >= map->count)
+		return map->count;
+
+	/* ignore blocks before "from" in the first word */
+	bits = (bmp[word] ^ invert) & (0xffffffff << (from & 31));
+
+	while (!bits) {
+		if (++word == words)
+			return map->count;
+		bits = bmp[word] ^ invert;
+	}
+
+	idx = (word << 5) + __builtin_ctz(bits);
+
+	return MIN(idx, map->count);
+}
+
+/* find the first block at or after "from" whose usage equals "used" */
+static inline unsigned int map_find(struct block_map *map, unsigned int from,
+				    int used)
+{
+	return map_find_bits(map, map->used_map, from, used);
+}
+
+/* largest continuous run of free blocks in map */
+static unsigned int map_max_run(struct block_map *map)
+{
+	unsigned int start;
+	unsigned int end;
+	unsigned int run = 0;
+
+	for (start = map->first_free; start < map->count;
+	     start = map_find(map, end, 0)) {
+		end = map_find(map, start, 1);
+		run = MAX(run, end - start);
+	}
+
+	return run;
+}
+
+/* update high-water marks after an allocation from map */
+static void heap_account_alloc(struct mm_heap *heap, struct block_map *map)
+{
+	if (heap->info.used > heap->info.peak)
+		heap->info.peak = heap->info.used;
+
+	if (map->count - map->free_count > map->max_used)
+		map->max_used = map->count - map->free_count;
+}
+
+/* account failed request to the map it would have been allocated from */
+static void heap_account_failed(struct mm_heap *heap, size_t bytes)
+{
+	struct block_map *map;
+	int i;
+
+	heap->info.failed++;
+
+	for (i = 0; i < heap->blocks; i++) {
+		map = cache_to_uncache(&heap->map[i]);
+
+		if (map->block_size >= bytes || i == heap->blocks - 1) {
+			map->failed++;
+			return;
+		}
+	}
+}
+
 #if DEBUG_BLOCK_ALLOC || DEBUG_BLOCK_FREE
 static void alloc_memset_region(void *ptr, uint32_t bytes, uint32_t val)
 {
@@ -138,6 +273,7 @@ static void *rmalloc_sys(int zone, int core, size_t bytes)
 
 	cpu_heap->info.used += bytes;
 	cpu_heap->info.free -= alignment + bytes;
+	cpu_heap->info.peak = cpu_heap->info.used;
 
 #if DEBUG_BLOCK_ALLOC
 	alloc_memset_region(ptr, bytes, DEBUG_BLOCK_ALLOC_VALUE);
@@ -156,7 +292,6 @@ static void *alloc_block(struct mm_heap *heap, int level,
 	struct block_map *map = cache_to_uncache(&heap->map[level]);
 	struct block_hdr *hdr = cache_to_uncache(&map->block[map->first_free]);
 	void *ptr;
-	int i;
 
 	map->free_count--;
 	ptr = (void *)(map->base + map->first_free * map->block_size);
@@ -164,17 +299,12 @@ static void *alloc_block(struct mm_heap *heap, int level,
 	hdr->used = 1;
 	heap->info.used += map->block_size;
 	heap->info.free -= map->block_size;
+	heap_account_alloc(heap, map);
 
 	/* find next free */
-	for (i = map->first_free; i < map->count; ++i) {
-
-		hdr = cache_to_uncache(&map->block[i]);
-
-		if (hdr->used == 0) {
-			map->first_free = i;
-			break;
-		}
-	}
+	map_set_used(map, map->first_free, 1, 1);
+	map_set_dirty(map, map->first_free, 1, 1);
+	map->first_free = map_find(map, map->first_free + 1, 0);
 
 #if DEBUG_BLOCK_ALLOC
 	alloc_memset_region(ptr, map->block_size, DEBUG_BLOCK_ALLOC_VALUE);
@@ -191,30 +321,19 @@ static void *alloc_cont_blocks(struct mm_heap *heap, int level,
 	struct block_hdr *hdr;
 	void *ptr;
 	unsigned int start;
-	unsigned int current;
-	unsigned int count = bytes / map->block_size;
-	unsigned int i;
-	unsigned int remaining = map->count - count;
 	unsigned int end;
+	unsigned int count = bytes / map->block_size;
 
 	if (bytes % map->block_size)
 		count++;
 
-	/* check for continuous blocks from "start" */
-	for (start = map->first_free; start < remaining; start++) {
-
-		/* check that we have enough free blocks from start pos */
-		end = start + count;
-		for (current = start; current < end; current++) {
-			hdr = cache_to_uncache(&map->block[current]);
-
-			/* is block used */
-			if (hdr->used)
-				break;
-		}
+	/* check each run of free blocks, skipping whole used runs */
+	for (start = map->first_free; start + count <= map->count;
+	     start = map_find(map, end, 0)) {
+		end = map_find(map, start, 1);
 
 		/* enough free blocks ? */
-		if (current == end)
+		if (end - start >= count)
 			goto found;
 	}
 
@@ -228,29 +347,18 @@ found:
 	ptr = (void *)(map->base + start * map->block_size);
 	hdr = cache_to_uncache(&map->block[start]);
 	hdr->size = count;
+	hdr->used = 1;
 	heap->info.used += count * map->block_size;
 	heap->info.free -= count * map->block_size;
+	heap_account_alloc(heap, map);
 
 	/* allocate each block */
-	for (current = start; current < end; current++) {
-		hdr = cache_to_uncache(&map->block[current]);
-		hdr->used = 1;
-	}
+	map_set_used(map, start, count, 1);
+	map_set_dirty(map, start, count, 1);
 
 	/* do we need to find a new first free block ? */
-	if (start == map->first_free) {
-
-		/* find next free */
-		for (i = map->first_free + count; i < map->count; ++i) {
-
-			hdr = cache_to_uncache(&map->block[i]);
-
-			if (hdr->used == 0) {
-				map->first_free = i;
-				break;
-			}
-		}
-	}
+	if (start == map->first_free)
+		map->first_free = map_find(map, start + count, 0);
 
 #if DEBUG_BLOCK_ALLOC
 	alloc_memset_region(ptr, bytes, DEBUG_BLOCK_ALLOC_VALUE);
@@ -318,14 +426,42 @@ static struct mm_heap *get_buffer_heap_from_caps(uint32_t caps)
 	return NULL;
 }
 
+/* find map that ptr belongs to, maps are laid out in ascending order */
+static struct block_map *get_map_from_ptr(struct mm_heap *heap, void *ptr)
+{
+	struct block_map *map;
+	int low = 0;
+	int high = heap->blocks - 1;
+	int mid;
+
+	while (low < high) {
+		mid = (low + high + 1) >> 1;
+		map = cache_to_uncache(&heap->map[mid]);
+
+		if ((uint32_t)ptr < map->base)
+			high = mid - 1;
+		else
+			low = mid;
+	}
+
+	map = cache_to_uncache(&heap->map[low]);
+
+	/* is ptr in this block */
+	if ((uint32_t)ptr < map->base ||
+	    (uint32_t)ptr >= map->base + map->block_size * map->count)
+		return NULL;
+
+	return map;
+}
+
 /* free block(s) */
 static void free_block(void *ptr)
 {
 	struct mm_heap *heap;
 	struct block_map *block_map;
 	struct block_hdr *hdr;
-	int i;
 	int block;
+	int count;
 
 	heap = get_heap_from_ptr(ptr);
 	if (!heap) {
@@ -334,22 +470,13 @@ static void free_block(void *ptr)
 		return;
 	}
 
-	/* find block that ptr belongs to */
-	for (i = 0; i < heap->blocks; i++) {
-		block_map = cache_to_uncache(&heap->map[i]);
-
-		/* is ptr in this block */
-		if ((uint32_t)ptr < (block_map->base +
-		    (block_map->block_size * block_map->count)))
-			goto found;
+	block_map = get_map_from_ptr(heap, ptr);
+	if (!block_map) {
+		trace_error(TRACE_CLASS_MEM, "invalid ptr %p cpu %d",
+			    (uintptr_t)ptr, cpu_get_id());
+		return;
 	}
 
-	/* not found */
-	trace_error(TRACE_CLASS_MEM, "invalid ptr %p cpu %d",
-		    (uintptr_t)ptr, cpu_get_id());
-	return;
-
-found:
 	/* calculate block header */
 	block = ((uint32_t)ptr - block_map->base) / block_map->block_size;
 	hdr = cache_to_uncache(&block_map->block[block]);
@@ -358,16 +485,23 @@ found:
 	if (block_map->base + block_map->block_size * block != (uint32_t)ptr)
 		panic(SOF_IPC_PANIC_MEM);
 
-	/* free block header and continuous blocks */
-	for (i = block; i < block + hdr->size; i++) {
-		hdr = cache_to_uncache(&block_map->block[i]);
-		hdr->size = 0;
-		hdr->used = 0;
-		block_map->free_count++;
-		heap->info.used -= block_map->block_size;
-		heap->info.free += block_map->block_size;
+	/* only the first block of an allocation can be freed */
+	if (!hdr->used) {
+		trace_error(TRACE_CLASS_MEM, "block not in use %p cpu %d",
+			    (uintptr_t)ptr, cpu_get_id());
+		return;
 	}
 
+	/* free block header and continuous blocks */
+	count = hdr->size;
+	hdr->size = 0;
+	hdr->used = 0;
+	map_set_used(block_map, block, count, 0);
+	map_set_dirty(block_map, block, count, 0);
+	block_map->free_count += count;
+	heap->info.used -= block_map->block_size * count;
+	heap->info.free += block_map->block_size * count;
+
 	/* set first free block */
 	if (block < block_map->first_free)
 		block_map->first_free = block;
@@ -375,10 +509,400 @@ found:
 #if DEBUG_BLOCK_FREE
 	/* memset the whole block incase some not aligned ptr*/
 	alloc_memset_region((void *)(block_map->base + block_map->block_size * block),
-			    block_map->block_size * (i - block), DEBUG_BLOCK_FREE_VALUE);
+			    block_map->block_size * count, DEBUG_BLOCK_FREE_VALUE);
 #endif
 }
 
+/*
+ * Mark the blocks holding [ptr, ptr + bytes) as changed since the last PM
+ * context save. Zero bytes marks the whole allocation holding ptr.
+ */
+static void pm_dirty(void *ptr, size_t bytes)
+{
+	struct mm_heap *heap;
+	struct block_map *map;
+	struct block_hdr *hdr;
+	unsigned int block;
+	unsigned int last;
+
+	/* memory may be written through its uncached alias */
+	heap = get_heap_from_ptr(ptr);
+	if (!heap) {
+		ptr = uncache_to_cache(ptr);
+		heap = get_heap_from_ptr(ptr);
+		if (!heap)
+			return;
+	}
+
+	map = get_map_from_ptr(heap, ptr);
+	if (!map)
+		return;
+
+	block = ((uint32_t)ptr - map->base) / map->block_size;
+
+	if (bytes) {
+		last = ((uint32_t)ptr + bytes - 1 - map->base) /
+			map->block_size;
+		map_set_dirty(map, block, MIN(last + 1, map->count) - block,
+			      1);
+		return;
+	}
+
+	/* free memory is not saved */
+	if (map_find(map, block, 1) != block)
+		return;
+
+	/* walk back to the first block of the allocation */
+	hdr = cache_to_uncache(&map->block[block]);
+	while (!hdr->used && block)
+		hdr = cache_to_uncache(&map->block[--block]);
+
+	map_set_dirty(map, block, hdr->size, 1);
+}
+
+/* allocates continuous buffers from heap */
+static void *rballoc_heap(struct mm_heap *heap, uint32_t caps, size_t bytes)
+{
+	struct block_map *map;
+	int i;
+
+	/* will request fit in single block */
+	for (i = 0; i < heap->blocks; i++) {
+		map = cache_to_uncache(&heap->map[i]);
+
+		/* is block big enough */
+		if (map->block_size < bytes)
+			continue;
+
+		/* does block have free space */
+		if (map->free_count == 0)
+			continue;
+
+		/* allocate block */
+		return alloc_block(heap, i, caps);
+	}
+
+	/* request spans > 1 block */
+
+	/* only 1 choice for block size */
+	if (heap->blocks == 1)
+		return alloc_cont_blocks(heap, 0, caps, bytes);
+
+	/* find best block size for request */
+	for (i = 0; i < heap->blocks; i++) {
+		map = cache_to_uncache(&heap->map[i]);
+
+		/* allocate is block size smaller than request */
+		if (map->block_size < bytes)
+			alloc_cont_blocks(heap, i, caps, bytes);
+	}
+
+	return alloc_cont_blocks(heap, heap->blocks - 1, caps, bytes);
+}
+
+/* find the arena a pipeline allocates from */
+static struct mm_arena *arena_find(int pipeline_id)
+{
+	struct mm_arena *arena;
+	int i;
+
+	for (i = 0; i < HEAP_ARENA_COUNT; i++) {
+		arena = cache_to_uncache(&memmap.arena[i]);
+
+		if (arena->base && !arena->released &&
+		    arena->pipeline_id == pipeline_id)
+			return arena;
+	}
+
+	return NULL;
+}
+
+/* create pipeline arena from the buffer heap */
+static struct mm_arena *arena_new(int pipeline_id)
+{
+	struct mm_arena *arena;
+	struct mm_heap *heap;
+	void *ptr;
+	int i;
+
+	for (i = 0; i < HEAP_ARENA_COUNT; i++) {
+		arena = cache_to_uncache(&memmap.arena[i]);
+
+		if (!arena->base)
+			goto found;
+	}
+
+	/* all arenas in use, pipeline allocates from the heaps */
+	return NULL;
+
+found:
+	heap = get_buffer_heap_from_caps(SOF_MEM_CAPS_RAM);
+	if (!heap)
+		return NULL;
+
+	ptr = rballoc_heap(heap, SOF_MEM_CAPS_RAM, HEAP_ARENA_SIZE);
+	if (!ptr)
+		return NULL;
+
+	arena->pipeline_id = pipeline_id;
+	arena->base = (uint32_t)ptr;
+	arena->size = HEAP_ARENA_SIZE;
+	arena->used = 0;
+	arena->last = 0;
+	arena->caps = heap->caps;
+	arena->live = 0;
+	arena->released = 0;
+
+	return arena;
+}
+
+/* give arena memory back to the heap */
+static void arena_free_memory(struct mm_arena *arena)
+{
+	struct mm_arena **current;
+	int i;
+
+	for (i = 0; i < PLATFORM_HEAP_SYSTEM; i++) {
+		current = cache_to_uncache(&memmap.arena_current[i]);
+		if (*current == arena)
+			*current = NULL;
+	}
+
+	free_block((void *)arena->base);
+	arena->base = 0;
+}
+
+/* allocate from the arena selected on this core */
+static void *arena_alloc(int zone, uint32_t caps, size_t bytes)
+{
+	struct mm_arena *arena;
+	uint32_t offset;
+
+	arena = *(struct mm_arena **)cache_to_uncache(memmap.arena_current +
+						      cpu_get_id());
+	if (!arena)
+		return NULL;
+
+	/* uncached memory is shared with other cores or the host */
+	if ((zone & RZONE_FLAG_MASK) == RZONE_FLAG_UNCACHED ||
+	    (arena->caps & caps) != caps)
+		return NULL;
+
+	/* align to dcache line size, arena full falls back to the heaps */
+	offset = arena->used;
+	if (offset % PLATFORM_DCACHE_ALIGN)
+		offset += PLATFORM_DCACHE_ALIGN -
+			(offset % PLATFORM_DCACHE_ALIGN);
+	if (offset + bytes > arena->size)
+		return NULL;
+
+	arena->last = offset;
+	arena->used = offset + bytes;
+	arena->live++;
+	pm_dirty((void *)(arena->base + offset), MAX(bytes, 1));
+
+	return (void *)(arena->base + offset);
+}
+
+/* find the arena holding ptr */
+static struct mm_arena *arena_find_ptr(void *ptr)
+{
+	struct mm_arena *arena;
+	int i;
+
+	for (i = 0; i < HEAP_ARENA_COUNT; i++) {
+		arena = cache_to_uncache(&memmap.arena[i]);
+
+		if (arena->base && (uint32_t)ptr >= arena->base &&
+		    (uint32_t)ptr < arena->base + arena->size)
+			return arena;
+	}
+
+	return NULL;
+}
+
+/* free arena allocation, returns 0 if ptr is not arena memory */
+static int arena_free(void *ptr)
+{
+	struct mm_arena *arena = arena_find_ptr(ptr);
+
+	if (!arena)
+		return 0;
+
+	arena->live--;
+
+	/* most recent allocation can be handed out again */
+	if ((uint32_t)ptr == arena->base + arena->last)
+		arena->used = arena->last;
+
+	if (!arena->live) {
+		arena->used = 0;
+		arena->last = 0;
+		if (arena->released)
+			arena_free_memory(arena);
+	}
+
+	return 1;
+}
+
+int arena_select(int pipeline_id)
+{
+	struct mm_arena **current;
+	struct mm_arena *arena = NULL;
+	uint32_t flags;
+	int prev;
+
+	spin_lock_irq(&memmap.lock, flags);
+
+	current = cache_to_uncache(memmap.arena_current + cpu_get_id());
+	prev = *current ? (*current)->pipeline_id : ARENA_NONE;
+
+	if (pipeline_id != ARENA_NONE) {
+		arena = arena_find(pipeline_id);
+		if (!arena)
+			arena = arena_new(pipeline_id);
+	}
+
+	*current = arena;
+
+	spin_unlock_irq(&memmap.lock, flags);
+	return prev;
+}
+
+void arena_release(int pipeline_id)
+{
+	struct mm_arena *arena;
+	uint32_t flags;
+
+	spin_lock_irq(&memmap.lock, flags);
+
+	arena = arena_find(pipeline_id);
+	if (arena) {
+		/* members still allocated are freed later by their owners */
+		arena->released = 1;
+		if (!arena->live)
+			arena_free_memory(arena);
+	}
+
+	spin_unlock_irq(&memmap.lock, flags);
+}
+
+/* slab cache object size, alignment, number of objects and capabilities */
+struct slab_def {
+	uint32_t size;
+	uint32_t align;
+	uint32_t count;
+	uint32_t caps;
+};
+
+/*
+ * Component objects fit the host, dai, volume, mixer and src components.
+ * The counts cover a playback and a capture pipeline of host, volume and
+ * DAI with their two buffers, and an IPC container for each of these
+ * objects, larger topologies use the runtime heap for the rest.
+ */
+static const struct slab_def slab_def[SLAB_COUNT] = {
+	[SLAB_COMP_DEV] = {COMP_SIZE(struct sof_ipc_comp_volume),
+			   PLATFORM_DCACHE_ALIGN, 6, SOF_MEM_CAPS_RAM},
+	[SLAB_BUFFER] = {sizeof(struct comp_buffer), PLATFORM_DCACHE_ALIGN, 4,
+			 SOF_MEM_CAPS_RAM},
+	[SLAB_PIPELINE] = {sizeof(struct pipeline), PLATFORM_DCACHE_ALIGN, 2,
+			   SOF_MEM_CAPS_RAM},
+	[SLAB_IPC_COMP] = {sizeof(struct ipc_comp_dev), sizeof(uint32_t), 12,
+			   SOF_MEM_CAPS_RAM},
+};
+
+static inline uint32_t slab_align(uint32_t size, uint32_t align)
+{
+	return (size + align - 1) / align * align;
+}
+
+/* carve the slab cache objects of the master core from the buffer heap */
+static void init_slab(void)
+{
+	struct mm_heap *heap;
+	struct mm_slab *cache;
+	uint32_t offset[SLAB_COUNT];
+	uint32_t size = 0;
+	uint32_t caps = 0;
+	uint32_t base;
+	int i;
+
+	/* all caches share one continuous allocation with all their caps */
+	for (i = 0; i < SLAB_COUNT; i++) {
+		cache = &memmap.slab[i];
+		cache->size = slab_align(slab_def[i].size, slab_def[i].align);
+		cache->count = slab_def[i].count;
+		cache->caps = slab_def[i].caps;
+		caps |= cache->caps;
+
+		size = slab_align(size, slab_def[i].align);
+		offset[i] = size;
+		size += cache->size * cache->count;
+	}
+
+	/* objects are allocated from the heap if there is no space */
+	heap = get_buffer_heap_from_caps(caps);
+	base = heap ? (uint32_t)rballoc_heap(heap, caps, size) : 0;
+	if (!base)
+		trace_mem_error("eSl");
+
+	for (i = 0; i < SLAB_COUNT; i++) {
+		cache = &memmap.slab[i];
+		cache->base = base ? base + offset[i] : 0;
+		cache->free = base ? 0xffffffff >> (32 - cache->count) : 0;
+	}
+
+	dcache_writeback_invalidate_region(memmap.slab, sizeof(memmap.slab));
+}
+
+/* find slab cache holding ptr and offset of ptr in its objects */
+static struct mm_slab *slab_find(void *ptr, uint32_t *offset)
+{
+	struct mm_slab *cache;
+	uint32_t size;
+	int i;
+
+	for (i = 0; i < SLAB_COUNT; i++) {
+		cache = cache_to_uncache(&memmap.slab[i]);
+		size = cache->size * cache->count;
+
+		if (!cache->base)
+			continue;
+
+		/* objects are used by their cached or uncached alias */
+		*offset = (uint32_t)ptr - cache->base;
+		if (*offset >= size)
+			*offset = (uint32_t)ptr - (uint32_t)
+				cache_to_uncache((void *)cache->base);
+		if (*offset < size)
+			return cache;
+	}
+
+	return NULL;
+}
+
+/* free slab cache object, returns 0 if ptr is not slab memory */
+static int slab_free(void *ptr)
+{
+	struct mm_slab *cache;
+	uint32_t offset;
+
+	cache = slab_find(ptr, &offset);
+	if (!cache)
+		return 0;
+
+	if (offset % cache->size ||
+	    cache->free & (1U << (offset / cache->size))) {
+		trace_error(TRACE_CLASS_MEM, "invalid slab ptr %p cpu %d",
+			    (uintptr_t)ptr, cpu_get_id());
+		return 1;
+	}
+
+	cache->free |= 1U << (offset / cache->size);
+	return 1;
+}
+
 /* allocate single block for runtime */
 static void *rmalloc_runtime(int zone, uint32_t caps, size_t bytes)
 {
@@ -415,6 +939,9 @@ find:
 		break;
 	}
 
+	if (!ptr)
+		heap_account_failed(heap, bytes);
+
 	if ((zone & RZONE_FLAG_MASK) == RZONE_FLAG_UNCACHED)
 		ptr = cache_to_uncache(ptr);
 
@@ -439,7 +966,9 @@ void *rmalloc(int zone, uint32_t caps, size_t bytes)
 		ptr = rmalloc_sys(zone, cpu_get_id(), bytes);
 		break;
 	case RZONE_RUNTIME:
-		ptr = rmalloc_runtime(zone, caps, bytes);
+		ptr = arena_alloc(zone, caps, bytes);
+		if (!ptr)
+			ptr = rmalloc_runtime(zone, caps, bytes);
 		break;
 	default:
 		trace_mem_error("eMz");
@@ -462,6 +991,41 @@ void *rzalloc(int zone, uint32_t caps, size_t bytes)
 	return ptr;
 }
 
+/*
+ * Slab objects are only used on the master core and never come from a
+ * pipeline arena, not even when the slab cache is exhausted. The runtime
+ * heap then provides them with the capabilities of the cache.
+ */
+void *rzalloc_slab(int zone, int slab, size_t bytes)
+{
+	struct mm_slab *cache = cache_to_uncache(&memmap.slab[slab]);
+	uint32_t flags;
+	void *ptr = NULL;
+	int obj;
+
+	spin_lock_irq(&memmap.lock, flags);
+
+	if (cpu_get_id() == PLATFORM_MASTER_CORE_ID && bytes <= cache->size &&
+	    cache->free) {
+		obj = __builtin_ctz(cache->free);
+		cache->free &= ~(1U << obj);
+		ptr = (void *)(cache->base + obj * cache->size);
+		pm_dirty(ptr, cache->size);
+
+		if ((zone & RZONE_FLAG_MASK) == RZONE_FLAG_UNCACHED)
+			ptr = cache_to_uncache(ptr);
+	} else {
+		ptr = rmalloc_runtime(zone, cache->caps, bytes);
+	}
+
+	spin_unlock_irq(&memmap.lock, flags);
+
+	if (ptr)
+		bzero(ptr, bytes);
+
+	return ptr;
+}
+
 void *rzalloc_core_sys(int core, size_t bytes)
 {
 	uint32_t flags;
@@ -482,8 +1046,6 @@ void *rzalloc_core_sys(int core, size_t bytes)
 void *rballoc(int zone, uint32_t caps, size_t bytes)
 {
 	struct mm_heap *heap;
-	struct block_map *map;
-	int i;
 	uint32_t flags;
 	void *ptr = NULL;
 
@@ -493,42 +1055,9 @@ void *rballoc(int zone, uint32_t caps, size_t bytes)
 	if (heap == NULL)
 		goto out;
 
-	/* will request fit in single block */
-	for (i = 0; i < heap->blocks; i++) {
-		map = cache_to_uncache(&heap->map[i]);
-
-		/* is block big enough */
-		if (map->block_size < bytes)
-			continue;
-
-		/* does block have free space */
-		if (map->free_count == 0)
-			continue;
-
-		/* allocate block */
-		ptr = alloc_block(heap, i, caps);
-		goto out;
-	}
-
-	/* request spans > 1 block */
-
-	/* only 1 choice for block size */
-	if (heap->blocks == 1) {
-		ptr = alloc_cont_blocks(heap, 0, caps, bytes);
-		goto out;
-	} else {
-
-		/* find best block size for request */
-		for (i = 0; i < heap->blocks; i++) {
-			map = cache_to_uncache(&heap->map[i]);
-
-			/* allocate is block size smaller than request */
-			if (map->block_size < bytes)
-				alloc_cont_blocks(heap, i, caps, bytes);
-		}
-	}
-
-	ptr = alloc_cont_blocks(heap, heap->blocks - 1, caps, bytes);
+	ptr = rballoc_heap(heap, caps, bytes);
+	if (!ptr)
+		heap_account_failed(heap, bytes);
 
 out:
 	if (ptr && ((zone & RZONE_FLAG_MASK) == RZONE_FLAG_UNCACHED))
@@ -560,33 +1089,485 @@ void rfree(void *ptr)
 
 	/* free the block */
 	spin_lock_irq(&memmap.lock, flags);
-	free_block(ptr);
+	if (!slab_free(ptr) && !arena_free(ptr))
+		free_block(ptr);
 	spin_unlock_irq(&memmap.lock, flags);
 }
 
-/* TODO: all mm_pm_...() routines to be implemented for IMR storage */
-uint32_t mm_pm_context_size(void)
+int mm_heap_info(uint32_t zone, uint32_t index, struct sof_ipc_heap_info *info,
+		 size_t size)
 {
+	struct sof_ipc_heap_map_info *map_info;
+	struct mm_heap *heap;
+	struct block_map *map;
+	uint32_t flags;
+	int i;
+
+	switch (zone) {
+	case SOF_IPC_HEAP_SYSTEM:
+		heap = memmap.system;
+		info->num_heaps = PLATFORM_HEAP_SYSTEM;
+		break;
+	case SOF_IPC_HEAP_RUNTIME:
+		heap = memmap.runtime;
+		info->num_heaps = PLATFORM_HEAP_RUNTIME;
+		break;
+	case SOF_IPC_HEAP_BUFFER:
+		heap = memmap.buffer;
+		info->num_heaps = PLATFORM_HEAP_BUFFER;
+		break;
+	default:
+		return -EINVAL;
+	}
+
+	if (index >= info->num_heaps)
+		return -EINVAL;
+
+	heap = cache_to_uncache(heap + index);
+
+	/* maps must fit in the caller buffer */
+	if (sizeof(*info) + heap->blocks * sizeof(*map_info) > size)
+		return -ENOMEM;
+
+	spin_lock_irq(&memmap.lock, flags);
+
+	info->zone = zone;
+	info->index = index;
+	info->caps = heap->caps;
+	info->size = heap->size;
+	info->used = heap->info.used;
+	info->free = heap->info.free;
+	info->peak = heap->info.peak;
+	info->failed = heap->info.failed;
+	info->num_maps = heap->blocks;
+
+	for (i = 0; i < heap->blocks; i++) {
+		map = cache_to_uncache(&heap->map[i]);
+		map_info = &info->map[i];
+
+		map_info->block_size = map->block_size;
+		map_info->count = map->count;
+		map_info->free_count = map->free_count;
+		map_info->max_used = map->max_used;
+		map_info->max_run = map_max_run(map);
+		map_info->failed = map->failed;
+	}
+
+	spin_unlock_irq(&memmap.lock, flags);
+
 	return 0;
 }
 
+/* heap statistics snapshot and period for trace sampling */
+static uint32_t heap_sample_data[SOF_IPC_MSG_MAX_SIZE / sizeof(uint32_t)];
+static uint32_t heap_sample_period;
+static struct work heap_sample_work;
+
+/* trace statistics of every heap */
+static uint64_t heap_sample(void *data, uint64_t delay)
+{
+	struct sof_ipc_heap_info *info = (void *)heap_sample_data;
+	struct sof_ipc_heap_map_info *map_info;
+	uint32_t zone;
+	uint32_t index;
+	int i;
+
+	for (zone = SOF_IPC_HEAP_SYSTEM; zone <= SOF_IPC_HEAP_BUFFER; zone++) {
+		for (index = 0; !mm_heap_info(zone, index, info,
+					      sizeof(heap_sample_data));
+		     index++) {
+			trace_event(TRACE_CLASS_MEM,
+				    "heap %d.%d used %d peak %d",
+				    zone, index, info->used, info->peak);
+			trace_event(TRACE_CLASS_MEM,
+				    "heap %d.%d free %d failed %d",
+				    zone, index, info->free, info->failed);
+
+			for (i = 0; i < info->num_maps; i++) {
+				map_info = &info->map[i];
+				trace_event(TRACE_CLASS_MEM,
+					    "map %d free %d max used %d",
+					    map_info->block_size,
+					    map_info->free_count,
+					    map_info->max_used);
+				trace_event(TRACE_CLASS_MEM,
+					    "map %d run %d failed %d",
+					    map_info->block_size,
+					    map_info->max_run,
+					    map_info->failed);
+			}
+		}
+	}
+
+	return heap_sample_period * 1000;
+}
+
+void mm_heap_sample(uint32_t period_ms)
+{
+	work_cancel_default(&heap_sample_work);
+
+	heap_sample_period = period_ms;
+	if (period_ms)
+		work_schedule_default(&heap_sample_work, period_ms * 1000);
+}
+
+void mm_pm_dirty(void *ptr)
+{
+	struct mm_slab *cache;
+	struct mm_arena *arena;
+	uint32_t offset;
+	uint32_t flags;
+
+	if (!ptr)
+		return;
+
+	spin_lock_irq(&memmap.lock, flags);
+
+	/* slab objects and arena memory are carved from large heap
+	 * allocations, only mark the object or the arena memory from ptr on
+	 */
+	cache = slab_find(ptr, &offset);
+	if (cache) {
+		pm_dirty((char *)ptr - offset % cache->size, cache->size);
+		goto out;
+	}
+
+	arena = arena_find_ptr(ptr);
+	if (arena) {
+		if ((uint32_t)ptr < arena->base + arena->used)
+			pm_dirty(ptr, arena->base + arena->used -
+				 (uint32_t)ptr);
+		goto out;
+	}
+
+	pm_dirty(ptr, 0);
+
+out:
+	spin_unlock_irq(&memmap.lock, flags);
+}
+
+/* PM context image header, copied to the host after the heaps */
+static struct mm_pm_hdr pm_hdr;
+
+/* state of a PM context image walk */
+struct pm_ctx {
+	int save;		/* copy to the host, else only size image */
+	struct dma_copy *dc;
+	struct dma_sg_config *sg;
+	uint32_t offset;	/* image offset of the next object */
+	uint32_t copied;	/* bytes copied to the host */
+};
+
+/* runtime and buffer heaps in image order */
+#define PM_HEAPS	(PLATFORM_HEAP_RUNTIME + PLATFORM_HEAP_BUFFER)
+
+static struct mm_heap *pm_get_heap(int i)
+{
+	if (i < PLATFORM_HEAP_RUNTIME)
+		return cache_to_uncache(&memmap.runtime[i]);
+
+	return cache_to_uncache(&memmap.buffer[i - PLATFORM_HEAP_RUNTIME]);
+}
+
+/*
+ * Add region restored from the image. Regions continuous in DSP memory and
+ * in the image are merged. Once only "reserve" entries are left, regions of
+ * the same heap are merged across the free blocks between them too.
+ */
+static int pm_add_region(struct pm_ctx *ctx, uint32_t addr, uint32_t offset,
+			 uint32_t size, int reserve)
+{
+	struct mm_pm_region *region = pm_hdr.region + pm_hdr.num_regions;
+
+	if (!ctx->save || !size)
+		return 0;
+
+	if (pm_hdr.num_regions) {
+		region--;
+		if (region->offset - region->addr == offset - addr &&
+		    (region->addr + region->size == addr ||
+		     pm_hdr.num_regions + reserve >= MM_PM_REGIONS)) {
+			region->size = addr + size - region->addr;
+			return 0;
+		}
+		region++;
+	}
+
+	if (pm_hdr.num_regions == MM_PM_REGIONS) {
+		trace_mem_error("ePr");
+		return -ENOMEM;
+	}
+
+	region->addr = addr;
+	region->offset = offset;
+	region->size = size;
+	pm_hdr.num_regions++;
+
+	return 0;
+}
+
+/* copy DSP memory to the image */
+static int pm_copy(struct pm_ctx *ctx, uint32_t addr, uint32_t offset,
+		   uint32_t size)
+{
+	int ret;
+
+	if (!ctx->save || !size)
+		return 0;
+
+	dcache_writeback_region((void *)addr, size);
+
+	ret = dma_copy_to_host(ctx->dc, ctx->sg, offset, (void *)addr, size);
+	if (ret < 0)
+		return ret;
+
+	ctx->copied += size;
+	return 0;
+}
+
+/* allocator state is always saved whole */
+static int pm_save_state(struct pm_ctx *ctx, void *ptr, uint32_t size)
+{
+	uint32_t offset = ctx->offset;
+	int ret;
+
+	ctx->offset += size;
+
+	ret = pm_add_region(ctx, (uint32_t)ptr, offset, size,
+			    PM_HEAPS + PLATFORM_HEAP_SYSTEM);
+	if (ret < 0)
+		return ret;
+
+	return pm_copy(ctx, (uint32_t)ptr, offset, size);
+}
+
+/* save blocks in use, copying only the ones changed since the last save */
+static int pm_save_heap(struct pm_ctx *ctx, struct mm_heap *heap,
+			int reserve)
+{
+	struct block_map *map;
+	uint32_t delta = ctx->offset - heap->heap;
+	uint32_t addr;
+	unsigned int start;
+	unsigned int end;
+	unsigned int first;
+	unsigned int last;
+	int ret;
+	int i;
+
+	ctx->offset += heap->size;
+
+	for (i = 0; i < heap->blocks; i++) {
+		map = cache_to_uncache(&heap->map[i]);
+
+		for (start = map_find(map, 0, 1); start < map->count;
+		     start = map_find(map, end, 1)) {
+			end = map_find(map, start, 0);
+			addr = map->base + start * map->block_size;
+
+			ret = pm_add_region(ctx, addr, addr + delta,
+					    (end - start) * map->block_size,
+					    reserve);
+			if (ret < 0)
+				return ret;
+
+			/* copy the changed blocks of the run */
+			for (first = map_find_bits(map, map->dirty_map,
+						   start, 1);
+			     first < end;
+			     first = map_find_bits(map, map->dirty_map,
+						   last, 1)) {
+				last = MIN(map_find_bits(map, map->dirty_map,
+							 first, 0), end);
+				addr = map->base + first * map->block_size;
+
+				ret = pm_copy(ctx, addr, addr + delta,
+					      (last - first) *
+					      map->block_size);
+				if (ret < 0)
+					return ret;
+			}
+		}
+	}
+
+	return 0;
+}
+
+/*
+ * Walk the image: header, allocator state and the block maps, block headers
+ * and usage bitmaps of each runtime and buffer heap, then the system heaps
+ * followed by the runtime and buffer heaps, each at a fixed offset.
+ */
+static int pm_context(struct pm_ctx *ctx)
+{
+	struct mm_heap *heap;
+	struct block_map *map;
+	int ret;
+	int i;
+	int j;
+
+	ctx->offset = sizeof(pm_hdr);
+	ctx->copied = 0;
+
+	ret = pm_save_state(ctx, cache_to_uncache(&memmap), sizeof(memmap));
+	if (ret < 0)
+		return ret;
+
+	for (i = 0; i < PM_HEAPS; i++) {
+		heap = pm_get_heap(i);
+
+		ret = pm_save_state(ctx, cache_to_uncache(heap->map),
+				    sizeof(*heap->map) * heap->blocks);
+		if (ret < 0)
+			return ret;
+
+		for (j = 0; j < heap->blocks; j++) {
+			map = cache_to_uncache(&heap->map[j]);
+
+			ret = pm_save_state(ctx, cache_to_uncache(map->block),
+					    sizeof(*map->block) * map->count);
+			if (ret < 0)
+				return ret;
+
+			ret = pm_save_state(ctx,
+					    cache_to_uncache(map->used_map),
+					    sizeof(*map->used_map) *
+					    BLOCK_MAP_WORDS(map->count));
+			if (ret < 0)
+				return ret;
+		}
+	}
+
+	/* system heaps are never freed, save the used part */
+	for (i = 0; i < PLATFORM_HEAP_SYSTEM; i++) {
+		heap = cache_to_uncache(&memmap.system[i]);
+
+		ret = pm_add_region(ctx, heap->heap, ctx->offset,
+				    heap->info.used,
+				    PM_HEAPS + PLATFORM_HEAP_SYSTEM - i);
+		if (ret < 0)
+			return ret;
+
+		ret = pm_copy(ctx, heap->heap, ctx->offset, heap->info.used);
+		if (ret < 0)
+			return ret;
+
+		ctx->offset += heap->size;
+	}
+
+	for (i = 0; i < PM_HEAPS; i++) {
+		ret = pm_save_heap(ctx, pm_get_heap(i), PM_HEAPS - i);
+		if (ret < 0)
+			return ret;
+	}
+
+	return 0;
+}
+
+/* forget changes, the image holds the current heap contents */
+static void pm_clear_dirty(void)
+{
+	struct mm_heap *heap;
+	struct block_map *map;
+	int i;
+	int j;
+
+	for (i = 0; i < PM_HEAPS; i++) {
+		heap = pm_get_heap(i);
+
+		for (j = 0; j < heap->blocks; j++) {
+			map = cache_to_uncache(&heap->map[j]);
+			map_set_dirty(map, 0, map->count, 0);
+		}
+	}
+}
+
+uint32_t mm_pm_context_size(void)
+{
+	struct pm_ctx ctx = { .save = 0 };
+
+	pm_context(&ctx);
+
+	return ctx.offset;
+}
+
 /*
  * Save the DSP memories that are in use the system and modules. All pipeline and modules
  * must be disabled before calling this functions. No allocations are permitted after
  * calling this and before calling restore.
+ *
+ * The host buffer must hold the image of the previous save, if any. Only
+ * heap blocks allocated or marked by mm_pm_dirty() since then are copied.
+ * Returns the number of bytes copied.
  */
 int mm_pm_context_save(struct dma_copy *dc, struct dma_sg_config *sg)
 {
-	return -ENOTSUP;
+	struct pm_ctx ctx = { .save = 1, .dc = dc, .sg = sg };
+	uint32_t size;
+	int ret;
+
+	pm_hdr.num_regions = 0;
+	ret = pm_context(&ctx);
+	if (ret < 0)
+		return ret;
+
+	/* header is written last so a failed save is not restored */
+	pm_hdr.magic = MM_PM_MAGIC;
+	pm_hdr.size = ctx.offset;
+	pm_hdr.saved = ctx.copied;
+	size = sizeof(pm_hdr) - sizeof(pm_hdr.region) +
+		pm_hdr.num_regions * sizeof(*pm_hdr.region);
+
+	dcache_writeback_region(&pm_hdr, size);
+	ret = dma_copy_to_host(dc, sg, 0, &pm_hdr, size);
+	if (ret < 0)
+		return ret;
+
+	pm_clear_dirty();
+
+	return ctx.copied + size;
 }
 
 /*
  * Restore the DSP memories to modules and the system. This must be called immediately
- * after booting before any pipeline work.
+ * after booting before any pipeline work. Returns the number of bytes copied.
  */
 int mm_pm_context_restore(struct dma_copy *dc, struct dma_sg_config *sg)
 {
-	return -ENOTSUP;
+	struct mm_pm_region *region;
+	uint32_t copied = sizeof(pm_hdr);
+	int ret;
+	int i;
+
+	ret = dma_copy_from_host(dc, sg, 0, &pm_hdr, sizeof(pm_hdr));
+	if (ret < 0)
+		return ret;
+	dcache_invalidate_region(&pm_hdr, sizeof(pm_hdr));
+
+	if (pm_hdr.magic != MM_PM_MAGIC ||
+	    pm_hdr.num_regions > MM_PM_REGIONS ||
+	    pm_hdr.size != mm_pm_context_size()) {
+		trace_mem_error("ePm");
+		return -EINVAL;
+	}
+
+	for (i = 0; i < pm_hdr.num_regions; i++) {
+		region = &pm_hdr.region[i];
+
+		ret = dma_copy_from_host(dc, sg, region->offset,
+					 (void *)region->addr, region->size);
+		if (ret < 0)
+			return ret;
+		dcache_invalidate_region((void *)region->addr, region->size);
+
+		copied += region->size;
+	}
+
+	/* the lock is not part of the image and heaps match the image */
+	spinlock_init(&memmap.lock);
+	pm_clear_dirty();
+
+	return copied;
 }
 
 void free_heap(int zone)
@@ -622,6 +1603,7 @@ void init_heap(struct sof *sof)
 		panic(SOF_IPC_PANIC_MEM);
 
 	spinlock_init(&memmap.lock);
+	work_init(&heap_sample_work, heap_sample, NULL, WORK_ASYNC);
 
 	/* initialise buffer map */
 	for (i = 0; i < PLATFORM_HEAP_BUFFER; i++) {
@@ -668,4 +1650,6 @@ void init_heap(struct sof *sof)
 
 		dcache_writeback_invalidate_region(heap, sizeof(*heap));
 	}
+
+	init_slab();
 }
@@ -37,18 +37,35 @@
 #include <platform/timer.h>
 #include <platform/dma.h>
 #include <platform/platform.h>
+#include <platform/memory.h>
 #include <sof/lock.h>
 #include <sof/cpu.h>
+#include <sof/interrupt.h>
+#include <sof/idc.h>
+#include <platform/idc.h>
+#include <stddef.h>
 #include <stdint.h>
 
 static struct dma_trace_data *trace_data = NULL;
 
-/* amount of dropped entries */
-static uint32_t dropped_entries;
-
 static int dma_trace_get_avail_data(struct dma_trace_data *d,
 				    struct dma_trace_buf *buffer,
 				    int avail);
+static void dtrace_drain(struct dma_trace_data *d);
+
+/*
+ * Send one position update for all copies since the previous one. There
+ * isn't a DMA completion callback in GW DMA copying, so this always runs
+ * before the next copy and guarantees the previous copy has finished.
+ */
+static void dtrace_send_position(struct dma_trace_data *d)
+{
+	if (d->old_host_offset == d->host_offset)
+		return;
+
+	ipc_dma_trace_send_position();
+	d->old_host_offset = d->host_offset;
+}
 
 static uint64_t trace_work(void *data, uint64_t delay)
 {
@@ -56,10 +73,16 @@ static uint64_t trace_work(void *data, uint64_t delay)
 	struct dma_trace_buf *buffer = &d->dmatb;
 	struct dma_sg_config *config = &d->config;
 	unsigned long flags;
-	uint32_t avail = buffer->avail;
+	uint32_t avail;
 	int32_t size;
 	uint32_t overflow;
 
+	dtrace_send_position(d);
+
+	/* collect the entries logged by all cores since the last copy */
+	dtrace_drain(d);
+	avail = buffer->avail;
+
 	/* make sure we don't write more than buffer */
 	if (avail > DMA_TRACE_LOCAL_SIZE) {
 		overflow = avail - DMA_TRACE_LOCAL_SIZE;
@@ -73,9 +96,13 @@ static uint64_t trace_work(void *data, uint64_t delay)
 	 */
 	size = dma_trace_get_avail_data(d, buffer, avail);
 
-	/* any data to copy ? */
-	if (size == 0)
-		return DMA_TRACE_PERIOD;
+	/* nothing to copy, back off until there is */
+	if (size == 0) {
+		d->copy_in_progress = 0;
+		if (d->period < DMA_TRACE_PERIOD_MAX)
+			d->period <<= 1;
+		return d->period;
+	}
 
 	d->overflow = overflow;
 
@@ -90,6 +117,9 @@ static uint64_t trace_work(void *data, uint64_t delay)
 		goto out;
 	}
 
+	d->flushes++;
+	d->bytes += size;
+
 	/* update host pointer and check for wrap */
 	d->host_offset += size;
 	if (d->host_offset >= d->host_size)
@@ -110,21 +140,37 @@ out:
 		else
 			buffer->avail -= size;
 	}
+	avail = buffer->avail;
 
 	/* DMA trace copying is done, allow reschedule */
 	d->copy_in_progress = 0;
 
 	spin_unlock_irq(&d->lock, flags);
 
-	/* reschedule the trace copying work */
-	return DMA_TRACE_PERIOD;
+	d->period = DMA_TRACE_PERIOD;
+
+	/* copy the rest right away if this copy stopped at a buffer wrap */
+	if (avail)
+		return DMA_TRACE_RESCHEDULE_TIME;
+
+	return d->period;
 }
 
 int dma_trace_init_early(struct sof *sof)
 {
+	int i;
+
 	trace_data = rzalloc(RZONE_SYS | RZONE_FLAG_UNCACHED, SOF_MEM_CAPS_RAM,
 			     sizeof(*trace_data));
 
+	/* system allocations start on a cache line, so the ring control
+	 * words of the cores never share one
+	 */
+	for (i = 0; i < PLATFORM_CORE_COUNT; i++)
+		trace_data->ring[i] = rzalloc(RZONE_SYS | RZONE_FLAG_UNCACHED,
+					      SOF_MEM_CAPS_RAM,
+					      sizeof(struct dma_trace_ring));
+
 	dma_sg_init(&trace_data->config.elem_array);
 	spinlock_init(&trace_data->lock);
 	sof->dmat = trace_data;
@@ -132,9 +178,21 @@ int dma_trace_init_early(struct sof *sof)
 	return 0;
 }
 
+/* runs on a slave core, IDC is not sent from dtrace_event() as it traces */
+static uint64_t dtrace_ring_flush(void *data, uint64_t delay)
+{
+	struct idc_msg trace_flush = { IDC_MSG_TRACE_FLUSH,
+		IDC_MSG_TRACE_FLUSH_EXT, PLATFORM_MASTER_CORE_ID };
+
+	idc_send_msg(&trace_flush, IDC_NON_BLOCKING);
+
+	return 0;
+}
+
 int dma_trace_init_complete(struct dma_trace_data *d)
 {
 	int ret;
+	int i;
 
 	trace_buffer("dtn");
 
@@ -147,6 +205,10 @@ int dma_trace_init_complete(struct dma_trace_data *d)
 
 	work_init(&d->dmat_work, trace_work, d, WORK_ASYNC);
 
+	for (i = 0; i < PLATFORM_CORE_COUNT; i++)
+		work_init(&d->ring[i]->flush_work, dtrace_ring_flush, d,
+			  WORK_ASYNC);
+
 	return 0;
 }
 
@@ -165,6 +227,18 @@ int dma_trace_host_buffer(struct dma_trace_data *d,
 static int dma_trace_buffer_init(struct dma_trace_data *d)
 {
 	struct dma_trace_buf *buffer = &d->dmatb;
+	int i;
+
+	/* allocate per core rings, uncached as other cores fill them */
+	for (i = 0; i < PLATFORM_CORE_COUNT; i++) {
+		d->ring[i]->addr = rballoc(RZONE_RUNTIME | RZONE_FLAG_UNCACHED,
+					   SOF_MEM_CAPS_RAM,
+					   DMA_TRACE_RING_SIZE);
+		if (!d->ring[i]->addr) {
+			trace_buffer_error("ebr");
+			return -ENOMEM;
+		}
+	}
 
 	/* allocate new buffer */
 	buffer->addr = rballoc(RZONE_RUNTIME,
@@ -233,17 +307,6 @@ static int dma_trace_get_avail_data(struct dma_trace_data *d,
 {
 	int size;
 
-	/* there isn't DMA completion callback in GW DMA copying.
-	 * so we send previous position always before the next copying
-	 * for guaranteeing previous DMA copying is finished.
-	 * This function will be called once every 500ms at least even
-	 * if no new trace is filled.
-	 */
-	if (d->old_host_offset != d->host_offset) {
-		ipc_dma_trace_send_position();
-		d->old_host_offset = d->host_offset;
-	}
-
 	if (avail == 0)
 		return 0;
 
@@ -323,7 +386,8 @@ int dma_trace_enable(struct dma_trace_data *d)
 	}
 
 	d->enabled = 1;
-	work_schedule_default(&d->dmat_work, DMA_TRACE_PERIOD);
+	d->period = DMA_TRACE_PERIOD;
+	work_schedule_default(&d->dmat_work, d->period);
 
 	return 0;
 }
@@ -331,28 +395,33 @@ int dma_trace_enable(struct dma_trace_data *d)
 void dma_trace_flush(void *t)
 {
 	struct dma_trace_buf *buffer = NULL;
-	uint32_t avail;
-	int32_t size;
+	uint32_t back;
+	int32_t size = 0;
 	int32_t wrap_count;
+	int i;
 
 	if (!trace_data || !trace_data->dmatb.addr)
 		return;
 
 	buffer = &trace_data->dmatb;
-	avail = buffer->avail;
 
-	/* number of bytes to flush */
-	if (avail > DMA_FLUSH_TRACE_SIZE) {
-		size = DMA_FLUSH_TRACE_SIZE;
-	} else {
-		/* check for buffer wrap */
-		if (buffer->w_ptr > buffer->r_ptr)
-			size = buffer->w_ptr - buffer->r_ptr;
-		else
-			size = buffer->end_addr - buffer->r_ptr +
-				buffer->w_ptr - buffer->addr;
+	/* pull in what is still in the rings, only the master drains them */
+	if (cpu_get_id() == PLATFORM_MASTER_CORE_ID)
+		dtrace_drain(trace_data);
+
+	/* the compact stream only decodes from a burst record, so flush from
+	 * the oldest burst that is still in the buffer and fits the mailbox
+	 */
+	for (i = 0; i < DMA_TRACE_BURSTS; i++) {
+		back = trace_data->pos - trace_data->burst[i];
+		if (back <= DMA_FLUSH_TRACE_SIZE && back <= buffer->size &&
+		    back > size)
+			size = back;
 	}
 
+	if (!size)
+		return;
+
 	/* check for buffer wrap */
 	if (buffer->w_ptr - size < buffer->addr) {
 		wrap_count = buffer->w_ptr - buffer->addr;
@@ -368,130 +437,302 @@ void dma_trace_flush(void *t)
 	dcache_writeback_invalidate_region((void *)t, size);
 }
 
-static int dtrace_calc_buf_overflow(struct dma_trace_buf *buffer,
-				    uint32_t length)
+/* size of a trace.c log entry with params parameters */
+#define DTRACE_ENTRY_SIZE(params) \
+	(sizeof(struct log_entry_header) + (1 + (params)) * sizeof(uint32_t))
+#define DTRACE_ENTRY_WORDS(params) \
+	(DTRACE_ENTRY_SIZE(params) / sizeof(uint32_t))
+
+/* worst case compact event, tag and varints of 64 and 32 bit values */
+#define DTRACE_COMPACT_MAX	(1 + 10 + 5 * 5)
+
+/* ring entry size, entry length word plus the entry padded to words */
+#define DTRACE_RING_ENTRY(length) \
+	(sizeof(uint32_t) + (((length) + 3) & ~3))
+
+/* offset of the log entry timestamp from the start of a ring entry */
+#define DTRACE_RING_TIMESTAMP \
+	(sizeof(uint32_t) + offsetof(struct log_entry_header, timestamp))
+
+static void dtrace_ring_write(struct dma_trace_ring *ring, uint32_t pos,
+			      const void *src, uint32_t bytes)
+{
+	uint32_t offset = pos & (DMA_TRACE_RING_SIZE - 1);
+	uint32_t margin = DMA_TRACE_RING_SIZE - offset;
+
+	if (bytes <= margin) {
+		memcpy(ring->addr + offset, src, bytes);
+	} else {
+		memcpy(ring->addr + offset, src, margin);
+		memcpy(ring->addr, src + margin, bytes - margin);
+	}
+}
+
+static void dtrace_ring_read(struct dma_trace_ring *ring, uint32_t pos,
+			     void *dst, uint32_t bytes)
 {
-	uint32_t margin;
-	uint32_t overflow_margin;
-	uint32_t overflow = 0;
+	uint32_t offset = pos & (DMA_TRACE_RING_SIZE - 1);
+	uint32_t margin = DMA_TRACE_RING_SIZE - offset;
 
-	margin = buffer->end_addr - buffer->w_ptr;
+	if (bytes <= margin) {
+		memcpy(dst, ring->addr + offset, bytes);
+	} else {
+		memcpy(dst, ring->addr + offset, margin);
+		memcpy(dst + margin, ring->addr, bytes - margin);
+	}
+}
 
-	/* overflow calculating */
-	if (buffer->w_ptr < buffer->r_ptr)
-		overflow_margin = buffer->r_ptr - buffer->w_ptr;
-	else
-		overflow_margin = margin + buffer->r_ptr - buffer->addr;
+/* append one entry to the calling core ring, called with local irqs off */
+static struct dma_trace_ring *dtrace_ring_add(const char *e, uint32_t length)
+{
+	struct dma_trace_ring *ring = trace_data->ring[cpu_get_id()];
+	uint32_t size = DTRACE_RING_ENTRY(length);
+
+	/* ring full, the drain reports the dropped amount */
+	if (DMA_TRACE_RING_SIZE - (ring->w_pos - ring->r_pos) < size) {
+		ring->dropped++;
+		return ring;
+	}
+
+	dtrace_ring_write(ring, ring->w_pos, &length, sizeof(length));
+	dtrace_ring_write(ring, ring->w_pos + sizeof(length), e, length);
 
-	if (overflow_margin < length)
-		overflow = length - overflow_margin;
+	/* publish the entry to the master core */
+	ring->w_pos += size;
 
-	return overflow;
+	return ring;
 }
 
+/* append bytes to the local DMA buffer, the caller checked for room */
 static void dtrace_add_event(const char *e, uint32_t length)
 {
 	struct dma_trace_buf *buffer = &trace_data->dmatb;
 	uint32_t margin;
-	uint32_t overflow = 0;
 
 	margin = dtrace_calc_buf_margin(buffer);
-	overflow = dtrace_calc_buf_overflow(buffer, length);
-
-	/* tracing dropped entries */
-	if (dropped_entries) {
-		if (!overflow) {
-			/*
-			 * if any dropped entries have appeared and there
-			 * is not any overflow, their amount will be logged
-			 */
-			uint32_t tmp_dropped_entries = dropped_entries;
-
-			dropped_entries = 0;
-			/*
-			 * this trace_error invocation causes recursion,
-			 * so after it we have to recalculate margin and
-			 * overflow
-			 */
-			trace_error(0, "Number of dropped logs: %u",
-				    tmp_dropped_entries);
-			margin = dtrace_calc_buf_margin(buffer);
-			overflow = dtrace_calc_buf_overflow(buffer, length);
-		}
+
+	/* check for buffer wrap */
+	if (margin > length) {
+		/* no wrap */
+		memcpy(buffer->w_ptr, e, length);
+		buffer->w_ptr += length;
+	} else {
+		/* data is bigger than remaining margin so we wrap */
+		memcpy(buffer->w_ptr, e, margin);
+		buffer->w_ptr = buffer->addr;
+
+		memcpy(buffer->w_ptr, e + margin, length - margin);
+		buffer->w_ptr += length - margin;
+	}
+
+	buffer->avail += length;
+	trace_data->pos += length;
+}
+
+static uint8_t *dtrace_put_varint(uint8_t *p, uint64_t value)
+{
+	while (value >= 0x80) {
+		*p++ = (value & 0x7f) | 0x80;
+		value >>= 7;
 	}
+	*p++ = value;
 
-	/* checking overflow */
-	if (!overflow) {
-		/* check for buffer wrap */
-		if (margin > length) {
-			/* no wrap */
-			memcpy(buffer->w_ptr, e, length);
-			dcache_writeback_invalidate_region(buffer->w_ptr,
-							   length);
-			buffer->w_ptr += length;
-		} else {
-			/* data is bigger than remaining margin so we wrap */
-			memcpy(buffer->w_ptr, e, margin);
-			dcache_writeback_invalidate_region(buffer->w_ptr,
-							   margin);
-			buffer->w_ptr = buffer->addr;
-
-			memcpy(buffer->w_ptr, e + margin, length - margin);
-			dcache_writeback_invalidate_region(buffer->w_ptr,
-							   length - margin);
-			buffer->w_ptr += length - margin;
+	return p;
+}
+
+/*
+ * Encode one ring entry into the compact stream format, see uapi/logging.h.
+ * Returns the encoded size. Interrupts can reorder two entries of one core
+ * after their timestamps were taken, so the delta is signed.
+ */
+static uint32_t dtrace_encode(const uint32_t *entry, uint32_t length,
+			      uint64_t prev, uint8_t *dst)
+{
+	const struct log_entry_header *header = (const void *)entry;
+	const uint32_t *payload = entry + sizeof(*header) / sizeof(uint32_t);
+	uint32_t params = (length - DTRACE_ENTRY_SIZE(0)) / sizeof(uint32_t);
+	int64_t delta = header->timestamp - prev;
+	uint8_t *p = dst;
+	int i;
+
+	*p++ = LOG_COMPACT_TAG(header->core_id, params);
+	p = dtrace_put_varint(p, ((uint64_t)delta << 1) ^ (delta >> 63));
+	p = dtrace_put_varint(p, payload[0] - LOG_ENTRY_ELF_BASE);
+	for (i = 1; i <= params; i++)
+		p = dtrace_put_varint(p, payload[i]);
+
+	return p - dst;
+}
+
+/*
+ * Merge the per core rings into the local DMA buffer in timestamp order,
+ * as one compact burst. Entries stay in their ring while the DMA buffer is
+ * full, so only the rings themselves can overflow. Runs on the master core
+ * only.
+ */
+static void dtrace_drain(struct dma_trace_data *d)
+{
+	struct dma_trace_buf *buffer = &d->dmatb;
+	struct dma_trace_ring *ring;
+	struct dma_trace_ring *next;
+	struct log_compact_burst burst;
+	uint32_t entry[DTRACE_ENTRY_WORDS(4)];
+	uint8_t compact[DTRACE_COMPACT_MAX];
+	uint8_t pad[sizeof(uint32_t)];
+	uint64_t timestamp;
+	uint64_t next_timestamp = 0;
+	uint64_t prev = 0;
+	uint32_t length;
+	uint32_t size;
+	uint32_t header;
+	uint32_t burst_size = 0;
+	uint32_t dropped = 0;
+	unsigned long flags;
+	int i;
+
+	for (;;) {
+		/* pick the oldest entry at the head of all rings */
+		next = NULL;
+		for (i = 0; i < PLATFORM_CORE_COUNT; i++) {
+			ring = d->ring[i];
+			if (!ring->addr || ring->w_pos == ring->r_pos)
+				continue;
+
+			dtrace_ring_read(ring,
+					 ring->r_pos + DTRACE_RING_TIMESTAMP,
+					 &timestamp, sizeof(timestamp));
+			if (!next || timestamp < next_timestamp) {
+				next = ring;
+				next_timestamp = timestamp;
+			}
 		}
 
-		buffer->avail += length;
-		trace_data->messages++;
-	} else {
-		/* if there is not enough memory for new log, we drop it */
-		dropped_entries++;
+		if (!next)
+			break;
+
+		dtrace_ring_read(next, next->r_pos, &length, sizeof(length));
+		dtrace_ring_read(next, next->r_pos + sizeof(length), entry,
+				 length);
+
+		/* the first event opens the burst with its full timestamp */
+		if (!burst_size) {
+			burst.tag = LOG_COMPACT_BURST;
+			burst.version = LOG_COMPACT_VERSION;
+			burst.timestamp = next_timestamp;
+			burst.entry_base = LOG_ENTRY_ELF_BASE;
+			prev = next_timestamp;
+			burst_size = sizeof(burst);
+		}
+
+		size = dtrace_encode(entry, length, prev, compact);
+
+		/* the header goes out with the first event of the burst */
+		header = burst_size == sizeof(burst) ? sizeof(burst) : 0;
+
+		/* the buffer holds the events added so far, so keep room for
+		 * this one and the burst padding
+		 */
+		if (DMA_TRACE_LOCAL_SIZE - buffer->avail <
+		    header + size + sizeof(pad))
+			break;
+
+		spin_lock_irq(&d->lock, flags);
+		if (header) {
+			d->burst[d->burst_index] = d->pos;
+			d->burst_index = (d->burst_index + 1) %
+				DMA_TRACE_BURSTS;
+			dtrace_add_event((const char *)&burst, header);
+		}
+		dtrace_add_event((const char *)compact, size);
+		spin_unlock_irq(&d->lock, flags);
+
+		d->messages++;
+		burst_size += size;
+		prev = next_timestamp;
+		next->r_pos += DTRACE_RING_ENTRY(length);
+	}
+
+	/* close the burst on a word boundary */
+	size = -(uintptr_t)buffer->w_ptr & (sizeof(pad) - 1);
+	if (burst_size > sizeof(burst) && size) {
+		memset(pad, LOG_COMPACT_PAD, sizeof(pad));
+		spin_lock_irq(&d->lock, flags);
+		dtrace_add_event((const char *)pad, size);
+		spin_unlock_irq(&d->lock, flags);
+	}
+
+	for (i = 0; i < PLATFORM_CORE_COUNT; i++) {
+		dropped += d->ring[i]->dropped;
+		d->ring[i]->flush = 0;
+	}
+
+	/* this lands in the master ring and goes out with the next drain */
+	if (dropped != d->dropped) {
+		trace_error(0, "Number of dropped logs: %u",
+			    dropped - d->dropped);
+		d->dropped = dropped;
 	}
 }
 
 void dtrace_event(const char *e, uint32_t length)
 {
-	struct dma_trace_buf *buffer = NULL;
-	unsigned long flags;
+	struct dma_trace_ring *ring;
+	uint32_t flags;
 
 	if (!trace_data || !trace_data->dmatb.addr ||
-	    length > DMA_TRACE_LOCAL_SIZE / 8 || length == 0)
+	    length > DTRACE_ENTRY_SIZE(4) || length < DTRACE_ENTRY_SIZE(0))
 		return;
 
-	buffer = &trace_data->dmatb;
-
-	spin_lock_irq(&trace_data->lock, flags);
-	dtrace_add_event(e, length);
+	/* the ring is per core, so only the local irqs need to be off */
+	flags = interrupt_global_disable();
+	ring = dtrace_ring_add(e, length);
+	interrupt_global_enable(flags);
 
-	/* if DMA trace copying is working or slave core
-	 * don't check if local buffer is half full
-	 */
-	if (trace_data->copy_in_progress ||
-	    cpu_get_id() != PLATFORM_MASTER_CORE_ID) {
-		spin_unlock_irq(&trace_data->lock, flags);
+	/* if DMA trace copying is working don't check the local ring fill */
+	if (!trace_data->enabled || trace_data->copy_in_progress)
 		return;
-	}
 
-	spin_unlock_irq(&trace_data->lock, flags);
-
-	/* schedule copy now if buffer > 50% full */
-	if (trace_data->enabled &&
-	    buffer->avail >= (DMA_TRACE_LOCAL_SIZE / 2)) {
+	if (ring->w_pos - ring->r_pos >= DMA_TRACE_WATERMARK) {
+		if (cpu_get_id() == PLATFORM_MASTER_CORE_ID) {
+			dma_trace_schedule_copy();
+		} else if (!ring->flush) {
+			/* the work may be backed off, wake the master */
+			ring->flush = 1;
+			work_reschedule_default(&ring->flush_work,
+						DMA_TRACE_RESCHEDULE_TIME);
+		}
+	} else if (cpu_get_id() == PLATFORM_MASTER_CORE_ID &&
+		   trace_data->period != DMA_TRACE_PERIOD) {
+		/* first event after the work backed off */
+		trace_data->period = DMA_TRACE_PERIOD;
 		work_reschedule_default(&trace_data->dmat_work,
-		DMA_TRACE_RESCHEDULE_TIME);
-		/* reschedule should not be interrupted
-		 * just like we are in copy progress
-		 */
-		trace_data->copy_in_progress = 1;
+					DMA_TRACE_PERIOD);
 	}
 }
 
+/* copy the rings out now, called on the master core */
+void dma_trace_schedule_copy(void)
+{
+	if (!trace_data || !trace_data->enabled ||
+	    trace_data->copy_in_progress)
+		return;
+
+	/* schedule copy now and stop backing off */
+	trace_data->period = DMA_TRACE_PERIOD;
+	work_reschedule_default(&trace_data->dmat_work,
+				DMA_TRACE_RESCHEDULE_TIME);
+
+	/* reschedule should not be interrupted
+	 * just like we are in copy progress
+	 */
+	trace_data->copy_in_progress = 1;
+}
+
 void dtrace_event_atomic(const char *e, uint32_t length)
 {
 	if (!trace_data || !trace_data->dmatb.addr ||
-	    length > DMA_TRACE_LOCAL_SIZE / 8 || length == 0)
+	    length > DTRACE_ENTRY_SIZE(4) || length < DTRACE_ENTRY_SIZE(0))
 		return;
 
-	dtrace_add_event(e, length);
+	dtrace_ring_add(e, length);
 }
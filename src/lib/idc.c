@@ -0,0 +1,181 @@
+/*
+ * Copyright (c) 2018, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of the Intel Corporation nor the
+ *     names of its contributors may be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Author: Tomasz Lauda <tomasz.lauda@linux.intel.com>
+ */
+
+/**
+ * \file lib/idc.c
+ * \brief IDC message handlers
+ * \authors Tomasz Lauda <tomasz.lauda@linux.intel.com>
+ *
+ * Shared by the SMP architecture IDC task and the host core emulation.
+ */
+
+#include <stdint.h>
+#include <errno.h>
+#include <sof/audio/component.h>
+#include <sof/audio/pipeline.h>
+#include <sof/cpu.h>
+#include <sof/dma-trace.h>
+#include <sof/idc.h>
+#include <sof/ipc.h>
+#include <sof/notifier.h>
+#include <arch/cache.h>
+
+extern struct ipc *_ipc;
+
+/**
+ * \brief Executes IDC pipeline trigger message.
+ * \param[in] cmd Trigger command.
+ * \return Error code.
+ */
+static int idc_pipeline_trigger(uint32_t cmd)
+{
+	struct sof_ipc_stream *data = _ipc->comp_data;
+	struct ipc_comp_dev *pcm_dev;
+	int ret;
+
+	/* invalidate stream data */
+	dcache_invalidate_region(data, sizeof(*data));
+
+	/* check whether component exists */
+	pcm_dev = ipc_get_comp(_ipc, data->comp_id);
+	if (!pcm_dev)
+		return -ENODEV;
+
+	/* check whether we are executing from the right core */
+	if (cpu_get_id() != pcm_dev->cd->pipeline->ipc_pipe.core)
+		return -EINVAL;
+
+	/* invalidate pipeline on start */
+	if (cmd == COMP_TRIGGER_START)
+		pipeline_cache(pcm_dev->cd->pipeline,
+			       pcm_dev->cd, COMP_CACHE_INVALIDATE);
+
+	/* trigger pipeline */
+	ret = pipeline_trigger(pcm_dev->cd->pipeline, pcm_dev->cd, cmd);
+
+	/* writeback pipeline on stop */
+	if (cmd == COMP_TRIGGER_STOP)
+		pipeline_cache(pcm_dev->cd->pipeline,
+			       pcm_dev->cd, COMP_CACHE_WRITEBACK_INV);
+
+	return ret;
+}
+
+/**
+ * \brief Executes IDC component command message.
+ * \param[in] cmd Component command.
+ * \return Error code.
+ */
+static int idc_component_command(uint32_t cmd)
+{
+	struct sof_ipc_ctrl_data *data = _ipc->comp_data;
+	struct ipc_comp_dev *comp_dev;
+	int ret;
+
+	/* invalidate control data */
+	dcache_invalidate_region(data, sizeof(*data));
+	dcache_invalidate_region(data + 1,
+				 data->rhdr.hdr.size - sizeof(*data));
+
+	/* check whether component exists */
+	comp_dev = ipc_get_comp(_ipc, data->comp_id);
+	if (!comp_dev)
+		return -ENODEV;
+
+	/* check whether we are executing from the right core */
+	if (cpu_get_id() != comp_dev->cd->pipeline->ipc_pipe.core)
+		return -EINVAL;
+
+	/* execute component command */
+	ret = comp_cmd(comp_dev->cd, cmd, data);
+
+	/* writeback control data */
+	dcache_writeback_region(data, data->rhdr.hdr.size);
+
+	return ret;
+}
+
+/**
+ * \brief Executes IDC pipeline migrate messages.
+ * \param[in] type Migrate out or in message type.
+ * \param[in] ext Pipeline id and new core.
+ * \return Error code.
+ */
+static int idc_pipeline_migrate(uint32_t type, uint32_t ext)
+{
+	struct ipc_comp_dev *ppl_dev;
+
+	/* check whether pipeline exists */
+	ppl_dev = ipc_get_comp(_ipc, IDC_MSG_PPL_MIGRATE_ID(ext));
+	if (!ppl_dev || ppl_dev->type != COMP_TYPE_PIPELINE)
+		return -ENODEV;
+
+	if (type == IDC_MSG_PPL_MIGRATE_OUT)
+		return pipeline_migrate_out(ppl_dev->pipeline,
+					    IDC_MSG_PPL_MIGRATE_CORE(ext));
+
+	return pipeline_migrate_in(ppl_dev->pipeline);
+}
+
+/**
+ * \brief Executes IDC message based on type.
+ * \param[in,out] msg Pointer to IDC message.
+ */
+void idc_cmd(struct idc_msg *msg)
+{
+	uint32_t type = iTS(msg->header);
+
+	switch (type) {
+	case iTS(IDC_MSG_POWER_DOWN):
+		cpu_power_down_core();
+		break;
+	case iTS(IDC_MSG_PPL_TRIGGER):
+		idc_pipeline_trigger(msg->extension);
+		break;
+	case iTS(IDC_MSG_COMP_CMD):
+		idc_component_command(msg->extension);
+		break;
+	case iTS(IDC_MSG_PPL_MIGRATE_OUT):
+		idc_pipeline_migrate(IDC_MSG_PPL_MIGRATE_OUT, msg->extension);
+		break;
+	case iTS(IDC_MSG_PPL_MIGRATE_IN):
+		idc_pipeline_migrate(IDC_MSG_PPL_MIGRATE_IN, msg->extension);
+		break;
+	case iTS(IDC_MSG_NOTIFY):
+		notifier_notify();
+		break;
+	case iTS(IDC_MSG_TRACE_FLUSH):
+		dma_trace_schedule_copy();
+		break;
+	default:
+		trace_idc_error("eTc");
+		trace_error_value(msg->header);
+	}
+}
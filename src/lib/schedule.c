@@ -123,8 +123,11 @@ static inline struct task *edf_get_next(uint64_t current,
 		/* include the length of task in deadline calc */
 		deadline = task->deadline - task->max_rtime;
 
-		if (current < deadline) {
-			delta = deadline - current;
+		if (current < deadline || task->priority == TASK_PRI_LL) {
+			/* late low latency work runs at once, deferring it
+			 * would only turn it into an xrun
+			 */
+			delta = current < deadline ? deadline - current : 0;
 
 			/* get highest priority */
 			if (task->priority < next_priority) {
@@ -328,6 +331,28 @@ void schedule_task(struct task *task, uint64_t start, uint64_t deadline)
 	}
 }
 
+/*
+ * Track the longest run of a low latency task, so the EDF deadline check
+ * accounts for it, and report runs that do not fit the deadline window
+ * with the scheduling overhead. The run time of all tasks adds up for the
+ * pipeline load balancing. rtime is in scheduler clock ticks, like the
+ * deadline window and PLATFORM_SCHEDULE_COST.
+ */
+void schedule_task_rtime(struct task *task, uint64_t rtime)
+{
+	task->total_rtime += rtime;
+
+	if (task->priority != TASK_PRI_LL || rtime <= task->max_rtime)
+		return;
+
+	task->max_rtime = rtime;
+
+	if (rtime + PLATFORM_SCHEDULE_COST > task->deadline - task->start) {
+		trace_pipe_error("llb");
+		trace_error_value(rtime);
+	}
+}
+
 /* Remove a task from the scheduler when complete */
 void schedule_task_complete(struct task *task)
 {
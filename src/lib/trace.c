@@ -47,6 +47,14 @@ struct trace {
 
 static struct trace *trace;
 
+/* errors and info of all classes by default, verbose only on request */
+struct trace_filter trace_filter = {
+	.mask = {
+		[LOG_LEVEL_CRITICAL] = 0xffffffff,
+		[LOG_LEVEL_INFO] = 0xffffffff,
+	},
+};
+
 /* calculates total message size, both header and payload */
 #define MESSAGE_SIZE(args_num) \
 	((sizeof(struct log_entry_header) + (1 + args_num) * sizeof(uint32_t)) \
@@ -56,6 +64,7 @@ static void put_header(volatile uint32_t *dst, uint64_t timestamp)
 {
 	struct log_entry_header header;
 
+	header.magic = LOG_ENTRY_MAGIC;
 	header.rsvd = 0;
 	header.core_id = cpu_get_id();
 	header.timestamp = timestamp;
@@ -714,6 +723,14 @@ void trace_off(void)
 	trace->enable = 0;
 }
 
+void trace_level_set(uint32_t level, uint32_t class_mask)
+{
+	volatile struct trace_filter *filter =
+		cache_to_uncache(&trace_filter);
+
+	filter->mask[level] = class_mask;
+}
+
 void trace_init(struct sof *sof)
 {
 	dma_trace_init_early(sof);
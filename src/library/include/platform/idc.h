@@ -31,9 +31,12 @@
 #ifndef __INCLUDE_PLATFORM_IDC_H__
 #define __INCLUDE_PLATFORM_IDC_H__
 
+/* messages go to the emulated cores, see src/host/idc.c */
+int emu_idc_send_msg(struct idc_msg *msg, uint32_t mode);
+
 static inline int idc_send_msg(struct idc_msg *msg, uint32_t mode)
 {
-	return 0;
+	return emu_idc_send_msg(msg, mode);
 }
 
 static inline void idc_process_msg_queue(void)
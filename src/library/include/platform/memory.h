@@ -31,6 +31,7 @@
 #ifndef __PLATFORM_HOST_MEMORY_H__
 #define __PLATFORM_HOST_MEMORY_H__
 
+#include <stdint.h>
 #include <config.h>
 
 #if CONFIG_HT_BAYTRAIL
@@ -87,7 +88,21 @@
 #endif
 
 #define MAILBOX_DSPBOX_BASE	0
-#define MAILBOX_HOSTBOX_BASE	0
-#define MAILBOX_BASE		0
+
+/*
+ * Mailbox windows in host memory, defined by the program running IPC code.
+ * The host mailbox is apart so it can be as large as on any DSP.
+ */
+extern uint8_t emu_mailbox[];
+extern uint8_t emu_hostbox[];
+#define MAILBOX_BASE		((uintptr_t)emu_mailbox)
+#define MAILBOX_HOSTBOX_SIZE	0x2000
+#define MAILBOX_HOSTBOX_BASE	((uintptr_t)emu_hostbox)
+
+#define uncache_to_cache(address)	address
+#define cache_to_uncache(address)	address
+
+#define LOG_ENTRY_ELF_BASE	0x20000000
+#define LOG_ENTRY_ELF_SIZE	0x2000000
 
 #endif
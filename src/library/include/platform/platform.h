@@ -51,6 +51,12 @@
  */
 #define PLATFORM_WORKQ_DEFAULT_TIMEOUT	1000
 
+/* scheduler clock ticks of one scheduler pass */
+#define PLATFORM_SCHEDULE_COST	200
+
+/* the emulated scheduler clock counts nanoseconds */
+#define PLATFORM_SCHED_CLOCK	PLATFORM_DEFAULT_CLOCK
+
 /* Host page size */
 #define HOST_PAGE_SIZE		4096
 
@@ -67,6 +73,18 @@
 /* DSP default delay in cycles */
 #define PLATFORM_DEFAULT_DELAY	12
 
+/* local buffer size of DMA tracing */
+#define DMA_TRACE_LOCAL_SIZE	HOST_PAGE_SIZE
+
+/* trace bytes flushed during panic */
+#define DMA_FLUSH_TRACE_SIZE	(MAILBOX_TRACE_SIZE >> 2)
+
+/* the interval of DMA trace copying */
+#define DMA_TRACE_PERIOD	500000
+
+/* the interval of reschedule DMA trace copying when the buffer fills */
+#define DMA_TRACE_RESCHEDULE_TIME	100
+
 static inline void platform_panic(uint32_t p) {}
 
 extern struct timer *platform_timer;
@@ -88,6 +88,9 @@ int do_task_master_core(struct sof *sof)
 		/* now process any IPC messages from host */
 		ipc_process_msg_queue();
 
+		/* move pipelines off overloaded cores */
+		sa_balance(sof);
+
 		/* schedule any idle tasks */
 		schedule();
 	}
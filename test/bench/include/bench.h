@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2018, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of the Intel Corporation nor the
+ *     names of its contributors may be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _BENCH_H
+#define _BENCH_H
+
+#include <stdint.h>
+#include <sof/audio/component.h>
+#include <sof/audio/buffer.h>
+
+/* sweep limits */
+#define BENCH_MAX_CHANNELS	8
+#define BENCH_MAX_FRAMES	1024
+
+/* one benchmark case, run() is called once per measured kernel call */
+struct bench_case {
+	const char *kernel;	/* kernel name */
+	const char *variant;	/* sample format or other variant */
+	int channels;		/* channels processed per call */
+	int frames;		/* frames processed per call */
+	void (*run)(void *data);
+	void *data;
+};
+
+/* sweeps shared by all kernels */
+extern const int bench_channels[];
+extern const int bench_channels_count;
+extern const int bench_frames[];
+extern const int bench_frames_count;
+extern const enum sof_ipc_frame bench_formats[];
+extern const int bench_formats_count;
+
+/* measure and report one case, returns the time per call in ns */
+double bench_run(struct bench_case *bc);
+
+/* returns non zero if the kernel is filtered out on the command line */
+int bench_skip(const char *kernel);
+
+/* helpers */
+const char *bench_format_name(enum sof_ipc_frame fmt);
+int bench_sample_bytes(enum sof_ipc_frame fmt);
+struct comp_buffer *bench_buffer_new(uint32_t size);
+void bench_buffer_fill(struct comp_buffer *buffer, enum sof_ipc_frame fmt);
+
+/* pipeline hooks of the mocks */
+extern int bench_xruns;
+extern void (*bench_schedule_copy)(struct pipeline *p);
+
+/* kernel suites */
+void bench_iir(void);
+void bench_fir(void);
+void bench_src(void);
+void bench_volume(void);
+void bench_mixer(void);
+void bench_math(void);
+void bench_buffer(void);
+void bench_trace(void);
+void bench_ipc(void);
+void bench_host(void);
+void bench_smp(void);
+
+#endif
@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2018, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of the Intel Corporation nor the
+ *     names of its contributors may be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <config.h>
+#include <arch/cache.h>
+#include <sof/audio/component.h>
+#include <sof/audio/buffer.h>
+#include "bench.h"
+
+struct buffer_bench {
+	struct comp_buffer *buffer;
+	uint32_t bytes;
+	uint32_t periods;
+};
+
+/* the DMA end of the sync cases */
+static struct comp_dev buffer_dma_comp = {
+	.is_dma_connected = 1,
+};
+
+/* one producer and one consumer period, as seen by every copy() */
+static void buffer_run(void *data)
+{
+	struct buffer_bench *bb = data;
+
+	comp_update_buffer_produce(bb->buffer, bb->bytes);
+	comp_update_buffer_consume(bb->buffer, bb->bytes);
+}
+
+static void buffer_case(int channels, int frames)
+{
+	struct bench_case bc;
+	struct buffer_bench bb;
+
+	/* odd period count keeps the pointers moving and wrapping */
+	bb.bytes = frames * channels * sizeof(int32_t);
+	bb.buffer = bench_buffer_new(bb.bytes * 3);
+
+	bc.kernel = "buffer_produce_consume";
+	bc.variant = "s32";
+	bc.channels = channels;
+	bc.frames = frames;
+	bc.run = buffer_run;
+	bc.data = &bb;
+	bench_run(&bc);
+
+	buffer_free(bb.buffer);
+}
+
+/* a period produced, synced by the pipeline walk and consumed */
+static void buffer_sync_run(void *data)
+{
+	struct buffer_bench *bb = data;
+
+	comp_update_buffer_produce(bb->buffer, bb->bytes);
+	buffer_sync(bb->buffer);
+	comp_update_buffer_consume(bb->buffer, bb->bytes);
+	bb->periods++;
+}
+
+static void buffer_sync_case(const char *variant, int playback, int frames)
+{
+	struct bench_case bc;
+	struct buffer_bench bb;
+#if defined(CONFIG_HOST)
+	struct dcache_stats start = dcache_stats;
+#endif
+
+	bb.bytes = frames * 2 * sizeof(int32_t);
+	bb.buffer = bench_buffer_new(bb.bytes * 3);
+	bb.periods = 0;
+
+	/* playback DMA reads the buffer, capture DMA writes it */
+	if (playback)
+		bb.buffer->sink = &buffer_dma_comp;
+	else
+		bb.buffer->source = &buffer_dma_comp;
+
+	bc.kernel = "buffer_dma_sync";
+	bc.variant = variant;
+	bc.channels = 2;
+	bc.frames = frames;
+	bc.run = buffer_sync_run;
+	bc.data = &bb;
+	bench_run(&bc);
+
+#if defined(CONFIG_HOST)
+	/* the host cache only counts the lines maintained */
+	printf("buffer_dma_sync %s %d frames: %.1f bytes written back "
+	       "%.1f bytes invalidated per period\n", variant, frames,
+	       (double)(dcache_stats.writeback - start.writeback) /
+	       bb.periods,
+	       (double)(dcache_stats.invalidate - start.invalidate) /
+	       bb.periods);
+#endif
+
+	buffer_free(bb.buffer);
+}
+
+void bench_buffer(void)
+{
+	int c, n;
+
+	if (!bench_skip("buffer_produce_consume"))
+		for (c = 0; c < bench_channels_count; c++)
+			for (n = 0; n < bench_frames_count; n++)
+				buffer_case(bench_channels[c],
+					    bench_frames[n]);
+
+	if (!bench_skip("buffer_dma_sync"))
+		for (n = 0; n < bench_frames_count; n++) {
+			buffer_sync_case("playback", 1, bench_frames[n]);
+			buffer_sync_case("capture", 0, bench_frames[n]);
+		}
+}
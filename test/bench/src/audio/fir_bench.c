@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2018, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of the Intel Corporation nor the
+ *     names of its contributors may be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <sof/audio/format.h>
+#include <uapi/eq.h>
+#include "fir_config.h"
+#include "bench.h"
+
+#if FIR_GENERIC
+
+#include "fir.h"
+
+static const int fir_taps[] = {32, 128};
+
+struct fir_bench {
+	struct fir_state_32x16 fir[BENCH_MAX_CHANNELS];
+	struct comp_buffer *source;
+	struct comp_buffer *sink;
+	void (*func)(struct fir_state_32x16 fir[], struct comp_buffer *source,
+		     struct comp_buffer *sink, int frames, int nch);
+	int channels;
+	int frames;
+};
+
+static void fir_run(void *data)
+{
+	struct fir_bench *fb = data;
+
+	fb->func(fb->fir, fb->source, fb->sink, fb->frames, fb->channels);
+}
+
+/* low pass moving average scaled to Q1.15 */
+static struct sof_eq_fir_coef_data *fir_config_new(int taps)
+{
+	struct sof_eq_fir_coef_data *config;
+	int i;
+
+	config = malloc(sizeof(*config) + taps * sizeof(int16_t));
+	config->length = taps;
+	config->out_shift = 0;
+
+	for (i = 0; i < taps; i++)
+		config->coef[i] = INT16_MAX / taps;
+
+	return config;
+}
+
+static void fir_case(struct sof_eq_fir_coef_data *config,
+		     enum sof_ipc_frame fmt, int channels, int frames)
+{
+	struct bench_case bc;
+	struct fir_bench fb;
+	char variant[16];
+	int32_t *delay;
+	int32_t *d;
+	uint32_t size;
+	int ch;
+
+	switch (fmt) {
+	case SOF_IPC_FRAME_S16_LE:
+		fb.func = eq_fir_s16;
+		break;
+	case SOF_IPC_FRAME_S24_4LE:
+		fb.func = eq_fir_s24;
+		break;
+	default:
+		fb.func = eq_fir_s32;
+		break;
+	}
+
+	fb.channels = channels;
+	fb.frames = frames;
+	size = frames * channels * bench_sample_bytes(fmt);
+	fb.source = bench_buffer_new(size);
+	fb.sink = bench_buffer_new(size);
+	bench_buffer_fill(fb.source, fmt);
+
+	delay = calloc(channels * config->length, sizeof(int32_t));
+	d = delay;
+	for (ch = 0; ch < channels; ch++) {
+		fir_init_coef(&fb.fir[ch], config);
+		fir_init_delay(&fb.fir[ch], &d);
+	}
+
+	sprintf(variant, "%s/%dt", bench_format_name(fmt), config->length);
+	bc.kernel = "eq_fir";
+	bc.variant = variant;
+	bc.channels = channels;
+	bc.frames = frames;
+	bc.run = fir_run;
+	bc.data = &fb;
+	bench_run(&bc);
+
+	free(delay);
+	buffer_free(fb.source);
+	buffer_free(fb.sink);
+}
+
+void bench_fir(void)
+{
+	struct sof_eq_fir_coef_data *config;
+	int t, f, c, n;
+
+	if (bench_skip("eq_fir"))
+		return;
+
+	for (t = 0; t < ARRAY_SIZE(fir_taps); t++) {
+		config = fir_config_new(fir_taps[t]);
+
+		for (f = 0; f < bench_formats_count; f++)
+			for (c = 0; c < bench_channels_count; c++)
+				for (n = 0; n < bench_frames_count; n++)
+					fir_case(config, bench_formats[f],
+						 bench_channels[c],
+						 bench_frames[n]);
+
+		free(config);
+	}
+}
+
+#else
+
+/* optimized FIR variants use their own state layout */
+void bench_fir(void)
+{
+}
+
+#endif
@@ -0,0 +1,481 @@
+/*
+ * Copyright (c) 2018, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of the Intel Corporation nor the
+ *     names of its contributors may be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sof/list.h>
+#include <sof/dai.h>
+#include <sof/dma.h>
+#include <sof/math/numbers.h>
+#include <sof/audio/component.h>
+#include <sof/audio/buffer.h>
+#include <host/dai.h>
+#include <host/dma.h>
+#include "bench.h"
+
+/* one period of 48 frames of stereo S32_LE */
+#define HOST_BENCH_FRAMES	48
+#define HOST_BENCH_CHANNELS	2
+#define HOST_BENCH_PERIOD	(HOST_BENCH_FRAMES * HOST_BENCH_CHANNELS * 4)
+#define HOST_BENCH_PERIOD_US	1000
+
+/* host buffer pages */
+#define HOST_BENCH_PAGE		4096
+
+/* SSP frame rate and slots of the DAI pipeline */
+#define DAI_BENCH_RATE		48000
+#define DAI_BENCH_SLOTS		2
+
+struct host_bench {
+	struct comp_dev *dev;
+	struct comp_buffer *buffer;
+	struct dma_sg_elem_array pages;
+	uint32_t *host;		/* host buffer */
+	uint32_t host_size;
+	uint32_t host_pos;	/* host position of the next period */
+	int errors;
+	struct pipeline pipeline;
+};
+
+/* host to DAI playback pipeline */
+struct dai_bench {
+	struct host_bench hb;	/* errors count wrong line samples */
+	struct comp_dev *dev;
+	struct emu_dai_fifo *fifo;
+};
+
+/* virtual time of the emulated DMA in usecs, never goes back */
+static uint64_t host_bench_time;
+
+extern struct comp_driver comp_host;
+extern struct comp_driver comp_dai;
+
+/* host buffer of the given periods as pages, filled with a ramp */
+static int host_bench_pages(struct host_bench *hb, uint32_t periods)
+{
+	uint32_t offset;
+	int i;
+
+	hb->host_size = periods * HOST_BENCH_PERIOD;
+	hb->host = malloc(hb->host_size);
+	if (!hb->host)
+		return -ENOMEM;
+
+	for (i = 0; i < hb->host_size / sizeof(uint32_t); i++)
+		hb->host[i] = i;
+
+	hb->pages.count = (hb->host_size + HOST_BENCH_PAGE - 1) /
+		HOST_BENCH_PAGE;
+	hb->pages.elems = calloc(hb->pages.count, sizeof(*hb->pages.elems));
+	if (!hb->pages.elems)
+		return -ENOMEM;
+
+	for (i = 0, offset = 0; i < hb->pages.count; i++) {
+		hb->pages.elems[i].src = (uintptr_t)hb->host + offset;
+		hb->pages.elems[i].size = MIN(HOST_BENCH_PAGE,
+					      hb->host_size - offset);
+		offset += hb->pages.elems[i].size;
+	}
+
+	return 0;
+}
+
+/* playback host component feeding a two period buffer */
+static int host_bench_new(struct host_bench *hb, uint32_t periods)
+{
+	struct sof_ipc_comp_host ipc_host = {
+		.comp = {
+			.hdr.size = sizeof(ipc_host),
+			.id = 1,
+			.type = SOF_COMP_HOST,
+		},
+		.config = {
+			.periods_sink = 2,
+			.frame_fmt = SOF_IPC_FRAME_S32_LE,
+		},
+		.direction = SOF_IPC_STREAM_PLAYBACK,
+	};
+	struct comp_dev *dev;
+	int ret;
+
+	ret = host_bench_pages(hb, periods);
+	if (ret < 0)
+		return ret;
+
+	dev = comp_host.ops.new((struct sof_ipc_comp *)&ipc_host);
+	if (!dev)
+		return -ENOMEM;
+
+	hb->dev = dev;
+	dev->pipeline = &hb->pipeline;
+	hb->buffer = bench_buffer_new(HOST_BENCH_PERIOD * 2);
+	hb->buffer->source = dev;
+	list_init(&dev->bsink_list);
+	list_item_prepend(&hb->buffer->source_list, &dev->bsink_list);
+
+	dev->frames = HOST_BENCH_FRAMES;
+	dev->params.direction = SOF_IPC_STREAM_PLAYBACK;
+	dev->params.frame_fmt = SOF_IPC_FRAME_S32_LE;
+	dev->params.channels = HOST_BENCH_CHANNELS;
+	dev->params.buffer.size = hb->host_size;
+	dev->params.stream_tag = 1;
+
+	ret = comp_host.ops.host_buffer(dev, &hb->pages, hb->host_size);
+	if (ret < 0)
+		return ret;
+
+	ret = comp_host.ops.params(dev);
+	if (ret < 0)
+		return ret;
+
+	ret = comp_host.ops.prepare(dev);
+	if (ret < 0)
+		return ret;
+
+	dev->state = COMP_STATE_ACTIVE;
+	return 0;
+}
+
+/* copy a period, let the DMA complete it and consume it downstream */
+static void host_bench_run(void *data)
+{
+	struct host_bench *hb = data;
+	uint32_t *local = hb->buffer->r_ptr;
+	uint32_t *host = hb->host + hb->host_pos / sizeof(uint32_t);
+
+	comp_host.ops.copy(hb->dev);
+
+	host_bench_time += HOST_BENCH_PERIOD_US;
+	emu_dma_run(host_bench_time);
+
+	/* the pipeline walk syncs the period for the sink */
+	buffer_sync(hb->buffer);
+
+	if (hb->buffer->avail < HOST_BENCH_PERIOD ||
+	    memcmp(local, host, HOST_BENCH_PERIOD))
+		hb->errors++;
+
+	comp_update_buffer_consume(hb->buffer, HOST_BENCH_PERIOD);
+
+	hb->host_pos += HOST_BENCH_PERIOD;
+	if (hb->host_pos == hb->host_size)
+		hb->host_pos = 0;
+}
+
+/* stop mid stream, prepare again and check it restarts from the start */
+static int host_bench_restart(struct host_bench *hb, uint32_t periods)
+{
+	int errors;
+	int i;
+
+	/* stop away from the start of the host buffer */
+	for (i = 0; i < 3; i++)
+		host_bench_run(hb);
+
+	errors = hb->errors;
+	if (comp_host.ops.trigger(hb->dev, COMP_TRIGGER_STOP) < 0 ||
+	    comp_host.ops.prepare(hb->dev) < 0)
+		return -EINVAL;
+
+	buffer_reset_pos(hb->buffer);
+	hb->dev->state = COMP_STATE_ACTIVE;
+	hb->host_pos = 0;
+
+	for (i = 0; i < periods; i++)
+		host_bench_run(hb);
+
+	return hb->errors - errors;
+}
+
+static void host_bench_free(struct host_bench *hb)
+{
+	if (hb->dev)
+		comp_host.ops.free(hb->dev);
+	free(hb->pages.elems);
+	free(hb->host);
+}
+
+static void host_case(const char *variant, uint32_t periods)
+{
+	struct emu_dma_stats *stats;
+	struct emu_dma_stats start;
+	struct bench_case bc;
+	struct host_bench hb;
+	struct dma *dma;
+	double count;
+
+	memset(&hb, 0, sizeof(hb));
+	dma = dma_get(DMA_DIR_HMEM_TO_LMEM, 0, DMA_DEV_HOST,
+		      DMA_ACCESS_SHARED);
+	if (!dma || host_bench_new(&hb, periods) < 0) {
+		fprintf(stderr, "error: host %s setup\n", variant);
+		goto out;
+	}
+
+	stats = emu_dma_get_stats(dma);
+	start = *stats;
+
+	bc.kernel = "host_dma";
+	bc.variant = variant;
+	bc.channels = HOST_BENCH_CHANNELS;
+	bc.frames = HOST_BENCH_FRAMES;
+	bc.run = host_bench_run;
+	bc.data = &hb;
+	bench_run(&bc);
+
+	/* DMA driver calls per period */
+	count = (double)(stats->bytes - start.bytes) / HOST_BENCH_PERIOD;
+	printf("host_dma %s %u periods: %.2f configs %.2f starts "
+	       "%.2f restarts %.2f transfers per period, %d errors\n",
+	       variant, periods, (stats->configs - start.configs) / count,
+	       (stats->starts - start.starts) / count,
+	       (stats->copies - start.copies) / count,
+	       (stats->transfers - start.transfers) / count, hb.errors);
+
+	printf("host_dma %s restart: %d errors\n", variant,
+	       host_bench_restart(&hb, periods + 1));
+
+out:
+	host_bench_free(&hb);
+	if (dma)
+		dma_put(dma);
+}
+
+/* samples leaving the SSP must be the host ones, in order */
+static void dai_bench_line(void *data, void *samples, uint32_t bytes)
+{
+	struct host_bench *hb = data;
+	uint32_t *host = hb->host + hb->host_pos / sizeof(uint32_t);
+
+	if (bytes != HOST_BENCH_PERIOD || memcmp(samples, host, bytes))
+		hb->errors++;
+
+	hb->host_pos += HOST_BENCH_PERIOD;
+	if (hb->host_pos == hb->host_size)
+		hb->host_pos = 0;
+}
+
+/* pipeline copy scheduled by the DAI DMA callback, host then DAI */
+static void dai_bench_copy(struct pipeline *p)
+{
+	struct dai_bench *db = container_of(p, struct dai_bench, hb.pipeline);
+
+	comp_host.ops.copy(db->hb.dev);
+	comp_dai.ops.copy(db->dev);
+}
+
+/* SSP0 playback DAI sinking the host component buffer */
+static int dai_bench_new(struct dai_bench *db)
+{
+	struct sof_ipc_comp_dai ipc_dai = {
+		.comp = {
+			.hdr.size = sizeof(ipc_dai),
+			.id = 2,
+			.type = SOF_COMP_DAI,
+		},
+		.config = {
+			.frame_fmt = SOF_IPC_FRAME_S32_LE,
+		},
+		.direction = SOF_IPC_STREAM_PLAYBACK,
+		.type = SOF_DAI_INTEL_SSP,
+		.dai_index = 0,
+	};
+	struct sof_ipc_dai_config config = {
+		.type = SOF_DAI_INTEL_SSP,
+		.ssp = {
+			.fsync_rate = DAI_BENCH_RATE,
+			.tdm_slots = DAI_BENCH_SLOTS,
+			.sample_valid_bits = 32,
+		},
+	};
+	struct host_bench *hb = &db->hb;
+	struct comp_dev *dev;
+	struct dai *dai;
+	int ret;
+
+	dev = comp_dai.ops.new((struct sof_ipc_comp *)&ipc_dai);
+	if (!dev)
+		return -ENOMEM;
+
+	db->dev = dev;
+	dev->pipeline = &hb->pipeline;
+	list_init(&dev->bsource_list);
+	list_item_prepend(&hb->buffer->sink_list, &dev->bsource_list);
+	hb->buffer->sink = dev;
+
+	dev->frames = HOST_BENCH_FRAMES;
+	dev->params = hb->dev->params;
+
+	/* the IPC configures the SSP, then the component */
+	dai = dai_get(SOF_DAI_INTEL_SSP, 0, 0);
+	ret = dai_set_config(dai, &config);
+	db->fifo = emu_dai_get_fifo(dai, SOF_IPC_STREAM_PLAYBACK);
+	dai_put(dai);
+	if (ret < 0)
+		return ret;
+
+	ret = comp_dai.ops.dai_config(dev, &config);
+	if (ret < 0)
+		return ret;
+
+	ret = comp_dai.ops.params(dev);
+	if (ret < 0)
+		return ret;
+
+	ret = comp_dai.ops.prepare(dev);
+	if (ret < 0)
+		return ret;
+
+	db->fifo->line = dai_bench_line;
+	db->fifo->line_data = hb;
+
+	dev->state = COMP_STATE_ACTIVE;
+	return 0;
+}
+
+/* trigger like the IPC does and run the first pipeline copy */
+static int dai_bench_start(struct dai_bench *db)
+{
+	int ret;
+
+	/* preload the first period */
+	ret = comp_host.ops.trigger(db->hb.dev, COMP_TRIGGER_START);
+	if (ret < 0)
+		return ret;
+
+	ret = comp_dai.ops.trigger(db->dev, COMP_TRIGGER_START);
+	if (ret < 0)
+		return ret;
+
+	host_bench_time += HOST_BENCH_PERIOD_US;
+	emu_dma_run(host_bench_time);
+
+	/* the DAI starts on its first copy, DMA callbacks copy the rest */
+	bench_schedule_copy = dai_bench_copy;
+	dai_bench_copy(&db->hb.pipeline);
+	return 0;
+}
+
+/* one period goes out of the SSP */
+static void dai_bench_run(void *data)
+{
+	host_bench_time += HOST_BENCH_PERIOD_US;
+	emu_dma_run(host_bench_time);
+}
+
+static void dai_bench_free(struct dai_bench *db)
+{
+	bench_schedule_copy = NULL;
+
+	if (db->dev) {
+		comp_dai.ops.trigger(db->dev, COMP_TRIGGER_STOP);
+		comp_dai.ops.reset(db->dev);
+		comp_dai.ops.free(db->dev);
+	}
+
+	host_bench_free(&db->hb);
+}
+
+static void dai_case(const char *variant, uint32_t jitter)
+{
+	struct emu_dma_stats *stats;
+	struct emu_dma_stats start;
+	struct dai_bench db;
+	struct bench_case bc;
+	struct dma *dma;
+	int xruns = bench_xruns;
+	double count;
+
+	memset(&db, 0, sizeof(db));
+	dma = dma_get(DMA_DIR_MEM_TO_DEV, 0, DMA_DEV_SSP, DMA_ACCESS_SHARED);
+	if (!dma || host_bench_new(&db.hb, 16) < 0 ||
+	    dai_bench_new(&db) < 0) {
+		fprintf(stderr, "error: host_dai %s setup\n", variant);
+		goto out;
+	}
+
+	/* the same delays on every run */
+	emu_dma_set_jitter(jitter, 1);
+
+	stats = emu_dma_get_stats(dma);
+	start = *stats;
+
+	if (dai_bench_start(&db) < 0) {
+		fprintf(stderr, "error: host_dai %s start\n", variant);
+		goto out;
+	}
+
+	bc.kernel = "host_dai";
+	bc.variant = variant;
+	bc.channels = HOST_BENCH_CHANNELS;
+	bc.frames = HOST_BENCH_FRAMES;
+	bc.run = dai_bench_run;
+	bc.data = &db;
+	bench_run(&bc);
+
+	count = (double)(stats->bytes - start.bytes) / HOST_BENCH_PERIOD;
+	printf("host_dai %s: %.0f periods, %.1f us mean %u us max delay, "
+	       "%d xruns %d errors\n", variant, count,
+	       stats->jitter / count, stats->jitter_max,
+	       bench_xruns - xruns, db.hb.errors);
+
+out:
+	emu_dma_set_jitter(0, 1);
+	dai_bench_free(&db);
+	if (dma)
+		dma_put(dma);
+}
+
+/*
+ * Playback periods through host.c on the emulated DMA. A short host buffer
+ * fits the descriptor ring, a long one makes host.c program every period.
+ * The host_dai cases add dai.c on an emulated SSP paced by its frame
+ * clock, with DMA completions delayed by up to half and one and a half
+ * periods of injected jitter.
+ */
+void bench_host(void)
+{
+	if (bench_skip("host_dma") && bench_skip("host_dai"))
+		return;
+
+	emu_dma_init();
+	emu_dai_init();
+
+	if (!bench_skip("host_dma")) {
+		host_case("ring", 16);
+		host_case("reprogram", 320);
+	}
+
+	if (!bench_skip("host_dai")) {
+		dai_case("steady", 0);
+		dai_case("jitter500", HOST_BENCH_PERIOD_US / 2);
+		dai_case("jitter1500", HOST_BENCH_PERIOD_US * 3 / 2);
+	}
+}
@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) 2018, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of the Intel Corporation nor the
+ *     names of its contributors may be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <sof/audio/format.h>
+#include <uapi/eq.h>
+#include "iir.h"
+#include "bench.h"
+
+/* coefficients per biquad {a2, a1, b2, b1, b0, shift, gain} */
+#define IIR_BIQUAD_WORDS	7
+
+static const int iir_sections[] = {1, 4};
+
+struct iir_bench {
+	struct iir_state_df2t iir[BENCH_MAX_CHANNELS];
+	struct comp_buffer *source;
+	struct comp_buffer *sink;
+	enum sof_ipc_frame fmt;
+	int channels;
+	int frames;
+};
+
+/* same data path as the eq_iir sXX_default() copy functions */
+static void iir_run(void *data)
+{
+	struct iir_bench *ib = data;
+	int16_t *x16 = ib->source->r_ptr;
+	int16_t *y16 = ib->sink->w_ptr;
+	int32_t *x32 = ib->source->r_ptr;
+	int32_t *y32 = ib->sink->w_ptr;
+	int32_t z;
+	int nch = ib->channels;
+	int ch;
+	int i;
+
+	for (ch = 0; ch < nch; ch++) {
+		for (i = ch; i < ib->frames * nch; i += nch) {
+			switch (ib->fmt) {
+			case SOF_IPC_FRAME_S16_LE:
+				z = iir_df2t(&ib->iir[ch], x16[i] << 16);
+				y16[i] = sat_int16(Q_SHIFT_RND(z, 31, 15));
+				break;
+			case SOF_IPC_FRAME_S24_4LE:
+				z = iir_df2t(&ib->iir[ch], x32[i] << 8);
+				y32[i] = sat_int24(Q_SHIFT_RND(z, 31, 23));
+				break;
+			default:
+				y32[i] = iir_df2t(&ib->iir[ch], x32[i]);
+				break;
+			}
+		}
+	}
+}
+
+/* mildly low pass biquad in Q2.30 with unity gain */
+static struct sof_eq_iir_header_df2t *iir_config_new(int sections)
+{
+	struct sof_eq_iir_header_df2t *config;
+	int32_t *c;
+	int i;
+
+	config = malloc(sizeof(*config) +
+			sections * IIR_BIQUAD_WORDS * sizeof(int32_t));
+	config->num_sections = sections;
+	config->num_sections_in_series = sections;
+
+	for (i = 0; i < sections; i++) {
+		c = &config->biquads[i * IIR_BIQUAD_WORDS];
+		c[0] = -Q_CONVERT_FLOAT(0.2, 30);	/* a2 */
+		c[1] = Q_CONVERT_FLOAT(0.5, 30);	/* a1 */
+		c[2] = Q_CONVERT_FLOAT(0.175, 30);	/* b2 */
+		c[3] = Q_CONVERT_FLOAT(0.35, 30);	/* b1 */
+		c[4] = Q_CONVERT_FLOAT(0.175, 30);	/* b0 */
+		c[5] = 0;				/* shift */
+		c[6] = Q_CONVERT_FLOAT(1.0, 14);	/* gain */
+	}
+
+	return config;
+}
+
+static void iir_case(struct sof_eq_iir_header_df2t *config,
+		     enum sof_ipc_frame fmt, int channels, int frames)
+{
+	struct bench_case bc;
+	struct iir_bench ib;
+	char variant[16];
+	int64_t *delay;
+	int64_t *d;
+	uint32_t size;
+	int ch;
+
+	ib.fmt = fmt;
+	ib.channels = channels;
+	ib.frames = frames;
+	size = frames * channels * bench_sample_bytes(fmt);
+	ib.source = bench_buffer_new(size);
+	ib.sink = bench_buffer_new(size);
+	bench_buffer_fill(ib.source, fmt);
+
+	delay = calloc(channels * 2 * config->num_sections, sizeof(int64_t));
+	d = delay;
+	for (ch = 0; ch < channels; ch++) {
+		iir_init_coef_df2t(&ib.iir[ch], config);
+		iir_init_delay_df2t(&ib.iir[ch], &d);
+	}
+
+	sprintf(variant, "%s/%dbq", bench_format_name(fmt),
+		config->num_sections);
+	bc.kernel = "iir_df2t";
+	bc.variant = variant;
+	bc.channels = channels;
+	bc.frames = frames;
+	bc.run = iir_run;
+	bc.data = &ib;
+	bench_run(&bc);
+
+	free(delay);
+	buffer_free(ib.source);
+	buffer_free(ib.sink);
+}
+
+void bench_iir(void)
+{
+	struct sof_eq_iir_header_df2t *config;
+	int s, f, c, n;
+
+	if (bench_skip("iir_df2t"))
+		return;
+
+	for (s = 0; s < ARRAY_SIZE(iir_sections); s++) {
+		config = iir_config_new(iir_sections[s]);
+
+		for (f = 0; f < bench_formats_count; f++)
+			for (c = 0; c < bench_channels_count; c++)
+				for (n = 0; n < bench_frames_count; n++)
+					iir_case(config, bench_formats[f],
+						 bench_channels[c],
+						 bench_frames[n]);
+
+		free(config);
+	}
+}
@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) 2018, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of the Intel Corporation nor the
+ *     names of its contributors may be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sof/list.h>
+#include <sof/lock.h>
+#include <sof/audio/component.h>
+#include <sof/audio/format.h>
+#include "bench.h"
+
+/* mixer_copy() bails out at PLATFORM_MAX_STREAMS - 1 sources */
+#define MIXER_BENCH_MAX_SOURCES	3
+
+static const int mixer_sources[] = {1, 2, 3};
+static const int mixer_channels[] = {2, 4, 8};
+
+static struct comp_driver mixer_drv;
+
+/* the mixer registers itself here so the bench can reach its ops */
+int comp_register(struct comp_driver *drv)
+{
+	if (drv->type == SOF_COMP_MIXER)
+		memcpy(&mixer_drv, drv, sizeof(*drv));
+
+	return 0;
+}
+
+struct mixer_bench {
+	struct comp_dev *dev;
+	struct comp_dev upstream[MIXER_BENCH_MAX_SOURCES];
+	struct comp_dev downstream;
+	struct comp_buffer *source[MIXER_BENCH_MAX_SOURCES];
+	struct comp_buffer *sink;
+	uint32_t period_bytes;
+	int num_sources;
+};
+
+/* refill the sources and drain the sink around each mixer period */
+static void mixer_run(void *data)
+{
+	struct mixer_bench *mb = data;
+	int i;
+
+	for (i = 0; i < mb->num_sources; i++)
+		comp_update_buffer_produce(mb->source[i], mb->period_bytes);
+
+	mixer_drv.ops.copy(mb->dev);
+
+	comp_update_buffer_consume(mb->sink, mb->period_bytes);
+}
+
+static void mixer_case(int num_sources, int channels, int frames)
+{
+	struct sof_ipc_comp_mixer ipc_mixer = {
+		.comp = {
+			.type = SOF_COMP_MIXER,
+		},
+		.config = {
+			.periods_sink = 1,
+		},
+	};
+	struct bench_case bc;
+	struct mixer_bench mb;
+	char variant[16];
+	int i;
+
+	memset(&mb, 0, sizeof(mb));
+	mb.num_sources = num_sources;
+	mb.period_bytes = frames * channels * sizeof(int32_t);
+
+	mb.dev = mixer_drv.ops.new(&ipc_mixer.comp);
+	mb.dev->drv = &mixer_drv;
+	spinlock_init(&mb.dev->lock);
+	list_init(&mb.dev->bsource_list);
+	list_init(&mb.dev->bsink_list);
+
+	for (i = 0; i < num_sources; i++) {
+		mb.upstream[i].state = COMP_STATE_ACTIVE;
+		list_init(&mb.upstream[i].bsink_list);
+		mb.source[i] = bench_buffer_new(mb.period_bytes);
+		mb.source[i]->source = &mb.upstream[i];
+		mb.source[i]->sink = mb.dev;
+		bench_buffer_fill(mb.source[i], SOF_IPC_FRAME_S32_LE);
+		list_item_prepend(&mb.source[i]->source_list,
+				  &mb.upstream[i].bsink_list);
+		list_item_prepend(&mb.source[i]->sink_list,
+				  &mb.dev->bsource_list);
+	}
+
+	mb.sink = bench_buffer_new(mb.period_bytes);
+	mb.sink->source = mb.dev;
+	mb.sink->sink = &mb.downstream;
+	list_item_prepend(&mb.sink->source_list, &mb.dev->bsink_list);
+
+	mb.dev->params.frame_fmt = SOF_IPC_FRAME_S32_LE;
+	mb.dev->params.channels = channels;
+	mb.dev->frames = frames;
+	mixer_drv.ops.params(mb.dev);
+	mixer_drv.ops.prepare(mb.dev);
+	mb.dev->state = COMP_STATE_ACTIVE;
+
+	sprintf(variant, "s32/%dsrc", num_sources);
+	bc.kernel = "mix_n";
+	bc.variant = variant;
+	bc.channels = channels;
+	bc.frames = frames;
+	bc.run = mixer_run;
+	bc.data = &mb;
+	bench_run(&bc);
+
+	for (i = 0; i < num_sources; i++)
+		buffer_free(mb.source[i]);
+	buffer_free(mb.sink);
+	mixer_drv.ops.free(mb.dev);
+}
+
+void bench_mixer(void)
+{
+	int s, c, n;
+
+	if (bench_skip("mix_n"))
+		return;
+
+	sys_comp_mixer_init();
+
+	for (s = 0; s < ARRAY_SIZE(mixer_sources); s++)
+		for (c = 0; c < ARRAY_SIZE(mixer_channels); c++)
+			for (n = 0; n < bench_frames_count; n++)
+				mixer_case(mixer_sources[s],
+					   mixer_channels[c],
+					   bench_frames[n]);
+}
@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) 2018, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of the Intel Corporation nor the
+ *     names of its contributors may be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <sof/audio/format.h>
+#include "src_config.h"
+#include "src.h"
+#include "bench.h"
+
+#if SRC_SHORT
+typedef int16_t src_coef_t;
+#else
+typedef int32_t src_coef_t;
+#endif
+
+static src_coef_t coef_1_2[40] __attribute__((aligned(8)));
+static src_coef_t coef_2_1[40] __attribute__((aligned(8)));
+static src_coef_t coef_3_2[300] __attribute__((aligned(8)));
+
+/* stage geometries match the src_std_int32 conversions of the same ratio */
+static struct src_stage stage_1_2 = {
+	1, 0, 1, 40, 40, 2, 1, 0, 1, coef_1_2};
+static struct src_stage stage_2_1 = {
+	0, 1, 2, 20, 40, 1, 2, 0, 0, coef_2_1};
+static struct src_stage stage_3_2 = {
+	1, 2, 3, 100, 300, 2, 3, 0, 0, coef_3_2};
+
+static const struct {
+	const char *name;
+	struct src_stage *stage;
+	src_coef_t *coef;
+} src_stages[] = {
+	{"1:2", &stage_1_2, coef_1_2},
+	{"2:1", &stage_2_1, coef_2_1},
+	{"3:2", &stage_3_2, coef_3_2},
+};
+
+struct src_bench {
+	struct src_stage_prm prm;
+	struct src_state state;
+	struct comp_buffer *source;
+	struct comp_buffer *sink;
+	void (*func)(struct src_stage_prm *s);
+};
+
+static void src_run(void *data)
+{
+	struct src_bench *sb = data;
+
+	sb->prm.x_rptr = sb->source->addr;
+	sb->prm.y_wptr = sb->sink->addr;
+	sb->func(&sb->prm);
+}
+
+static void src_coef_init(src_coef_t *coef, int taps)
+{
+	int i;
+
+#if SRC_SHORT
+	for (i = 0; i < taps; i++)
+		coef[i] = INT16_MAX / taps;
+#else
+	for (i = 0; i < taps; i++)
+		coef[i] = INT32_MAX / taps;
+#endif
+}
+
+static void src_case(struct src_stage *stage, const char *name,
+		     enum sof_ipc_frame fmt, int channels, int frames)
+{
+	struct bench_case bc;
+	struct src_bench sb;
+	char variant[16];
+	int32_t *delay;
+	int times;
+
+	times = frames / stage->blk_in;
+	if (!times)
+		return;
+
+	sb.func = fmt == SOF_IPC_FRAME_S24_4LE ?
+		src_polyphase_stage_cir_s24 : src_polyphase_stage_cir;
+	sb.source = bench_buffer_new(times * stage->blk_in * channels *
+				     sizeof(int32_t));
+	sb.sink = bench_buffer_new(times * stage->blk_out * channels *
+				   sizeof(int32_t));
+	bench_buffer_fill(sb.source, fmt);
+
+	/* delay lines as sized by src_buffer_lengths() */
+	sb.state.fir_delay_size = channels * (stage->subfilter_length +
+		(stage->num_of_subfilters - 1) * stage->idm + stage->blk_in);
+	sb.state.out_delay_size = channels *
+		(1 + (stage->num_of_subfilters - 1) * stage->odm);
+	delay = calloc(sb.state.fir_delay_size + sb.state.out_delay_size,
+		       sizeof(int32_t));
+	sb.state.fir_delay = delay;
+	sb.state.out_delay = delay + sb.state.fir_delay_size;
+	sb.state.fir_wp = &sb.state.fir_delay[sb.state.fir_delay_size - 1];
+	sb.state.out_rp = sb.state.out_delay;
+
+	sb.prm.nch = channels;
+	sb.prm.times = times;
+	sb.prm.x_end_addr = sb.source->end_addr;
+	sb.prm.x_size = sb.source->size;
+	sb.prm.y_addr = sb.sink->addr;
+	sb.prm.y_end_addr = sb.sink->end_addr;
+	sb.prm.y_size = sb.sink->size;
+	sb.prm.state = &sb.state;
+	sb.prm.stage = stage;
+
+	sprintf(variant, "%s/%s", bench_format_name(fmt), name);
+	bc.kernel = "src_polyphase_stage_cir";
+	bc.variant = variant;
+	bc.channels = channels;
+	bc.frames = times * stage->blk_in;
+	bc.run = src_run;
+	bc.data = &sb;
+	bench_run(&bc);
+
+	free(delay);
+	buffer_free(sb.source);
+	buffer_free(sb.sink);
+}
+
+void bench_src(void)
+{
+	enum sof_ipc_frame fmts[] = {
+		SOF_IPC_FRAME_S24_4LE,
+		SOF_IPC_FRAME_S32_LE,
+	};
+	int s, f, c, n;
+
+	if (bench_skip("src_polyphase_stage_cir"))
+		return;
+
+	for (s = 0; s < ARRAY_SIZE(src_stages); s++) {
+		src_coef_init(src_stages[s].coef,
+			      src_stages[s].stage->filter_length);
+
+		for (f = 0; f < ARRAY_SIZE(fmts); f++)
+			for (c = 0; c < bench_channels_count; c++)
+				for (n = 0; n < bench_frames_count; n++)
+					src_case(src_stages[s].stage,
+						 src_stages[s].name, fmts[f],
+						 bench_channels[c],
+						 bench_frames[n]);
+	}
+}
@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2018, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of the Intel Corporation nor the
+ *     names of its contributors may be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <sof/audio/component.h>
+#include <sof/audio/format.h>
+#include "volume.h"
+#include "bench.h"
+
+static const int vol_channels[] = {2, 4, 8};
+
+struct vol_bench {
+	struct comp_dev *dev;
+	struct comp_data cd;
+	struct comp_buffer *source;
+	struct comp_buffer *sink;
+};
+
+static void vol_run(void *data)
+{
+	struct vol_bench *vb = data;
+
+	vb->cd.scale_vol(vb->dev, vb->sink, vb->source, vb->dev->frames);
+}
+
+static void vol_case(enum sof_ipc_frame source_fmt,
+		     enum sof_ipc_frame sink_fmt, int channels, int frames)
+{
+	struct bench_case bc;
+	struct vol_bench vb;
+	char variant[16];
+	int ch;
+
+	vb.dev = calloc(1, COMP_SIZE(struct sof_ipc_comp_volume));
+	vb.dev->params.channels = channels;
+	vb.dev->frames = frames;
+	comp_set_drvdata(vb.dev, &vb.cd);
+
+	vb.cd.source_format = source_fmt;
+	vb.cd.sink_format = sink_fmt;
+	for (ch = 0; ch < channels; ch++)
+		vb.cd.volume[ch] = VOL_ZERO_DB >> 1;
+
+	/* not every format and channel combination has a kernel */
+	vb.cd.scale_vol = vol_get_processing_function(vb.dev);
+	if (!vb.cd.scale_vol) {
+		free(vb.dev);
+		return;
+	}
+
+	vb.source = bench_buffer_new(frames * channels *
+				     bench_sample_bytes(source_fmt));
+	vb.sink = bench_buffer_new(frames * channels *
+				   bench_sample_bytes(sink_fmt));
+	bench_buffer_fill(vb.source, source_fmt);
+
+	sprintf(variant, "%s>%s", bench_format_name(source_fmt),
+		bench_format_name(sink_fmt));
+	bc.kernel = "vol_scale";
+	bc.variant = variant;
+	bc.channels = channels;
+	bc.frames = frames;
+	bc.run = vol_run;
+	bc.data = &vb;
+	bench_run(&bc);
+
+	buffer_free(vb.source);
+	buffer_free(vb.sink);
+	free(vb.dev);
+}
+
+void bench_volume(void)
+{
+	int i, o, c, n;
+
+	if (bench_skip("vol_scale"))
+		return;
+
+	for (i = 0; i < bench_formats_count; i++)
+		for (o = 0; o < bench_formats_count; o++)
+			for (c = 0; c < ARRAY_SIZE(vol_channels); c++)
+				for (n = 0; n < bench_frames_count; n++)
+					vol_case(bench_formats[i],
+						 bench_formats[o],
+						 vol_channels[c],
+						 bench_frames[n]);
+}
@@ -0,0 +1,235 @@
+/*
+ * Copyright (c) 2018, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of the Intel Corporation nor the
+ *     names of its contributors may be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * DSP kernel microbenchmarks.
+ *
+ * Each kernel is called in a tight loop on the same block of data until
+ * the minimum measuring time has passed. Results are reported as time per
+ * call, time per frame and frames per second for every swept combination
+ * of kernel variant, channel count and block size.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <getopt.h>
+#include <config.h>
+#include <sof/list.h>
+#include <sof/audio/component.h>
+#include <sof/audio/buffer.h>
+#include "bench.h"
+
+/* default minimum measuring time per case in ms */
+#define BENCH_MIN_TIME_MS	20
+
+const int bench_channels[] = {1, 2, 4, 8};
+const int bench_channels_count = ARRAY_SIZE(bench_channels);
+
+const int bench_frames[] = {16, 48, 192, 1024};
+const int bench_frames_count = ARRAY_SIZE(bench_frames);
+
+const enum sof_ipc_frame bench_formats[] = {
+	SOF_IPC_FRAME_S16_LE,
+	SOF_IPC_FRAME_S24_4LE,
+	SOF_IPC_FRAME_S32_LE,
+};
+const int bench_formats_count = ARRAY_SIZE(bench_formats);
+
+static uint64_t min_time_ns = BENCH_MIN_TIME_MS * 1000000ULL;
+static const char *kernel_filter;
+
+/* idle endpoint for buffers that are not connected to real components */
+static struct comp_dev bench_comp;
+
+static uint64_t bench_time_ns(void)
+{
+#ifdef CLOCK_MONOTONIC
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+#else
+	return (uint64_t)clock() * (1000000000ULL / CLOCKS_PER_SEC);
+#endif
+}
+
+int bench_skip(const char *kernel)
+{
+	return kernel_filter && !strstr(kernel, kernel_filter);
+}
+
+double bench_run(struct bench_case *bc)
+{
+	uint64_t iterations = 1;
+	uint64_t start;
+	uint64_t elapsed;
+	uint64_t i;
+	double ns_call;
+	double ns_frame;
+
+	if (bench_skip(bc->kernel))
+		return 0;
+
+	/* warm up caches and branch predictors */
+	bc->run(bc->data);
+
+	/* double the iteration count until the run is long enough */
+	for (;;) {
+		start = bench_time_ns();
+		for (i = 0; i < iterations; i++)
+			bc->run(bc->data);
+		elapsed = bench_time_ns() - start;
+
+		if (elapsed >= min_time_ns)
+			break;
+		iterations <<= 1;
+	}
+
+	ns_call = (double)elapsed / iterations;
+	ns_frame = ns_call / bc->frames;
+
+	printf("%-24s %-10s %3d %6d %12.1f %10.2f %14.0f\n",
+	       bc->kernel, bc->variant, bc->channels, bc->frames,
+	       ns_call, ns_frame, 1e9 / ns_frame);
+
+	return ns_call;
+}
+
+const char *bench_format_name(enum sof_ipc_frame fmt)
+{
+	switch (fmt) {
+	case SOF_IPC_FRAME_S16_LE:
+		return "s16";
+	case SOF_IPC_FRAME_S24_4LE:
+		return "s24";
+	case SOF_IPC_FRAME_S32_LE:
+		return "s32";
+	default:
+		return "unknown";
+	}
+}
+
+int bench_sample_bytes(enum sof_ipc_frame fmt)
+{
+	return fmt == SOF_IPC_FRAME_S16_LE ? 2 : 4;
+}
+
+struct comp_buffer *bench_buffer_new(uint32_t size)
+{
+	struct sof_ipc_buffer desc = {
+		.size = size,
+	};
+	struct comp_buffer *buffer;
+
+	buffer = buffer_new(&desc);
+	if (!buffer) {
+		fprintf(stderr, "error: buffer alloc %u bytes\n", size);
+		exit(EXIT_FAILURE);
+	}
+
+	list_init(&buffer->source_list);
+	list_init(&buffer->sink_list);
+	buffer->source = &bench_comp;
+	buffer->sink = &bench_comp;
+
+	return buffer;
+}
+
+/* fill with full scale pseudo random data, kept within format range */
+void bench_buffer_fill(struct comp_buffer *buffer, enum sof_ipc_frame fmt)
+{
+	int16_t *s16 = buffer->addr;
+	int32_t *s32 = buffer->addr;
+	uint32_t seed = 1;
+	int i;
+
+	for (i = 0; i < buffer->size / bench_sample_bytes(fmt); i++) {
+		seed = seed * 1664525 + 1013904223;
+		switch (fmt) {
+		case SOF_IPC_FRAME_S16_LE:
+			s16[i] = seed >> 16;
+			break;
+		case SOF_IPC_FRAME_S24_4LE:
+			s32[i] = (int32_t)seed >> 8;
+			break;
+		default:
+			s32[i] = seed;
+			break;
+		}
+	}
+}
+
+static void print_usage(char *executable)
+{
+	printf("Usage: %s [-k <kernel>] [-t <min_time_ms>]\n", executable);
+	printf("  -k  only run kernels whose name contains <kernel>\n");
+	printf("  -t  minimum measuring time per case, default %d ms\n",
+	       BENCH_MIN_TIME_MS);
+}
+
+int main(int argc, char **argv)
+{
+	int option;
+
+	while ((option = getopt(argc, argv, "hk:t:")) != -1) {
+		switch (option) {
+		case 'k':
+			kernel_filter = optarg;
+			break;
+		case 't':
+			min_time_ns = atoi(optarg) * 1000000ULL;
+			break;
+		case 'h':
+		default:
+			print_usage(argv[0]);
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	printf("%-24s %-10s %3s %6s %12s %10s %14s\n", "kernel", "variant",
+	       "ch", "frames", "ns/call", "ns/frame", "frames/s");
+
+	bench_iir();
+	bench_fir();
+	bench_src();
+	bench_volume();
+	bench_mixer();
+	bench_math();
+	bench_buffer();
+	bench_trace();
+	bench_ipc();
+	bench_host();
+#if defined(CONFIG_HOST)
+	bench_smp();
+#endif
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,251 @@
+/*
+ * Copyright (c) 2018, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of the Intel Corporation nor the
+ *     names of its contributors may be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Topology load replay. The messages a host sends to load a playback
+ * topology are built from the real IPC structures, then replayed either as
+ * one mailbox round trip per message or packed into compound messages that
+ * are run by the firmware compound handler. The per message handler only
+ * looks at the message, so the time measured is the cost of packing the
+ * mailbox and handling it. The host interrupt and wake up latency of a
+ * round trip can't be measured here and is not part of it.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sof/ipc.h>
+#include <sof/mailbox.h>
+#include <platform/mailbox.h>
+#include <uapi/ipc.h>
+#include "bench.h"
+
+extern struct ipc *_ipc;
+
+/* pipelines in the replayed topology */
+#define BENCH_IPC_PIPELINES	16
+
+/* host -> buffer -> volume -> buffer -> dai, plus the DAI config */
+#define BENCH_IPC_PIPE_MSGS	11
+#define BENCH_IPC_MSGS		(BENCH_IPC_PIPELINES * BENCH_IPC_PIPE_MSGS)
+
+/* inbox sizes, haswell and baytrail versus apollolake and cannonlake */
+static const uint32_t bench_mailbox_sizes[] = {1024, 8192};
+
+struct ipc_bench {
+	uint8_t msg[BENCH_IPC_MSGS][SOF_IPC_MSG_MAX_SIZE];
+	uint8_t comp_data[SOF_IPC_MSG_MAX_SIZE];
+	struct ipc ipc;
+	uint32_t mailbox_size;	/* 0 replays one message per round trip */
+	uint32_t round_trips;
+	uint32_t checksum;
+};
+
+static struct ipc_bench ipc_bench;
+
+/* host mailbox of the host builds, see platform/memory.h */
+uint8_t emu_hostbox[MAILBOX_HOSTBOX_SIZE];
+
+/* firmware side of one message, look at what was read into comp_data */
+int ipc_compound_cmd(uint32_t header)
+{
+	struct sof_ipc_hdr *hdr = ipc_bench.ipc.comp_data;
+
+	ipc_bench.checksum += header + hdr->size;
+	return 0;
+}
+
+static void ipc_msg_add(struct ipc_bench *ib, int *n, uint32_t cmd,
+			uint32_t size)
+{
+	struct sof_ipc_hdr *hdr = (struct sof_ipc_hdr *)ib->msg[*n];
+
+	memset(hdr, 0, size);
+	hdr->cmd = cmd;
+	hdr->size = size;
+	(*n)++;
+}
+
+static void ipc_connect_add(struct ipc_bench *ib, int *n, uint32_t source,
+			    uint32_t sink)
+{
+	struct sof_ipc_pipe_comp_connect *connect =
+		(struct sof_ipc_pipe_comp_connect *)ib->msg[*n];
+
+	ipc_msg_add(ib, n, SOF_IPC_GLB_TPLG_MSG | SOF_IPC_TPLG_COMP_CONNECT,
+		    sizeof(*connect));
+	connect->source_id = source;
+	connect->sink_id = sink;
+}
+
+static void ipc_topology_build(struct ipc_bench *ib)
+{
+	uint32_t tplg = SOF_IPC_GLB_TPLG_MSG;
+	uint32_t id;
+	int n = 0;
+	int p;
+
+	for (p = 0; p < BENCH_IPC_PIPELINES; p++) {
+		id = p * 8;
+		ipc_msg_add(ib, &n, tplg | SOF_IPC_TPLG_PIPE_NEW,
+			    sizeof(struct sof_ipc_pipe_new));
+		ipc_msg_add(ib, &n, tplg | SOF_IPC_TPLG_COMP_NEW,
+			    sizeof(struct sof_ipc_comp_host));
+		ipc_msg_add(ib, &n, tplg | SOF_IPC_TPLG_BUFFER_NEW,
+			    sizeof(struct sof_ipc_buffer));
+		ipc_msg_add(ib, &n, tplg | SOF_IPC_TPLG_COMP_NEW,
+			    sizeof(struct sof_ipc_comp_volume));
+		ipc_msg_add(ib, &n, tplg | SOF_IPC_TPLG_BUFFER_NEW,
+			    sizeof(struct sof_ipc_buffer));
+		ipc_msg_add(ib, &n, tplg | SOF_IPC_TPLG_COMP_NEW,
+			    sizeof(struct sof_ipc_comp_dai));
+		ipc_connect_add(ib, &n, id + 1, id + 2);
+		ipc_connect_add(ib, &n, id + 2, id + 3);
+		ipc_connect_add(ib, &n, id + 3, id + 4);
+		ipc_msg_add(ib, &n, SOF_IPC_GLB_DAI_MSG | SOF_IPC_DAI_CONFIG,
+			    sizeof(struct sof_ipc_dai_config));
+		ipc_msg_add(ib, &n, tplg | SOF_IPC_TPLG_PIPE_COMPLETE,
+			    sizeof(struct sof_ipc_pipe_ready));
+	}
+}
+
+/* one message per round trip, read like the firmware reads any message */
+static void ipc_replay_msg(struct ipc_bench *ib, struct sof_ipc_hdr *msg)
+{
+	struct sof_ipc_hdr *hdr = ib->ipc.comp_data;
+
+	mailbox_hostbox_write(0, msg, msg->size);
+
+	mailbox_hostbox_read(hdr, 0, sizeof(*hdr));
+	mailbox_hostbox_read(hdr + 1, sizeof(*hdr), hdr->size - sizeof(*hdr));
+	ipc_compound_cmd(hdr->cmd);
+
+	ib->round_trips++;
+}
+
+/* the host sends the compound packed so far, the firmware runs it */
+static void ipc_replay_compound(struct ipc_bench *ib, uint32_t count,
+				uint32_t size)
+{
+	struct sof_ipc_compound_hdr compound;
+	struct sof_ipc_hdr *hdr = ib->ipc.comp_data;
+
+	compound.hdr.cmd = SOF_IPC_GLB_COMPOUND;
+	compound.hdr.size = size;
+	compound.count = count;
+	mailbox_hostbox_write(0, &compound, sizeof(compound));
+
+	mailbox_hostbox_read(hdr, 0, sizeof(*hdr));
+	if (!ipc_compound_read(hdr))
+		ipc_glb_compound_message(hdr->cmd);
+
+	ib->round_trips++;
+}
+
+static void ipc_replay(void *data)
+{
+	struct ipc_bench *ib = data;
+	struct sof_ipc_hdr *hdr;
+	uint32_t offset = sizeof(struct sof_ipc_compound_hdr);
+	uint32_t count = 0;
+	uint32_t size;
+	int i;
+
+	ib->round_trips = 0;
+
+	for (i = 0; i < BENCH_IPC_MSGS; i++) {
+		hdr = (struct sof_ipc_hdr *)ib->msg[i];
+
+		if (!ib->mailbox_size) {
+			ipc_replay_msg(ib, hdr);
+			continue;
+		}
+
+		/* send what is packed so far when this message doesn't fit */
+		size = (hdr->size + 3) & ~3;
+		if (offset + size > ib->mailbox_size ||
+		    count == SOF_IPC_COMPOUND_MAX_COUNT) {
+			ipc_replay_compound(ib, count, offset);
+			offset = sizeof(struct sof_ipc_compound_hdr);
+			count = 0;
+		}
+
+		mailbox_hostbox_write(offset, hdr, hdr->size);
+		offset += size;
+		count++;
+	}
+
+	if (count)
+		ipc_replay_compound(ib, count, offset);
+}
+
+static void ipc_case(struct ipc_bench *ib, uint32_t mailbox_size)
+{
+	struct bench_case bc;
+	char variant[16];
+	double ns_call;
+
+	ib->mailbox_size = mailbox_size;
+	if (mailbox_size)
+		sprintf(variant, "cmpd%u", mailbox_size);
+	else
+		sprintf(variant, "single");
+
+	bc.kernel = "ipc_compound";
+	bc.variant = variant;
+	bc.channels = BENCH_IPC_PIPELINES;
+	bc.frames = BENCH_IPC_MSGS;
+	bc.run = ipc_replay;
+	bc.data = ib;
+	ns_call = bench_run(&bc);
+
+	printf("ipc_compound %-10s %u round trips, %.0f ns each\n",
+	       variant, ib->round_trips, ns_call / ib->round_trips);
+}
+
+/* channels are the pipelines, frames the replayed messages */
+void bench_ipc(void)
+{
+	struct ipc *ipc = _ipc;
+	int i;
+
+	if (bench_skip("ipc_compound"))
+		return;
+
+	ipc_topology_build(&ipc_bench);
+
+	/* the compound handler runs on the IPC context of the firmware */
+	ipc_bench.ipc.comp_data = ipc_bench.comp_data;
+	_ipc = &ipc_bench.ipc;
+
+	ipc_case(&ipc_bench, 0);
+	for (i = 0; i < ARRAY_SIZE(bench_mailbox_sizes); i++)
+		ipc_case(&ipc_bench, bench_mailbox_sizes[i]);
+
+	_ipc = ipc;
+}
@@ -0,0 +1,277 @@
+/*
+ * Copyright (c) 2018, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of the Intel Corporation nor the
+ *     names of its contributors may be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <inttypes.h>
+#include <sched.h>
+#include <sof/audio/component.h>
+#include <sof/audio/buffer.h>
+#include <sof/idc.h>
+#include <sof/schedule.h>
+#include <platform/platcfg.h>
+#include "volume.h"
+#include "host/cpu.h"
+#include "bench.h"
+
+/*
+ * Multicore benchmarks on the host core emulation, every slave core is a
+ * thread. Results depend on the host having a CPU per emulated core.
+ */
+
+/* frames in a period */
+#define SMP_BENCH_FRAMES	192
+
+/* periods a core processes per run when measuring scaling */
+#define SMP_BENCH_PERIODS	16
+
+#define SMP_BENCH_CHANNELS	2
+
+#define SMP_BENCH_FMT		SOF_IPC_FRAME_S32_LE
+
+/* volume component working on a slave core */
+struct smp_worker {
+	struct comp_dev *dev;
+	struct comp_data cd;
+	struct comp_buffer *source;
+	struct comp_buffer *sink;
+	struct task task;
+	uint32_t period_bytes;
+};
+
+struct smp_bench {
+	struct smp_worker workers[PLATFORM_CORE_COUNT];
+	int cores;
+};
+
+static uint32_t smp_buffer_free(struct comp_buffer *buffer)
+{
+	return __atomic_load_n(&buffer->free, __ATOMIC_ACQUIRE);
+}
+
+static uint32_t smp_buffer_avail(struct comp_buffer *buffer)
+{
+	return __atomic_load_n(&buffer->avail, __ATOMIC_ACQUIRE);
+}
+
+static void smp_scale(void *data)
+{
+	struct smp_worker *w = data;
+	int i;
+
+	for (i = 0; i < SMP_BENCH_PERIODS; i++)
+		w->cd.scale_vol(w->dev, w->sink, w->source, w->dev->frames);
+}
+
+/* one period into the shared buffer once the consumer made room */
+static void smp_produce(void *data)
+{
+	struct smp_worker *w = data;
+
+	while (smp_buffer_free(w->sink) < w->period_bytes)
+		sched_yield();
+
+	w->cd.scale_vol(w->dev, w->sink, w->source, w->dev->frames);
+	comp_update_buffer_produce(w->sink, w->period_bytes);
+}
+
+/* one period from the shared buffer once the producer wrote it */
+static void smp_consume(void *data)
+{
+	struct smp_worker *w = data;
+
+	while (smp_buffer_avail(w->source) < w->period_bytes)
+		sched_yield();
+
+	w->cd.scale_vol(w->dev, w->sink, w->source, w->dev->frames);
+	comp_update_buffer_consume(w->source, w->period_bytes);
+}
+
+static void smp_worker_init(struct smp_worker *w, int core,
+			    void (*func)(void *))
+{
+	int ch;
+
+	w->period_bytes = SMP_BENCH_FRAMES * SMP_BENCH_CHANNELS *
+		bench_sample_bytes(SMP_BENCH_FMT);
+
+	w->dev = calloc(1, COMP_SIZE(struct sof_ipc_comp_volume));
+	w->dev->params.channels = SMP_BENCH_CHANNELS;
+	w->dev->frames = SMP_BENCH_FRAMES;
+	comp_set_drvdata(w->dev, &w->cd);
+
+	w->cd.source_format = SMP_BENCH_FMT;
+	w->cd.sink_format = SMP_BENCH_FMT;
+	for (ch = 0; ch < SMP_BENCH_CHANNELS; ch++)
+		w->cd.volume[ch] = VOL_ZERO_DB >> 1;
+	w->cd.scale_vol = vol_get_processing_function(w->dev);
+
+	w->source = bench_buffer_new(w->period_bytes);
+	w->sink = bench_buffer_new(w->period_bytes);
+	bench_buffer_fill(w->source, SMP_BENCH_FMT);
+
+	schedule_task_init(&w->task, func, w);
+	schedule_task_config(&w->task, 0, core);
+}
+
+static void smp_worker_free(struct smp_worker *w)
+{
+	buffer_free(w->source);
+	buffer_free(w->sink);
+	free(w->dev);
+}
+
+static void smp_run(void *data)
+{
+	struct smp_bench *sb = data;
+	int i;
+
+	for (i = 0; i < sb->cores; i++)
+		emu_cpu_schedule(&sb->workers[i].task);
+
+	for (i = 0; i < sb->cores; i++)
+		emu_cpu_wait_idle(sb->workers[i].task.core);
+}
+
+static void idc_run(void *data)
+{
+	struct idc_msg msg = { IDC_MSG_NOTIFY, IDC_MSG_NOTIFY_EXT, 1 };
+
+	emu_idc_send_msg(&msg, IDC_BLOCKING);
+}
+
+/* same work on every core, frames are the total of all cores */
+static void smp_scale_case(struct smp_bench *sb, int cores)
+{
+	struct bench_case bc;
+	char variant[16];
+
+	sb->cores = cores;
+
+	sprintf(variant, "%d core%s", cores, cores > 1 ? "s" : "");
+	bc.kernel = "smp_vol";
+	bc.variant = variant;
+	bc.channels = SMP_BENCH_CHANNELS;
+	bc.frames = cores * SMP_BENCH_PERIODS * SMP_BENCH_FRAMES;
+	bc.run = smp_run;
+	bc.data = sb;
+	bench_run(&bc);
+}
+
+/* a period handed from core 1 to core 2 through a shared buffer */
+static void smp_buffer_case(struct smp_bench *sb)
+{
+	struct smp_worker *producer = &sb->workers[0];
+	struct smp_worker *consumer = &sb->workers[1];
+	struct comp_buffer *shared;
+	struct bench_case bc;
+
+	smp_worker_init(producer, 1, smp_produce);
+	smp_worker_init(consumer, 2, smp_consume);
+
+	shared = bench_buffer_new(producer->period_bytes * 2);
+	buffer_free(producer->sink);
+	buffer_free(consumer->source);
+	producer->sink = shared;
+	consumer->source = shared;
+
+	sb->cores = 2;
+
+	bc.kernel = "smp_buffer";
+	bc.variant = "1>2";
+	bc.channels = SMP_BENCH_CHANNELS;
+	bc.frames = SMP_BENCH_FRAMES;
+	bc.run = smp_run;
+	bc.data = sb;
+	bench_run(&bc);
+
+	buffer_free(producer->source);
+	buffer_free(shared);
+	buffer_free(consumer->sink);
+	free(producer->dev);
+	free(consumer->dev);
+}
+
+static void smp_idc_case(void)
+{
+	struct emu_idc_stats *stats;
+	struct bench_case bc;
+
+	stats = emu_idc_get_stats(PLATFORM_MASTER_CORE_ID);
+	*stats = (struct emu_idc_stats){ 0 };
+
+	bc.kernel = "smp_idc";
+	bc.variant = "0>1";
+	bc.channels = 1;
+	bc.frames = 1;
+	bc.run = idc_run;
+	bc.data = NULL;
+	bench_run(&bc);
+
+	printf("smp_idc %" PRIu64 " round trips, max %.2f us, %" PRIu64
+	       " timeouts\n", stats->msgs, stats->max_ns / 1e3,
+	       stats->timeouts);
+}
+
+void bench_smp(void)
+{
+	struct smp_bench sb;
+	int i;
+
+	if (bench_skip("smp_vol") && bench_skip("smp_buffer") &&
+	    bench_skip("smp_idc"))
+		return;
+
+	for (i = 1; i < PLATFORM_CORE_COUNT; i++)
+		emu_cpu_enable_core(i);
+
+	if (!bench_skip("smp_vol")) {
+		for (i = 1; i < PLATFORM_CORE_COUNT; i++)
+			smp_worker_init(&sb.workers[i - 1], i, smp_scale);
+
+		for (i = 1; i < PLATFORM_CORE_COUNT; i++)
+			smp_scale_case(&sb, i);
+
+		for (i = 1; i < PLATFORM_CORE_COUNT; i++)
+			smp_worker_free(&sb.workers[i - 1]);
+	}
+
+	if (!bench_skip("smp_buffer") && PLATFORM_CORE_COUNT > 2)
+		smp_buffer_case(&sb);
+
+	if (!bench_skip("smp_idc"))
+		smp_idc_case();
+
+	for (i = 1; i < PLATFORM_CORE_COUNT; i++)
+		emu_cpu_disable_core(i);
+}
@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) 2018, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of the Intel Corporation nor the
+ *     names of its contributors may be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <sof/sof.h>
+#include <sof/dma-trace.h>
+#include <platform/memory.h>
+#include <uapi/logging.h>
+#include "bench.h"
+
+/* events logged between two trace work runs */
+#define TRACE_BENCH_EVENTS	64
+
+/* log entry with two parameters, as written by _trace_event2() */
+struct trace_bench_entry {
+	struct log_entry_header header;
+	uint32_t log_entry;
+	uint32_t params[2];
+} __attribute__((packed));
+
+struct trace_bench {
+	struct dma_trace_data *d;
+	struct trace_bench_entry entry;
+	uint32_t seed;
+	int cores;
+};
+
+static struct sof sof;
+
+/*
+ * Events round robin over the cores. Time moves by up to 4k ticks between
+ * events, the parameters are a small id and a full 32 bit value.
+ */
+static void trace_log(struct trace_bench *tb)
+{
+	int i;
+
+	for (i = 0; i < TRACE_BENCH_EVENTS; i++) {
+		tb->seed = tb->seed * 1664525 + 1013904223;
+		bench_cpu_id = i % tb->cores;
+		tb->entry.header.core_id = bench_cpu_id;
+		tb->entry.header.timestamp += tb->seed >> 20;
+		tb->entry.log_entry = LOG_ENTRY_ELF_BASE + (tb->seed & 0x3ffc);
+		tb->entry.params[0] = i;
+		tb->entry.params[1] = tb->seed;
+		dtrace_event((const char *)&tb->entry, sizeof(tb->entry));
+	}
+
+	bench_cpu_id = PLATFORM_MASTER_CORE_ID;
+}
+
+/* log, then let the master drain the rings and copy to the host */
+static void trace_run(void *data)
+{
+	struct trace_bench *tb = data;
+	struct dma_trace_data *d = tb->d;
+
+	trace_log(tb);
+	d->dmat_work.cb(d->dmat_work.cb_data, 0);
+}
+
+/* events that fit in the local DMA buffer, compact against full entries */
+static void trace_density(struct dma_trace_data *d)
+{
+	struct trace_bench tb = {
+		.d = d,
+		.seed = 1,
+		.cores = 1,
+	};
+	char flush[DMA_FLUSH_TRACE_SIZE];
+	uint32_t avail;
+
+	/* empty the buffer, then drain one burst without copying it */
+	d->dmat_work.cb(d->dmat_work.cb_data, 0);
+	avail = d->dmatb.avail;
+	trace_log(&tb);
+	dma_trace_flush(flush);
+	avail = d->dmatb.avail - avail;
+	d->dmat_work.cb(d->dmat_work.cb_data, 0);
+
+	printf("dtrace_event %d byte entries take %.1f bytes, "
+	       "%u vs %u per %u byte buffer\n", (int)sizeof(tb.entry),
+	       (double)avail / TRACE_BENCH_EVENTS,
+	       DMA_TRACE_LOCAL_SIZE * TRACE_BENCH_EVENTS / avail,
+	       DMA_TRACE_LOCAL_SIZE / (uint32_t)sizeof(tb.entry),
+	       DMA_TRACE_LOCAL_SIZE);
+}
+
+static void trace_case(struct dma_trace_data *d, int cores)
+{
+	struct bench_case bc;
+	struct trace_bench tb = {
+		.d = d,
+		.seed = 1,
+		.cores = cores,
+	};
+
+	bc.kernel = "dtrace_event";
+	bc.variant = "ring";
+	bc.channels = cores;
+	bc.frames = TRACE_BENCH_EVENTS;
+	bc.run = trace_run;
+	bc.data = &tb;
+	bench_run(&bc);
+}
+
+/* channels are the simulated cores, frames the events per drain */
+void bench_trace(void)
+{
+	struct dma_trace_data *d;
+
+	if (bench_skip("dtrace_event"))
+		return;
+
+	dma_trace_init_early(&sof);
+	d = sof.dmat;
+	if (dma_trace_init_complete(d) < 0)
+		return;
+
+	d->host_size = DMA_TRACE_LOCAL_SIZE * 4;
+	if (dma_trace_enable(d) < 0) {
+		fprintf(stderr, "error: dma trace enable\n");
+		return;
+	}
+
+	trace_case(d, 1);
+	if (PLATFORM_CORE_COUNT >= 4)
+		trace_case(d, 4);
+
+	trace_density(d);
+
+	printf("dtrace_event %u flushes of %u bytes on average\n",
+	       d->flushes, d->flushes ? d->bytes / d->flushes : 0);
+}
@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2018, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of the Intel Corporation nor the
+ *     names of its contributors may be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <sof/audio/component.h>
+#include <sof/audio/format.h>
+#include <sof/math/trig.h>
+#include <sof/math/numbers.h>
+#include "bench.h"
+
+struct math_bench {
+	int32_t *in;
+	int frames;
+	volatile int32_t out;
+};
+
+static void sin_run(void *data)
+{
+	struct math_bench *mb = data;
+	int32_t acc = 0;
+	int i;
+
+	for (i = 0; i < mb->frames; i++)
+		acc += sin_fixed(mb->in[i]);
+
+	mb->out = acc;
+}
+
+static void norm_run(void *data)
+{
+	struct math_bench *mb = data;
+	int32_t acc = 0;
+	int i;
+
+	for (i = 0; i < mb->frames; i++)
+		acc += norm_int32(mb->in[i]);
+
+	mb->out = acc;
+}
+
+static void math_case(const char *kernel, void (*run)(void *data),
+		      int32_t step, int frames)
+{
+	struct bench_case bc;
+	struct math_bench mb;
+	int i;
+
+	mb.frames = frames;
+	mb.in = malloc(frames * sizeof(int32_t));
+	for (i = 0; i < frames; i++)
+		mb.in[i] = i * step;
+
+	bc.kernel = kernel;
+	bc.variant = "q31";
+	bc.channels = 1;
+	bc.frames = frames;
+	bc.run = run;
+	bc.data = &mb;
+	bench_run(&bc);
+
+	free(mb.in);
+}
+
+void bench_math(void)
+{
+	int n;
+
+	for (n = 0; n < bench_frames_count; n++) {
+		/* sweep the angle over 0 ... 2pi in Q4.28 */
+		math_case("sin_fixed", sin_run,
+			  Q_CONVERT_FLOAT(6.2831853, 28) / bench_frames[n],
+			  bench_frames[n]);
+		math_case("norm_int32", norm_run,
+			  INT32_MAX / bench_frames[n], bench_frames[n]);
+	}
+}
@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2018, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of the Intel Corporation nor the
+ *     names of its contributors may be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdint.h>
+#include <sof/audio/component.h>
+#include <sof/audio/pipeline.h>
+#include <sof/dma.h>
+#include <sof/ipc.h>
+#include <sof/work.h>
+#include "bench.h"
+
+/* core the benchmark currently acts as, see include/arch/cpu.h */
+int bench_cpu_id;
+
+/* pipeline xruns reported by components */
+int bench_xruns;
+
+/* runs the pipeline copy scheduled by a component, if set */
+void (*bench_schedule_copy)(struct pipeline *p);
+
+void pipeline_xrun(struct pipeline *p, struct comp_dev *dev, int32_t bytes)
+{
+	bench_xruns++;
+}
+
+/* copies run at once, in the context of the DMA callback */
+void pipeline_schedule_copy(struct pipeline *p, uint64_t start)
+{
+	if (bench_schedule_copy)
+		bench_schedule_copy(p);
+}
+
+/* bench pipelines have no deadline, so they are never low latency */
+uint32_t pipeline_ll_periods(struct sof_ipc_pipe_new *pipe_desc)
+{
+	return 0;
+}
+
+int comp_set_state(struct comp_dev *dev, int cmd)
+{
+	return 0;
+}
+
+/* trace DMA copies go nowhere, only the local bookkeeping is measured */
+int dma_copy_new(struct dma_copy *dc)
+{
+	static struct dma dma;
+
+	dc->dmac = &dma;
+	dc->chan = 0;
+
+	return 0;
+}
+
+int dma_copy_to_host_nowait(struct dma_copy *dc, struct dma_sg_config *host_sg,
+			    int32_t host_offset, void *local_ptr, int32_t size)
+{
+	return size;
+}
+
+int ipc_dma_trace_send_position(void)
+{
+	return 0;
+}
+
+/* host positions are not reported */
+void pipeline_get_timestamp(struct pipeline *p, struct comp_dev *host_dev,
+			    struct sof_ipc_stream_posn *posn)
+{
+}
+
+int ipc_stream_send_position(struct comp_dev *cdev,
+			     struct sof_ipc_stream_posn *posn)
+{
+	return 0;
+}
+
+void ipc_stream_publish_position(struct comp_dev *cdev,
+				 struct sof_ipc_stream_posn *posn)
+{
+}
+
+void work_schedule_default(struct work *work, uint64_t timeout)
+{
+}
+
+void work_reschedule_default(struct work *work, uint64_t timeout)
+{
+}
+
+/* IDC messages in the SMP benchmarks don't address components */
+struct ipc *_ipc;
+
+struct ipc_comp_dev *ipc_get_comp(struct ipc *ipc, uint32_t id)
+{
+	return NULL;
+}
+
+int pipeline_trigger(struct pipeline *p, struct comp_dev *host_cd, int cmd)
+{
+	return 0;
+}
+
+void pipeline_cache(struct pipeline *p, struct comp_dev *dev, int cmd)
+{
+}
+
+int pipeline_migrate_out(struct pipeline *p, int core)
+{
+	return 0;
+}
+
+int pipeline_migrate_in(struct pipeline *p)
+{
+	return 0;
+}
@@ -158,6 +158,154 @@ static void test_audio_buffer_copy_fit_no_space_constraint(void **state)
 	buffer_free(snk);
 }
 
+static void test_audio_buffer_copy_frames_sink_constraint(void **state)
+{
+	(void)state;
+
+	struct sof_ipc_buffer test_buf_desc = {
+		.size = 256
+	};
+
+	struct comp_dev dev = { 0 };
+	struct comp_buffer *src = buffer_new(&test_buf_desc);
+	struct comp_buffer *snk = buffer_new(&test_buf_desc);
+
+	assert_non_null(src);
+	assert_non_null(snk);
+	src->source = src->sink = &dev;
+	snk->source = snk->sink = &dev;
+
+	/* 4 byte source frames, 8 byte sink frames */
+	comp_update_buffer_produce(src, 18);
+	comp_update_buffer_produce(snk, 232);
+
+	assert_int_equal(src->avail, 18);
+	assert_int_equal(snk->free, 24);
+	assert_int_equal(comp_buffer_get_copy_frames(src, 4, snk, 8), 3);
+
+	buffer_free(src);
+	buffer_free(snk);
+}
+
+static void test_audio_buffer_copy_frames_partial_frame(void **state)
+{
+	(void)state;
+
+	struct sof_ipc_buffer test_buf_desc = {
+		.size = 256
+	};
+
+	struct comp_dev dev = { 0 };
+	struct comp_buffer *src = buffer_new(&test_buf_desc);
+	struct comp_buffer *snk = buffer_new(&test_buf_desc);
+
+	assert_non_null(src);
+	assert_non_null(snk);
+	src->source = src->sink = &dev;
+	snk->source = snk->sink = &dev;
+
+	comp_update_buffer_produce(src, 3);
+
+	assert_int_equal(src->avail, 3);
+	assert_int_equal(comp_buffer_get_copy_frames(src, 4, snk, 4), 0);
+
+	buffer_free(src);
+	buffer_free(snk);
+}
+
+static void test_audio_buffer_copy_contig_source_wrap(void **state)
+{
+	(void)state;
+
+	struct sof_ipc_buffer test_buf_desc = {
+		.size = 256
+	};
+
+	struct comp_dev dev = { 0 };
+	struct comp_buffer *src = buffer_new(&test_buf_desc);
+	struct comp_buffer *snk = buffer_new(&test_buf_desc);
+	uint32_t frames;
+
+	assert_non_null(src);
+	assert_non_null(snk);
+	src->source = src->sink = &dev;
+	snk->source = snk->sink = &dev;
+
+	/* move the source read pointer 2 frames before the end */
+	comp_update_buffer_produce(src, 248);
+	comp_update_buffer_consume(src, 248);
+	comp_update_buffer_produce(src, 16);
+
+	frames = comp_buffer_get_copy_frames(src, 4, snk, 8);
+	assert_int_equal(frames, 4);
+	assert_int_equal(comp_buffer_get_contig_frames(src, 4, snk, 8, frames),
+			 2);
+
+	/* the rest is contiguous after the read pointer wraps */
+	comp_update_buffer_consume(src, 8);
+	comp_update_buffer_produce(snk, 16);
+
+	assert_ptr_equal(src->r_ptr, src->addr);
+	assert_int_equal(comp_buffer_get_contig_frames(src, 4, snk, 8, 2), 2);
+
+	buffer_free(src);
+	buffer_free(snk);
+}
+
+static void test_audio_buffer_copy_contig_sink_wrap(void **state)
+{
+	(void)state;
+
+	struct sof_ipc_buffer test_buf_desc = {
+		.size = 256
+	};
+
+	struct comp_dev dev = { 0 };
+	struct comp_buffer *src = buffer_new(&test_buf_desc);
+	struct comp_buffer *snk = buffer_new(&test_buf_desc);
+	uint32_t frames;
+
+	assert_non_null(src);
+	assert_non_null(snk);
+	src->source = src->sink = &dev;
+	snk->source = snk->sink = &dev;
+
+	/* move the sink write pointer 2 frames before the end */
+	comp_update_buffer_produce(snk, 240);
+	comp_update_buffer_consume(snk, 240);
+	comp_update_buffer_produce(src, 64);
+
+	frames = comp_buffer_get_copy_frames(src, 4, snk, 8);
+	assert_int_equal(frames, 16);
+	assert_int_equal(comp_buffer_get_contig_frames(src, 4, snk, 8, frames),
+			 2);
+
+	buffer_free(src);
+	buffer_free(snk);
+}
+
+static void test_audio_buffer_copy_check_frames(void **state)
+{
+	(void)state;
+
+	struct sof_ipc_buffer test_buf_desc = {
+		.size = 256
+	};
+
+	struct comp_buffer *buf = buffer_new(&test_buf_desc);
+
+	assert_non_null(buf);
+
+	/* a source without a frame size is not checked */
+	assert_int_equal(comp_buffer_check_frames(buf, 0), 0);
+	assert_int_equal(comp_buffer_check_frames(buf, 8), 0);
+
+	/* 6 channels of 16 bit leave 4 bytes before the end */
+	assert_int_equal(comp_buffer_check_frames(buf, 12), -EINVAL);
+
+	buffer_free(buf);
+}
+
 int main(void)
 {
 	const struct CMUnitTest tests[] = {
@@ -165,7 +313,12 @@ int main(void)
 		cmocka_unit_test(test_audio_buffer_copy_overrun),
 		cmocka_unit_test(test_audio_buffer_copy_success),
 		cmocka_unit_test(test_audio_buffer_copy_fit_space_constraint),
-		cmocka_unit_test(test_audio_buffer_copy_fit_no_space_constraint)
+		cmocka_unit_test(test_audio_buffer_copy_fit_no_space_constraint),
+		cmocka_unit_test(test_audio_buffer_copy_frames_sink_constraint),
+		cmocka_unit_test(test_audio_buffer_copy_frames_partial_frame),
+		cmocka_unit_test(test_audio_buffer_copy_contig_source_wrap),
+		cmocka_unit_test(test_audio_buffer_copy_contig_sink_wrap),
+		cmocka_unit_test(test_audio_buffer_copy_check_frames)
 	};
 
 	cmocka_set_message_output(CM_OUTPUT_TAP);
@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2018, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of the Intel Corporation nor the
+ *     names of its contributors may be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <sof/audio/component.h>
+#include <sof/audio/buffer.h>
+#include <sof/ipc.h>
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+static struct comp_dev cpu_comp;
+static struct comp_dev dma_comp = {
+	.is_dma_connected = 1,
+};
+
+static struct comp_buffer *buffer_sync_new(struct comp_dev *source,
+					   struct comp_dev *sink)
+{
+	struct sof_ipc_buffer test_buf_desc = {
+		.size = 10
+	};
+	struct comp_buffer *buf = buffer_new(&test_buf_desc);
+
+	assert_non_null(buf);
+	buf->source = source;
+	buf->sink = sink;
+
+	return buf;
+}
+
+static void test_audio_buffer_sync_accumulates_wrapped_region(void **state)
+{
+	(void)state;
+
+	struct comp_buffer *buf = buffer_sync_new(&cpu_comp, &dma_comp);
+
+	comp_update_buffer_produce(buf, 6);
+	comp_update_buffer_consume(buf, 6);
+	assert_int_equal(buf->sync_bytes, 6);
+	assert_ptr_equal(buf->sync_ptr, buf->addr);
+
+	/* the second produce wraps, the region keeps its start */
+	comp_update_buffer_produce(buf, 6);
+	assert_int_equal(buf->sync_bytes, 10);
+	assert_ptr_equal(buf->sync_ptr, buf->addr);
+
+	buffer_sync(buf);
+	assert_int_equal(buf->sync_bytes, 0);
+
+	/* the next region starts at the write pointer */
+	comp_update_buffer_consume(buf, 6);
+	comp_update_buffer_produce(buf, 3);
+	assert_int_equal(buf->sync_bytes, 3);
+	assert_ptr_equal(buf->sync_ptr, (char *)buf->addr + 2);
+
+	buffer_free(buf);
+}
+
+static void test_audio_buffer_sync_skips_cpu_buffers(void **state)
+{
+	(void)state;
+
+	struct comp_buffer *buf = buffer_sync_new(&cpu_comp, &cpu_comp);
+
+	comp_update_buffer_produce(buf, 5);
+	assert_int_equal(buf->sync_bytes, 0);
+
+	buffer_free(buf);
+
+	buf = buffer_sync_new(&dma_comp, &dma_comp);
+
+	comp_update_buffer_produce(buf, 5);
+	assert_int_equal(buf->sync_bytes, 0);
+
+	buffer_free(buf);
+}
+
+static void test_audio_buffer_sync_reset_pos(void **state)
+{
+	(void)state;
+
+	struct comp_buffer *buf = buffer_sync_new(&dma_comp, &cpu_comp);
+
+	comp_update_buffer_produce(buf, 5);
+	assert_int_equal(buf->sync_bytes, 5);
+
+	buffer_reset_pos(buf);
+	assert_int_equal(buf->sync_bytes, 0);
+
+	buffer_free(buf);
+}
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test
+			(test_audio_buffer_sync_accumulates_wrapped_region),
+		cmocka_unit_test(test_audio_buffer_sync_skips_cpu_buffers),
+		cmocka_unit_test(test_audio_buffer_sync_reset_pos),
+	};
+
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -34,6 +34,9 @@
 #include <sof/alloc.h>
 #include <sof/trace.h>
 
+/* trace filter of the call sites, all classes off */
+struct trace_filter trace_filter;
+
 void _trace_event0(uint32_t log_entry)
 {
 	(void)log_entry;
@@ -56,12 +59,38 @@ void _trace_event_mbox_atomic1(uint32_t log_entry, uint32_t param)
 	(void)param;
 }
 
+void _trace_event2(uint32_t log_entry, uint32_t param1, uint32_t param2)
+{
+	(void)log_entry;
+	(void)param1;
+	(void)param2;
+}
+
+void _trace_event_mbox_atomic2(uint32_t log_entry, uint32_t param1,
+			       uint32_t param2)
+{
+	(void)log_entry;
+	(void)param1;
+	(void)param2;
+}
+
+void _trace_event_mbox_atomic4(uint32_t log_entry, uint32_t param1,
+			       uint32_t param2, uint32_t param3,
+			       uint32_t param4)
+{
+	(void)log_entry;
+	(void)param1;
+	(void)param2;
+	(void)param3;
+	(void)param4;
+}
+
 void *rzalloc(int zone, uint32_t caps, size_t bytes)
 {
 	(void)zone;
 	(void)caps;
 
-	return malloc(bytes);
+	return calloc(bytes, 1);
 }
 
 void *rballoc(int zone, uint32_t caps, size_t bytes)
@@ -72,7 +101,20 @@ void *rballoc(int zone, uint32_t caps, size_t bytes)
 	return malloc(bytes);
 }
 
+void *rzalloc_slab(int zone, int slab, size_t bytes)
+{
+	(void)zone;
+	(void)slab;
+
+	return calloc(bytes, 1);
+}
+
 void rfree(void *ptr)
 {
 	free(ptr);
 }
+
+void mm_pm_dirty(void *ptr)
+{
+	(void)ptr;
+}
@@ -34,6 +34,9 @@
 #include <sof/alloc.h>
 #include <sof/trace.h>
 
+/* trace filter of the call sites, all classes off */
+struct trace_filter trace_filter;
+
 void _trace_event0(uint32_t log_entry)
 {
 	(void)log_entry;
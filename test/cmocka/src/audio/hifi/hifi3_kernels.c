@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2018, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of the Intel Corporation nor the
+ *     names of its contributors may be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* HiFi3 kernels built with the host emulation of the intrinsics */
+
+#define OPS_HIFI3_EMU
+
+#define fir_reset hifi3_fir_reset
+#define fir_init_coef hifi3_fir_init_coef
+#define fir_init_delay hifi3_fir_init_delay
+#define fir_get_lrshifts hifi3_fir_get_lrshifts
+#define src_polyphase_stage_cir hifi3_src_polyphase_stage_cir
+#define src_polyphase_stage_cir_s24 hifi3_src_polyphase_stage_cir_s24
+#define func_map hifi3_func_map
+#define vol_get_processing_function hifi3_vol_get_processing_function
+
+#include <stdlib.h>
+#include "fir_hifi3.c"
+#include "src_hifi3.c"
+#include "volume_hifi3.c"
+#include "hifi_kernels.h"
+
+void hifi3_fir_run(struct sof_eq_fir_coef_data *config, const int32_t *x,
+		   int32_t *y, int samples, int dual)
+{
+	struct fir_state_32x16 fir;
+	int32_t *delay;
+	int32_t *data;
+	int lshift;
+	int rshift;
+	int i;
+
+	fir_reset(&fir);
+	delay = calloc(fir_init_coef(&fir, config), 1);
+	data = delay;
+	fir_init_delay(&fir, &data);
+	fir_get_lrshifts(&fir, &lshift, &rshift);
+	fir_hifi3_setup_circular(&fir);
+
+	if (dual) {
+		for (i = 0; i < samples; i += 2)
+			fir_32x16_2x_hifi3(&fir, x[i], x[i + 1],
+					   &y[i], &y[i + 1], lshift - rshift);
+	} else {
+		for (i = 0; i < samples; i++)
+			fir_32x16_hifi3(&fir, x[i], &y[i], lshift - rshift);
+	}
+
+	free(delay);
+}
@@ -0,0 +1,467 @@
+/*
+ * Copyright (c) 2018, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of the Intel Corporation nor the
+ *     names of its contributors may be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Differential test of the HiFi optimized kernels against the generic C
+ * versions. Both are run with identical random input and the outputs are
+ * compared with a tolerance that covers the different rounding and the
+ * 24 bit data path of the DSP versions. The number of emulated intrinsics
+ * per sample is reported as TAP diagnostics.
+ */
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <cmocka.h>
+#include <sof/audio/component.h>
+#include <sof/math/numbers.h>
+#include <arch/hifi_emu.h>
+#include <uapi/eq.h>
+#include "fir.h"
+#include "hifi_kernels.h"
+
+#define TEST_SAMPLES	960
+#define TEST_SEED	0x50f
+
+enum hifi_isa {
+	HIFI2EP,
+	HIFI3,
+};
+
+static const char * const isa_name[] = {"hifi2ep", "hifi3"};
+
+static int32_t rand32(void)
+{
+	return (int32_t)((uint32_t)rand() << 16 ^ (uint32_t)rand());
+}
+
+static void fill_random(int32_t *x, int n, int bits)
+{
+	int i;
+
+	for (i = 0; i < n; i++)
+		x[i] = rand32() >> (32 - bits);
+}
+
+static void report_ops(const char *isa, const char *kernel, int samples)
+{
+	print_message("# %s %s: %.2f ops/sample, %.2f cycles/sample\n",
+		      isa, kernel, (double)hifi_emu_ops_total() / samples,
+		      (double)hifi_emu_cycles() / samples);
+}
+
+/* check |a - b| <= tol for all samples, a and b are in the same domain */
+static void assert_close(const int32_t *a, const int32_t *b, int n, int shift,
+			 int tol)
+{
+	int64_t d;
+	int i;
+
+	for (i = 0; i < n; i++) {
+		d = (int64_t)(a[i] >> shift) - (b[i] >> shift);
+		if (d > tol || d < -tol)
+			fail_msg("sample %d: %d vs %d", i, a[i], b[i]);
+	}
+}
+
+/*
+ * FIR
+ */
+
+struct fir_test_parameters {
+	enum hifi_isa isa;
+	int taps;
+	int out_shift;
+	int dual;
+};
+
+static void test_audio_hifi_fir(void **state)
+{
+	struct fir_test_parameters *p = *state;
+	struct sof_eq_fir_coef_data *config;
+	struct fir_state_32x16 fir;
+	int32_t *x = test_malloc(TEST_SAMPLES * sizeof(int32_t));
+	int32_t *y = test_malloc(TEST_SAMPLES * sizeof(int32_t));
+	int32_t *ref = test_malloc(TEST_SAMPLES * sizeof(int32_t));
+	int32_t *delay;
+	int32_t *data;
+	int i;
+
+	srand(TEST_SEED);
+	config = test_malloc(sizeof(*config) + p->taps * sizeof(int16_t));
+	config->length = p->taps;
+	config->out_shift = p->out_shift;
+	for (i = 0; i < p->taps; i++)
+		config->coef[i] = (int16_t)(rand32() % (INT16_MAX / p->taps));
+	fill_random(x, TEST_SAMPLES, 32);
+
+	/* generic reference */
+	fir_reset(&fir);
+	delay = test_calloc(fir_init_coef(&fir, config), 1);
+	data = delay;
+	fir_init_delay(&fir, &data);
+	for (i = 0; i < TEST_SAMPLES; i++)
+		ref[i] = fir_32x16(&fir, x[i]);
+
+	hifi_emu_ops_reset();
+	if (p->isa == HIFI3) {
+		/* 32 bit data, the DSP version only rounds differently */
+		hifi3_fir_run(config, x, y, TEST_SAMPLES, p->dual);
+		assert_close(ref, y, TEST_SAMPLES, 0, 1);
+	} else {
+		/* data is used as Q1.23, compare in 24 bits */
+		hifi2ep_fir_run(config, x, y, TEST_SAMPLES, p->dual);
+		assert_close(ref, y, TEST_SAMPLES, 8, 2);
+	}
+	report_ops(isa_name[p->isa], p->dual ? "fir_32x16_2x" : "fir_32x16",
+		   TEST_SAMPLES);
+
+	test_free(delay);
+	test_free(config);
+	test_free(ref);
+	test_free(y);
+	test_free(x);
+}
+
+static struct fir_test_parameters fir_parameters[] = {
+	{ HIFI3,   32, 0, 0 },
+	{ HIFI3,   32, 0, 1 },
+	{ HIFI3,   80, 1, 0 },
+	{ HIFI3,   80, 1, 1 },
+	{ HIFI2EP, 32, 0, 0 },
+	{ HIFI2EP, 32, 0, 1 },
+	{ HIFI2EP, 80, 1, 0 },
+	{ HIFI2EP, 80, 1, 1 },
+};
+
+/*
+ * SRC
+ */
+
+struct src_test_parameters {
+	enum hifi_isa isa;
+	int s24;
+	int nch;
+	/* stage geometry */
+	int idm;
+	int odm;
+	int num_of_subfilters;
+	int subfilter_length;
+	int blk_in;
+	int blk_out;
+	int shift;
+};
+
+static struct src_stage *src_stage_new(struct src_test_parameters *p,
+				       const void *coefs)
+{
+	struct src_stage tmpl = {
+		p->idm, p->odm, p->num_of_subfilters, p->subfilter_length,
+		p->num_of_subfilters * p->subfilter_length, p->blk_in,
+		p->blk_out, 0, p->shift, coefs
+	};
+	struct src_stage *stage = test_malloc(sizeof(*stage));
+
+	memcpy(stage, &tmpl, sizeof(tmpl));
+	return stage;
+}
+
+/* Run a stage over the whole input. The delay lines are sized as in
+ * src_buffer_lengths().
+ */
+static void src_run(struct src_stage *stage, int nch, int32_t *x, int32_t *y,
+		    int times, void (*func)(struct src_stage_prm *s))
+{
+	struct src_stage_prm prm;
+	struct src_state st;
+	int32_t *delay;
+
+	st.fir_delay_size = nch * (stage->subfilter_length +
+		(stage->num_of_subfilters - 1) * stage->idm + stage->blk_in);
+	st.out_delay_size = nch *
+		(1 + (stage->num_of_subfilters - 1) * stage->odm);
+	delay = test_calloc(st.fir_delay_size + st.out_delay_size,
+			    sizeof(int32_t));
+	st.fir_delay = delay;
+	st.out_delay = delay + st.fir_delay_size;
+	st.fir_wp = &st.fir_delay[st.fir_delay_size - 1];
+	st.out_rp = st.out_delay;
+
+	prm.nch = nch;
+	prm.times = times;
+	prm.x_rptr = x;
+	prm.x_end_addr = x + times * stage->blk_in * nch;
+	prm.x_size = times * stage->blk_in * nch * sizeof(int32_t);
+	prm.y_wptr = y;
+	prm.y_addr = y;
+	prm.y_end_addr = y + times * stage->blk_out * nch;
+	prm.y_size = times * stage->blk_out * nch * sizeof(int32_t);
+	prm.state = &st;
+	prm.stage = stage;
+	func(&prm);
+
+	test_free(delay);
+}
+
+static void test_audio_hifi_src(void **state)
+{
+	struct src_test_parameters *p = *state;
+	struct src_stage *ref_stage;
+	struct src_stage *stage;
+	int taps = p->num_of_subfilters * p->subfilter_length;
+	int times = TEST_SAMPLES / p->blk_in;
+	int n_in = times * p->blk_in * p->nch;
+	int n_out = times * p->blk_out * p->nch;
+	int32_t *coef32 = test_malloc(taps * sizeof(int32_t));
+	int16_t *coef16 = test_malloc(taps * sizeof(int16_t));
+	int32_t *x = test_malloc(n_in * sizeof(int32_t));
+	int32_t *y = test_malloc(n_out * sizeof(int32_t));
+	int32_t *ref = test_malloc(n_out * sizeof(int32_t));
+	void (*func)(struct src_stage_prm *s);
+	int i;
+
+	srand(TEST_SEED);
+	fill_random(x, n_in, p->s24 ? 24 : 32);
+	for (i = 0; i < taps; i++) {
+		coef32[i] = rand32() % (INT32_MAX / p->subfilter_length);
+		coef16[i] = coef32[i] >> 16;
+	}
+
+	/* HiFi2 EP uses 16 bit coefficients, feed the same to generic */
+	if (p->isa == HIFI2EP) {
+		for (i = 0; i < taps; i++)
+			coef32[i] = coef16[i] * 65536;
+		stage = src_stage_new(p, coef16);
+		func = p->s24 ? hifi2ep_src_polyphase_stage_cir_s24 :
+			hifi2ep_src_polyphase_stage_cir;
+	} else {
+		stage = src_stage_new(p, coef32);
+		func = p->s24 ? hifi3_src_polyphase_stage_cir_s24 :
+			hifi3_src_polyphase_stage_cir;
+	}
+	ref_stage = src_stage_new(p, coef32);
+
+	src_run(ref_stage, p->nch, x, ref, times, p->s24 ?
+		src_polyphase_stage_cir_s24 : src_polyphase_stage_cir);
+
+	hifi_emu_ops_reset();
+	src_run(stage, p->nch, x, y, times, func);
+	report_ops(isa_name[p->isa], p->s24 ? "src_s24" : "src_s32", n_out);
+
+	/* data is used as Q1.23 by both DSP versions */
+	if (p->s24)
+		assert_close(ref, y, n_out, 0, 2);
+	else
+		assert_close(ref, y, n_out, 8, 2);
+
+	test_free(ref_stage);
+	test_free(stage);
+	test_free(ref);
+	test_free(y);
+	test_free(x);
+	test_free(coef16);
+	test_free(coef32);
+}
+
+/* decimation by two, interpolation by two and 3/2 interpolation stages */
+#define SRC_DOWN_2	1, 0, 1, 40, 2, 1, 1
+#define SRC_UP_2	0, 1, 2, 20, 1, 2, 0
+#define SRC_UP_3_2	1, 2, 3, 100, 2, 3, 0
+
+static struct src_test_parameters src_parameters[] = {
+	{ HIFI3,   0, 2, SRC_DOWN_2 },
+	{ HIFI3,   0, 2, SRC_UP_2 },
+	{ HIFI3,   0, 2, SRC_UP_3_2 },
+	{ HIFI3,   1, 2, SRC_UP_3_2 },
+	{ HIFI3,   0, 1, SRC_UP_3_2 },
+	{ HIFI3,   0, 4, SRC_UP_3_2 },
+	{ HIFI2EP, 0, 2, SRC_DOWN_2 },
+	{ HIFI2EP, 0, 2, SRC_UP_2 },
+	{ HIFI2EP, 0, 2, SRC_UP_3_2 },
+	{ HIFI2EP, 1, 2, SRC_UP_3_2 },
+	{ HIFI2EP, 0, 1, SRC_UP_3_2 },
+	{ HIFI2EP, 0, 4, SRC_UP_3_2 },
+};
+
+/*
+ * Volume
+ */
+
+struct vol_test_parameters {
+	uint32_t volume;
+	uint32_t channels;
+	uint32_t source_format;
+	uint32_t sink_format;
+};
+
+static int frame_bits(uint32_t fmt)
+{
+	switch (fmt) {
+	case SOF_IPC_FRAME_S16_LE:
+		return 16;
+	case SOF_IPC_FRAME_S24_4LE:
+		return 24;
+	default:
+		return 32;
+	}
+}
+
+static void load_samples(int32_t *out, const void *buf, uint32_t fmt, int n)
+{
+	int i;
+
+	for (i = 0; i < n; i++) {
+		if (fmt == SOF_IPC_FRAME_S16_LE)
+			out[i] = ((const int16_t *)buf)[i];
+		else if (fmt == SOF_IPC_FRAME_S24_4LE)
+			out[i] = sign_extend_s24(((const int32_t *)buf)[i]);
+		else
+			out[i] = ((const int32_t *)buf)[i];
+	}
+}
+
+static void test_audio_hifi_volume(void **state)
+{
+	struct vol_test_parameters *p = *state;
+	struct comp_dev *dev = test_calloc(1, COMP_SIZE(struct sof_ipc_comp_volume));
+	struct comp_data *cd = test_calloc(1, sizeof(*cd));
+	struct comp_buffer source;
+	struct comp_buffer sink;
+	struct comp_buffer ref_sink;
+	int n = TEST_SAMPLES;
+	int32_t *x = test_malloc(n * sizeof(int32_t));
+	int32_t *y = test_malloc(n * sizeof(int32_t));
+	int32_t *ref = test_malloc(n * sizeof(int32_t));
+	scale_vol generic;
+	scale_vol hifi3;
+	int32_t tol;
+	int shift;
+	int i;
+
+	dev->params.channels = p->channels;
+	dev->frames = n / p->channels;
+	comp_set_drvdata(dev, cd);
+	cd->source_format = p->source_format;
+	cd->sink_format = p->sink_format;
+	for (i = 0; i < p->channels; i++)
+		cd->volume[i] = p->volume;
+
+	generic = vol_get_processing_function(dev);
+	hifi3 = hifi3_vol_get_processing_function(dev);
+	assert_non_null(generic);
+	assert_non_null(hifi3);
+
+	srand(TEST_SEED);
+	source.r_ptr = test_malloc(n * sizeof(int32_t));
+	sink.w_ptr = test_calloc(n, sizeof(int32_t));
+	ref_sink.w_ptr = test_calloc(n, sizeof(int32_t));
+	fill_random(x, n, frame_bits(p->source_format));
+	for (i = 0; i < n; i++) {
+		if (p->source_format == SOF_IPC_FRAME_S16_LE)
+			((int16_t *)source.r_ptr)[i] = x[i];
+		else
+			((int32_t *)source.r_ptr)[i] = x[i];
+	}
+
+	generic(dev, &ref_sink, &source, dev->frames);
+	hifi_emu_ops_reset();
+	hifi3(dev, &sink, &source, dev->frames);
+	report_ops("hifi3", "volume", n);
+
+	/* The DSP version keeps only the precision of the narrower format
+	 * and scales the gain to Q1.31 with INT32_MAX, so compare in the
+	 * narrower format and allow an error relative to the sample value.
+	 */
+	shift = frame_bits(p->sink_format) -
+		MIN(frame_bits(p->source_format), frame_bits(p->sink_format));
+	load_samples(ref, ref_sink.w_ptr, p->sink_format, n);
+	load_samples(y, sink.w_ptr, p->sink_format, n);
+	for (i = 0; i < n; i++) {
+		ref[i] >>= shift;
+		y[i] >>= shift;
+		tol = 1 + (abs(ref[i]) >> 14);
+		if (ref[i] - y[i] > tol || y[i] - ref[i] > tol)
+			fail_msg("sample %d: %d vs %d", i, ref[i], y[i]);
+	}
+
+	test_free(ref_sink.w_ptr);
+	test_free(sink.w_ptr);
+	test_free(source.r_ptr);
+	test_free(ref);
+	test_free(y);
+	test_free(x);
+	test_free(cd);
+	test_free(dev);
+}
+
+#define VOL_FORMATS(fmt) \
+	{ VOL_MAX,     2, fmt, SOF_IPC_FRAME_S16_LE }, \
+	{ VOL_MAX / 3, 2, fmt, SOF_IPC_FRAME_S24_4LE }, \
+	{ VOL_MAX / 2, 4, fmt, SOF_IPC_FRAME_S32_LE }
+
+static struct vol_test_parameters vol_parameters[] = {
+	VOL_FORMATS(SOF_IPC_FRAME_S16_LE),
+	VOL_FORMATS(SOF_IPC_FRAME_S24_4LE),
+	VOL_FORMATS(SOF_IPC_FRAME_S32_LE),
+};
+
+int main(void)
+{
+	struct CMUnitTest tests[ARRAY_SIZE(fir_parameters) +
+				ARRAY_SIZE(src_parameters) +
+				ARRAY_SIZE(vol_parameters)];
+	struct CMUnitTest *t = tests;
+	int i;
+
+	memset(tests, 0, sizeof(tests));
+
+	for (i = 0; i < ARRAY_SIZE(fir_parameters); i++, t++) {
+		t->name = "test_audio_hifi_fir";
+		t->test_func = test_audio_hifi_fir;
+		t->initial_state = &fir_parameters[i];
+	}
+
+	for (i = 0; i < ARRAY_SIZE(src_parameters); i++, t++) {
+		t->name = "test_audio_hifi_src";
+		t->test_func = test_audio_hifi_src;
+		t->initial_state = &src_parameters[i];
+	}
+
+	for (i = 0; i < ARRAY_SIZE(vol_parameters); i++, t++) {
+		t->name = "test_audio_hifi_volume";
+		t->test_func = test_audio_hifi_volume;
+		t->initial_state = &vol_parameters[i];
+	}
+
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
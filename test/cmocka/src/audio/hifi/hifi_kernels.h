@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2018, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of the Intel Corporation nor the
+ *     names of its contributors may be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef HIFI_KERNELS_H
+#define HIFI_KERNELS_H
+
+#include <stdint.h>
+#include <uapi/eq.h>
+#include "src.h"
+#include "volume.h"
+
+/* The optimized kernels are built with the host emulation of the HiFi
+ * intrinsics. Their symbols are prefixed with the ISA name so that they
+ * can be linked next to the generic versions of the same kernels.
+ */
+
+void hifi3_fir_run(struct sof_eq_fir_coef_data *config, const int32_t *x,
+		   int32_t *y, int samples, int dual);
+
+void hifi2ep_fir_run(struct sof_eq_fir_coef_data *config, const int32_t *x,
+		     int32_t *y, int samples, int dual);
+
+void hifi3_src_polyphase_stage_cir(struct src_stage_prm *s);
+
+void hifi3_src_polyphase_stage_cir_s24(struct src_stage_prm *s);
+
+void hifi2ep_src_polyphase_stage_cir(struct src_stage_prm *s);
+
+void hifi2ep_src_polyphase_stage_cir_s24(struct src_stage_prm *s);
+
+scale_vol hifi3_vol_get_processing_function(struct comp_dev *dev);
+
+#endif
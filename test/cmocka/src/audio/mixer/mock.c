@@ -38,6 +38,9 @@
 
 #include "comp_mock.h"
 
+/* trace filter of the call sites, all classes off */
+struct trace_filter trace_filter;
+
 void _trace_event0(uint32_t log_entry)
 {
 	(void)log_entry;
@@ -76,11 +79,24 @@ void *rzalloc(int zone, uint32_t caps, size_t bytes)
 	return calloc(bytes, 1);
 }
 
+void *rzalloc_slab(int zone, int slab, size_t bytes)
+{
+	(void)zone;
+	(void)slab;
+
+	return calloc(bytes, 1);
+}
+
 void rfree(void *ptr)
 {
 	free(ptr);
 }
 
+void mm_pm_dirty(void *ptr)
+{
+	(void)ptr;
+}
+
 void pipeline_xrun(struct pipeline *p, struct comp_dev *dev, int32_t bytes)
 {
 }
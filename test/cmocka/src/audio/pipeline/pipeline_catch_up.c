@@ -0,0 +1,325 @@
+/*
+ * Copyright (c) 2018, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of the Intel Corporation nor the
+ *     names of its contributors may be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Pipeline catch up after a late pipeline task. The scheduler mock runs the
+ * task at once like the host scheduler, a delay skips task runs while the
+ * DAI keeps consuming periods.
+ */
+
+#include <sof/audio/component.h>
+#include <sof/audio/pipeline.h>
+#include <sof/schedule.h>
+#include "pipeline_mocks.h"
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <cmocka.h>
+
+#define CATCH_UP_FRAMES		48
+#define CATCH_UP_CHANNELS	2
+#define CATCH_UP_PERIOD		(CATCH_UP_FRAMES * CATCH_UP_CHANNELS * 4)
+
+/* host -> buffer -> DAI playback pipeline */
+struct catch_up_data {
+	struct pipeline *p;
+	struct comp_dev *host;
+	struct comp_dev *dai;
+	struct comp_buffer *buffer;
+	int host_periods;	/* periods the host has ready */
+};
+
+/* buffer sizes in periods, the initial state of the tests */
+static uint32_t two_periods = 2;
+static uint32_t three_periods = 3;
+static uint32_t budget_periods = 2 * PIPELINE_CATCHUP_PERIODS;
+
+/* a period from the host while it has one and the buffer has space */
+static int host_copy(struct comp_dev *dev)
+{
+	struct catch_up_data *data = comp_get_drvdata(dev);
+	struct comp_buffer *sink = data->buffer;
+
+	if (!data->host_periods) {
+		pipeline_xrun(dev->pipeline, dev, -CATCH_UP_PERIOD);
+		return -EIO;
+	}
+
+	if (sink->free < CATCH_UP_PERIOD) {
+		comp_overrun(dev, sink, CATCH_UP_PERIOD, 0);
+		return -EIO;
+	}
+
+	sink->avail += CATCH_UP_PERIOD;
+	sink->free -= CATCH_UP_PERIOD;
+	data->host_periods--;
+	return 0;
+}
+
+/* the DAI DMA does the copy */
+static int dai_copy(struct comp_dev *dev)
+{
+	return 0;
+}
+
+static int comp_op(struct comp_dev *dev)
+{
+	return 0;
+}
+
+static int comp_trigger_op(struct comp_dev *dev, int cmd)
+{
+	return 0;
+}
+
+static struct comp_driver host_drv = {
+	.type = SOF_COMP_HOST,
+	.ops = {
+		.trigger = comp_trigger_op,
+		.prepare = comp_op,
+		.copy = host_copy,
+	},
+};
+
+static struct comp_driver dai_drv = {
+	.type = SOF_COMP_DAI,
+	.ops = {
+		.trigger = comp_trigger_op,
+		.prepare = comp_op,
+		.copy = dai_copy,
+	},
+};
+
+static struct comp_dev *comp_mock_new(struct comp_driver *drv, uint32_t id)
+{
+	struct comp_dev *dev = calloc(1, COMP_SIZE(struct sof_ipc_comp_host));
+
+	dev->drv = drv;
+	dev->comp.id = id;
+	dev->comp.type = drv->type;
+	dev->comp.pipeline_id = 1;
+	dev->params.direction = SOF_IPC_STREAM_PLAYBACK;
+	dev->params.frame_fmt = SOF_IPC_FRAME_S32_LE;
+	dev->params.channels = CATCH_UP_CHANNELS;
+	list_init(&dev->bsource_list);
+	list_init(&dev->bsink_list);
+
+	return dev;
+}
+
+/* DAI DMA completes a period, it plays stale data when the buffer is empty */
+static void dai_period(struct catch_up_data *data)
+{
+	struct comp_buffer *buffer = data->buffer;
+
+	if (buffer->avail >= CATCH_UP_PERIOD) {
+		buffer->avail -= CATCH_UP_PERIOD;
+		buffer->free += CATCH_UP_PERIOD;
+	}
+
+	if (buffer->avail < CATCH_UP_PERIOD)
+		comp_underrun(data->dai, buffer, CATCH_UP_PERIOD, 0);
+
+	pipeline_schedule_copy(data->p, 0);
+}
+
+/* full buffer of the initial state periods and a running pipeline */
+static int setup(void **state)
+{
+	struct sof_ipc_pipe_new desc = {
+		.pipeline_id = 1,
+		.deadline = 1000,
+		.frames_per_sched = CATCH_UP_FRAMES,
+	};
+	uint32_t periods = *(uint32_t *)*state;
+	struct catch_up_data *data;
+	struct comp_buffer *buffer;
+
+	data = calloc(1, sizeof(*data));
+	if (!data)
+		return -1;
+
+	data->host = comp_mock_new(&host_drv, 1);
+	data->dai = comp_mock_new(&dai_drv, 3);
+	comp_set_drvdata(data->host, data);
+
+	buffer = calloc(1, sizeof(*buffer));
+	buffer->size = periods * CATCH_UP_PERIOD;
+	buffer->addr = calloc(1, buffer->size);
+	buffer->avail = buffer->size;
+	buffer->ipc_buffer.comp.id = 2;
+	data->buffer = buffer;
+
+	data->p = pipeline_new(&desc, data->dai);
+	if (!data->p)
+		return -1;
+	pipeline_comp_connect(data->p, data->host, buffer);
+	pipeline_buffer_connect(data->p, buffer, data->dai);
+	if (pipeline_complete(data->p) < 0)
+		return -1;
+
+	data->host->state = COMP_STATE_ACTIVE;
+	data->dai->state = COMP_STATE_ACTIVE;
+	data->host_periods = 1000;
+
+	schedule_delay = 0;
+	ipc_xruns = 0;
+
+	*state = data;
+
+	return 0;
+}
+
+static int teardown(void **state)
+{
+	struct catch_up_data *data = *state;
+
+	free(data->buffer->addr);
+	free(data->buffer);
+	free(data->host);
+	free(data->dai);
+	free(data->p);
+	free(data);
+
+	return 0;
+}
+
+static void test_audio_pipeline_catch_up_steady(void **state)
+{
+	struct catch_up_data *data = *state;
+	int i;
+
+	for (i = 0; i < 16; i++) {
+		dai_period(data);
+		assert_int_equal(data->buffer->avail, 2 * CATCH_UP_PERIOD);
+	}
+
+	assert_int_equal(data->p->catch_ups, 0);
+	assert_int_equal(data->p->recovers, 0);
+	assert_int_equal(ipc_xruns, 0);
+}
+
+static void test_audio_pipeline_catch_up_late_task(void **state)
+{
+	struct catch_up_data *data = *state;
+
+	/* one missed task run, the next run copies two periods */
+	schedule_delay = 1;
+	dai_period(data);
+	dai_period(data);
+
+	assert_int_equal(data->buffer->avail, 3 * CATCH_UP_PERIOD);
+	assert_int_equal(data->p->catch_ups, 1);
+	assert_int_equal(data->p->catch_up_periods, 1);
+	assert_int_equal(data->p->recovers, 0);
+	assert_int_equal(ipc_xruns, 0);
+}
+
+static void test_audio_pipeline_catch_up_xrun(void **state)
+{
+	struct catch_up_data *data = *state;
+
+	/* the DAI runs out of data before the task runs again */
+	schedule_delay = 2;
+	dai_period(data);
+	dai_period(data);
+	dai_period(data);
+
+	assert_int_equal(data->buffer->avail, 3 * CATCH_UP_PERIOD);
+	assert_int_equal(data->p->catch_ups, 1);
+	assert_int_equal(data->p->catch_up_periods, 3);
+	assert_int_equal(data->p->recovers, 0);
+	assert_int_equal(data->p->xrun_bytes, 0);
+	assert_int_equal(ipc_xruns, 0);
+
+	/* and then runs in step again */
+	dai_period(data);
+	assert_int_equal(data->buffer->avail, 3 * CATCH_UP_PERIOD);
+	assert_int_equal(data->p->catch_ups, 1);
+}
+
+static void test_audio_pipeline_catch_up_budget(void **state)
+{
+	struct catch_up_data *data = *state;
+	int i;
+
+	/* more missed periods than one task run may copy */
+	schedule_delay = 2 * PIPELINE_CATCHUP_PERIODS - 1;
+	for (i = 0; i < 2 * PIPELINE_CATCHUP_PERIODS; i++)
+		dai_period(data);
+
+	assert_int_equal(data->buffer->avail,
+			 PIPELINE_CATCHUP_PERIODS * CATCH_UP_PERIOD);
+	assert_int_equal(data->p->catch_up_periods, PIPELINE_CATCHUP_PERIODS);
+	assert_int_equal(data->p->recovers, 0);
+	assert_int_equal(ipc_xruns, 0);
+}
+
+static void test_audio_pipeline_catch_up_recover(void **state)
+{
+	struct catch_up_data *data = *state;
+
+	/* the host is out of data, the DAI still has a period */
+	data->host_periods = 0;
+	dai_period(data);
+	assert_int_equal(data->p->recovers, 0);
+	assert_int_equal(ipc_xruns, 0);
+
+	/* nothing to catch up with once the DAI is empty */
+	dai_period(data);
+	assert_int_equal(data->p->recovers, 1);
+	assert_int_equal(ipc_xruns, 1);
+}
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test_prestate_setup_teardown
+			(test_audio_pipeline_catch_up_steady,
+			 setup, teardown, &two_periods),
+		cmocka_unit_test_prestate_setup_teardown
+			(test_audio_pipeline_catch_up_late_task,
+			 setup, teardown, &three_periods),
+		cmocka_unit_test_prestate_setup_teardown
+			(test_audio_pipeline_catch_up_xrun,
+			 setup, teardown, &three_periods),
+		cmocka_unit_test_prestate_setup_teardown
+			(test_audio_pipeline_catch_up_budget,
+			 setup, teardown, &budget_periods),
+		cmocka_unit_test_prestate_setup_teardown
+			(test_audio_pipeline_catch_up_recover,
+			 setup, teardown, &two_periods),
+	};
+
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,240 @@
+/*
+ * Copyright (c) 2018, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of the Intel Corporation nor the
+ *     names of its contributors may be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Pipeline handover between cores. The pipeline stays active, only the DMA
+ * period events of its host and DAI components move, between two periods.
+ */
+
+#include <sof/audio/component.h>
+#include <sof/audio/pipeline.h>
+#include <sof/schedule.h>
+#include "pipeline_mocks.h"
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <cmocka.h>
+
+#define MIGRATE_TRIGGERS	4
+
+/* trigger commands seen by a component */
+struct migrate_comp {
+	int cmd[MIGRATE_TRIGGERS];
+	int count;
+};
+
+/* host -> buffer -> DAI playback pipeline on core 0 */
+struct migrate_data {
+	struct pipeline *p;
+	struct comp_dev *host;
+	struct comp_dev *dai;
+	struct comp_buffer *buffer;
+	struct migrate_comp host_cmds;
+	struct migrate_comp dai_cmds;
+};
+
+static int comp_op(struct comp_dev *dev)
+{
+	return 0;
+}
+
+static int comp_trigger_op(struct comp_dev *dev, int cmd)
+{
+	struct migrate_comp *cmds = comp_get_drvdata(dev);
+
+	if (cmds->count < MIGRATE_TRIGGERS)
+		cmds->cmd[cmds->count++] = cmd;
+
+	return 0;
+}
+
+static struct comp_driver host_drv = {
+	.type = SOF_COMP_HOST,
+	.ops = {
+		.trigger = comp_trigger_op,
+		.prepare = comp_op,
+		.copy = comp_op,
+	},
+};
+
+static struct comp_driver dai_drv = {
+	.type = SOF_COMP_DAI,
+	.ops = {
+		.trigger = comp_trigger_op,
+		.prepare = comp_op,
+		.copy = comp_op,
+	},
+};
+
+static struct comp_dev *comp_mock_new(struct comp_driver *drv, uint32_t id,
+				      struct migrate_comp *cmds)
+{
+	struct comp_dev *dev = calloc(1, COMP_SIZE(struct sof_ipc_comp_host));
+
+	dev->drv = drv;
+	dev->comp.id = id;
+	dev->comp.type = drv->type;
+	dev->comp.pipeline_id = 1;
+	dev->params.direction = SOF_IPC_STREAM_PLAYBACK;
+	dev->state = COMP_STATE_ACTIVE;
+	list_init(&dev->bsource_list);
+	list_init(&dev->bsink_list);
+	comp_set_drvdata(dev, cmds);
+
+	return dev;
+}
+
+static int setup(void **state)
+{
+	struct sof_ipc_pipe_new desc = {
+		.pipeline_id = 1,
+		.deadline = 1000,
+		.frames_per_sched = 48,
+	};
+	struct migrate_data *data;
+
+	data = calloc(1, sizeof(*data));
+	if (!data)
+		return -1;
+
+	data->host = comp_mock_new(&host_drv, 1, &data->host_cmds);
+	data->dai = comp_mock_new(&dai_drv, 3, &data->dai_cmds);
+	data->buffer = calloc(1, sizeof(*data->buffer));
+	data->buffer->ipc_buffer.comp.id = 2;
+
+	data->p = pipeline_new(&desc, data->dai);
+	if (!data->p)
+		return -1;
+	pipeline_comp_connect(data->p, data->host, data->buffer);
+	pipeline_buffer_connect(data->p, data->buffer, data->dai);
+	if (pipeline_complete(data->p) < 0)
+		return -1;
+
+	data->p->status = COMP_STATE_ACTIVE;
+	data->p->pipe_task.state = TASK_STATE_COMPLETED;
+
+	*state = data;
+
+	return 0;
+}
+
+static int teardown(void **state)
+{
+	struct migrate_data *data = *state;
+
+	free(data->buffer);
+	free(data->host);
+	free(data->dai);
+	free(data->p);
+	free(data);
+
+	return 0;
+}
+
+static void assert_cmds(struct migrate_comp *cmds, int cmd)
+{
+	assert_int_equal(cmds->count, 1);
+	assert_int_equal(cmds->cmd[0], cmd);
+}
+
+static void test_audio_pipeline_migrate_out(void **state)
+{
+	struct migrate_data *data = *state;
+
+	assert_int_equal(pipeline_migrate_out(data->p, 1), 0);
+
+	/* the DMA events leave, the stream is not paused */
+	assert_cmds(&data->host_cmds, COMP_TRIGGER_MIGRATE_OUT);
+	assert_cmds(&data->dai_cmds, COMP_TRIGGER_MIGRATE_OUT);
+	assert_int_equal(data->p->status, COMP_STATE_ACTIVE);
+
+	assert_int_equal(data->p->ipc_pipe.core, 1);
+	assert_int_equal(data->p->pipe_task.core, 1);
+}
+
+static void test_audio_pipeline_migrate_out_in_period(void **state)
+{
+	struct migrate_data *data = *state;
+
+	/* a DMA event scheduled the task, the period completes here */
+	data->p->pipe_task.state = TASK_STATE_QUEUED;
+
+	assert_int_equal(pipeline_migrate_out(data->p, 1), -EBUSY);
+	assert_int_equal(data->host_cmds.count, 0);
+	assert_int_equal(data->dai_cmds.count, 0);
+	assert_int_equal(data->p->ipc_pipe.core, 0);
+}
+
+static void test_audio_pipeline_migrate_out_other_core(void **state)
+{
+	struct migrate_data *data = *state;
+
+	data->p->ipc_pipe.core = 1;
+
+	assert_int_equal(pipeline_migrate_out(data->p, 0), -EINVAL);
+	assert_int_equal(data->host_cmds.count, 0);
+	assert_int_equal(data->dai_cmds.count, 0);
+}
+
+static void test_audio_pipeline_migrate_in(void **state)
+{
+	struct migrate_data *data = *state;
+
+	/* handed over to this core */
+	assert_int_equal(pipeline_migrate_in(data->p), 0);
+
+	assert_cmds(&data->host_cmds, COMP_TRIGGER_MIGRATE_IN);
+	assert_cmds(&data->dai_cmds, COMP_TRIGGER_MIGRATE_IN);
+	assert_int_equal(data->p->status, COMP_STATE_ACTIVE);
+	assert_int_equal(data->p->migrations, 1);
+}
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test_setup_teardown
+			(test_audio_pipeline_migrate_out,
+			 setup, teardown),
+		cmocka_unit_test_setup_teardown
+			(test_audio_pipeline_migrate_out_in_period,
+			 setup, teardown),
+		cmocka_unit_test_setup_teardown
+			(test_audio_pipeline_migrate_out_other_core,
+			 setup, teardown),
+		cmocka_unit_test_setup_teardown
+			(test_audio_pipeline_migrate_in,
+			 setup, teardown),
+	};
+
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -31,12 +31,16 @@
 #include <sof/audio/component.h>
 #include <sof/audio/pipeline.h>
 #include <sof/schedule.h>
+#include <sof/idc.h>
 #include <stdarg.h>
 #include <stddef.h>
 #include <setjmp.h>
 #include <stdint.h>
 #include <cmocka.h>
 
+extern int schedule_delay;
+extern int ipc_xruns;
+
 int ipc_stream_send_xrun(struct comp_dev *cdev,
 	struct sof_ipc_stream_posn *posn);
 
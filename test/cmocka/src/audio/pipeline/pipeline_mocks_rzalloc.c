@@ -44,3 +44,10 @@ void *rzalloc(int zone, uint32_t caps, size_t bytes)
 	(void)caps;
 	return calloc(bytes, 1);
 }
+
+void *rzalloc_slab(int zone, int slab, size_t bytes)
+{
+	(void)zone;
+	(void)slab;
+	return calloc(bytes, 1);
+}
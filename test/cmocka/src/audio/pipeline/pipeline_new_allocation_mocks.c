@@ -37,12 +37,12 @@
 #include <stdint.h>
 #include <cmocka.h>
 
-void *rzalloc(int zone, uint32_t caps, size_t bytes)
+void *rzalloc_slab(int zone, int slab, size_t bytes)
 {
 	check_expected(zone);
-	check_expected(caps);
+	check_expected(slab);
 	check_expected(bytes);
 	(void)zone;
-	(void)caps;
+	(void)slab;
 	return calloc(bytes, 1);
 }
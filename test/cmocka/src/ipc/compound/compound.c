@@ -0,0 +1,326 @@
+/*
+ * Copyright (c) 2018, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of the Intel Corporation nor the
+ *     names of its contributors may be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Compound message handler. Messages are packed into the host mailbox the
+ * way the host driver does and the per message handler only records what
+ * it was given and returns the error it is told to.
+ */
+
+#include <sof/ipc.h>
+#include <platform/mailbox.h>
+#include <uapi/ipc.h>
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <cmocka.h>
+
+#define COMPOUND_MSGS		4
+
+struct compound_data {
+	struct ipc ipc;
+	uint8_t comp_data[SOF_IPC_MSG_MAX_SIZE];
+	uint32_t offset;	/* end of the packed messages */
+	uint32_t count;
+};
+
+struct ipc *_ipc;
+
+/* commands run and the return value for each */
+static uint32_t cmd_run[COMPOUND_MSGS];
+static uint32_t cmd_size[COMPOUND_MSGS];
+static int cmd_ret[COMPOUND_MSGS];
+static int cmd_count;
+
+int ipc_compound_cmd(uint32_t header)
+{
+	struct sof_ipc_hdr *hdr = _ipc->comp_data;
+
+	cmd_run[cmd_count] = header;
+	cmd_size[cmd_count] = hdr->size;
+	return cmd_ret[cmd_count++];
+}
+
+static int setup(void **state)
+{
+	struct compound_data *data = calloc(1, sizeof(*data));
+
+	if (data == NULL)
+		return -1;
+
+	memset(emu_hostbox, 0, MAILBOX_HOSTBOX_SIZE);
+	memset(cmd_ret, 0, sizeof(cmd_ret));
+	cmd_count = 0;
+
+	data->ipc.comp_data = data->comp_data;
+	data->offset = sizeof(struct sof_ipc_compound_hdr);
+	_ipc = &data->ipc;
+
+	*state = data;
+	return 0;
+}
+
+static int teardown(void **state)
+{
+	_ipc = NULL;
+	free(*state);
+	return 0;
+}
+
+/* packs a message, size is what its header claims */
+static void compound_add(struct compound_data *data, uint32_t cmd,
+			 uint32_t size)
+{
+	struct sof_ipc_hdr hdr = {
+		.cmd = cmd,
+		.size = size,
+	};
+
+	memcpy(emu_hostbox + data->offset, &hdr, sizeof(hdr));
+	data->offset += (size + 3) & ~3;
+	data->count++;
+}
+
+/* writes the compound header and reads it like ipc_cmd() does */
+static int compound_run(struct compound_data *data, uint32_t size)
+{
+	struct sof_ipc_compound_hdr compound = {
+		.hdr.cmd = SOF_IPC_GLB_COMPOUND,
+		.hdr.size = size,
+		.count = data->count,
+	};
+
+	memcpy(emu_hostbox, &compound, sizeof(compound));
+	memcpy(data->comp_data, &compound, sizeof(compound.hdr));
+
+	if (ipc_compound_read(data->ipc.comp_data))
+		return -EINVAL;
+
+	return ipc_glb_compound_message(SOF_IPC_GLB_COMPOUND);
+}
+
+static struct sof_ipc_compound_reply *compound_reply(void)
+{
+	return (struct sof_ipc_compound_reply *)emu_hostbox;
+}
+
+static void test_ipc_compound_runs_all_messages(void **state)
+{
+	uint32_t tplg = SOF_IPC_GLB_TPLG_MSG | SOF_IPC_TPLG_COMP_NEW;
+	uint32_t dai = SOF_IPC_GLB_DAI_MSG | SOF_IPC_DAI_CONFIG;
+	struct compound_data *data = *state;
+	struct sof_ipc_compound_reply *reply = compound_reply();
+
+	compound_add(data, tplg, sizeof(struct sof_ipc_comp_volume));
+	compound_add(data, dai, sizeof(struct sof_ipc_dai_config));
+	compound_add(data, tplg, 14);
+
+	/* positive means the handler wrote a reply of its own */
+	cmd_ret[1] = 1;
+
+	assert_int_equal(compound_run(data, data->offset), 1);
+	assert_int_equal(cmd_count, 3);
+	assert_int_equal(cmd_run[0], tplg);
+	assert_int_equal(cmd_run[1], dai);
+	assert_int_equal(cmd_size[1], sizeof(struct sof_ipc_dai_config));
+	assert_int_equal(cmd_size[2], 14);
+
+	assert_int_equal(reply->rhdr.hdr.cmd, SOF_IPC_GLB_COMPOUND);
+	assert_int_equal(reply->rhdr.hdr.size, sizeof(*reply) + 3 * 4);
+	assert_int_equal(reply->rhdr.error, 0);
+	assert_int_equal(reply->count, 3);
+	assert_int_equal(reply->error[0], 0);
+	assert_int_equal(reply->error[1], 0);
+	assert_int_equal(reply->error[2], 0);
+}
+
+static void test_ipc_compound_stops_at_failing_message(void **state)
+{
+	uint32_t tplg = SOF_IPC_GLB_TPLG_MSG | SOF_IPC_TPLG_COMP_NEW;
+	struct compound_data *data = *state;
+	struct sof_ipc_compound_reply *reply = compound_reply();
+
+	compound_add(data, tplg, sizeof(struct sof_ipc_comp_volume));
+	compound_add(data, tplg, sizeof(struct sof_ipc_comp_volume));
+	compound_add(data, tplg, sizeof(struct sof_ipc_comp_volume));
+	cmd_ret[1] = -ENODEV;
+
+	assert_int_equal(compound_run(data, data->offset), 1);
+	assert_int_equal(cmd_count, 2);
+
+	assert_int_equal(reply->rhdr.hdr.size, sizeof(*reply) + 2 * 4);
+	assert_int_equal(reply->rhdr.error, -ENODEV);
+	assert_int_equal(reply->count, 2);
+	assert_int_equal(reply->error[0], 0);
+	assert_int_equal(reply->error[1], -ENODEV);
+}
+
+static void test_ipc_compound_rejects_truncated_message(void **state)
+{
+	uint32_t tplg = SOF_IPC_GLB_TPLG_MSG | SOF_IPC_TPLG_COMP_NEW;
+	struct compound_data *data = *state;
+	struct sof_ipc_compound_reply *reply = compound_reply();
+
+	compound_add(data, tplg, sizeof(struct sof_ipc_comp_volume));
+	compound_add(data, tplg, sizeof(struct sof_ipc_comp_volume));
+
+	/* the compound ends 4 bytes into the second message */
+	assert_int_equal(compound_run(data, data->offset - 4), 1);
+	assert_int_equal(cmd_count, 1);
+
+	assert_int_equal(reply->rhdr.error, -EINVAL);
+	assert_int_equal(reply->count, 2);
+	assert_int_equal(reply->error[0], 0);
+	assert_int_equal(reply->error[1], -EINVAL);
+}
+
+static void test_ipc_compound_rejects_truncated_header(void **state)
+{
+	uint32_t tplg = SOF_IPC_GLB_TPLG_MSG | SOF_IPC_TPLG_COMP_NEW;
+	struct compound_data *data = *state;
+	struct sof_ipc_compound_reply *reply = compound_reply();
+	uint32_t size;
+
+	compound_add(data, tplg, sizeof(struct sof_ipc_comp_volume));
+	size = data->offset;
+	compound_add(data, tplg, sizeof(struct sof_ipc_comp_volume));
+
+	/* only half the header of the second message is in the compound */
+	assert_int_equal(compound_run(data, size + 4), 1);
+	assert_int_equal(cmd_count, 1);
+
+	assert_int_equal(reply->rhdr.error, -EINVAL);
+	assert_int_equal(reply->count, 2);
+	assert_int_equal(reply->error[1], -EINVAL);
+}
+
+static void test_ipc_compound_rejects_overlong_message(void **state)
+{
+	uint32_t tplg = SOF_IPC_GLB_TPLG_MSG | SOF_IPC_TPLG_COMP_NEW;
+	struct compound_data *data = *state;
+	struct sof_ipc_compound_reply *reply = compound_reply();
+
+	compound_add(data, tplg, SOF_IPC_MSG_MAX_SIZE + 4);
+	compound_add(data, tplg, sizeof(struct sof_ipc_comp_volume));
+
+	/* fits in the compound but not in comp_data */
+	assert_int_equal(compound_run(data, data->offset), 1);
+	assert_int_equal(cmd_count, 0);
+
+	assert_int_equal(reply->rhdr.error, -EINVAL);
+	assert_int_equal(reply->count, 1);
+	assert_int_equal(reply->error[0], -EINVAL);
+}
+
+static void test_ipc_compound_rejects_short_message(void **state)
+{
+	uint32_t tplg = SOF_IPC_GLB_TPLG_MSG | SOF_IPC_TPLG_COMP_NEW;
+	struct compound_data *data = *state;
+	struct sof_ipc_compound_reply *reply = compound_reply();
+
+	compound_add(data, tplg, sizeof(struct sof_ipc_hdr) - 4);
+
+	assert_int_equal(compound_run(data, data->offset), 1);
+	assert_int_equal(cmd_count, 0);
+	assert_int_equal(reply->count, 1);
+	assert_int_equal(reply->error[0], -EINVAL);
+}
+
+static void test_ipc_compound_rejects_short_compound(void **state)
+{
+	struct compound_data *data = *state;
+
+	/* shorter than its own header */
+	assert_int_equal(compound_run(data, sizeof(struct sof_ipc_hdr)),
+			 -EINVAL);
+	assert_int_equal(cmd_count, 0);
+}
+
+static void test_ipc_compound_rejects_large_compound(void **state)
+{
+	uint32_t tplg = SOF_IPC_GLB_TPLG_MSG | SOF_IPC_TPLG_COMP_NEW;
+	struct compound_data *data = *state;
+
+	/* larger than the mailbox */
+	compound_add(data, tplg, sizeof(struct sof_ipc_comp_volume));
+	assert_int_equal(compound_run(data, MAILBOX_HOSTBOX_SIZE + 4),
+			 -EINVAL);
+	assert_int_equal(cmd_count, 0);
+}
+
+static void test_ipc_compound_rejects_too_many_messages(void **state)
+{
+	struct compound_data *data = *state;
+
+	/* more messages than there are error codes in the reply */
+	data->count = SOF_IPC_COMPOUND_MAX_COUNT + 1;
+	assert_int_equal(compound_run(data, data->offset), -EINVAL);
+	assert_int_equal(cmd_count, 0);
+}
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test_setup_teardown
+			(test_ipc_compound_runs_all_messages,
+			 setup, teardown),
+		cmocka_unit_test_setup_teardown
+			(test_ipc_compound_stops_at_failing_message,
+			 setup, teardown),
+		cmocka_unit_test_setup_teardown
+			(test_ipc_compound_rejects_truncated_message,
+			 setup, teardown),
+		cmocka_unit_test_setup_teardown
+			(test_ipc_compound_rejects_truncated_header,
+			 setup, teardown),
+		cmocka_unit_test_setup_teardown
+			(test_ipc_compound_rejects_overlong_message,
+			 setup, teardown),
+		cmocka_unit_test_setup_teardown
+			(test_ipc_compound_rejects_short_message,
+			 setup, teardown),
+		cmocka_unit_test_setup_teardown
+			(test_ipc_compound_rejects_short_compound,
+			 setup, teardown),
+		cmocka_unit_test_setup_teardown
+			(test_ipc_compound_rejects_large_compound,
+			 setup, teardown),
+		cmocka_unit_test_setup_teardown
+			(test_ipc_compound_rejects_too_many_messages,
+			 setup, teardown),
+	};
+
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2018, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of the Intel Corporation nor the
+ *     names of its contributors may be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <cmocka.h>
+
+#include <sof/alloc.h>
+#include <sof/ipc.h>
+
+#include "mock.h"
+
+int mock_allocs;
+
+/* trace filter of the call sites, all classes off */
+struct trace_filter trace_filter;
+
+void _trace_event0(uint32_t log_entry)
+{
+	(void)log_entry;
+}
+
+void _trace_event1(uint32_t log_entry, uint32_t param)
+{
+	(void)log_entry;
+	(void)param;
+}
+
+void _trace_event2(uint32_t log_entry, uint32_t param1, uint32_t param2)
+{
+	(void)log_entry;
+	(void)param1;
+	(void)param2;
+}
+
+void _trace_event_mbox_atomic0(uint32_t log_entry)
+{
+	(void)log_entry;
+}
+
+void _trace_event_mbox_atomic1(uint32_t log_entry, uint32_t param)
+{
+	(void)log_entry;
+	(void)param;
+}
+
+void _trace_event_mbox_atomic2(uint32_t log_entry, uint32_t param1,
+			       uint32_t param2)
+{
+	(void)log_entry;
+	(void)param1;
+	(void)param2;
+}
+
+/* messages the queue grows by, freed by the test */
+void *rzalloc(int zone, uint32_t caps, size_t bytes)
+{
+	(void)zone;
+	(void)caps;
+
+	mock_allocs++;
+
+	return test_calloc(1, bytes);
+}
@@ -0,0 +1,349 @@
+/*
+ * Copyright (c) 2018, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of the Intel Corporation nor the
+ *     names of its contributors may be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Outbound IPC message queue: priority order, coalescing through the hash
+ * buckets, pool growth and eviction of less important messages.
+ */
+
+#include <sof/ipc.h>
+#include <sof/list.h>
+#include <uapi/ipc.h>
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <cmocka.h>
+
+#include "mock.h"
+
+#define QUEUE_XRUN	(SOF_IPC_GLB_STREAM_MSG | SOF_IPC_STREAM_TRIG_XRUN)
+#define QUEUE_POSN	(SOF_IPC_GLB_STREAM_MSG | SOF_IPC_STREAM_POSITION)
+#define QUEUE_TRACE	(SOF_IPC_GLB_TRACE_MSG | SOF_IPC_TRACE_DMA_POSITION)
+
+struct queue_data {
+	struct ipc ipc;
+	struct ipc_shared_context ctx;
+};
+
+/* set up the queue the way ipc_init() does */
+static int queue_setup(void **state)
+{
+	struct queue_data *data = test_calloc(1, sizeof(*data));
+	int i;
+
+	data->ipc.shared_ctx = &data->ctx;
+	list_init(&data->ctx.empty_list);
+	list_init(&data->ctx.msg_list);
+	list_init(&data->ctx.comp_list);
+
+	for (i = 0; i < MSG_QUEUE_SIZE; i++)
+		list_item_prepend(&data->ctx.message[i].list,
+				  &data->ctx.empty_list);
+	data->ctx.msg_count = MSG_QUEUE_SIZE;
+
+	mock_allocs = 0;
+	*state = data;
+
+	return 0;
+}
+
+static int queue_teardown(void **state)
+{
+	struct queue_data *data = *state;
+	struct ipc_msg *msg;
+	struct list_item *clist;
+	struct list_item *tlist;
+
+	while ((msg = ipc_msg_dequeue(&data->ipc)))
+		list_item_append(&msg->list, &data->ctx.empty_list);
+
+	/* messages the queue grew by are the ones outside message[] */
+	list_for_item_safe(clist, tlist, &data->ctx.empty_list) {
+		msg = container_of(clist, struct ipc_msg, list);
+		if (msg < data->ctx.message ||
+		    msg >= data->ctx.message + MSG_QUEUE_SIZE)
+			test_free(msg);
+	}
+
+	test_free(data);
+
+	return 0;
+}
+
+/* queue a stream message, the payload carries the component id */
+static int queue_stream(struct queue_data *data, uint32_t header,
+			uint32_t comp_id, uint64_t posn, uint32_t replace)
+{
+	struct sof_ipc_stream_posn msg;
+
+	memset(&msg, 0, sizeof(msg));
+	msg.rhdr.hdr.cmd = header;
+	msg.rhdr.hdr.size = sizeof(msg);
+	msg.comp_id = comp_id;
+	msg.host_posn = posn;
+
+	return ipc_queue_host_message(&data->ipc, header, &msg, sizeof(msg),
+				      replace);
+}
+
+static int queue_trace(struct queue_data *data, uint64_t posn)
+{
+	struct sof_ipc_dma_trace_posn msg;
+
+	memset(&msg, 0, sizeof(msg));
+	msg.rhdr.hdr.cmd = QUEUE_TRACE;
+	msg.rhdr.hdr.size = sizeof(msg);
+	msg.host_offset = posn;
+
+	return ipc_queue_host_message(&data->ipc, QUEUE_TRACE, &msg,
+				      sizeof(msg), 0);
+}
+
+/* dequeue the next message and hand it back to the pool */
+static struct ipc_msg *queue_next(struct queue_data *data)
+{
+	struct ipc_msg *msg = ipc_msg_dequeue(&data->ipc);
+
+	assert_non_null(msg);
+	list_item_append(&msg->list, &data->ctx.empty_list);
+
+	return msg;
+}
+
+static uint64_t msg_posn(struct ipc_msg *msg)
+{
+	return ((struct sof_ipc_stream_posn *)msg->tx_data)->host_posn;
+}
+
+static uint32_t msg_comp(struct ipc_msg *msg)
+{
+	return ((struct sof_ipc_stream_posn *)msg->tx_data)->comp_id;
+}
+
+static void test_ipc_msg_queue_priority_order(void **state)
+{
+	struct queue_data *data = *state;
+	struct ipc_msg *msg;
+
+	assert_int_equal(queue_trace(data, 1), 0);
+	assert_int_equal(queue_stream(data, QUEUE_POSN, 1, 10, 0), 0);
+	assert_int_equal(queue_stream(data, QUEUE_XRUN, 1, 20, 0), 0);
+	assert_int_equal(queue_stream(data, QUEUE_POSN, 2, 30, 0), 0);
+	assert_int_equal(queue_stream(data, QUEUE_XRUN, 2, 40, 0), 0);
+	assert_int_equal(data->ctx.dsp_pending, 1);
+
+	/* urgent first, positions next, trace last, FIFO within each */
+	msg = queue_next(data);
+	assert_int_equal(msg->header, QUEUE_XRUN);
+	assert_int_equal(msg_posn(msg), 20);
+	msg = queue_next(data);
+	assert_int_equal(msg->header, QUEUE_XRUN);
+	assert_int_equal(msg_posn(msg), 40);
+	msg = queue_next(data);
+	assert_int_equal(msg->header, QUEUE_POSN);
+	assert_int_equal(msg_posn(msg), 10);
+	msg = queue_next(data);
+	assert_int_equal(msg->header, QUEUE_POSN);
+	assert_int_equal(msg_posn(msg), 30);
+	msg = queue_next(data);
+	assert_int_equal(msg->header, QUEUE_TRACE);
+
+	assert_ptr_equal(ipc_msg_dequeue(&data->ipc), NULL);
+}
+
+static void test_ipc_msg_queue_tail_follows_dequeue(void **state)
+{
+	struct queue_data *data = *state;
+	struct ipc_msg *msg;
+
+	assert_int_equal(queue_stream(data, QUEUE_XRUN, 1, 1, 0), 0);
+	assert_int_equal(queue_stream(data, QUEUE_POSN, 1, 2, 0), 0);
+
+	/* the urgent tail is gone, the next urgent goes to the front */
+	msg = queue_next(data);
+	assert_int_equal(msg_posn(msg), 1);
+	assert_ptr_equal(data->ctx.msg_tail[IPC_MSG_PRIO_URGENT], NULL);
+
+	assert_int_equal(queue_stream(data, QUEUE_XRUN, 1, 3, 0), 0);
+	assert_int_equal(msg_posn(queue_next(data)), 3);
+	assert_int_equal(msg_posn(queue_next(data)), 2);
+	assert_ptr_equal(data->ctx.msg_tail[IPC_MSG_PRIO_POSN], NULL);
+}
+
+static void test_ipc_msg_queue_coalesces_same_stream(void **state)
+{
+	struct queue_data *data = *state;
+	struct ipc_msg *msg;
+
+	assert_int_equal(queue_stream(data, QUEUE_POSN, 1, 10, 1), 0);
+	assert_int_equal(queue_stream(data, QUEUE_POSN, 2, 20, 1), 0);
+	assert_int_equal(queue_stream(data, QUEUE_POSN, 1, 11, 1), 0);
+	assert_int_equal(queue_stream(data, QUEUE_POSN, 1, 12, 1), 0);
+	assert_int_equal(data->ctx.msg_coalesced, 2);
+
+	/* stream 1 keeps its place in the queue with the newest position */
+	msg = queue_next(data);
+	assert_int_equal(msg_comp(msg), 1);
+	assert_int_equal(msg_posn(msg), 12);
+	msg = queue_next(data);
+	assert_int_equal(msg_comp(msg), 2);
+	assert_int_equal(msg_posn(msg), 20);
+	assert_ptr_equal(ipc_msg_dequeue(&data->ipc), NULL);
+
+	/* once sent, the next position is queued again */
+	assert_int_equal(queue_stream(data, QUEUE_POSN, 1, 13, 1), 0);
+	assert_int_equal(data->ctx.msg_coalesced, 2);
+	assert_int_equal(msg_posn(queue_next(data)), 13);
+}
+
+static void test_ipc_msg_queue_hash_collisions(void **state)
+{
+	struct queue_data *data = *state;
+	uint32_t other = 1 + MSG_HASH_SIZE;
+
+	/* both streams land in the same bucket */
+	assert_int_equal(queue_stream(data, QUEUE_POSN, 1, 10, 1), 0);
+	assert_int_equal(queue_stream(data, QUEUE_POSN, other, 20, 1), 0);
+	assert_int_equal(queue_stream(data, QUEUE_POSN, 1, 11, 1), 0);
+	assert_int_equal(queue_stream(data, QUEUE_POSN, other, 21, 1), 0);
+	assert_int_equal(data->ctx.msg_coalesced, 2);
+
+	/* unlinking the bucket head keeps the other one reachable */
+	assert_int_equal(msg_posn(queue_next(data)), 11);
+	assert_int_equal(queue_stream(data, QUEUE_POSN, other, 22, 1), 0);
+	assert_int_equal(data->ctx.msg_coalesced, 3);
+	assert_int_equal(msg_posn(queue_next(data)), 22);
+	assert_ptr_equal(ipc_msg_dequeue(&data->ipc), NULL);
+}
+
+static void test_ipc_msg_queue_no_replace_queues_copies(void **state)
+{
+	struct queue_data *data = *state;
+
+	assert_int_equal(queue_stream(data, QUEUE_XRUN, 1, 1, 0), 0);
+	assert_int_equal(queue_stream(data, QUEUE_XRUN, 1, 2, 0), 0);
+	assert_int_equal(data->ctx.msg_coalesced, 0);
+
+	assert_int_equal(msg_posn(queue_next(data)), 1);
+	assert_int_equal(msg_posn(queue_next(data)), 2);
+}
+
+static void test_ipc_msg_queue_grows_then_drops(void **state)
+{
+	struct queue_data *data = *state;
+	int i;
+
+	for (i = 0; i < MSG_QUEUE_MAX; i++)
+		assert_int_equal(queue_stream(data, QUEUE_XRUN, i, i, 0), 0);
+
+	assert_int_equal(mock_allocs, MSG_QUEUE_MAX - MSG_QUEUE_SIZE);
+	assert_int_equal(data->ctx.msg_count, MSG_QUEUE_MAX);
+
+	/* nothing less important to evict */
+	assert_int_equal(queue_stream(data, QUEUE_XRUN, i, i, 0), -EBUSY);
+	assert_int_equal(data->ctx.msg_dropped, 1);
+	assert_int_equal(mock_allocs, MSG_QUEUE_MAX - MSG_QUEUE_SIZE);
+
+	/* nothing was lost or reordered */
+	for (i = 0; i < MSG_QUEUE_MAX; i++)
+		assert_int_equal(msg_posn(queue_next(data)), i);
+}
+
+static void test_ipc_msg_queue_evicts_lower_priority(void **state)
+{
+	struct queue_data *data = *state;
+	struct ipc_msg *msg;
+	int i;
+
+	/* fill up with one position and the rest trace */
+	assert_int_equal(queue_stream(data, QUEUE_POSN, 1, 100, 1), 0);
+	for (i = 1; i < MSG_QUEUE_MAX; i++)
+		assert_int_equal(queue_trace(data, i), 0);
+
+	/* the newest trace update makes room for an xrun */
+	assert_int_equal(queue_stream(data, QUEUE_XRUN, 1, 200, 0), 0);
+	assert_int_equal(data->ctx.msg_dropped, 1);
+	assert_int_equal(data->ctx.msg_count, MSG_QUEUE_MAX);
+
+	/* and the one before it for a position of another stream */
+	assert_int_equal(queue_stream(data, QUEUE_POSN, 2, 300, 1), 0);
+	assert_int_equal(data->ctx.msg_dropped, 2);
+
+	/* a trace update has nothing less important to push out */
+	assert_int_equal(queue_trace(data, 99), -EBUSY);
+	assert_int_equal(data->ctx.msg_dropped, 3);
+
+	msg = queue_next(data);
+	assert_int_equal(msg->header, QUEUE_XRUN);
+	assert_int_equal(msg_posn(queue_next(data)), 100);
+	assert_int_equal(msg_posn(queue_next(data)), 300);
+
+	/* the oldest trace updates are the ones left */
+	for (i = 1; i < MSG_QUEUE_MAX - 2; i++) {
+		msg = queue_next(data);
+		assert_int_equal(msg->header, QUEUE_TRACE);
+		assert_int_equal(((struct sof_ipc_dma_trace_posn *)
+				  msg->tx_data)->host_offset, i);
+	}
+	assert_ptr_equal(ipc_msg_dequeue(&data->ipc), NULL);
+}
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test_setup_teardown
+			(test_ipc_msg_queue_priority_order,
+			 queue_setup, queue_teardown),
+		cmocka_unit_test_setup_teardown
+			(test_ipc_msg_queue_tail_follows_dequeue,
+			 queue_setup, queue_teardown),
+		cmocka_unit_test_setup_teardown
+			(test_ipc_msg_queue_coalesces_same_stream,
+			 queue_setup, queue_teardown),
+		cmocka_unit_test_setup_teardown
+			(test_ipc_msg_queue_hash_collisions,
+			 queue_setup, queue_teardown),
+		cmocka_unit_test_setup_teardown
+			(test_ipc_msg_queue_no_replace_queues_copies,
+			 queue_setup, queue_teardown),
+		cmocka_unit_test_setup_teardown
+			(test_ipc_msg_queue_grows_then_drops,
+			 queue_setup, queue_teardown),
+		cmocka_unit_test_setup_teardown
+			(test_ipc_msg_queue_evicts_lower_priority,
+			 queue_setup, queue_teardown),
+	};
+
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,186 @@
+/*
+ * Copyright (c) 2018, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of the Intel Corporation nor the
+ *     names of its contributors may be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <cmocka.h>
+
+#include <sof/alloc.h>
+#include <sof/ipc.h>
+#include <sof/audio/component.h>
+#include <sof/audio/pipeline.h>
+#include <platform/mailbox.h>
+
+#include "mock.h"
+
+int mock_core_enabled[PLATFORM_CORE_COUNT];
+
+/* mailbox windows of the host builds, see platform/memory.h */
+uint8_t emu_mailbox[MAILBOX_TRACE_OFFSET + MAILBOX_TRACE_SIZE];
+
+/* the balancer runs as the master core */
+__thread int emu_cpu_id = PLATFORM_MASTER_CORE_ID;
+
+int emu_cpu_is_core_enabled(int id)
+{
+	return mock_core_enabled[id];
+}
+
+/* trace filter of the call sites, all classes off */
+struct trace_filter trace_filter;
+
+void _trace_event0(uint32_t log_entry)
+{
+	(void)log_entry;
+}
+
+void _trace_event1(uint32_t log_entry, uint32_t param)
+{
+	(void)log_entry;
+	(void)param;
+}
+
+void _trace_event_mbox_atomic0(uint32_t log_entry)
+{
+	(void)log_entry;
+}
+
+void _trace_event_mbox_atomic1(uint32_t log_entry, uint32_t param)
+{
+	(void)log_entry;
+	(void)param;
+}
+
+/* the IPC component handlers are not reached by the balancer */
+
+void *rzalloc(int zone, uint32_t caps, size_t bytes)
+{
+	(void)zone;
+	(void)caps;
+	(void)bytes;
+
+	return NULL;
+}
+
+void *rzalloc_slab(int zone, int slab, size_t bytes)
+{
+	(void)zone;
+	(void)slab;
+	(void)bytes;
+
+	return NULL;
+}
+
+void rfree(void *ptr)
+{
+	(void)ptr;
+}
+
+void mm_pm_dirty(void *ptr)
+{
+	(void)ptr;
+}
+
+int arena_select(int pipeline_id)
+{
+	(void)pipeline_id;
+
+	return 0;
+}
+
+struct comp_dev *comp_new(struct sof_ipc_comp *comp)
+{
+	(void)comp;
+
+	return NULL;
+}
+
+struct comp_buffer *buffer_new(struct sof_ipc_buffer *desc)
+{
+	(void)desc;
+
+	return NULL;
+}
+
+void buffer_free(struct comp_buffer *buffer)
+{
+	(void)buffer;
+}
+
+struct pipeline *pipeline_new(struct sof_ipc_pipe_new *pipe_desc,
+			      struct comp_dev *cd)
+{
+	(void)pipe_desc;
+	(void)cd;
+
+	return NULL;
+}
+
+int pipeline_free(struct pipeline *p)
+{
+	(void)p;
+
+	return 0;
+}
+
+int pipeline_complete(struct pipeline *p)
+{
+	(void)p;
+
+	return 0;
+}
+
+int pipeline_comp_connect(struct pipeline *p, struct comp_dev *source_comp,
+			  struct comp_buffer *sink_buffer)
+{
+	(void)p;
+	(void)source_comp;
+	(void)sink_buffer;
+
+	return 0;
+}
+
+int pipeline_buffer_connect(struct pipeline *p,
+			    struct comp_buffer *source_buffer,
+			    struct comp_dev *sink_comp)
+{
+	(void)p;
+	(void)source_buffer;
+	(void)sink_comp;
+
+	return 0;
+}
+
+int platform_ipc_init(struct ipc *ipc)
+{
+	(void)ipc;
+
+	return 0;
+}
@@ -0,0 +1,285 @@
+/*
+ * Copyright (c) 2018, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of the Intel Corporation nor the
+ *     names of its contributors may be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Pipeline load balancing policy, loads are given as task run times over a
+ * balance period of 1000 so a run time is the load in per mille.
+ */
+
+#include <sof/ipc.h>
+#include <sof/audio/component.h>
+#include <sof/audio/pipeline.h>
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <cmocka.h>
+
+#include "mock.h"
+
+#define BALANCE_PIPELINES	4
+#define BALANCE_PERIOD		1000
+
+struct balance_data {
+	struct ipc ipc;
+	struct ipc_shared_context ctx;
+	struct ipc_comp_dev icd[BALANCE_PIPELINES];
+	struct pipeline p[BALANCE_PIPELINES];
+	struct ipc_comp_dev dai_icd;
+	struct comp_dev dai;
+	int count;
+};
+
+/* enabled cores, the initial state of the tests */
+static int two_cores = 2;
+static int one_core = 1;
+
+static struct pipeline *migrated;
+static int migrated_core;
+
+int pipeline_migrate(struct pipeline *p, int core)
+{
+	migrated = p;
+	migrated_core = core;
+	p->ipc_pipe.core = core;
+
+	return 0;
+}
+
+static int setup(void **state)
+{
+	int cores = *(int *)*state;
+	struct balance_data *data;
+	int i;
+
+	data = calloc(1, sizeof(*data));
+	if (!data)
+		return -1;
+
+	data->ipc.shared_ctx = &data->ctx;
+	list_init(&data->ctx.comp_list);
+
+	for (i = 0; i < PLATFORM_CORE_COUNT; i++)
+		mock_core_enabled[i] = i < cores;
+
+	migrated = NULL;
+	migrated_core = -1;
+
+	*state = data;
+
+	return 0;
+}
+
+static int teardown(void **state)
+{
+	free(*state);
+
+	return 0;
+}
+
+static struct pipeline *balance_add(struct balance_data *data, int core,
+				    uint64_t rtime, uint32_t status)
+{
+	struct ipc_comp_dev *icd = &data->icd[data->count];
+	struct pipeline *p = &data->p[data->count];
+
+	p->ipc_pipe.comp_id = data->count + 1;
+	p->ipc_pipe.pipeline_id = data->count + 1;
+	p->ipc_pipe.core = core;
+	p->pipe_task.total_rtime = rtime;
+	p->status = status;
+
+	icd->type = COMP_TYPE_PIPELINE;
+	icd->pipeline = p;
+	list_item_append(&icd->list, &data->ctx.comp_list);
+
+	data->count++;
+	return p;
+}
+
+static void balance_add_dai(struct balance_data *data, struct pipeline *p)
+{
+	data->dai.comp.type = SOF_COMP_DAI;
+	data->dai.comp.pipeline_id = p->ipc_pipe.pipeline_id;
+
+	data->dai_icd.type = COMP_TYPE_COMPONENT;
+	data->dai_icd.cd = &data->dai;
+	list_item_append(&data->dai_icd.list, &data->ctx.comp_list);
+}
+
+static void test_ipc_pipeline_balance_moves_best_pipeline(void **state)
+{
+	struct balance_data *data = *state;
+	struct pipeline *a;
+
+	a = balance_add(data, 0, 400, COMP_STATE_ACTIVE);
+	balance_add(data, 0, 200, COMP_STATE_ACTIVE);
+	balance_add(data, 0, 100, COMP_STATE_ACTIVE);
+
+	/* 700 against 0, moving 400 leaves 300 and 400 */
+	assert_int_equal(ipc_pipeline_balance(&data->ipc, BALANCE_PERIOD), 1);
+	assert_ptr_equal(migrated, a);
+	assert_int_equal(migrated_core, 1);
+	assert_int_equal(data->icd[0].load, 400);
+}
+
+static void test_ipc_pipeline_balance_keeps_balanced_cores(void **state)
+{
+	struct balance_data *data = *state;
+
+	balance_add(data, 0, 400, COMP_STATE_ACTIVE);
+	balance_add(data, 0, 300, COMP_STATE_ACTIVE);
+	balance_add(data, 1, 600, COMP_STATE_ACTIVE);
+
+	assert_int_equal(ipc_pipeline_balance(&data->ipc, BALANCE_PERIOD), 0);
+	assert_ptr_equal(NULL, migrated);
+}
+
+static void test_ipc_pipeline_balance_keeps_light_load(void **state)
+{
+	struct balance_data *data = *state;
+
+	balance_add(data, 0, 300, COMP_STATE_ACTIVE);
+	balance_add(data, 0, 200, COMP_STATE_ACTIVE);
+
+	assert_int_equal(ipc_pipeline_balance(&data->ipc, BALANCE_PERIOD), 0);
+	assert_ptr_equal(NULL, migrated);
+}
+
+static void test_ipc_pipeline_balance_skips_disabled_cores(void **state)
+{
+	struct balance_data *data = *state;
+
+	balance_add(data, 0, 400, COMP_STATE_ACTIVE);
+	balance_add(data, 0, 300, COMP_STATE_ACTIVE);
+
+	assert_int_equal(ipc_pipeline_balance(&data->ipc, BALANCE_PERIOD), 0);
+	assert_ptr_equal(NULL, migrated);
+}
+
+static void test_ipc_pipeline_balance_keeps_single_pipeline(void **state)
+{
+	struct balance_data *data = *state;
+
+	/* moving it would only make the other core the busy one */
+	balance_add(data, 0, 800, COMP_STATE_ACTIVE);
+
+	assert_int_equal(ipc_pipeline_balance(&data->ipc, BALANCE_PERIOD), 0);
+	assert_ptr_equal(NULL, migrated);
+}
+
+static void test_ipc_pipeline_balance_ignores_paused(void **state)
+{
+	struct balance_data *data = *state;
+
+	balance_add(data, 0, 700, COMP_STATE_ACTIVE);
+	balance_add(data, 0, 350, COMP_STATE_PAUSED);
+
+	assert_int_equal(ipc_pipeline_balance(&data->ipc, BALANCE_PERIOD), 0);
+	assert_ptr_equal(NULL, migrated);
+	assert_int_equal(data->icd[1].load, 0);
+}
+
+static void test_ipc_pipeline_balance_moves_dai_pipeline(void **state)
+{
+	struct balance_data *data = *state;
+	struct pipeline *a;
+
+	a = balance_add(data, 0, 400, COMP_STATE_ACTIVE);
+	balance_add(data, 0, 200, COMP_STATE_ACTIVE);
+	balance_add(data, 0, 100, COMP_STATE_ACTIVE);
+	balance_add_dai(data, a);
+
+	/* the DAI keeps running, its pipeline moves between two periods */
+	assert_int_equal(ipc_pipeline_balance(&data->ipc, BALANCE_PERIOD), 1);
+	assert_ptr_equal(migrated, a);
+	assert_int_equal(migrated_core, 1);
+}
+
+static void test_ipc_pipeline_balance_uses_period_run_time(void **state)
+{
+	struct balance_data *data = *state;
+	struct pipeline *a;
+	struct pipeline *b;
+	struct pipeline *c;
+
+	a = balance_add(data, 0, 400, COMP_STATE_ACTIVE);
+	b = balance_add(data, 0, 100, COMP_STATE_ACTIVE);
+	c = balance_add(data, 1, 100, COMP_STATE_ACTIVE);
+
+	assert_int_equal(ipc_pipeline_balance(&data->ipc, BALANCE_PERIOD), 0);
+
+	/* only the run time since the last balance counts */
+	a->pipe_task.total_rtime += 500;
+	b->pipe_task.total_rtime += 300;
+	c->pipe_task.total_rtime += 100;
+
+	/* 800 against 100, moving 300 leaves 500 and 400 */
+	assert_int_equal(ipc_pipeline_balance(&data->ipc,
+					       2 * BALANCE_PERIOD), 1);
+	assert_int_equal(data->icd[0].load, 500);
+	assert_int_equal(data->icd[1].load, 300);
+	assert_ptr_equal(migrated, b);
+	assert_int_equal(migrated_core, 1);
+}
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test_prestate_setup_teardown
+			(test_ipc_pipeline_balance_moves_best_pipeline,
+			 setup, teardown, &two_cores),
+		cmocka_unit_test_prestate_setup_teardown
+			(test_ipc_pipeline_balance_keeps_balanced_cores,
+			 setup, teardown, &two_cores),
+		cmocka_unit_test_prestate_setup_teardown
+			(test_ipc_pipeline_balance_keeps_light_load,
+			 setup, teardown, &two_cores),
+		cmocka_unit_test_prestate_setup_teardown
+			(test_ipc_pipeline_balance_skips_disabled_cores,
+			 setup, teardown, &one_core),
+		cmocka_unit_test_prestate_setup_teardown
+			(test_ipc_pipeline_balance_keeps_single_pipeline,
+			 setup, teardown, &two_cores),
+		cmocka_unit_test_prestate_setup_teardown
+			(test_ipc_pipeline_balance_ignores_paused,
+			 setup, teardown, &two_cores),
+		cmocka_unit_test_prestate_setup_teardown
+			(test_ipc_pipeline_balance_moves_dai_pipeline,
+			 setup, teardown, &two_cores),
+		cmocka_unit_test_prestate_setup_teardown
+			(test_ipc_pipeline_balance_uses_period_run_time,
+			 setup, teardown, &two_cores),
+	};
+
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
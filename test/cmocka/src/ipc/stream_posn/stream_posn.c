@@ -0,0 +1,222 @@
+/*
+ * Copyright (c) 2018, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of the Intel Corporation nor the
+ *     names of its contributors may be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Stream position slot readers running on other threads while the position
+ * is published by ipc_stream_posn_write(), every read must see one complete
+ * update.
+ */
+
+#include <sof/ipc.h>
+#include <sof/seqlock.h>
+#include <sof/audio/component.h>
+#include <sof/audio/pipeline.h>
+#include <platform/mailbox.h>
+#include <uapi/ipc.h>
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <string.h>
+#include <pthread.h>
+#include <sched.h>
+#include <cmocka.h>
+
+#define STREAM_POSN_UPDATES	50000
+#define STREAM_POSN_READERS	2
+#define STREAM_POSN_PERIOD	192
+#define STREAM_POSN_YIELD	64
+
+struct stream_posn_test {
+	struct ipc ipc;
+	struct pipeline p;
+	struct comp_dev cd;
+	struct sof_ipc_stream_posn_slot *slot;
+	uint32_t *seq;		/* aligned seq word of the packed slot */
+	volatile int done;
+};
+
+struct stream_posn_reader {
+	pthread_t thread;
+	struct stream_posn_test *test;
+	uint64_t reads;
+	uint64_t torn;
+	uint64_t backwards;
+};
+
+/* publish an update with all fields derived from count */
+static void stream_posn_publish(struct stream_posn_test *test, uint64_t count)
+{
+	struct sof_ipc_stream_posn posn;
+
+	memset(&posn, 0, sizeof(posn));
+	posn.rhdr.hdr.cmd = SOF_IPC_GLB_STREAM_MSG | SOF_IPC_STREAM_POSITION;
+	posn.rhdr.hdr.size = sizeof(posn);
+	posn.host_posn = count * STREAM_POSN_PERIOD;
+	posn.dai_posn = count * STREAM_POSN_PERIOD;
+	posn.comp_posn = count * STREAM_POSN_PERIOD;
+	posn.wallclock = count * 3;
+	posn.timestamp = count;
+
+	ipc_stream_posn_write(&test->cd, &posn);
+
+	/* let the readers run between updates */
+	if (!(count % STREAM_POSN_YIELD))
+		sched_yield();
+}
+
+static void stream_posn_setup(struct stream_posn_test *test)
+{
+	int offset;
+
+	memset(test, 0, sizeof(*test));
+	memset(emu_mailbox + MAILBOX_STREAM_OFFSET, 0, MAILBOX_STREAM_SIZE);
+
+	test->cd.pipeline = &test->p;
+	offset = ipc_get_posn_offset(&test->ipc, &test->p);
+	assert_true(offset >= 0);
+
+	test->slot = (struct sof_ipc_stream_posn_slot *)
+		(MAILBOX_STREAM_BASE + offset);
+	test->seq = (uint32_t *)(MAILBOX_STREAM_BASE + offset +
+		offsetof(struct sof_ipc_stream_posn_slot, seq));
+}
+
+/* host side read of the slot */
+static void stream_posn_read(struct stream_posn_test *test,
+			     struct sof_ipc_stream_posn *posn)
+{
+	uint32_t seq;
+
+	do {
+		seq = seq_read_begin(test->seq);
+		memcpy(posn, &test->slot->posn, sizeof(*posn));
+	} while (seq_read_retry(test->seq, seq));
+}
+
+static void *stream_posn_reader_run(void *data)
+{
+	struct stream_posn_reader *reader = data;
+	struct sof_ipc_stream_posn posn;
+	uint64_t last = 0;
+
+	while (!reader->test->done) {
+		stream_posn_read(reader->test, &posn);
+		reader->reads++;
+
+		if (posn.dai_posn != posn.host_posn ||
+		    posn.comp_posn != posn.host_posn ||
+		    posn.host_posn != posn.timestamp * STREAM_POSN_PERIOD ||
+		    posn.wallclock != posn.timestamp * 3)
+			reader->torn++;
+
+		if (posn.timestamp < last)
+			reader->backwards++;
+		last = posn.timestamp;
+	}
+
+	return NULL;
+}
+
+static void test_ipc_stream_posn_concurrent_reads_are_consistent(void **state)
+{
+	struct stream_posn_test test;
+	struct stream_posn_reader readers[STREAM_POSN_READERS];
+	uint64_t count;
+	int i;
+
+	(void) state;
+
+	stream_posn_setup(&test);
+	memset(readers, 0, sizeof(readers));
+	stream_posn_publish(&test, 0);
+
+	for (i = 0; i < STREAM_POSN_READERS; i++) {
+		readers[i].test = &test;
+		assert_int_equal(pthread_create(&readers[i].thread, NULL,
+						stream_posn_reader_run,
+						&readers[i]), 0);
+	}
+
+	for (count = 1; count <= STREAM_POSN_UPDATES; count++)
+		stream_posn_publish(&test, count);
+
+	test.done = 1;
+
+	for (i = 0; i < STREAM_POSN_READERS; i++) {
+		pthread_join(readers[i].thread, NULL);
+		assert_true(readers[i].reads > 0);
+		assert_int_equal(readers[i].torn, 0);
+		assert_int_equal(readers[i].backwards, 0);
+	}
+
+	assert_int_equal(*test.seq, 2 * (STREAM_POSN_UPDATES + 1));
+}
+
+static void test_ipc_stream_posn_slots_have_own_cache_lines(void **state)
+{
+	struct ipc ipc;
+	struct pipeline p[PLATFORM_MAX_STREAMS];
+	int offset;
+	int i;
+
+	(void) state;
+
+	memset(&ipc, 0, sizeof(ipc));
+
+	for (i = 0; i < PLATFORM_MAX_STREAMS; i++) {
+		offset = ipc_get_posn_offset(&ipc, &p[i]);
+		assert_true(offset >= 0);
+		assert_int_equal(offset % PLATFORM_DCACHE_ALIGN, 0);
+		assert_true(offset + sizeof(struct sof_ipc_stream_posn_slot) <=
+			    MAILBOX_STREAM_SIZE);
+
+		/* a neighbour never starts within the slot */
+		if (i)
+			assert_true(offset - p[i - 1].posn_offset >=
+				    sizeof(struct sof_ipc_stream_posn_slot));
+	}
+
+	/* the same pipeline keeps its slot */
+	assert_int_equal(ipc_get_posn_offset(&ipc, &p[1]), p[1].posn_offset);
+}
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test
+			(test_ipc_stream_posn_concurrent_reads_are_consistent),
+		cmocka_unit_test
+			(test_ipc_stream_posn_slots_have_own_cache_lines),
+	};
+
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
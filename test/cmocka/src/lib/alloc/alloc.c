@@ -30,13 +30,17 @@
 
 #include <stdlib.h>
 #include <stdint.h>
+#include <errno.h>
 #include <stdarg.h>
 #include <stddef.h>
 #include <setjmp.h>
+#include <time.h>
 #include <cmocka.h>
 
 #include <sof/sof.h>
 #include <sof/alloc.h>
+#include <sof/dma.h>
+#include <uapi/ipc.h>
 
 extern struct mm memmap;
 
@@ -308,6 +312,409 @@ static void test_lib_alloc_zero(struct test_case *tc)
 	rfree(all_mem);
 }
 
+/*
+ * Fragmentation tests run on the first buffer heap, relocated into a host
+ * allocated arena and trimmed to TEST_FRAG_BLOCKS blocks so the allocator
+ * state can be checked against a simple reference model.
+ */
+
+#define TEST_FRAG_BLOCKS	256
+#define TEST_FRAG_ITERATIONS	20000
+#define TEST_FRAG_MAX_RUN	8
+#define TEST_BENCH_ITERATIONS	10000
+
+struct frag_alloc {
+	uint8_t *ptr;
+	unsigned int start;
+	unsigned int count;
+};
+
+static struct frag_state {
+	struct mm_heap heap;		/* saved heap descriptor */
+	struct block_map map;		/* saved block map */
+	uint8_t *arena;
+	uint8_t used[TEST_FRAG_BLOCKS];	/* reference block usage */
+	struct frag_alloc live[TEST_FRAG_BLOCKS];
+	unsigned int live_count;
+	uint32_t seed;
+} frag;
+
+static uint32_t frag_rand(void)
+{
+	frag.seed = frag.seed * 1103515245 + 12345;
+
+	return frag.seed >> 16;
+}
+
+static int frag_setup(void **state)
+{
+	struct mm_heap *heap = &memmap.buffer[0];
+	struct block_map *map = &heap->map[0];
+	unsigned int words = BLOCK_MAP_WORDS(TEST_FRAG_BLOCKS);
+
+	frag.heap = *heap;
+	frag.map = *map;
+	frag.arena = malloc(TEST_FRAG_BLOCKS * map->block_size);
+	frag.live_count = 0;
+	frag.seed = 0x5eed;
+	memset(frag.used, 0, sizeof(frag.used));
+
+	map->count = TEST_FRAG_BLOCKS;
+	map->free_count = TEST_FRAG_BLOCKS;
+	map->first_free = 0;
+	map->max_used = 0;
+	map->failed = 0;
+	memset(map->block, 0, TEST_FRAG_BLOCKS * sizeof(*map->block));
+	memset(map->used_map, 0, words * sizeof(*map->used_map));
+	memset(map->dirty_map, 0, words * sizeof(*map->dirty_map));
+
+	heap->heap = (uint32_t)frag.arena;
+	heap->size = TEST_FRAG_BLOCKS * map->block_size;
+	heap->info.used = 0;
+	heap->info.free = heap->size;
+	heap->info.peak = 0;
+	heap->info.failed = 0;
+	map->base = heap->heap;
+
+	return 0;
+}
+
+static int frag_teardown(void **state)
+{
+	struct mm_heap *heap = &memmap.buffer[0];
+
+	*heap->map = frag.map;
+	*heap = frag.heap;
+	free(frag.arena);
+
+	return 0;
+}
+
+/* first fit in the reference model, TEST_FRAG_BLOCKS if none */
+static unsigned int frag_first_fit(unsigned int count)
+{
+	unsigned int start;
+	unsigned int run = 0;
+
+	for (start = 0; start < TEST_FRAG_BLOCKS; start++) {
+		run = frag.used[start] ? 0 : run + 1;
+		if (run == count)
+			return start + 1 - count;
+	}
+
+	return TEST_FRAG_BLOCKS;
+}
+
+static void frag_alloc(unsigned int count)
+{
+	struct block_map *map = &memmap.buffer[0].map[0];
+	size_t bytes = count * map->block_size - frag_rand() % map->block_size;
+	unsigned int expect = frag_first_fit(count);
+	struct frag_alloc *a;
+	uint8_t *ptr;
+
+	ptr = rballoc(RZONE_BUFFER, SOF_MEM_CAPS_RAM, bytes);
+
+	if (expect == TEST_FRAG_BLOCKS) {
+		assert_null(ptr);
+		return;
+	}
+
+	/* allocator and reference model must agree on the first fit */
+	assert_ptr_equal(ptr, frag.arena + expect * map->block_size);
+	memset(frag.used + expect, 1, count);
+
+	/* tag the blocks so overlapping allocations are caught on free */
+	a = &frag.live[frag.live_count++];
+	a->ptr = ptr;
+	a->start = expect;
+	a->count = count;
+	memset(ptr, (uint8_t)expect, bytes);
+}
+
+static unsigned int frag_find(unsigned int start)
+{
+	unsigned int i;
+
+	for (i = 0; i < frag.live_count; i++)
+		if (frag.live[i].start == start)
+			break;
+
+	assert_true(i < frag.live_count);
+
+	return i;
+}
+
+static void frag_free(unsigned int idx)
+{
+	struct frag_alloc *a = &frag.live[idx];
+
+	assert_int_equal(a->ptr[0], (uint8_t)a->start);
+
+	rfree(a->ptr);
+	memset(frag.used + a->start, 0, a->count);
+	*a = frag.live[--frag.live_count];
+}
+
+static void test_lib_alloc_fragmentation(void **state)
+{
+	struct mm_heap *heap = &memmap.buffer[0];
+	struct block_map *map = &heap->map[0];
+	unsigned int i;
+
+	for (i = 0; i < TEST_FRAG_ITERATIONS; i++) {
+		/* bias towards allocating until the heap is mostly full */
+		if (frag.live_count && (frag_rand() % 8 < 3 ||
+		    map->free_count < TEST_FRAG_BLOCKS / 8))
+			frag_free(frag_rand() % frag.live_count);
+		else
+			frag_alloc(1 + frag_rand() % TEST_FRAG_MAX_RUN);
+	}
+
+	while (frag.live_count)
+		frag_free(0);
+
+	assert_int_equal(map->free_count, TEST_FRAG_BLOCKS);
+	assert_int_equal(map->first_free, 0);
+	assert_int_equal(heap->info.used, 0);
+	assert_int_equal(heap->info.free, heap->size);
+}
+
+static void test_lib_alloc_bench(void **state)
+{
+	struct block_map *map = &memmap.buffer[0].map[0];
+	clock_t single;
+	clock_t cont;
+	void *ptr;
+	unsigned int i;
+
+	/* fill the heap and free every other block to fragment it, leaving
+	 * the only continuous space at the end of the map
+	 */
+	for (i = 0; i < TEST_FRAG_BLOCKS; i++)
+		frag_alloc(1);
+	for (i = 0; i < TEST_FRAG_BLOCKS * 3 / 4; i += 2)
+		frag_free(frag_find(i));
+	for (i = TEST_FRAG_BLOCKS * 7 / 8; i < TEST_FRAG_BLOCKS; i++)
+		frag_free(frag_find(i));
+
+	single = clock();
+	for (i = 0; i < TEST_BENCH_ITERATIONS; i++) {
+		ptr = rballoc(RZONE_BUFFER, SOF_MEM_CAPS_RAM, map->block_size);
+		assert_non_null(ptr);
+		rfree(ptr);
+	}
+	single = clock() - single;
+
+	cont = clock();
+	for (i = 0; i < TEST_BENCH_ITERATIONS; i++) {
+		ptr = rballoc(RZONE_BUFFER, SOF_MEM_CAPS_RAM,
+			      TEST_FRAG_MAX_RUN * map->block_size);
+		assert_non_null(ptr);
+		rfree(ptr);
+	}
+	cont = clock() - cont;
+
+	print_message("alloc/free x%d: single %ld, continuous %ld clocks\n",
+		      TEST_BENCH_ITERATIONS, (long)single, (long)cont);
+
+	while (frag.live_count)
+		frag_free(0);
+}
+
+static void test_lib_alloc_heap_info(void **state)
+{
+	struct block_map *map = &memmap.buffer[0].map[0];
+	uint32_t data[SOF_IPC_MSG_MAX_SIZE / sizeof(uint32_t)];
+	struct sof_ipc_heap_info *info = (void *)data;
+	unsigned int i;
+
+	/* fill the heap, then free runs of 8 and 3 blocks */
+	for (i = 0; i < TEST_FRAG_BLOCKS; i++)
+		frag_alloc(1);
+	for (i = 4; i < 12; i++)
+		frag_free(frag_find(i));
+	for (i = 100; i < 103; i++)
+		frag_free(frag_find(i));
+
+	/* too big for any free run */
+	assert_null(rballoc(RZONE_BUFFER, SOF_MEM_CAPS_RAM,
+			    9 * map->block_size));
+
+	assert_int_equal(mm_heap_info(SOF_IPC_HEAP_BUFFER, 0, info,
+				      sizeof(data)), 0);
+	assert_int_equal(info->num_heaps, PLATFORM_HEAP_BUFFER);
+	assert_int_equal(info->used, (TEST_FRAG_BLOCKS - 11) * map->block_size);
+	assert_int_equal(info->peak, TEST_FRAG_BLOCKS * map->block_size);
+	assert_int_equal(info->failed, 1);
+	assert_int_equal(info->num_maps, 1);
+	assert_int_equal(info->map[0].free_count, 11);
+	assert_int_equal(info->map[0].max_used, TEST_FRAG_BLOCKS);
+	assert_int_equal(info->map[0].max_run, 8);
+	assert_int_equal(info->map[0].failed, 1);
+
+	assert_int_equal(mm_heap_info(SOF_IPC_HEAP_BUFFER,
+				      PLATFORM_HEAP_BUFFER, info,
+				      sizeof(data)), -EINVAL);
+
+	while (frag.live_count)
+		frag_free(0);
+}
+
+static void test_lib_alloc_slab(void **state)
+{
+	struct mm_slab *cache = &memmap.slab[SLAB_BUFFER];
+	struct mm_arena *arena;
+	void *obj[33];
+	void *big;
+	unsigned int i;
+
+	/* each object comes from the master core's cache until it runs out */
+	for (i = 0; i < cache->count; i++) {
+		obj[i] = rzalloc_slab(RZONE_RUNTIME, SLAB_BUFFER, cache->size);
+		assert_ptr_equal(obj[i], (void *)(cache->base +
+						  i * cache->size));
+	}
+	assert_int_equal(cache->free, 0);
+
+	/* then falls back to the runtime heap, never to the selected arena */
+	arena_select(1);
+	arena = memmap.arena_current[0];
+	obj[i] = rzalloc_slab(RZONE_RUNTIME, SLAB_BUFFER, cache->size);
+	assert_non_null(obj[i]);
+	assert_true((uint32_t)obj[i] - cache->base >=
+		    cache->size * cache->count);
+	assert_int_equal(arena->live, 0);
+
+	/* as do objects larger than the cache object */
+	big = rzalloc_slab(RZONE_RUNTIME, SLAB_BUFFER, cache->size + 1);
+	assert_non_null(big);
+	assert_true((uint32_t)big - cache->base >=
+		    cache->size * cache->count);
+	assert_int_equal(arena->live, 0);
+	rfree(big);
+
+	/* with the capabilities of the cache */
+	cache->caps = SOF_MEM_CAPS_RAM | SOF_MEM_CAPS_DMA;
+	big = rzalloc_slab(RZONE_RUNTIME, SLAB_BUFFER, cache->size);
+	assert_true((uint32_t)big - HEAP_HP_BUFFER_BASE < HEAP_HP_BUFFER_SIZE);
+	rfree(big);
+	cache->caps = SOF_MEM_CAPS_RAM;
+
+	arena_select(ARENA_NONE);
+	arena_release(1);
+
+	/* freed objects are handed out again */
+	rfree(obj[1]);
+	assert_ptr_equal(rzalloc_slab(RZONE_RUNTIME, SLAB_BUFFER, 1), obj[1]);
+
+	for (i = 0; i <= cache->count; i++)
+		rfree(obj[i]);
+	assert_int_equal(cache->free, 0xffffffff >> (32 - cache->count));
+}
+
+/*
+ * PM context tests save and restore against a host image in memory, the
+ * DMA copies to and from the host are modelled with memcpy().
+ */
+
+static uint8_t *pm_image;
+static uint32_t pm_image_size;
+
+int dma_copy_to_host(struct dma_copy *dc, struct dma_sg_config *host_sg,
+		     int32_t host_offset, void *local_ptr, int32_t size)
+{
+	assert_true(host_offset + size <= pm_image_size);
+	memcpy(pm_image + host_offset, local_ptr, size);
+
+	return size;
+}
+
+int dma_copy_from_host(struct dma_copy *dc, struct dma_sg_config *host_sg,
+		       int32_t host_offset, void *local_ptr, int32_t size)
+{
+	assert_true(host_offset + size <= pm_image_size);
+	memcpy(local_ptr, pm_image + host_offset, size);
+
+	return size;
+}
+
+static void test_lib_alloc_pm_context(void **state)
+{
+	struct block_map *map = &memmap.buffer[0].map[0];
+	struct mm_pm_hdr *hdr;
+	uint8_t *changed;
+	clock_t full;
+	clock_t incr;
+	clock_t restore;
+	int full_bytes;
+	int base_bytes;
+	int incr_bytes;
+	int restore_bytes;
+	unsigned int i;
+
+	pm_image_size = mm_pm_context_size();
+	pm_image = calloc(pm_image_size, 1);
+	hdr = (struct mm_pm_hdr *)pm_image;
+
+	/* fill half the heap, every block is saved the first time */
+	for (i = 0; i < TEST_FRAG_BLOCKS / 2; i++)
+		frag_alloc(1);
+
+	full = clock();
+	full_bytes = mm_pm_context_save(NULL, NULL);
+	full = clock() - full;
+	assert_true(full_bytes >= TEST_FRAG_BLOCKS / 2 * map->block_size);
+	assert_int_equal(hdr->magic, MM_PM_MAGIC);
+	assert_int_equal(hdr->size, pm_image_size);
+
+	/* nothing changed, only the allocator state is copied */
+	base_bytes = mm_pm_context_save(NULL, NULL);
+	assert_true(base_bytes < full_bytes);
+
+	/* change one allocation and add a new one of two blocks */
+	changed = frag.live[0].ptr;
+	memset(changed + 1, 0xa5, map->block_size - 1);
+	mm_pm_dirty(changed);
+	frag_alloc(2);
+
+	incr = clock();
+	incr_bytes = mm_pm_context_save(NULL, NULL);
+	incr = clock() - incr;
+	assert_int_equal(incr_bytes, base_bytes + 3 * map->block_size);
+
+	/* lose the heap contents and allocator state */
+	memset(frag.arena, 0, TEST_FRAG_BLOCKS * map->block_size);
+	memset(map->used_map, 0,
+	       BLOCK_MAP_WORDS(TEST_FRAG_BLOCKS) * sizeof(*map->used_map));
+	map->free_count = 0;
+
+	restore = clock();
+	restore_bytes = mm_pm_context_restore(NULL, NULL);
+	restore = clock() - restore;
+	assert_true(restore_bytes > 0);
+
+	assert_int_equal(map->free_count, TEST_FRAG_BLOCKS / 2 - 2);
+	assert_int_equal(changed[1], 0xa5);
+	assert_int_equal(changed[map->block_size - 1], 0xa5);
+
+	print_message("pm context %u bytes: full save %d bytes %ld clocks, "
+		      "incremental save %d bytes %ld clocks, "
+		      "restore %d bytes %ld clocks\n", pm_image_size,
+		      full_bytes, (long)full, incr_bytes, (long)incr,
+		      restore_bytes, (long)restore);
+
+	/* images not written by a save are rejected */
+	hdr->magic = 0;
+	assert_int_equal(mm_pm_context_restore(NULL, NULL), -EINVAL);
+
+	/* allocation tags are checked on free */
+	while (frag.live_count)
+		frag_free(0);
+
+	free(pm_image);
+}
+
 static void test_lib_alloc(void **state)
 {
 	struct test_case *tc = *((struct test_case **)state);
@@ -329,7 +736,7 @@ static void test_lib_alloc(void **state)
 
 int main(void)
 {
-	struct CMUnitTest tests[ARRAY_SIZE(test_cases)];
+	struct CMUnitTest tests[ARRAY_SIZE(test_cases) + 5];
 
 	int i;
 
@@ -343,6 +750,16 @@ int main(void)
 		t->teardown_func = NULL;
 	}
 
+	tests[i++] = (struct CMUnitTest)cmocka_unit_test_setup_teardown(
+		test_lib_alloc_fragmentation, frag_setup, frag_teardown);
+	tests[i++] = (struct CMUnitTest)cmocka_unit_test_setup_teardown(
+		test_lib_alloc_bench, frag_setup, frag_teardown);
+	tests[i++] = (struct CMUnitTest)cmocka_unit_test_setup_teardown(
+		test_lib_alloc_heap_info, frag_setup, frag_teardown);
+	tests[i++] = (struct CMUnitTest)cmocka_unit_test(test_lib_alloc_slab);
+	tests[i++] = (struct CMUnitTest)cmocka_unit_test_setup_teardown(
+		test_lib_alloc_pm_context, frag_setup, frag_teardown);
+
 	cmocka_set_message_output(CM_OUTPUT_TAP);
 
 	return cmocka_run_group_tests(tests, setup, teardown);
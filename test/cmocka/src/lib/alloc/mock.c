@@ -33,6 +33,7 @@
 
 #include <sof/alloc.h>
 #include <sof/trace.h>
+#include <sof/work.h>
 
 struct dma_copy;
 struct dma_sg_config;
@@ -44,6 +45,9 @@ int rstrlen(const char *s)
 	return 0;
 }
 
+/* trace filter of the call sites, all classes off */
+struct trace_filter trace_filter;
+
 void _trace_event0(uint32_t log_entry)
 {
 	(void)log_entry;
@@ -55,6 +59,25 @@ void _trace_event1(uint32_t log_entry, uint32_t param)
 	(void)param;
 }
 
+void _trace_event3(uint32_t log_entry, uint32_t param1, uint32_t param2,
+		   uint32_t param3)
+{
+	(void)log_entry;
+	(void)param1;
+	(void)param2;
+	(void)param3;
+}
+
+void _trace_event4(uint32_t log_entry, uint32_t param1, uint32_t param2,
+		   uint32_t param3, uint32_t param4)
+{
+	(void)log_entry;
+	(void)param1;
+	(void)param2;
+	(void)param3;
+	(void)param4;
+}
+
 void _trace_event_mbox_atomic0(uint32_t log_entry)
 {
 	(void)log_entry;
@@ -86,3 +109,14 @@ void _trace_event_mbox_atomic3(uint32_t log_entry, uint32_t param1,
 void trace_flush(void)
 {
 }
+
+void work_schedule_default(struct work *w, uint64_t timeout)
+{
+	(void)w;
+	(void)timeout;
+}
+
+void work_cancel_default(struct work *w)
+{
+	(void)w;
+}